@@ -8,6 +8,10 @@ def generate_sin_table(len):
    for i in range(len):
       yield math.sin(_2pi * i/len)
 
+def generate_hann_table(len):
+   for i in range(len):
+      yield 0.5 - 0.5 * math.cos(_2pi*i/len)
+
 def generate_hamming_table(len):
    for i in range(len):
       yield 0.54 - 0.46 * math.cos(_2pi*i/len)
@@ -32,6 +36,8 @@ if __name__ == "__main__":
    func = None
    if what == "sin":
       func = generate_sin_table
+   elif what == "hann":
+      func = generate_hann_table
    elif what == "hamming":
       func = generate_hamming_table
    elif what == "blackman":
@@ -0,0 +1,124 @@
+/*=============================================================================
+   Copyright (c) 2014-2020 Joel de Guzman. All rights reserved.
+
+   Distributed under the MIT License [ https://opensource.org/licenses/MIT ]
+=============================================================================*/
+#if !defined(CYCFI_Q_CONSTEXPR_MATH_OCTOBER_18_2026)
+#define CYCFI_Q_CONSTEXPR_MATH_OCTOBER_18_2026
+
+#include <q/support/base.hpp>
+
+namespace cycfi::q::detail
+{
+   ////////////////////////////////////////////////////////////////////////////
+   // constexpr versions of the math functions needed for compile time
+   // filter design. Like the sin and cos series in fft.hpp, these are
+   // series expansions, but take any real argument, with range reduction.
+   // All are accurate to within a few ulp in double precision.
+   ////////////////////////////////////////////////////////////////////////////
+
+   // Round to nearest integer
+   constexpr double constexpr_round(double x)
+   {
+      return (x < 0)?
+         -double(static_cast<long long>(-x + 0.5)) :
+         double(static_cast<long long>(x + 0.5))
+         ;
+   }
+
+   // Taylor series of sin, for |x| <= pi/2
+   constexpr double sin_taylor(double x)
+   {
+      double x2 = x * x;
+      double term = x;
+      double sum = x;
+      for (int n = 2; n < 32; n += 2)
+      {
+         term *= -x2 / (n * (n + 1));
+         sum += term;
+      }
+      return sum;
+   }
+
+   constexpr double constexpr_sin(double x)
+   {
+      // Reduce to [-pi, pi], then to [-pi/2, pi/2] using sin(pi - x) = sin(x)
+      x -= 2 * pi * constexpr_round(x / (2 * pi));
+      if (x > pi / 2)
+         x = pi - x;
+      else if (x < -pi / 2)
+         x = -pi - x;
+      return sin_taylor(x);
+   }
+
+   constexpr double constexpr_cos(double x)
+   {
+      return constexpr_sin(x + pi / 2);
+   }
+
+   constexpr double constexpr_exp(double x)
+   {
+      // x = k * ln(2) + r, with |r| <= ln(2) / 2. exp(x) = 2^k * exp(r)
+      constexpr double ln2 = 0.693147180559945309417232121458;
+      auto k = constexpr_round(x / ln2);
+      auto r = x - k * ln2;
+
+      double term = 1.0;
+      double sum = 1.0;
+      for (int n = 1; n < 24; ++n)
+      {
+         term *= r / n;
+         sum += term;
+      }
+
+      for (; k > 0; --k)
+         sum *= 2.0;
+      for (; k < 0; ++k)
+         sum *= 0.5;
+      return sum;
+   }
+
+   constexpr double constexpr_sinh(double x)
+   {
+      // (exp(x) - exp(-x)) / 2 cancels for small x. Below 1, use the
+      // Taylor series, x + x^3/3! + x^5/5! + ...
+      if (x > -1.0 && x < 1.0)
+      {
+         double x2 = x * x;
+         double term = x;
+         double sum = x;
+         for (int n = 2; n < 24; n += 2)
+         {
+            term *= x2 / (n * (n + 1));
+            sum += term;
+         }
+         return sum;
+      }
+      return (constexpr_exp(x) - constexpr_exp(-x)) / 2;
+   }
+
+   // Newton-Raphson. x must not be negative.
+   constexpr double constexpr_sqrt(double x)
+   {
+      if (x == 0)
+         return 0;
+      double r = (x > 1)? x : 1.0;
+      for (int i = 0; i != 1024; ++i)
+      {
+         double next = (r + x / r) / 2;
+         if (next >= r)
+            break;
+         r = next;
+      }
+      return r;
+   }
+
+   // 10^x
+   constexpr double constexpr_pow10(double x)
+   {
+      constexpr double ln10 = 2.30258509299404568401799145468;
+      return constexpr_exp(x * ln10);
+   }
+}
+
+#endif
@@ -0,0 +1,173 @@
+/*=============================================================================
+   Copyright (c) 2014-2020 Joel de Guzman. All rights reserved.
+
+   Distributed under the MIT License [ https://opensource.org/licenses/MIT ]
+=============================================================================*/
+#if !defined(CYCFI_Q_DB_POLY_OCTOBER_18_2026)
+#define CYCFI_Q_DB_POLY_OCTOBER_18_2026
+
+#include <cstdint>
+#include <cstring>
+#include <cstddef>
+
+namespace cycfi::q::detail
+{
+   ////////////////////////////////////////////////////////////////////////////
+   // Polynomial linear to decibel (fast_a2db) and decibel to linear
+   // (fast_db2a) conversions. These are alternatives to the a2db and db2a
+   // table lookups (db_table.hpp), for converting whole buffers: there are
+   // no tables (no gathers, nothing in the cache, other than a dozen
+   // coefficients) and no branches, so the buffer loops vectorize.
+   //
+   // Like fast_log2 and fast_pow2 (fast_math.hpp), these work on the IEEE
+   // 754 representation: the exponent is taken (or put back) with integer
+   // operations, and only the mantissa needs an approximation, here a
+   // polynomial, fitted at the Chebyshev nodes (near minimax).
+   //
+   // fast_a2db: a = 2^e * m, with m in [sqrt(1/2), sqrt(2)), then
+   //
+   //    log2(a) = e + u * P(u),    u = m - 1
+   //
+   // P: degree 6. The maximum error is 2e-5 dB (in float), over the whole
+   // range. The tables are accurate to about 0.01% of the result, but are
+   // off by up to 0.5 dB near -120 dB.
+   //
+   // fast_db2a: 10^(db/20) = 2^y = 2^n * 2^r, with n = round(y) and r in
+   // [-0.5, 0.5], then 2^r = Q(r).
+   //
+   // Q: degree 5. The maximum relative error is 1e-6, mostly from the
+   // rounding of y to float at the ends of the range (against 2e-5 for the
+   // tables).
+   //
+   // Like db2a, the range is +-120 dB: linear values are clamped to [1e-6,
+   // 1e6] and decibels to [-120, 120].
+   ////////////////////////////////////////////////////////////////////////////
+   // The float bits, with the magnitude bits flipped for negatives: these
+   // integer keys are ordered like the floats. Float comparisons may trap
+   // (NaNs), which keeps the compiler from turning selects into branch-free
+   // code in loops. Comparing the keys instead does not.
+   inline std::int32_t ordered_key(float f)
+   {
+      std::int32_t i;
+      std::memcpy(&i, &f, sizeof(float));
+      return i ^ ((i >> 31) & 0x7fffffff);
+   }
+
+   // a if c, else b, with integer masks. Both a and b are computed, which
+   // keeps the compiler from moving the computation of either into a
+   // branch (floating point operations may trap, so it would not compute
+   // them both to select the result, and the loop would not vectorize).
+   inline float select(bool c, float a, float b)
+   {
+      std::int32_t ia, ib;
+      std::memcpy(&ia, &a, sizeof(float));
+      std::memcpy(&ib, &b, sizeof(float));
+      std::int32_t const mask = -std::int32_t(c);
+      std::int32_t const i = (ia & mask) | (ib & ~mask);
+      float r;
+      std::memcpy(&r, &i, sizeof(float));
+      return r;
+   }
+
+   // Clamps x to [lo, hi], comparing the ordered keys
+   inline float ordered_clamp(float x, float lo, float hi)
+   {
+      auto k = ordered_key(x);
+      auto const k_lo = ordered_key(lo);
+      auto const k_hi = ordered_key(hi);
+      k = (k < k_lo)? k_lo : k;
+      k = (k > k_hi)? k_hi : k;
+      k ^= (k >> 31) & 0x7fffffff;
+      std::memcpy(&x, &k, sizeof(float));
+      return x;
+   }
+
+   inline float fast_a2db(float a)
+   {
+      // 20 * log10(2)
+      constexpr float db_per_octave = 6.02059991327962f;
+      constexpr std::int32_t sqrt_half = 0x3f3504f3;
+
+      // Clamp a to [1e-6, 1e6]. The bounds are positive, so the bits of
+      // a, as integers, compare like the floats (negatives, with the sign
+      // bit set, are below the lower bound). No need for ordered_key.
+      constexpr std::int32_t lo = 0x358637bd;   // 1e-6f
+      constexpr std::int32_t hi = 0x49742400;   // 1e6f
+      std::int32_t i;
+      std::memcpy(&i, &a, sizeof(float));
+      i = (i < lo)? lo : i;
+      i = (i > hi)? hi : i;
+
+      // Split the mantissa from the exponent, with the mantissa in
+      // [sqrt(1/2), sqrt(2)), centered around 1.
+      std::int32_t const k = i - sqrt_half;
+      std::int32_t const mi = (k & 0x007fffff) + sqrt_half;
+      float const e = float(k >> 23);
+      float m;
+      std::memcpy(&m, &mi, sizeof(float));
+
+      float const u = m - 1.0f;
+      float p = 0.16818659110579423f;
+      p = p * u + -0.26796387051465587f;
+      p = p * u + 0.29611955722204836f;
+      p = p * u + -0.35952445546337675f;
+      p = p * u + 0.48061312547290963f;
+      p = p * u + -0.7213601785760267f;
+      p = p * u + 1.442696523046545f;
+      return db_per_octave * (e + u * p);
+   }
+
+   inline float fast_db2a(float db)
+   {
+      // log2(10) / 20
+      constexpr float octaves_per_db = 0.166096404744368f;
+
+      // Adding and subtracting 1.5 * 2^23 rounds to the nearest integer
+      constexpr float round = 12582912.0f;
+
+      // Clamp db to [-120, 120]. The range is symmetric, so it is enough
+      // to clamp the magnitude bits, keeping the sign bit.
+      constexpr std::int32_t max_db = 0x42f00000;  // 120.0f
+      std::int32_t bits;
+      std::memcpy(&bits, &db, sizeof(float));
+      std::int32_t mag = bits & 0x7fffffff;
+      mag = (mag > max_db)? max_db : mag;
+      bits = mag | (bits & ~0x7fffffff);
+      std::memcpy(&db, &bits, sizeof(float));
+
+      float const y = db * octaves_per_db;
+      float const n = (y + round) - round;
+      float const r = y - n;
+
+      float q = 0.0013390863364533504f;
+      q = q * r + 0.009676031918326564f;
+      q = q * r + 0.05550357114219461f;
+      q = q * r + 0.24022107485308208f;
+      q = q * r + 0.6931471880262287f;
+      q = q * r + 1.0f;
+
+      // Multiply by 2^n, adding n to the exponent
+      std::int32_t i;
+      std::memcpy(&i, &q, sizeof(float));
+      i += std::int32_t(n) * (1 << 23);
+      std::memcpy(&q, &i, sizeof(float));
+      return q;
+   }
+
+   ////////////////////////////////////////////////////////////////////////////
+   // Buffer conversions. in and out may be the same buffer.
+   ////////////////////////////////////////////////////////////////////////////
+   inline void fast_a2db(float const* in, float* out, std::size_t n)
+   {
+      for (std::size_t i = 0; i != n; ++i)
+         out[i] = fast_a2db(in[i]);
+   }
+
+   inline void fast_db2a(float const* in, float* out, std::size_t n)
+   {
+      for (std::size_t i = 0; i != n; ++i)
+         out[i] = fast_db2a(in[i]);
+   }
+}
+
+#endif
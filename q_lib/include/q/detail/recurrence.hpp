@@ -0,0 +1,240 @@
+/*=============================================================================
+   Copyright (c) 2014-2020 Joel de Guzman. All rights reserved.
+
+   Distributed under the MIT License [ https://opensource.org/licenses/MIT ]
+=============================================================================*/
+#if !defined(CYCFI_Q_RECURRENCE_OCTOBER_18_2026)
+#define CYCFI_Q_RECURRENCE_OCTOBER_18_2026
+
+#include <q/detail/db_poly.hpp>
+#include <cstddef>
+
+namespace cycfi::q::detail
+{
+   ////////////////////////////////////////////////////////////////////////////
+   // Block processing of the first order linear recurrence:
+   //
+   //    y[i] = a * y[i-1] + u[i]
+   //
+   // which is the form of the one pole filters (one_pole_lowpass,
+   // leaky_integrator, dc_block, exp_moving_average and the
+   // envelope_follower).
+   //
+   // One sample at a time, each output has to wait for the previous one (a
+   // multiply and an add). Instead, the samples are processed in blocks of
+   // block_size samples. Within a block, the recurrence is expanded (a
+   // scan):
+   //
+   //    v[k] = u[i+k] + a * v[k-1],      with v[-1] = 0
+   //    y[i+k] = v[k] + a^(k+1) * y[i-1]
+   //
+   // The v[k] do not depend on the previous outputs, so these can be
+   // computed ahead (the CPU overlaps the blocks), and only a multiply and
+   // an add per block depends on the previous block. The outputs are then
+   // independent of each other, and can be computed in SIMD lanes.
+   //
+   // The sums are associated differently, so the results are not bit
+   // exact, but are within a few ulps of the sample by sample recurrence
+   // (relative to the signal level).
+   ////////////////////////////////////////////////////////////////////////////
+   struct recurrence
+   {
+      static constexpr std::size_t block_size = 8;
+
+      recurrence(float a)
+       : a(a)
+      {
+         float p = a;
+         for (std::size_t k = 0; k != block_size; ++k)
+         {
+            powers[k] = p;
+            p *= a;
+         }
+      }
+
+      // Process one block of inputs u, given the previous output y, and
+      // write the outputs to out. Returns the last output.
+      float block(float y, float const* u, float* out) const
+      {
+         float v[block_size];
+         v[0] = u[0];
+         for (std::size_t k = 1; k != block_size; ++k)
+            v[k] = u[k] + a * v[k-1];
+         for (std::size_t k = 0; k != block_size; ++k)
+            out[k] = v[k] + powers[k] * y;
+         return v[block_size-1] + powers[block_size-1] * y;
+      }
+
+      // Process n samples, given the previous output y. u(i) returns the
+      // ith input term, and is called in order, before out[i] is written
+      // (so that out may be the same buffer as the input). Returns the
+      // last output.
+      template <typename U>
+      float operator()(float y, float* out, std::size_t n, U&& u) const
+      {
+         auto const m = n - n % block_size;
+         std::size_t i = 0;
+         for (; i != m; i += block_size)
+         {
+            float ub[block_size];
+            for (std::size_t k = 0; k != block_size; ++k)
+               ub[k] = u(i + k);
+            y = block(y, ub, out + i);
+         }
+         for (; i < n; ++i)
+            out[i] = y = a * y + u(i);
+         return y;
+      }
+
+      float a;
+      float powers[block_size];   // a^1 ... a^block_size
+   };
+
+   ////////////////////////////////////////////////////////////////////////////
+   // Block processing of the "hold" recurrence:
+   //
+   //    y[i] = select(x[i], a * y[i-1] + (1-a) * x[i])
+   //
+   // where select is the maximum (e.g. the peak_envelope_follower: instant
+   // attack, exponential release) or the minimum (e.g. the release of the
+   // lookahead_limiter gain). See moving_maximum.hpp: select_max and
+   // select_min.
+   //
+   // Like the recurrence above, with a > 0, the steps compose: within a
+   // block, the output is:
+   //
+   //    y[i+k] = select(h[k], v[k] + a^(k+1) * y[i-1])
+   //
+   // where h[k] is the hold recurrence starting with no previous output
+   // (h[0] = x[i]), and v[k] + a^(k+1) * y[i-1], the linear recurrence
+   // (without the select), starting from the previous output. Both h and
+   // v are computed ahead, without the previous output.
+   //
+   // Still, h and v are serial within a block. Whole tiles of tile_size
+   // samples are split into lanes segments of segment_size samples
+   // instead, and the h and v of all the segments are computed side by
+   // side, in SIMD lanes (the tile is transposed, segment major). Only the
+   // outputs at the ends of the segments are then computed one after the
+   // other (one step per segment), and finally all the outputs, in lanes.
+   // The selects in the lanes compare the ordered keys of the floats (see
+   // ordered_key), so these vectorize.
+   ////////////////////////////////////////////////////////////////////////////
+   template <typename Select>
+   struct hold_recurrence
+   {
+      static constexpr std::size_t block_size = recurrence::block_size;
+      static constexpr std::size_t lanes = 16;
+      static constexpr std::size_t segment_size = 16;
+      static constexpr std::size_t tile_size = lanes * segment_size;
+
+      hold_recurrence(float a)
+       : r(a)
+       , b(1.0f - a)
+      {
+         float p = a;
+         for (std::size_t k = 0; k != segment_size; ++k)
+         {
+            powers[k] = p;
+            p *= a;
+         }
+      }
+
+      // Select, comparing the ordered keys. Select is select_max or
+      // select_min.
+      static float lane_select(float s, float c)
+      {
+         bool const is_max = Select{}(0.0f, 1.0f) == 1.0f;
+         auto const ks = ordered_key(s);
+         auto const kc = ordered_key(c);
+         return select(is_max? (ks < kc) : (kc < ks), c, s);
+      }
+
+      // Process a whole tile (see above). Returns the last output.
+      float tile(float y, float const* x, float* out) const
+      {
+         constexpr auto L = lanes;
+         constexpr auto S = segment_size;
+         auto const a = r.a;
+
+         // h and v, segment major, starting with the samples
+         float h[S][L], v[S][L], ys[L];
+         for (std::size_t j = 0; j != L; ++j)
+            for (std::size_t k = 0; k != S; ++k)
+               h[k][j] = x[j * S + k];
+
+         for (std::size_t j = 0; j != L; ++j)
+            v[0][j] = b * h[0][j];
+         for (std::size_t k = 1; k != S; ++k)
+         {
+            for (std::size_t j = 0; j != L; ++j)
+            {
+               auto const s = h[k][j];
+               auto const u = b * s;
+               auto const hp = h[k-1][j];
+               auto const vp = v[k-1][j];
+               h[k][j] = lane_select(s, u + a * hp);
+               v[k][j] = u + a * vp;
+            }
+         }
+
+         // The previous output of each segment
+         for (std::size_t j = 0; j != L; ++j)
+         {
+            ys[j] = y;
+            y = lane_select(h[S-1][j], v[S-1][j] + powers[S-1] * y);
+         }
+
+         // The outputs
+         for (std::size_t k = 0; k != S; ++k)
+         {
+            for (std::size_t j = 0; j != L; ++j)
+            {
+               auto const hk = h[k][j];
+               auto const vk = v[k][j];
+               h[k][j] = lane_select(hk, vk + powers[k] * ys[j]);
+            }
+         }
+
+         for (std::size_t k = 0; k != S; ++k)
+            for (std::size_t j = 0; j != L; ++j)
+               out[j * S + k] = h[k][j];
+         return y;
+      }
+
+      // Process n samples, x, given the previous output y. out may be the
+      // same buffer as x. Returns the last output.
+      float operator()(float y, float const* x, float* out, std::size_t n) const
+      {
+         Select select;
+         auto const a = r.a;
+         std::size_t i = 0;
+         for (; i + tile_size <= n; i += tile_size)
+            y = tile(y, x + i, out + i);
+
+         auto const m = n - (n - i) % block_size;
+         for (; i != m; i += block_size)
+         {
+            float const* s = x + i;
+            float u[block_size], v[block_size], h[block_size];
+            for (std::size_t k = 0; k != block_size; ++k)
+               u[k] = b * s[k];
+            h[0] = s[0];
+            for (std::size_t k = 1; k != block_size; ++k)
+               h[k] = select(s[k], u[k] + a * h[k-1]);
+            r.block(y, u, v);
+            for (std::size_t k = 0; k != block_size; ++k)
+               out[i+k] = select(h[k], v[k]);
+            y = out[i+block_size-1];
+         }
+         for (; i < n; ++i)
+            out[i] = y = select(x[i], b * x[i] + a * y);
+         return y;
+      }
+
+      recurrence r;
+      float b;                      // 1-a
+      float powers[segment_size];   // a^1 ... a^segment_size
+   };
+}
+
+#endif
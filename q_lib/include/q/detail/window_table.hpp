@@ -0,0 +1,416 @@
+/*=============================================================================
+   Copyright (c) 2014-2020 Joel de Guzman. All rights reserved.
+
+   Distributed under the MIT License [ https://opensource.org/licenses/MIT ]
+=============================================================================*/
+#if !defined(CYCFI_Q_WINDOW_TABLE_HPP_OCTOBER_18_2026)
+#define CYCFI_Q_WINDOW_TABLE_HPP_OCTOBER_18_2026
+
+namespace cycfi::q::detail
+{
+   ////////////////////////////////////////////////////////////////////////////
+   // Window lookup tables (generated by python/generate_tables.py). Each
+   // table holds one period (1024 points) of a periodic window plus one
+   // extra point (equal to the first) to allow interpolation at the end.
+   ////////////////////////////////////////////////////////////////////////////
+   constexpr float hann_table[] =
+   {
+      0.000000000000000, 0.000009412358699, 0.000037649080428, 0.000084709102088, 0.000150590651898, 0.000235291249453, 0.000338807705825, 0.000461136123677,
+      0.000602271897414, 0.000762209713353, 0.000940943549925, 0.001138466677904, 0.001354771660655, 0.001589850354417, 0.001843693908611, 0.002116292766170,
+      0.002407636663902, 0.002717714632872, 0.003046514998822, 0.003394025382603, 0.003760232700645, 0.004145123165450, 0.004548682286110, 0.004970894868851,
+      0.005411745017609, 0.005871216134625, 0.006349290921071, 0.006845951377701, 0.007361178805529, 0.007894953806535, 0.008447256284392, 0.009018065445222,
+      0.009607359798385, 0.010215117157280, 0.010841314640186, 0.011485928671123, 0.012148934980736, 0.012830308607212, 0.013530023897220, 0.014248054506874,
+      0.014984373402728, 0.015738952862791, 0.016511764477574, 0.017302779151155, 0.018111967102280, 0.018939297865479, 0.019784740292217, 0.020648262552064,
+      0.021529832133896, 0.022429415847115, 0.023346979822903, 0.024282489515496, 0.025235909703482, 0.026207204491129, 0.027196337309739, 0.028203270919020,
+      0.029227967408490, 0.030270388198905, 0.031330494043713, 0.032408245030526, 0.033503600582631, 0.034616519460508, 0.035746959763392, 0.036894878930844,
+      0.038060233744357, 0.039242980328979, 0.040443074154971, 0.041660470039479, 0.042895122148235, 0.044146983997285, 0.045416008454739, 0.046702147742542,
+      0.048005353438278, 0.049325576476989, 0.050662767153023, 0.052016875121907, 0.053387849402242, 0.054775638377621, 0.056180189798573, 0.057601450784531,
+      0.059039367825822, 0.060493886785683, 0.061964952902297, 0.063452510790855, 0.064956504445644, 0.066476877242154, 0.068013571939207, 0.069566530681116,
+      0.071135694999864, 0.072721005817300, 0.074322403447367, 0.075939827598351, 0.077573217375146, 0.079222511281551, 0.080887647222581, 0.082568562506810,
+      0.084265193848727, 0.085977477371122, 0.087705348607487, 0.089448742504448, 0.091207593424208, 0.092981835147026, 0.094771400873703, 0.096576223228100,
+      0.098396234259678, 0.100231365446047, 0.102081547695558, 0.103946711349894, 0.105826786186697, 0.107721701422212, 0.109631385713953, 0.111555767163384,
+      0.113494773318632, 0.115448331177210, 0.117416367188771, 0.119398807257869, 0.121395576746758, 0.123406600478194, 0.125431802738270, 0.127471107279267,
+      0.129524437322520, 0.131591715561315, 0.133672864163794, 0.135767804775887, 0.137876458524266, 0.139998746019309, 0.142134587358091, 0.144283902127392,
+      0.146446609406726, 0.148622627771387, 0.150811875295514, 0.153014269555173, 0.155229727631467, 0.157458166113650, 0.159699501102273, 0.161953648212342,
+      0.164220522576491, 0.166500038848181, 0.168792111204914, 0.171096653351461, 0.173413578523112, 0.175742799488944, 0.178084228555104, 0.180437777568112,
+      0.182803357918177, 0.185180880542536, 0.187570255928807, 0.189971394118355, 0.192384204709687, 0.194808596861845, 0.197244479297837, 0.199691760308066,
+      0.202150347753783, 0.204620149070563, 0.207101071271781, 0.209593020952118, 0.212095904291077, 0.214609627056516, 0.217134094608193, 0.219669211901332,
+      0.222214883490199, 0.224771013531698, 0.227337505788977, 0.229914263635054, 0.232501190056451, 0.235098187656853, 0.237705158660766, 0.240322004917205,
+      0.242948627903389, 0.245584928728447, 0.248230808137141, 0.250886166513609, 0.253550903885108, 0.256224919925782, 0.258908113960439, 0.261600384968339,
+      0.264301631587001, 0.267011752116017, 0.269730644520880, 0.272458206436828, 0.275194335172697, 0.277938927714785, 0.280691880730736, 0.283453090573424,
+      0.286222453284859, 0.288999864600100, 0.291785219951181, 0.294578414471048, 0.297379342997505, 0.300187900077177, 0.303003979969476, 0.305827476650587,
+      0.308658283817455, 0.311496294891791, 0.314341403024081, 0.317193501097613, 0.320052481732506, 0.322918237289755, 0.325790659875283, 0.328669641344003,
+      0.331555073303890, 0.334446847120062, 0.337344853918868, 0.340248984591992, 0.343159129800554, 0.346075179979233, 0.348997025340386, 0.351924555878188,
+      0.354857661372769, 0.357796231394364, 0.360740155307473, 0.363689322275025, 0.366643621262551, 0.369602941042362, 0.372567170197743, 0.375536197127140,
+      0.378509910048368, 0.381488197002816, 0.384470945859664, 0.387458044320104, 0.390449379921565, 0.393444840041954, 0.396444311903891, 0.399447682578954,
+      0.402454838991936, 0.405465667925097, 0.408480056022429, 0.411497889793926, 0.414519055619849, 0.417543439755015, 0.420570928333069, 0.423601407370778,
+      0.426634762772319, 0.429670880333575, 0.432709645746437, 0.435750944603103, 0.438794662400392, 0.441840684544048, 0.444888896353058, 0.447939183063973,
+      0.450991429835220, 0.454045521751434, 0.457101343827780, 0.460158781014285, 0.463217718200166, 0.466278040218168, 0.469339631848896, 0.472402377825155,
+      0.475466162836291, 0.478530871532530, 0.481596388529321, 0.484662598411682, 0.487729385738544, 0.490796635047098, 0.493864230857140, 0.496932057675423,
+      0.500000000000000, 0.503067942324577, 0.506135769142860, 0.509203364952902, 0.512270614261456, 0.515337401588318, 0.518403611470679, 0.521469128467470,
+      0.524533837163709, 0.527597622174845, 0.530660368151104, 0.533721959781832, 0.536782281799834, 0.539841218985715, 0.542898656172220, 0.545954478248566,
+      0.549008570164780, 0.552060816936027, 0.555111103646941, 0.558159315455952, 0.561205337599608, 0.564249055396897, 0.567290354253563, 0.570329119666425,
+      0.573365237227681, 0.576398592629222, 0.579429071666931, 0.582456560244985, 0.585480944380151, 0.588502110206074, 0.591519943977570, 0.594534332074903,
+      0.597545161008064, 0.600552317421046, 0.603555688096109, 0.606555159958046, 0.609550620078435, 0.612541955679896, 0.615529054140336, 0.618511802997184,
+      0.621490089951632, 0.624463802872860, 0.627432829802257, 0.630397058957638, 0.633356378737449, 0.636310677724974, 0.639259844692527, 0.642203768605636,
+      0.645142338627231, 0.648075444121812, 0.651002974659614, 0.653924820020767, 0.656840870199446, 0.659751015408008, 0.662655146081131, 0.665553152879938,
+      0.668444926696110, 0.671330358655997, 0.674209340124717, 0.677081762710245, 0.679947518267494, 0.682806498902387, 0.685658596975919, 0.688503705108209,
+      0.691341716182545, 0.694172523349413, 0.696996020030524, 0.699812099922823, 0.702620657002495, 0.705421585528952, 0.708214780048819, 0.711000135399900,
+      0.713777546715141, 0.716546909426576, 0.719308119269264, 0.722061072285215, 0.724805664827303, 0.727541793563172, 0.730269355479120, 0.732988247883983,
+      0.735698368412999, 0.738399615031661, 0.741091886039561, 0.743775080074218, 0.746449096114892, 0.749113833486391, 0.751769191862859, 0.754415071271554,
+      0.757051372096611, 0.759677995082795, 0.762294841339234, 0.764901812343147, 0.767498809943548, 0.770085736364946, 0.772662494211023, 0.775228986468302,
+      0.777785116509801, 0.780330788098668, 0.782865905391807, 0.785390372943484, 0.787904095708923, 0.790406979047882, 0.792898928728219, 0.795379850929437,
+      0.797849652246217, 0.800308239691934, 0.802755520702163, 0.805191403138155, 0.807615795290313, 0.810028605881645, 0.812429744071193, 0.814819119457464,
+      0.817196642081823, 0.819562222431888, 0.821915771444896, 0.824257200511056, 0.826586421476888, 0.828903346648539, 0.831207888795086, 0.833499961151819,
+      0.835779477423509, 0.838046351787658, 0.840300498897727, 0.842541833886350, 0.844770272368534, 0.846985730444827, 0.849188124704486, 0.851377372228613,
+      0.853553390593274, 0.855716097872608, 0.857865412641909, 0.860001253980691, 0.862123541475733, 0.864232195224113, 0.866327135836206, 0.868408284438685,
+      0.870475562677479, 0.872528892720733, 0.874568197261730, 0.876593399521806, 0.878604423253242, 0.880601192742131, 0.882583632811230, 0.884551668822790,
+      0.886505226681368, 0.888444232836616, 0.890368614286047, 0.892278298577788, 0.894173213813303, 0.896053288650106, 0.897918452304442, 0.899768634553953,
+      0.901603765740322, 0.903423776771900, 0.905228599126297, 0.907018164852974, 0.908792406575792, 0.910551257495552, 0.912294651392513, 0.914022522628878,
+      0.915734806151273, 0.917431437493190, 0.919112352777419, 0.920777488718449, 0.922426782624854, 0.924060172401649, 0.925677596552633, 0.927278994182700,
+      0.928864305000136, 0.930433469318884, 0.931986428060793, 0.933523122757846, 0.935043495554356, 0.936547489209145, 0.938035047097703, 0.939506113214317,
+      0.940960632174177, 0.942398549215469, 0.943819810201427, 0.945224361622379, 0.946612150597758, 0.947983124878093, 0.949337232846977, 0.950674423523011,
+      0.951994646561722, 0.953297852257458, 0.954583991545261, 0.955853016002715, 0.957104877851765, 0.958339529960521, 0.959556925845029, 0.960757019671021,
+      0.961939766255643, 0.963105121069156, 0.964253040236608, 0.965383480539492, 0.966496399417369, 0.967591754969474, 0.968669505956287, 0.969729611801095,
+      0.970772032591510, 0.971796729080980, 0.972803662690261, 0.973792795508871, 0.974764090296518, 0.975717510484504, 0.976653020177097, 0.977570584152885,
+      0.978470167866104, 0.979351737447936, 0.980215259707783, 0.981060702134521, 0.981888032897720, 0.982697220848845, 0.983488235522426, 0.984261047137209,
+      0.985015626597272, 0.985751945493126, 0.986469976102780, 0.987169691392788, 0.987851065019264, 0.988514071328877, 0.989158685359814, 0.989784882842720,
+      0.990392640201615, 0.990981934554778, 0.991552743715608, 0.992105046193465, 0.992638821194471, 0.993154048622299, 0.993650709078929, 0.994128783865375,
+      0.994588254982391, 0.995029105131149, 0.995451317713890, 0.995854876834550, 0.996239767299355, 0.996605974617397, 0.996953485001178, 0.997282285367128,
+      0.997592363336098, 0.997883707233830, 0.998156306091389, 0.998410149645583, 0.998645228339345, 0.998861533322096, 0.999059056450075, 0.999237790286647,
+      0.999397728102586, 0.999538863876323, 0.999661192294175, 0.999764708750547, 0.999849409348102, 0.999915290897912, 0.999962350919572, 0.999990587641301,
+      1.000000000000000, 0.999990587641301, 0.999962350919572, 0.999915290897912, 0.999849409348102, 0.999764708750547, 0.999661192294175, 0.999538863876323,
+      0.999397728102586, 0.999237790286647, 0.999059056450075, 0.998861533322096, 0.998645228339345, 0.998410149645583, 0.998156306091389, 0.997883707233830,
+      0.997592363336098, 0.997282285367128, 0.996953485001178, 0.996605974617397, 0.996239767299355, 0.995854876834550, 0.995451317713890, 0.995029105131149,
+      0.994588254982391, 0.994128783865375, 0.993650709078929, 0.993154048622299, 0.992638821194471, 0.992105046193465, 0.991552743715608, 0.990981934554778,
+      0.990392640201615, 0.989784882842720, 0.989158685359814, 0.988514071328877, 0.987851065019264, 0.987169691392788, 0.986469976102780, 0.985751945493126,
+      0.985015626597272, 0.984261047137209, 0.983488235522426, 0.982697220848845, 0.981888032897720, 0.981060702134521, 0.980215259707783, 0.979351737447936,
+      0.978470167866105, 0.977570584152885, 0.976653020177097, 0.975717510484504, 0.974764090296518, 0.973792795508871, 0.972803662690261, 0.971796729080980,
+      0.970772032591510, 0.969729611801095, 0.968669505956288, 0.967591754969474, 0.966496399417369, 0.965383480539492, 0.964253040236608, 0.963105121069156,
+      0.961939766255643, 0.960757019671021, 0.959556925845029, 0.958339529960521, 0.957104877851765, 0.955853016002715, 0.954583991545261, 0.953297852257458,
+      0.951994646561722, 0.950674423523011, 0.949337232846977, 0.947983124878093, 0.946612150597758, 0.945224361622379, 0.943819810201427, 0.942398549215469,
+      0.940960632174177, 0.939506113214317, 0.938035047097703, 0.936547489209145, 0.935043495554356, 0.933523122757846, 0.931986428060793, 0.930433469318884,
+      0.928864305000136, 0.927278994182700, 0.925677596552633, 0.924060172401649, 0.922426782624854, 0.920777488718449, 0.919112352777419, 0.917431437493190,
+      0.915734806151273, 0.914022522628878, 0.912294651392513, 0.910551257495552, 0.908792406575792, 0.907018164852974, 0.905228599126297, 0.903423776771900,
+      0.901603765740322, 0.899768634553953, 0.897918452304442, 0.896053288650106, 0.894173213813303, 0.892278298577788, 0.890368614286047, 0.888444232836616,
+      0.886505226681369, 0.884551668822790, 0.882583632811230, 0.880601192742131, 0.878604423253242, 0.876593399521806, 0.874568197261730, 0.872528892720733,
+      0.870475562677480, 0.868408284438685, 0.866327135836206, 0.864232195224113, 0.862123541475734, 0.860001253980691, 0.857865412641909, 0.855716097872608,
+      0.853553390593274, 0.851377372228613, 0.849188124704487, 0.846985730444827, 0.844770272368534, 0.842541833886350, 0.840300498897727, 0.838046351787658,
+      0.835779477423509, 0.833499961151819, 0.831207888795086, 0.828903346648539, 0.826586421476889, 0.824257200511056, 0.821915771444896, 0.819562222431888,
+      0.817196642081823, 0.814819119457463, 0.812429744071193, 0.810028605881645, 0.807615795290314, 0.805191403138155, 0.802755520702163, 0.800308239691935,
+      0.797849652246217, 0.795379850929437, 0.792898928728220, 0.790406979047882, 0.787904095708923, 0.785390372943484, 0.782865905391807, 0.780330788098668,
+      0.777785116509801, 0.775228986468302, 0.772662494211023, 0.770085736364946, 0.767498809943549, 0.764901812343147, 0.762294841339235, 0.759677995082795,
+      0.757051372096611, 0.754415071271554, 0.751769191862859, 0.749113833486391, 0.746449096114892, 0.743775080074218, 0.741091886039561, 0.738399615031661,
+      0.735698368412999, 0.732988247883983, 0.730269355479120, 0.727541793563172, 0.724805664827303, 0.722061072285215, 0.719308119269264, 0.716546909426576,
+      0.713777546715141, 0.711000135399900, 0.708214780048819, 0.705421585528952, 0.702620657002495, 0.699812099922823, 0.696996020030524, 0.694172523349413,
+      0.691341716182545, 0.688503705108209, 0.685658596975919, 0.682806498902387, 0.679947518267494, 0.677081762710245, 0.674209340124717, 0.671330358655997,
+      0.668444926696110, 0.665553152879938, 0.662655146081132, 0.659751015408008, 0.656840870199446, 0.653924820020768, 0.651002974659614, 0.648075444121812,
+      0.645142338627231, 0.642203768605636, 0.639259844692527, 0.636310677724974, 0.633356378737449, 0.630397058957638, 0.627432829802257, 0.624463802872860,
+      0.621490089951632, 0.618511802997184, 0.615529054140335, 0.612541955679896, 0.609550620078435, 0.606555159958046, 0.603555688096109, 0.600552317421046,
+      0.597545161008064, 0.594534332074903, 0.591519943977570, 0.588502110206074, 0.585480944380151, 0.582456560244985, 0.579429071666931, 0.576398592629222,
+      0.573365237227681, 0.570329119666425, 0.567290354253563, 0.564249055396897, 0.561205337599608, 0.558159315455952, 0.555111103646942, 0.552060816936027,
+      0.549008570164780, 0.545954478248566, 0.542898656172220, 0.539841218985715, 0.536782281799834, 0.533721959781832, 0.530660368151105, 0.527597622174845,
+      0.524533837163709, 0.521469128467471, 0.518403611470680, 0.515337401588318, 0.512270614261456, 0.509203364952903, 0.506135769142860, 0.503067942324577,
+      0.500000000000000, 0.496932057675423, 0.493864230857140, 0.490796635047098, 0.487729385738544, 0.484662598411682, 0.481596388529321, 0.478530871532530,
+      0.475466162836291, 0.472402377825155, 0.469339631848896, 0.466278040218168, 0.463217718200166, 0.460158781014285, 0.457101343827780, 0.454045521751434,
+      0.450991429835220, 0.447939183063973, 0.444888896353059, 0.441840684544048, 0.438794662400392, 0.435750944603103, 0.432709645746437, 0.429670880333576,
+      0.426634762772319, 0.423601407370778, 0.420570928333069, 0.417543439755015, 0.414519055619849, 0.411497889793926, 0.408480056022430, 0.405465667925097,
+      0.402454838991936, 0.399447682578954, 0.396444311903891, 0.393444840041954, 0.390449379921565, 0.387458044320104, 0.384470945859665, 0.381488197002816,
+      0.378509910048368, 0.375536197127140, 0.372567170197743, 0.369602941042362, 0.366643621262551, 0.363689322275026, 0.360740155307473, 0.357796231394364,
+      0.354857661372769, 0.351924555878188, 0.348997025340386, 0.346075179979233, 0.343159129800554, 0.340248984591992, 0.337344853918869, 0.334446847120062,
+      0.331555073303890, 0.328669641344003, 0.325790659875283, 0.322918237289755, 0.320052481732506, 0.317193501097613, 0.314341403024081, 0.311496294891791,
+      0.308658283817455, 0.305827476650587, 0.303003979969476, 0.300187900077177, 0.297379342997505, 0.294578414471048, 0.291785219951182, 0.288999864600100,
+      0.286222453284859, 0.283453090573424, 0.280691880730736, 0.277938927714785, 0.275194335172697, 0.272458206436828, 0.269730644520880, 0.267011752116017,
+      0.264301631587001, 0.261600384968339, 0.258908113960439, 0.256224919925782, 0.253550903885108, 0.250886166513609, 0.248230808137141, 0.245584928728447,
+      0.242948627903389, 0.240322004917205, 0.237705158660765, 0.235098187656853, 0.232501190056452, 0.229914263635054, 0.227337505788977, 0.224771013531698,
+      0.222214883490199, 0.219669211901332, 0.217134094608193, 0.214609627056516, 0.212095904291078, 0.209593020952118, 0.207101071271781, 0.204620149070563,
+      0.202150347753784, 0.199691760308066, 0.197244479297837, 0.194808596861845, 0.192384204709686, 0.189971394118355, 0.187570255928807, 0.185180880542537,
+      0.182803357918177, 0.180437777568112, 0.178084228555104, 0.175742799488944, 0.173413578523112, 0.171096653351461, 0.168792111204914, 0.166500038848181,
+      0.164220522576491, 0.161953648212342, 0.159699501102274, 0.157458166113650, 0.155229727631467, 0.153014269555173, 0.150811875295514, 0.148622627771387,
+      0.146446609406726, 0.144283902127392, 0.142134587358091, 0.139998746019309, 0.137876458524267, 0.135767804775888, 0.133672864163794, 0.131591715561315,
+      0.129524437322521, 0.127471107279267, 0.125431802738270, 0.123406600478194, 0.121395576746758, 0.119398807257869, 0.117416367188771, 0.115448331177210,
+      0.113494773318632, 0.111555767163384, 0.109631385713953, 0.107721701422212, 0.105826786186697, 0.103946711349894, 0.102081547695558, 0.100231365446048,
+      0.098396234259677, 0.096576223228100, 0.094771400873703, 0.092981835147026, 0.091207593424208, 0.089448742504448, 0.087705348607487, 0.085977477371122,
+      0.084265193848727, 0.082568562506810, 0.080887647222581, 0.079222511281551, 0.077573217375146, 0.075939827598351, 0.074322403447368, 0.072721005817300,
+      0.071135694999864, 0.069566530681116, 0.068013571939207, 0.066476877242154, 0.064956504445644, 0.063452510790855, 0.061964952902297, 0.060493886785683,
+      0.059039367825823, 0.057601450784531, 0.056180189798573, 0.054775638377621, 0.053387849402242, 0.052016875121908, 0.050662767153023, 0.049325576476989,
+      0.048005353438278, 0.046702147742542, 0.045416008454739, 0.044146983997285, 0.042895122148235, 0.041660470039479, 0.040443074154971, 0.039242980328979,
+      0.038060233744357, 0.036894878930844, 0.035746959763392, 0.034616519460508, 0.033503600582631, 0.032408245030526, 0.031330494043713, 0.030270388198905,
+      0.029227967408490, 0.028203270919020, 0.027196337309739, 0.026207204491129, 0.025235909703482, 0.024282489515496, 0.023346979822903, 0.022429415847115,
+      0.021529832133896, 0.020648262552064, 0.019784740292217, 0.018939297865479, 0.018111967102280, 0.017302779151155, 0.016511764477574, 0.015738952862791,
+      0.014984373402728, 0.014248054506874, 0.013530023897220, 0.012830308607212, 0.012148934980736, 0.011485928671123, 0.010841314640186, 0.010215117157280,
+      0.009607359798385, 0.009018065445222, 0.008447256284392, 0.007894953806535, 0.007361178805529, 0.006845951377701, 0.006349290921071, 0.005871216134625,
+      0.005411745017610, 0.004970894868851, 0.004548682286110, 0.004145123165450, 0.003760232700645, 0.003394025382603, 0.003046514998822, 0.002717714632872,
+      0.002407636663902, 0.002116292766170, 0.001843693908611, 0.001589850354417, 0.001354771660655, 0.001138466677904, 0.000940943549925, 0.000762209713353,
+      0.000602271897414, 0.000461136123677, 0.000338807705825, 0.000235291249453, 0.000150590651898, 0.000084709102088, 0.000037649080428, 0.000009412358699,
+      0.000000000000000
+   };
+
+   constexpr float hamming_table[] =
+   {
+      0.080000000000000, 0.080008659370004, 0.080034637153994, 0.080077932373921, 0.080138543399746, 0.080216467949497, 0.080311703089359, 0.080424245233783,
+      0.080554090145621, 0.080701232936284, 0.080865668065931, 0.081047389343672, 0.081246389927803, 0.081462662326064, 0.081696198395922, 0.081946989344876,
+      0.082215025730789, 0.082500297462243, 0.082802793798916, 0.083122503351995, 0.083459414084593, 0.083813513312214, 0.084184787703221, 0.084573223279343,
+      0.084978805416201, 0.085401518843855, 0.085841347647385, 0.086298275267485, 0.086772284501087, 0.087263357502013, 0.087771475781641, 0.088296620209605,
+      0.088838771014514, 0.089397907784697, 0.089974009468971, 0.090567054377433, 0.091177020182277, 0.091803883918635, 0.092447621985442, 0.093108210146324,
+      0.093785623530510, 0.094479836633768, 0.095190823319368, 0.095918556819063, 0.096663009734098, 0.097424154036241, 0.098201961068840, 0.098996401547899,
+      0.099807445563184, 0.100635062579345, 0.101479221437071, 0.102339890354256, 0.103217036927203, 0.104110628131839, 0.105020630324960, 0.105947009245498,
+      0.106889730015810, 0.107848757142993, 0.108824054520216, 0.109815585428084, 0.110823312536020, 0.111847197903667, 0.112887202982321, 0.113943288616377,
+      0.115015415044808, 0.116103541902661, 0.117207628222573, 0.118327632436320, 0.119463512376376, 0.120615225277502, 0.121782727778360, 0.122965975923139,
+      0.124164925163216, 0.125379530358830, 0.126609745780781, 0.127855525112155, 0.129116821450063, 0.130393587307411, 0.131685774614687, 0.132993334721769,
+      0.134316218399757, 0.135654375842829, 0.137007756670113, 0.138376309927587, 0.139759984089993, 0.141158727062781, 0.142572486184070, 0.144001208226627,
+      0.145444839399875, 0.146903325351916, 0.148376611171578, 0.149864641390483, 0.151367359985135, 0.152884710379027, 0.154416635444775, 0.155963077506265,
+      0.157523978340829, 0.159099279181432, 0.160688920718888, 0.162292843104092, 0.163910985950272, 0.165543288335264, 0.167189688803806, 0.168850125369852,
+      0.170524535518903, 0.172212856210364, 0.173915023879914, 0.175630974441902, 0.177360643291761, 0.179103965308435, 0.180860874856837, 0.182631305790313,
+      0.184415191453141, 0.186212464683033, 0.188023057813669, 0.189846902677240, 0.191683930607017, 0.193534072439938, 0.195397258519209, 0.197273418696926,
+      0.199162482336719, 0.201064378316410, 0.202979035030690, 0.204906380393816, 0.206846341842325, 0.208798846337764, 0.210763820369443, 0.212741189957200,
+      0.214730880654188, 0.216732817549676, 0.218746925271873, 0.220773127990759, 0.222811349420949, 0.224861512824558, 0.226923541014092, 0.228997356355355,
+      0.231082880770372, 0.233180035740327, 0.235288742308521, 0.237408921083344, 0.239540492241263, 0.241683375529828, 0.243837490270696, 0.246002755362663,
+      0.248179089284723, 0.250366410099134, 0.252564635454502, 0.254773682588887, 0.256993468332912, 0.259223909112898, 0.261464920954010, 0.263716419483420,
+      0.265978319933481, 0.268250537144918, 0.270532985570038, 0.272825579275948, 0.275128231947791, 0.277440856891995, 0.279763367039538, 0.282095674949225,
+      0.284437692810983, 0.286789332449162, 0.289150505325859, 0.291521122544249, 0.293901094851935, 0.296290332644304, 0.298688745967904, 0.301096244523829,
+      0.303512737671118, 0.305938134430171, 0.308372343486170, 0.310815273192520, 0.313266831574299, 0.315726926331719, 0.318195464843604, 0.320672354170872,
+      0.323157501060041, 0.325650811946736, 0.328152192959210, 0.330661549921882, 0.333178788358881, 0.335703813497603, 0.338236530272277, 0.340776843327550,
+      0.343324657022070, 0.345879875432092, 0.348442402355087, 0.351012141313364, 0.353588995557705, 0.356172868071003, 0.358763661571918, 0.361361278518540,
+      0.363965621112059, 0.366576591300448, 0.369194090782155, 0.371818021009804, 0.374448283193905, 0.377084778306574, 0.379727407085260, 0.382376070036483,
+      0.385030667439579, 0.387691099350457, 0.390357265605359, 0.393029065824633, 0.395706399416510, 0.398389165580894, 0.401077263313155, 0.403770591407933,
+      0.406469048462947, 0.409172532882815, 0.411880942882876, 0.414594176493023, 0.417312131561547, 0.420034705758973, 0.422761796581923, 0.425493301356969,
+      0.428229117244499, 0.430969141242591, 0.433713270190891, 0.436461400774495, 0.439213429527840, 0.441969252838598, 0.444728766951579, 0.447491867972638,
+      0.450258451872581, 0.453028414491089, 0.455801651540635, 0.458578058610412, 0.461357531170261, 0.464139964574614, 0.466925254066424, 0.469713294781116,
+      0.472503981750534, 0.475297209906889, 0.478092874086722, 0.480890869034855, 0.483691089408361, 0.486493429780524, 0.489297784644814, 0.492104048418855,
+      0.494912115448402, 0.497721880011319, 0.500533236321558, 0.503346078533142, 0.506160300744153, 0.508975797000714, 0.511792461300984, 0.514610187599143,
+      0.517428869809388, 0.520248401809927, 0.523068677446975, 0.525889590538747, 0.528711034879460, 0.531532904243330, 0.534355092388569, 0.537177493061389,
+      0.540000000000000, 0.542822506938611, 0.545644907611431, 0.548467095756670, 0.551288965120540, 0.554110409461253, 0.556931322553025, 0.559751598190073,
+      0.562571130190612, 0.565389812400857, 0.568207538699016, 0.571024202999285, 0.573839699255847, 0.576653921466858, 0.579466763678442, 0.582278119988681,
+      0.585087884551598, 0.587895951581145, 0.590702215355186, 0.593506570219476, 0.596308910591639, 0.599109130965145, 0.601907125913278, 0.604702790093111,
+      0.607496018249466, 0.610286705218884, 0.613074745933576, 0.615860035425386, 0.618642468829739, 0.621421941389589, 0.624198348459365, 0.626971585508911,
+      0.629741548127419, 0.632508132027362, 0.635271233048420, 0.638030747161402, 0.640786570472160, 0.643538599225505, 0.646286729809109, 0.649030858757409,
+      0.651770882755501, 0.654506698643031, 0.657238203418077, 0.659965294241027, 0.662687868438453, 0.665405823506977, 0.668119057117124, 0.670827467117185,
+      0.673530951537053, 0.676229408592067, 0.678922736686845, 0.681610834419106, 0.684293600583490, 0.686970934175367, 0.689642734394641, 0.692308900649543,
+      0.694969332560421, 0.697623929963517, 0.700272592914740, 0.702915221693426, 0.705551716806095, 0.708181978990196, 0.710805909217845, 0.713423408699552,
+      0.716034378887941, 0.718638721481460, 0.721236338428082, 0.723827131928998, 0.726411004442295, 0.728987858686636, 0.731557597644913, 0.734120124567908,
+      0.736675342977930, 0.739223156672450, 0.741763469727723, 0.744296186502397, 0.746821211641119, 0.749338450078118, 0.751847807040790, 0.754349188053264,
+      0.756842498939959, 0.759327645829128, 0.761804535156396, 0.764273073668280, 0.766733168425701, 0.769184726807480, 0.771627656513830, 0.774061865569829,
+      0.776487262328882, 0.778903755476171, 0.781311254032096, 0.783709667355696, 0.786098905148065, 0.788478877455751, 0.790849494674141, 0.793210667550838,
+      0.795562307189017, 0.797904325050775, 0.800236632960462, 0.802559143108005, 0.804871768052209, 0.807174420724052, 0.809467014429962, 0.811749462855082,
+      0.814021680066519, 0.816283580516580, 0.818535079045990, 0.820776090887102, 0.823006531667088, 0.825226317411113, 0.827435364545498, 0.829633589900866,
+      0.831820910715277, 0.833997244637337, 0.836162509729304, 0.838316624470172, 0.840459507758737, 0.842591078916656, 0.844711257691479, 0.846819964259673,
+      0.848917119229629, 0.851002643644645, 0.853076458985908, 0.855138487175442, 0.857188650579051, 0.859226872009241, 0.861253074728128, 0.863267182450324,
+      0.865269119345812, 0.867258810042800, 0.869236179630557, 0.871201153662236, 0.873153658157675, 0.875093619606184, 0.877020964969310, 0.878935621683590,
+      0.880837517663281, 0.882726581303074, 0.884602741480791, 0.886465927560062, 0.888316069392983, 0.890153097322760, 0.891976942186331, 0.893787535316967,
+      0.895584808546859, 0.897368694209687, 0.899139125143164, 0.900896034691565, 0.902639356708239, 0.904369025558098, 0.906084976120086, 0.907787143789636,
+      0.909475464481097, 0.911149874630148, 0.912810311196194, 0.914456711664736, 0.916089014049729, 0.917707156895908, 0.919311079281112, 0.920900720818568,
+      0.922476021659171, 0.924036922493735, 0.925583364555226, 0.927115289620973, 0.928632640014865, 0.930135358609517, 0.931623388828422, 0.933096674648084,
+      0.934555160600125, 0.935998791773373, 0.937427513815930, 0.938841272937219, 0.940240015910007, 0.941623690072414, 0.942992243329887, 0.944345624157171,
+      0.945683781600243, 0.947006665278231, 0.948314225385313, 0.949606412692589, 0.950883178549937, 0.952144474887845, 0.953390254219219, 0.954620469641170,
+      0.955835074836784, 0.957034024076861, 0.958217272221640, 0.959384774722498, 0.960536487623624, 0.961672367563680, 0.962792371777427, 0.963896458097339,
+      0.964984584955192, 0.966056711383623, 0.967112797017679, 0.968152802096333, 0.969176687463980, 0.970184414571916, 0.971175945479784, 0.972151242857007,
+      0.973110269984190, 0.974052990754502, 0.974979369675040, 0.975889371868161, 0.976782963072797, 0.977660109645744, 0.978520778562929, 0.979364937420655,
+      0.980192554436816, 0.981003598452101, 0.981798038931160, 0.982575845963759, 0.983336990265902, 0.984081443180937, 0.984809176680632, 0.985520163366232,
+      0.986214376469490, 0.986891789853676, 0.987552378014558, 0.988196116081365, 0.988822979817723, 0.989432945622567, 0.990025990531029, 0.990602092215303,
+      0.991161228985486, 0.991703379790395, 0.992228524218359, 0.992736642497987, 0.993227715498913, 0.993701724732515, 0.994158652352615, 0.994598481156145,
+      0.995021194583799, 0.995426776720657, 0.995815212296779, 0.996186486687786, 0.996540585915407, 0.996877496648006, 0.997197206201084, 0.997499702537758,
+      0.997784974269211, 0.998053010655124, 0.998303801604078, 0.998537337673936, 0.998753610072198, 0.998952610656328, 0.999134331934069, 0.999298767063716,
+      0.999445909854379, 0.999575754766217, 0.999688296910641, 0.999783532050503, 0.999861456600254, 0.999922067626079, 0.999965362846007, 0.999991340629997,
+      1.000000000000000, 0.999991340629997, 0.999965362846007, 0.999922067626079, 0.999861456600254, 0.999783532050503, 0.999688296910641, 0.999575754766217,
+      0.999445909854379, 0.999298767063716, 0.999134331934069, 0.998952610656328, 0.998753610072198, 0.998537337673936, 0.998303801604078, 0.998053010655124,
+      0.997784974269211, 0.997499702537758, 0.997197206201084, 0.996877496648006, 0.996540585915407, 0.996186486687786, 0.995815212296779, 0.995426776720657,
+      0.995021194583799, 0.994598481156145, 0.994158652352615, 0.993701724732516, 0.993227715498913, 0.992736642497987, 0.992228524218360, 0.991703379790395,
+      0.991161228985486, 0.990602092215303, 0.990025990531029, 0.989432945622567, 0.988822979817723, 0.988196116081365, 0.987552378014558, 0.986891789853676,
+      0.986214376469490, 0.985520163366232, 0.984809176680632, 0.984081443180937, 0.983336990265902, 0.982575845963759, 0.981798038931160, 0.981003598452101,
+      0.980192554436816, 0.979364937420655, 0.978520778562929, 0.977660109645744, 0.976782963072797, 0.975889371868161, 0.974979369675040, 0.974052990754502,
+      0.973110269984190, 0.972151242857007, 0.971175945479785, 0.970184414571916, 0.969176687463980, 0.968152802096333, 0.967112797017679, 0.966056711383623,
+      0.964984584955192, 0.963896458097339, 0.962792371777427, 0.961672367563680, 0.960536487623624, 0.959384774722498, 0.958217272221640, 0.957034024076861,
+      0.955835074836784, 0.954620469641170, 0.953390254219219, 0.952144474887845, 0.950883178549937, 0.949606412692589, 0.948314225385313, 0.947006665278231,
+      0.945683781600243, 0.944345624157171, 0.942992243329887, 0.941623690072414, 0.940240015910007, 0.938841272937219, 0.937427513815930, 0.935998791773373,
+      0.934555160600125, 0.933096674648084, 0.931623388828422, 0.930135358609517, 0.928632640014865, 0.927115289620973, 0.925583364555226, 0.924036922493735,
+      0.922476021659171, 0.920900720818568, 0.919311079281112, 0.917707156895908, 0.916089014049729, 0.914456711664736, 0.912810311196194, 0.911149874630148,
+      0.909475464481097, 0.907787143789637, 0.906084976120086, 0.904369025558098, 0.902639356708239, 0.900896034691565, 0.899139125143164, 0.897368694209687,
+      0.895584808546859, 0.893787535316967, 0.891976942186331, 0.890153097322760, 0.888316069392983, 0.886465927560062, 0.884602741480791, 0.882726581303074,
+      0.880837517663281, 0.878935621683590, 0.877020964969310, 0.875093619606184, 0.873153658157675, 0.871201153662236, 0.869236179630557, 0.867258810042800,
+      0.865269119345812, 0.863267182450324, 0.861253074728128, 0.859226872009241, 0.857188650579051, 0.855138487175442, 0.853076458985909, 0.851002643644645,
+      0.848917119229629, 0.846819964259673, 0.844711257691479, 0.842591078916656, 0.840459507758738, 0.838316624470172, 0.836162509729304, 0.833997244637337,
+      0.831820910715277, 0.829633589900866, 0.827435364545498, 0.825226317411113, 0.823006531667089, 0.820776090887102, 0.818535079045990, 0.816283580516580,
+      0.814021680066519, 0.811749462855082, 0.809467014429962, 0.807174420724052, 0.804871768052209, 0.802559143108005, 0.800236632960462, 0.797904325050775,
+      0.795562307189017, 0.793210667550838, 0.790849494674142, 0.788478877455751, 0.786098905148065, 0.783709667355696, 0.781311254032096, 0.778903755476171,
+      0.776487262328882, 0.774061865569829, 0.771627656513830, 0.769184726807480, 0.766733168425701, 0.764273073668281, 0.761804535156396, 0.759327645829128,
+      0.756842498939959, 0.754349188053265, 0.751847807040790, 0.749338450078118, 0.746821211641119, 0.744296186502398, 0.741763469727723, 0.739223156672450,
+      0.736675342977930, 0.734120124567908, 0.731557597644913, 0.728987858686636, 0.726411004442296, 0.723827131928998, 0.721236338428082, 0.718638721481460,
+      0.716034378887942, 0.713423408699552, 0.710805909217845, 0.708181978990196, 0.705551716806095, 0.702915221693426, 0.700272592914740, 0.697623929963518,
+      0.694969332560421, 0.692308900649543, 0.689642734394641, 0.686970934175367, 0.684293600583490, 0.681610834419106, 0.678922736686845, 0.676229408592067,
+      0.673530951537053, 0.670827467117185, 0.668119057117125, 0.665405823506977, 0.662687868438453, 0.659965294241027, 0.657238203418077, 0.654506698643031,
+      0.651770882755502, 0.649030858757409, 0.646286729809109, 0.643538599225505, 0.640786570472160, 0.638030747161402, 0.635271233048420, 0.632508132027362,
+      0.629741548127419, 0.626971585508911, 0.624198348459365, 0.621421941389589, 0.618642468829739, 0.615860035425386, 0.613074745933576, 0.610286705218884,
+      0.607496018249467, 0.604702790093111, 0.601907125913278, 0.599109130965145, 0.596308910591639, 0.593506570219476, 0.590702215355186, 0.587895951581145,
+      0.585087884551598, 0.582278119988681, 0.579466763678443, 0.576653921466858, 0.573839699255847, 0.571024202999286, 0.568207538699016, 0.565389812400857,
+      0.562571130190612, 0.559751598190073, 0.556931322553025, 0.554110409461253, 0.551288965120540, 0.548467095756670, 0.545644907611431, 0.542822506938611,
+      0.540000000000000, 0.537177493061389, 0.534355092388569, 0.531532904243330, 0.528711034879460, 0.525889590538747, 0.523068677446975, 0.520248401809927,
+      0.517428869809388, 0.514610187599143, 0.511792461300984, 0.508975797000715, 0.506160300744153, 0.503346078533142, 0.500533236321558, 0.497721880011319,
+      0.494912115448402, 0.492104048418855, 0.489297784644814, 0.486493429780524, 0.483691089408361, 0.480890869034855, 0.478092874086722, 0.475297209906890,
+      0.472503981750534, 0.469713294781116, 0.466925254066424, 0.464139964574614, 0.461357531170261, 0.458578058610412, 0.455801651540635, 0.453028414491089,
+      0.450258451872581, 0.447491867972638, 0.444728766951580, 0.441969252838598, 0.439213429527840, 0.436461400774495, 0.433713270190892, 0.430969141242591,
+      0.428229117244499, 0.425493301356969, 0.422761796581924, 0.420034705758973, 0.417312131561547, 0.414594176493024, 0.411880942882876, 0.409172532882815,
+      0.406469048462948, 0.403770591407933, 0.401077263313155, 0.398389165580894, 0.395706399416510, 0.393029065824633, 0.390357265605359, 0.387691099350457,
+      0.385030667439579, 0.382376070036483, 0.379727407085260, 0.377084778306575, 0.374448283193906, 0.371818021009804, 0.369194090782155, 0.366576591300448,
+      0.363965621112059, 0.361361278518540, 0.358763661571918, 0.356172868071003, 0.353588995557705, 0.351012141313364, 0.348442402355087, 0.345879875432092,
+      0.343324657022070, 0.340776843327550, 0.338236530272278, 0.335703813497602, 0.333178788358881, 0.330661549921882, 0.328152192959210, 0.325650811946736,
+      0.323157501060041, 0.320672354170872, 0.318195464843604, 0.315726926331720, 0.313266831574299, 0.310815273192521, 0.308372343486170, 0.305938134430171,
+      0.303512737671118, 0.301096244523829, 0.298688745967904, 0.296290332644304, 0.293901094851935, 0.291521122544250, 0.289150505325859, 0.286789332449162,
+      0.284437692810983, 0.282095674949225, 0.279763367039538, 0.277440856891995, 0.275128231947791, 0.272825579275948, 0.270532985570038, 0.268250537144918,
+      0.265978319933481, 0.263716419483420, 0.261464920954010, 0.259223909112898, 0.256993468332912, 0.254773682588887, 0.252564635454502, 0.250366410099134,
+      0.248179089284723, 0.246002755362663, 0.243837490270696, 0.241683375529828, 0.239540492241263, 0.237408921083344, 0.235288742308521, 0.233180035740327,
+      0.231082880770372, 0.228997356355355, 0.226923541014092, 0.224861512824558, 0.222811349420949, 0.220773127990759, 0.218746925271873, 0.216732817549676,
+      0.214730880654188, 0.212741189957201, 0.210763820369443, 0.208798846337765, 0.206846341842325, 0.204906380393817, 0.202979035030690, 0.201064378316410,
+      0.199162482336719, 0.197273418696926, 0.195397258519209, 0.193534072439938, 0.191683930607017, 0.189846902677240, 0.188023057813669, 0.186212464683033,
+      0.184415191453141, 0.182631305790313, 0.180860874856837, 0.179103965308436, 0.177360643291761, 0.175630974441902, 0.173915023879914, 0.172212856210364,
+      0.170524535518903, 0.168850125369852, 0.167189688803806, 0.165543288335264, 0.163910985950272, 0.162292843104092, 0.160688920718888, 0.159099279181433,
+      0.157523978340829, 0.155963077506265, 0.154416635444775, 0.152884710379027, 0.151367359985135, 0.149864641390483, 0.148376611171578, 0.146903325351916,
+      0.145444839399875, 0.144001208226627, 0.142572486184070, 0.141158727062781, 0.139759984089993, 0.138376309927587, 0.137007756670113, 0.135654375842829,
+      0.134316218399757, 0.132993334721769, 0.131685774614687, 0.130393587307411, 0.129116821450063, 0.127855525112155, 0.126609745780781, 0.125379530358830,
+      0.124164925163216, 0.122965975923139, 0.121782727778360, 0.120615225277502, 0.119463512376376, 0.118327632436320, 0.117207628222573, 0.116103541902661,
+      0.115015415044808, 0.113943288616377, 0.112887202982321, 0.111847197903668, 0.110823312536020, 0.109815585428084, 0.108824054520216, 0.107848757142993,
+      0.106889730015810, 0.105947009245498, 0.105020630324960, 0.104110628131839, 0.103217036927203, 0.102339890354256, 0.101479221437071, 0.100635062579345,
+      0.099807445563184, 0.098996401547899, 0.098201961068840, 0.097424154036241, 0.096663009734098, 0.095918556819063, 0.095190823319368, 0.094479836633768,
+      0.093785623530510, 0.093108210146324, 0.092447621985442, 0.091803883918635, 0.091177020182277, 0.090567054377433, 0.089974009468971, 0.089397907784697,
+      0.088838771014514, 0.088296620209605, 0.087771475781641, 0.087263357502013, 0.086772284501087, 0.086298275267485, 0.085841347647385, 0.085401518843855,
+      0.084978805416201, 0.084573223279343, 0.084184787703221, 0.083813513312214, 0.083459414084593, 0.083122503351995, 0.082802793798916, 0.082500297462243,
+      0.082215025730789, 0.081946989344876, 0.081696198395922, 0.081462662326064, 0.081246389927803, 0.081047389343672, 0.080865668065931, 0.080701232936284,
+      0.080554090145621, 0.080424245233783, 0.080311703089359, 0.080216467949497, 0.080138543399746, 0.080077932373921, 0.080034637153994, 0.080008659370004,
+      0.080000000000000
+   };
+
+   constexpr float blackman_table[] =
+   {
+      0.000000000000000, 0.000003388505831, 0.000013554576124, 0.000030499869156, 0.000054227148312, 0.000084740281465, 0.000122044240120, 0.000166145098300,
+      0.000217050031190, 0.000274767313541, 0.000339306317822, 0.000410677512127, 0.000488892457837, 0.000573963807046, 0.000665905299726, 0.000764731760667,
+      0.000870459096160, 0.000983104290442, 0.001102685401904, 0.001229221559048, 0.001362732956209, 0.001503240849038, 0.001650767549745, 0.001805336422097,
+      0.001966971876186, 0.002135699362961, 0.002311545368514, 0.002494537408142, 0.002684704020171, 0.002882074759541, 0.003086680191171, 0.003298551883080,
+      0.003517722399288, 0.003744225292484, 0.003978095096469, 0.004219367318365, 0.004468078430611, 0.004724265862728, 0.004987967992861, 0.005259224139102,
+      0.005538074550596, 0.005824560398424, 0.006118723766271, 0.006420607640882, 0.006730255902302, 0.007047713313900, 0.007373025512194, 0.007706238996451,
+      0.008047401118099, 0.008396560069917, 0.008753764875030, 0.009119065375703, 0.009492512221933, 0.009874156859840, 0.010264051519868, 0.010662249204787,
+      0.011068803677509, 0.011483769448702, 0.011907201764231, 0.012339156592403, 0.012779690611027, 0.013228861194301, 0.013686726399510, 0.014153344953550,
+      0.014628776239280, 0.015113080281697, 0.015606317733936, 0.016108549863115, 0.016619838535996, 0.017140246204499, 0.017669835891041, 0.018208671173726,
+      0.018756816171370, 0.019314335528380, 0.019881294399473, 0.020457758434253, 0.021043793761637, 0.021639466974136, 0.022244845112001, 0.022859995647220,
+      0.023484986467391, 0.024119885859447, 0.024764762493264, 0.025419685405132, 0.026084723981102, 0.026759947940211, 0.027445427317589, 0.028141232447446,
+      0.028847433945944, 0.029564102693959, 0.030291309819736, 0.031029126681434, 0.031777624849569, 0.032536876089362, 0.033306952342980, 0.034087925711694,
+      0.034879868437935, 0.035682852887269, 0.036496951530286, 0.037322236924402, 0.038158781695586, 0.039006658520007, 0.039865940105614, 0.040736699173639,
+      0.041619008440035, 0.042512940596852, 0.043418568293550, 0.044335964118255, 0.045265200578958, 0.046206350084666, 0.047159484926502, 0.048124677258761,
+      0.049101999079922, 0.050091522213621, 0.051093318289595, 0.052107458724578, 0.053134014703187, 0.054173057158764, 0.055224656754208, 0.056288883862778,
+      0.057365808548885, 0.058455500548870, 0.059558029251767, 0.060673463680064, 0.061801872470460, 0.062943323854618, 0.064097885639924, 0.065265625190249,
+      0.066446609406726, 0.067640904708530, 0.068848577013681, 0.070069691719864, 0.071304313685273, 0.072552507209473, 0.073814336014300, 0.075089863224787,
+      0.076379151350126, 0.077682262264671, 0.078999257188977, 0.080330196670891, 0.081675140566683, 0.083034148022235, 0.084407277454280, 0.085794586531701,
+      0.087196132156887, 0.088611970447159, 0.090042156716257, 0.091486745455902, 0.092945790317425, 0.094419344093484, 0.095907458699845, 0.097410185157261,
+      0.098927573573426, 0.100459673125025, 0.102006532039869, 0.103568197579137, 0.105144716019700, 0.106736132636562, 0.108342491685394, 0.109963836385185,
+      0.111600208900992, 0.113251650326814, 0.114918200668578, 0.116599898827243, 0.118296782582029, 0.120008888573770, 0.121736252288397, 0.123478908040546,
+      0.125236888957309, 0.127010226962117, 0.128798952758758, 0.130603095815552, 0.132422684349650, 0.134257745311504, 0.136108304369471, 0.137974385894575,
+      0.139856012945433, 0.141753207253328, 0.143665989207452, 0.145594377840313, 0.147538390813302, 0.149498044402439, 0.151473353484286, 0.153464331522033,
+      0.155470990551767, 0.157493341168917, 0.159531392514879, 0.161585152263834, 0.163654626609744, 0.165739820253540, 0.167840736390511, 0.169957376697869,
+      0.172089741322531, 0.174237828869085, 0.176401636387964, 0.178581159363820, 0.180776391704109, 0.182987325727878, 0.185213952154764, 0.187456260094206,
+      0.189714237034871, 0.191987868834294, 0.194277139708740, 0.196582032223281, 0.198902527282103, 0.201238604119025, 0.203590240288259, 0.205957411655386,
+      0.208340092388565, 0.210738254949977, 0.213151870087497, 0.215580906826604, 0.218025332462529, 0.220485112552635, 0.222960210909046, 0.225450589591507,
+      0.227956208900500, 0.230477027370588, 0.233013001764023, 0.235564087064587, 0.238130236471690, 0.240711401394712, 0.243307531447608, 0.245918574443749,
+      0.248544476391033, 0.251185181487240, 0.253840632115650, 0.256510768840920, 0.259195530405208, 0.261894853724573, 0.264608673885626, 0.267336924142443,
+      0.270079535913742, 0.272836438780330, 0.275607560482802, 0.278392826919515, 0.281192162144828, 0.284005488367603, 0.286832725949976, 0.289673793406402,
+      0.292528607402961, 0.295397082756936, 0.298279132436665, 0.301174667561656, 0.304083597402984, 0.307005829383945, 0.309941269080999, 0.312889820224966,
+      0.315851384702515, 0.318825862557907, 0.321813151995025, 0.324813149379670, 0.327825749242130, 0.330850844280030, 0.333888325361444, 0.336938081528291,
+      0.340000000000000, 0.343073966177446, 0.346159863647164, 0.349257574185834, 0.352366977765042, 0.355487952556306, 0.358620374936384, 0.361764119492848,
+      0.364919059029933, 0.368085064574656, 0.371262005383207, 0.374449748947610, 0.377648161002651, 0.380857105533086, 0.384076444781105, 0.387306039254069,
+      0.390545747732522, 0.393795427278457, 0.397054933243859, 0.400324119279508, 0.403602837344045, 0.406890937713308, 0.410188268989928, 0.413494678113179,
+      0.416810010369104, 0.420134109400886, 0.423466817219488, 0.426807974214543, 0.430157419165509, 0.433514989253068, 0.436880520070791, 0.440253845637046,
+      0.443634798407161, 0.447023209285841, 0.450418907639827, 0.453821721310804, 0.457231476628559, 0.460647998424380, 0.464071110044694, 0.467500633364955,
+      0.470936388803764, 0.474378195337227, 0.477825870513560, 0.481279230467911, 0.484738089937427, 0.488202262276553, 0.491671559472550, 0.495145792161249,
+      0.498624769643027, 0.502108299899010, 0.505596189607487, 0.509088244160560, 0.512584267680994, 0.516084063039297, 0.519587431871003, 0.523094174594171,
+      0.526604090427091, 0.530116977406200, 0.533632632404198, 0.537150851148368, 0.540671428239097, 0.544194157168594, 0.547718830339801, 0.551245239085504,
+      0.554773173687621, 0.558302423396695, 0.561832776451559, 0.565364020099187, 0.568895940614733, 0.572428323321738, 0.575960952612516, 0.579493611968717,
+      0.583026083982049, 0.586558150375185, 0.590089592022814, 0.593620188972869, 0.597149720467909, 0.600677964966657, 0.604204700165692, 0.607729703021294,
+      0.611252749771431, 0.614773615957897, 0.618292076448594, 0.621807905459940, 0.625320876579434, 0.628830762788333, 0.632337336484476, 0.635840369505224,
+      0.639339633150531, 0.642834898206136, 0.646325934966866, 0.649812513260065, 0.653294402469126, 0.656771371557135, 0.660243189090624, 0.663709623263419,
+      0.667170441920594, 0.670625412582521, 0.674074302469008, 0.677516878523529, 0.680952907437545, 0.684382155674901, 0.687804389496308, 0.691219374983899,
+      0.694626878065860, 0.698026664541130, 0.701418500104171, 0.704802150369794, 0.708177380898052, 0.711543957219191, 0.714901644858643, 0.718250209362086,
+      0.721589416320532, 0.724919031395477, 0.728238820344072, 0.731548549044347, 0.734847983520459, 0.738136889967969, 0.741415034779149, 0.744682184568308,
+      0.747938106197144, 0.751182566800103, 0.754415333809753, 0.757636174982173, 0.760844858422340, 0.764041152609518, 0.767224826422653, 0.770395649165755,
+      0.773553390593274, 0.776697820935466, 0.779828710923742, 0.782945831816000, 0.786048955421927, 0.789137854128289, 0.792212300924180, 0.795272069426240,
+      0.798316933903844, 0.801346669304244, 0.804361051277667, 0.807359856202376, 0.810342861209671, 0.813309844208840, 0.816260583912054, 0.819194859859201,
+      0.822112452442659, 0.825013142931994, 0.827896713498597, 0.830762947240241, 0.833611628205564, 0.836442541418467, 0.839255472902434, 0.842050209704757,
+      0.844826539920679, 0.847584252717438, 0.850323138358209, 0.853042988225955, 0.855743594847169, 0.858424751915507, 0.861086254315311, 0.863727898145025,
+      0.866349480740480, 0.868950800698074, 0.871531657897818, 0.874091853526260, 0.876631190099276, 0.879149471484731, 0.881646502925001, 0.884122091059359,
+      0.886576043946216, 0.889008171085213, 0.891418283439176, 0.893806193455904, 0.896171715089813, 0.898514663823423, 0.900834856688671, 0.903132112288080,
+      0.905406250815746, 0.907657094078158, 0.909884465514855, 0.912088190218894, 0.914268094957152, 0.916424008190438, 0.918555760093427, 0.920663182574402,
+      0.922746109294813, 0.924804375688641, 0.926837818981563, 0.928846278209929, 0.930829594239527, 0.932787609784157, 0.934720169423994, 0.936627119623739,
+      0.938508308750567, 0.940363587091861, 0.942192806872725, 0.943995822273285, 0.945772489445766, 0.947522666531351, 0.949246213676806, 0.950942993050892,
+      0.952612868860529, 0.954255707366748, 0.955871376900389, 0.957459747877581, 0.959020692814970, 0.960554086344712, 0.962059805229224, 0.963537728375687,
+      0.964987736850308, 0.966409713892323, 0.967803544927759, 0.969169117582942, 0.970506321697742, 0.971815049338572, 0.973095194811123, 0.974346654672841,
+      0.975569327745140, 0.976763115125354, 0.977927920198421, 0.979063648648304, 0.980170208469140, 0.981247509976119, 0.982295465816096, 0.983313990977925,
+      0.984303002802518, 0.985262420992635, 0.986192167622387, 0.987092167146471, 0.987962346409112, 0.988802634652741, 0.989612963526372, 0.990393267093710,
+      0.991143481840967, 0.991863546684394, 0.992553402977525, 0.993212994518138, 0.993842267554918, 0.994441170793842, 0.995009655404260, 0.995547675024698,
+      0.996055185768357, 0.996532146228327, 0.996978517482504, 0.997394263098211, 0.997779349136528, 0.998133744156318, 0.998457419217971, 0.998750347886836,
+      0.999012506236362, 0.999243872850945, 0.999444428828470, 0.999614157782558, 0.999753045844516, 0.999861081664980, 0.999938256415269, 0.999984563788432,
+      1.000000000000000, 0.999984563788432, 0.999938256415269, 0.999861081664980, 0.999753045844516, 0.999614157782558, 0.999444428828470, 0.999243872850945,
+      0.999012506236362, 0.998750347886836, 0.998457419217971, 0.998133744156318, 0.997779349136528, 0.997394263098212, 0.996978517482504, 0.996532146228327,
+      0.996055185768357, 0.995547675024698, 0.995009655404260, 0.994441170793842, 0.993842267554919, 0.993212994518138, 0.992553402977525, 0.991863546684394,
+      0.991143481840967, 0.990393267093710, 0.989612963526372, 0.988802634652741, 0.987962346409112, 0.987092167146471, 0.986192167622387, 0.985262420992635,
+      0.984303002802518, 0.983313990977925, 0.982295465816096, 0.981247509976119, 0.980170208469140, 0.979063648648304, 0.977927920198421, 0.976763115125354,
+      0.975569327745140, 0.974346654672841, 0.973095194811123, 0.971815049338572, 0.970506321697742, 0.969169117582942, 0.967803544927760, 0.966409713892323,
+      0.964987736850308, 0.963537728375687, 0.962059805229224, 0.960554086344712, 0.959020692814970, 0.957459747877581, 0.955871376900389, 0.954255707366748,
+      0.952612868860529, 0.950942993050892, 0.949246213676806, 0.947522666531351, 0.945772489445766, 0.943995822273285, 0.942192806872725, 0.940363587091861,
+      0.938508308750567, 0.936627119623739, 0.934720169423994, 0.932787609784158, 0.930829594239527, 0.928846278209929, 0.926837818981563, 0.924804375688641,
+      0.922746109294813, 0.920663182574402, 0.918555760093427, 0.916424008190439, 0.914268094957152, 0.912088190218894, 0.909884465514855, 0.907657094078158,
+      0.905406250815746, 0.903132112288081, 0.900834856688671, 0.898514663823423, 0.896171715089814, 0.893806193455904, 0.891418283439176, 0.889008171085213,
+      0.886576043946216, 0.884122091059359, 0.881646502925001, 0.879149471484731, 0.876631190099276, 0.874091853526260, 0.871531657897818, 0.868950800698074,
+      0.866349480740480, 0.863727898145025, 0.861086254315312, 0.858424751915507, 0.855743594847170, 0.853042988225955, 0.850323138358209, 0.847584252717438,
+      0.844826539920679, 0.842050209704757, 0.839255472902434, 0.836442541418467, 0.833611628205564, 0.830762947240241, 0.827896713498597, 0.825013142931994,
+      0.822112452442659, 0.819194859859201, 0.816260583912054, 0.813309844208840, 0.810342861209671, 0.807359856202376, 0.804361051277667, 0.801346669304244,
+      0.798316933903844, 0.795272069426240, 0.792212300924180, 0.789137854128289, 0.786048955421927, 0.782945831816000, 0.779828710923742, 0.776697820935466,
+      0.773553390593274, 0.770395649165755, 0.767224826422654, 0.764041152609518, 0.760844858422340, 0.757636174982173, 0.754415333809753, 0.751182566800103,
+      0.747938106197145, 0.744682184568308, 0.741415034779149, 0.738136889967969, 0.734847983520460, 0.731548549044347, 0.728238820344072, 0.724919031395477,
+      0.721589416320533, 0.718250209362086, 0.714901644858644, 0.711543957219191, 0.708177380898053, 0.704802150369794, 0.701418500104171, 0.698026664541130,
+      0.694626878065860, 0.691219374983899, 0.687804389496308, 0.684382155674901, 0.680952907437545, 0.677516878523529, 0.674074302469008, 0.670625412582521,
+      0.667170441920594, 0.663709623263419, 0.660243189090624, 0.656771371557135, 0.653294402469126, 0.649812513260065, 0.646325934966866, 0.642834898206135,
+      0.639339633150531, 0.635840369505224, 0.632337336484476, 0.628830762788333, 0.625320876579434, 0.621807905459941, 0.618292076448593, 0.614773615957897,
+      0.611252749771431, 0.607729703021294, 0.604204700165692, 0.600677964966657, 0.597149720467909, 0.593620188972869, 0.590089592022814, 0.586558150375185,
+      0.583026083982050, 0.579493611968716, 0.575960952612516, 0.572428323321738, 0.568895940614734, 0.565364020099187, 0.561832776451559, 0.558302423396696,
+      0.554773173687621, 0.551245239085504, 0.547718830339802, 0.544194157168594, 0.540671428239097, 0.537150851148368, 0.533632632404199, 0.530116977406201,
+      0.526604090427091, 0.523094174594171, 0.519587431871003, 0.516084063039297, 0.512584267680994, 0.509088244160560, 0.505596189607488, 0.502108299899010,
+      0.498624769643028, 0.495145792161249, 0.491671559472550, 0.488202262276553, 0.484738089937428, 0.481279230467911, 0.477825870513560, 0.474378195337228,
+      0.470936388803764, 0.467500633364956, 0.464071110044694, 0.460647998424380, 0.457231476628560, 0.453821721310804, 0.450418907639827, 0.447023209285841,
+      0.443634798407161, 0.440253845637046, 0.436880520070791, 0.433514989253069, 0.430157419165509, 0.426807974214543, 0.423466817219488, 0.420134109400886,
+      0.416810010369104, 0.413494678113179, 0.410188268989928, 0.406890937713309, 0.403602837344044, 0.400324119279508, 0.397054933243859, 0.393795427278457,
+      0.390545747732522, 0.387306039254069, 0.384076444781105, 0.380857105533087, 0.377648161002651, 0.374449748947610, 0.371262005383208, 0.368085064574656,
+      0.364919059029933, 0.361764119492848, 0.358620374936384, 0.355487952556306, 0.352366977765042, 0.349257574185835, 0.346159863647164, 0.343073966177446,
+      0.340000000000000, 0.336938081528291, 0.333888325361444, 0.330850844280030, 0.327825749242130, 0.324813149379670, 0.321813151995025, 0.318825862557907,
+      0.315851384702515, 0.312889820224967, 0.309941269080999, 0.307005829383946, 0.304083597402984, 0.301174667561656, 0.298279132436665, 0.295397082756936,
+      0.292528607402961, 0.289673793406402, 0.286832725949976, 0.284005488367603, 0.281192162144829, 0.278392826919515, 0.275607560482802, 0.272836438780330,
+      0.270079535913742, 0.267336924142443, 0.264608673885626, 0.261894853724574, 0.259195530405208, 0.256510768840920, 0.253840632115651, 0.251185181487240,
+      0.248544476391033, 0.245918574443749, 0.243307531447608, 0.240711401394712, 0.238130236471690, 0.235564087064587, 0.233013001764023, 0.230477027370588,
+      0.227956208900500, 0.225450589591508, 0.222960210909046, 0.220485112552635, 0.218025332462529, 0.215580906826604, 0.213151870087497, 0.210738254949977,
+      0.208340092388565, 0.205957411655386, 0.203590240288259, 0.201238604119025, 0.198902527282103, 0.196582032223282, 0.194277139708740, 0.191987868834294,
+      0.189714237034871, 0.187456260094206, 0.185213952154764, 0.182987325727878, 0.180776391704109, 0.178581159363820, 0.176401636387964, 0.174237828869086,
+      0.172089741322531, 0.169957376697869, 0.167840736390511, 0.165739820253540, 0.163654626609744, 0.161585152263834, 0.159531392514879, 0.157493341168917,
+      0.155470990551767, 0.153464331522033, 0.151473353484286, 0.149498044402439, 0.147538390813302, 0.145594377840313, 0.143665989207453, 0.141753207253328,
+      0.139856012945433, 0.137974385894575, 0.136108304369471, 0.134257745311504, 0.132422684349650, 0.130603095815552, 0.128798952758758, 0.127010226962117,
+      0.125236888957309, 0.123478908040546, 0.121736252288397, 0.120008888573770, 0.118296782582029, 0.116599898827243, 0.114918200668578, 0.113251650326814,
+      0.111600208900992, 0.109963836385185, 0.108342491685394, 0.106736132636562, 0.105144716019700, 0.103568197579137, 0.102006532039869, 0.100459673125025,
+      0.098927573573426, 0.097410185157261, 0.095907458699845, 0.094419344093484, 0.092945790317425, 0.091486745455902, 0.090042156716257, 0.088611970447159,
+      0.087196132156887, 0.085794586531701, 0.084407277454280, 0.083034148022235, 0.081675140566683, 0.080330196670891, 0.078999257188977, 0.077682262264671,
+      0.076379151350126, 0.075089863224787, 0.073814336014300, 0.072552507209473, 0.071304313685273, 0.070069691719864, 0.068848577013681, 0.067640904708530,
+      0.066446609406726, 0.065265625190249, 0.064097885639924, 0.062943323854618, 0.061801872470460, 0.060673463680064, 0.059558029251767, 0.058455500548870,
+      0.057365808548885, 0.056288883862778, 0.055224656754208, 0.054173057158764, 0.053134014703187, 0.052107458724578, 0.051093318289595, 0.050091522213621,
+      0.049101999079922, 0.048124677258761, 0.047159484926502, 0.046206350084666, 0.045265200578958, 0.044335964118255, 0.043418568293550, 0.042512940596852,
+      0.041619008440034, 0.040736699173639, 0.039865940105614, 0.039006658520007, 0.038158781695586, 0.037322236924402, 0.036496951530286, 0.035682852887269,
+      0.034879868437935, 0.034087925711694, 0.033306952342980, 0.032536876089362, 0.031777624849569, 0.031029126681434, 0.030291309819736, 0.029564102693959,
+      0.028847433945944, 0.028141232447446, 0.027445427317589, 0.026759947940211, 0.026084723981102, 0.025419685405132, 0.024764762493264, 0.024119885859447,
+      0.023484986467391, 0.022859995647220, 0.022244845112001, 0.021639466974136, 0.021043793761637, 0.020457758434254, 0.019881294399473, 0.019314335528380,
+      0.018756816171370, 0.018208671173726, 0.017669835891041, 0.017140246204499, 0.016619838535996, 0.016108549863115, 0.015606317733936, 0.015113080281697,
+      0.014628776239280, 0.014153344953550, 0.013686726399510, 0.013228861194301, 0.012779690611027, 0.012339156592403, 0.011907201764231, 0.011483769448702,
+      0.011068803677509, 0.010662249204787, 0.010264051519868, 0.009874156859840, 0.009492512221933, 0.009119065375703, 0.008753764875030, 0.008396560069917,
+      0.008047401118099, 0.007706238996451, 0.007373025512194, 0.007047713313900, 0.006730255902302, 0.006420607640882, 0.006118723766271, 0.005824560398424,
+      0.005538074550596, 0.005259224139102, 0.004987967992861, 0.004724265862728, 0.004468078430611, 0.004219367318365, 0.003978095096469, 0.003744225292484,
+      0.003517722399288, 0.003298551883080, 0.003086680191171, 0.002882074759541, 0.002684704020171, 0.002494537408142, 0.002311545368514, 0.002135699362961,
+      0.001966971876186, 0.001805336422097, 0.001650767549745, 0.001503240849038, 0.001362732956209, 0.001229221559048, 0.001102685401904, 0.000983104290442,
+      0.000870459096160, 0.000764731760667, 0.000665905299726, 0.000573963807046, 0.000488892457837, 0.000410677512127, 0.000339306317822, 0.000274767313541,
+      0.000217050031190, 0.000166145098300, 0.000122044240120, 0.000084740281465, 0.000054227148312, 0.000030499869156, 0.000013554576124, 0.000003388505831,
+      0.000000000000000
+   };
+}
+
+#endif
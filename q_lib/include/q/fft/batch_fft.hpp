@@ -0,0 +1,242 @@
+/*=============================================================================
+   Copyright (c) 2014-2020 Joel de Guzman. All rights reserved.
+
+   Distributed under the MIT License [ https://opensource.org/licenses/MIT ]
+=============================================================================*/
+#if !defined(CYCFI_Q_BATCH_FFT_OCTOBER_18_2026)
+#define CYCFI_Q_BATCH_FFT_OCTOBER_18_2026
+
+#include <q/fft/fft.hpp>
+#include <vector>
+
+namespace cycfi::q
+{
+   namespace detail
+   {
+      //////////////////////////////////////////////////////////////////////
+      // Batched Danielson-Lanczos. Same algorithm as danielson_lanczos
+      // (see fft.hpp), but each complex number is a batch of K lanes, laid
+      // out as K real parts followed by K imaginary parts. Each twiddle
+      // factor is computed once and applied to all K lanes. The lane loops
+      // have a fixed trip count and unit stride, and vectorize.
+      //////////////////////////////////////////////////////////////////////
+      template <std::size_t N, std::size_t K>
+      struct batch_danielson_lanczos
+      {
+         batch_danielson_lanczos<N/2, K> next;
+
+         void apply(double* data)
+         {
+            next.apply(data);
+            next.apply(data + N*K);
+
+            constexpr auto sina = -sin(N, 1);
+            constexpr auto sinb = -sin(N, 2);
+
+            double wtemp = sina;
+            double wpr = -2.0*wtemp*wtemp;
+            double wpi = sinb;
+            double wr = 1.0;
+            double wi = 0.0;
+            for (std::size_t i = 0; i != N/2; ++i)
+            {
+               double* a = data + i*2*K;
+               double* b = a + N*K;
+               for (std::size_t k = 0; k != K; ++k)
+               {
+                  double tempr = b[k]*wr - b[k+K]*wi;
+                  double tempi = b[k]*wi + b[k+K]*wr;
+                  b[k] = a[k]-tempr;
+                  b[k+K] = a[k+K]-tempi;
+                  a[k] += tempr;
+                  a[k+K] += tempi;
+               }
+
+               wtemp = wr;
+               wr += wr*wpr - wi*wpi;
+               wi += wi*wpr + wtemp*wpi;
+            }
+         }
+      };
+
+      template <std::size_t K>
+      struct batch_danielson_lanczos<2, K>
+      {
+         void apply(double* data)
+         {
+            double* a = data;
+            double* b = data + 2*K;
+            for (std::size_t k = 0; k != K; ++k)
+            {
+               double tr = b[k];
+               double ti = b[k+K];
+               b[k] = a[k]-tr;
+               b[k+K] = a[k+K]-ti;
+               a[k] += tr;
+               a[k+K] += ti;
+            }
+         }
+      };
+
+      template <std::size_t N, std::size_t K>
+      inline void batch_scramble(double* data)
+      {
+         std::size_t j = 0;
+         for (std::size_t i = 0; i != N; ++i)
+         {
+            if (j > i)
+            {
+               double* a = data + i*2*K;
+               double* b = data + j*2*K;
+               for (std::size_t k = 0; k != 2*K; ++k)
+                  std::swap(a[k], b[k]);
+            }
+            std::size_t m = N/2;
+            while (m >= 1 && j >= m)
+            {
+               j -= m;
+               m >>= 1;
+            }
+            j += m;
+         }
+      }
+   }
+
+   ////////////////////////////////////////////////////////////////////////////
+   // batch_fft: Computes the FFT of K signals of the same length, N,
+   // together. This is more efficient than calling fft<N> K times, one
+   // after another: the signals are interleaved across lanes so that each
+   // twiddle factor is computed once for all K signals, and the butterflies
+   // run K wide (vectorized).
+   //
+   // The channels are supplied as an array of K pointers, just like the
+   // buffers of audio_channels. Each channel holds N complex numbers in the
+   // same interleaved (real, imaginary) layout as fft<N>. Alternatively,
+   // for real input, the function call operator also takes K pointers to N
+   // real (e.g. float) input samples and writes the spectra to K output
+   // channels.
+   //
+   // The batch_fft owns the interleaved work buffer, which is allocated at
+   // construction.
+   ////////////////////////////////////////////////////////////////////////////
+   template <std::size_t N, std::size_t K>
+   class batch_fft
+   {
+   public:
+
+      static_assert(is_pow2(N) && N >= 2,
+         "Error: N must be a power of two");
+
+      static constexpr std::size_t size = N;
+      static constexpr std::size_t num_channels = K;
+
+                        batch_fft();
+
+      void              operator()(double* const* channels);
+                        template <typename T>
+      void              operator()(T const* const* in, double* const* out);
+      void              inverse(double* const* channels);
+
+   private:
+
+                        template <typename T>
+      void              load_real(T const* const* in);
+      void              load(double const* const* channels, bool conjugate);
+      void              store(double* const* channels, double scale, bool conjugate);
+      void              transform();
+
+      std::vector<double> _data;
+   };
+
+   ////////////////////////////////////////////////////////////////////////////
+   // Implementation
+   ////////////////////////////////////////////////////////////////////////////
+   template <std::size_t N, std::size_t K>
+   inline batch_fft<N, K>::batch_fft()
+    : _data(N * 2 * K)
+   {}
+
+   template <std::size_t N, std::size_t K>
+   inline void batch_fft<N, K>::load(double const* const* channels, bool conjugate)
+   {
+      double const sign = conjugate? -1.0 : 1.0;
+      for (std::size_t k = 0; k != K; ++k)
+      {
+         auto const* src = channels[k];
+         auto* dest = _data.data() + k;
+         for (std::size_t i = 0; i != N; ++i)
+         {
+            dest[i*2*K] = src[i*2];
+            dest[i*2*K + K] = sign * src[i*2 + 1];
+         }
+      }
+   }
+
+   template <std::size_t N, std::size_t K>
+   template <typename T>
+   inline void batch_fft<N, K>::load_real(T const* const* in)
+   {
+      for (std::size_t k = 0; k != K; ++k)
+      {
+         auto const* src = in[k];
+         auto* dest = _data.data() + k;
+         for (std::size_t i = 0; i != N; ++i)
+         {
+            dest[i*2*K] = src[i];
+            dest[i*2*K + K] = 0.0;
+         }
+      }
+   }
+
+   template <std::size_t N, std::size_t K>
+   inline void batch_fft<N, K>::store(double* const* channels, double scale, bool conjugate)
+   {
+      double const iscale = conjugate? -scale : scale;
+      for (std::size_t k = 0; k != K; ++k)
+      {
+         auto const* src = _data.data() + k;
+         auto* dest = channels[k];
+         for (std::size_t i = 0; i != N; ++i)
+         {
+            dest[i*2] = scale * src[i*2*K];
+            dest[i*2 + 1] = iscale * src[i*2*K + K];
+         }
+      }
+   }
+
+   template <std::size_t N, std::size_t K>
+   inline void batch_fft<N, K>::transform()
+   {
+      detail::batch_danielson_lanczos<N, K> recursion;
+      detail::batch_scramble<N, K>(_data.data());
+      recursion.apply(_data.data());
+   }
+
+   template <std::size_t N, std::size_t K>
+   inline void batch_fft<N, K>::operator()(double* const* channels)
+   {
+      load(channels, false);
+      transform();
+      store(channels, 1.0, false);
+   }
+
+   template <std::size_t N, std::size_t K>
+   template <typename T>
+   inline void batch_fft<N, K>::operator()(T const* const* in, double* const* out)
+   {
+      load_real(in);
+      transform();
+      store(out, 1.0, false);
+   }
+
+   // Inverse FFT, scaled by 1/N (see ifft<N>)
+   template <std::size_t N, std::size_t K>
+   inline void batch_fft<N, K>::inverse(double* const* channels)
+   {
+      load(channels, true);
+      transform();
+      store(channels, 1.0 / N, true);
+   }
+}
+
+#endif
@@ -154,6 +154,28 @@ namespace cycfi::q
       detail::scramble<N>(data);
       recursion.apply(data);
    }
+
+   ////////////////////////////////////////////////////////////////////////////
+   // Inverse FFT. Same layout as fft<N>: data holds N complex numbers as
+   // interleaved (real, imaginary) pairs. The result is scaled by 1/N, so
+   // ifft<N>(fft<N>(x)) == x. We compute the inverse using the forward
+   // transform by conjugating the input and the output.
+   ////////////////////////////////////////////////////////////////////////////
+   template <std::size_t N>
+   inline void ifft(double* data)
+   {
+      for (std::size_t i = 1; i < 2*N; i += 2)
+         data[i] = -data[i];
+
+      fft<N>(data);
+
+      constexpr double scale = 1.0 / N;
+      for (std::size_t i = 0; i < 2*N; i += 2)
+      {
+         data[i] *= scale;
+         data[i+1] *= -scale;
+      }
+   }
 }
 
 #endif
@@ -0,0 +1,199 @@
+/*=============================================================================
+   Copyright (c) 2014-2020 Joel de Guzman. All rights reserved.
+
+   Distributed under the MIT License [ https://opensource.org/licenses/MIT ]
+=============================================================================*/
+#if !defined(CYCFI_Q_STFT_OCTOBER_18_2026)
+#define CYCFI_Q_STFT_OCTOBER_18_2026
+
+#include <q/fft/fft.hpp>
+#include <q/utility/window.hpp>
+#include <array>
+#include <algorithm>
+
+namespace cycfi::q
+{
+   ////////////////////////////////////////////////////////////////////////////
+   // stft: Streaming short-time Fourier transform with weighted overlap-add
+   // resynthesis.
+   //
+   // Input is supplied in blocks of any length (e.g. the frames of an
+   // audio_stream callback). The stft collects the input in a linear
+   // buffer of N samples. Every Hop samples, the buffer is windowed and
+   // transformed using fft<N>, then the oldest Hop samples are shifted out
+   // (an N-Hop sample copy, small compared to the FFT itself). The
+   // resulting spectrum (N complex numbers in the same interleaved layout
+   // as fft<N>) is passed to the supplied callback, f, which may inspect or
+   // modify it in place.
+   //
+   // With resynthesis (the function call operator), the spectrum is then
+   // transformed back using ifft<N>, windowed again (the same window is
+   // used for analysis and synthesis) and overlap-added to the output.
+   // Each output position is normalized by the sum of the squared windows
+   // that overlap it, so an untouched spectrum reconstructs the input
+   // exactly, delayed by latency() samples, provided that sum is nonzero
+   // at every position. That holds for the usual windows with Hop <= N/2.
+   // Where the sum is zero, the input cannot be recovered and the output
+   // is zero: e.g. with Hop == N, the periodic hann window is zero at the
+   // start of each frame, and so is the output there.
+   //
+   // Take note that the output is real. If the callback modifies the
+   // spectrum, it should keep the conjugate symmetry of real signals
+   // (bin k and bin N-k) or else the imaginary part is discarded.
+   //
+   // All buffers are fixed size. There is no allocation at all.
+   //
+   //    N:    FFT size (must be a power of 2)
+   //    Hop:  number of samples between frames (must divide N).
+   ////////////////////////////////////////////////////////////////////////////
+   template <std::size_t N, std::size_t Hop = N/4>
+   class stft
+   {
+   public:
+
+      static_assert(is_pow2(N),
+         "Error: N must be a power of two");
+      static_assert(Hop > 0 && Hop <= N && (N % Hop) == 0,
+         "Error: Hop must divide N");
+
+      static constexpr std::size_t size = N;
+      static constexpr std::size_t hop = Hop;
+
+      using spectrum = std::array<double, N * 2>;
+
+                              template <typename Window = hann_window>
+      explicit                stft(Window const& window = Window{});
+
+                              template <typename F>
+      void                    operator()(float const* in, float* out, std::size_t n, F&& f);
+
+                              template <typename F>
+      void                    analyze(float const* in, std::size_t n, F&& f);
+
+      constexpr std::size_t   latency() const         { return N; }
+      float                   window(std::size_t i) const { return _window[i]; }
+      void                    reset();
+
+   private:
+
+                              template <typename F>
+      void                    analysis_frame(F&& f);
+      void                    synthesis_frame();
+
+      std::array<float, N>    _window;
+      std::array<float, Hop>  _norm;
+      std::array<float, N>    _in;
+      std::array<float, N>    _out;
+      spectrum                _spectrum;
+      std::size_t             _pos = 0;
+   };
+
+   ////////////////////////////////////////////////////////////////////////////
+   // Implementation
+   ////////////////////////////////////////////////////////////////////////////
+   template <std::size_t N, std::size_t Hop>
+   template <typename Window>
+   inline stft<N, Hop>::stft(Window const& window)
+   {
+      for (std::size_t i = 0; i != N; ++i)
+         _window[i] = window_periodic(window, i, N);
+
+      // Weighted overlap-add normalization: the reciprocal of the sum of
+      // the squared windows overlapping each position.
+      for (std::size_t i = 0; i != Hop; ++i)
+      {
+         double sum = 0.0;
+         for (std::size_t j = i; j < N; j += Hop)
+            sum += double(_window[j]) * _window[j];
+         _norm[i] = (sum > 1e-9)? 1.0 / sum : 0.0f;
+      }
+      reset();
+   }
+
+   template <std::size_t N, std::size_t Hop>
+   inline void stft<N, Hop>::reset()
+   {
+      _in.fill(0.0f);
+      _out.fill(0.0f);
+      _pos = 0;
+   }
+
+   template <std::size_t N, std::size_t Hop>
+   template <typename F>
+   inline void stft<N, Hop>::analysis_frame(F&& f)
+   {
+      for (std::size_t i = 0; i != N; ++i)
+      {
+         _spectrum[i*2] = _in[i] * _window[i];
+         _spectrum[i*2 + 1] = 0.0;
+      }
+      fft<N>(_spectrum.data());
+      f(_spectrum);
+
+      // Discard the oldest Hop samples
+      std::copy(_in.begin() + Hop, _in.end(), _in.begin());
+   }
+
+   template <std::size_t N, std::size_t Hop>
+   inline void stft<N, Hop>::synthesis_frame()
+   {
+      ifft<N>(_spectrum.data());
+
+      // The first Hop samples were already sent out. Shift them out and
+      // overlap-add the new frame.
+      std::copy(_out.begin() + Hop, _out.end(), _out.begin());
+      std::fill(_out.end() - Hop, _out.end(), 0.0f);
+      for (std::size_t i = 0; i != N; ++i)
+         _out[i] += _spectrum[i*2] * _window[i] * _norm[i & (Hop-1)];
+   }
+
+   template <std::size_t N, std::size_t Hop>
+   template <typename F>
+   inline void stft<N, Hop>::operator()(
+      float const* in, float* out, std::size_t n, F&& f)
+   {
+      while (n != 0)
+      {
+         auto const chunk = std::min(n, Hop - _pos);
+
+         // Take the input first; in and out may be the same buffer.
+         std::copy(in, in + chunk, _in.begin() + (N - Hop) + _pos);
+         std::copy(_out.begin() + _pos, _out.begin() + _pos + chunk, out);
+
+         in += chunk;
+         out += chunk;
+         n -= chunk;
+         _pos += chunk;
+
+         if (_pos == Hop)
+         {
+            analysis_frame(f);
+            synthesis_frame();
+            _pos = 0;
+         }
+      }
+   }
+
+   template <std::size_t N, std::size_t Hop>
+   template <typename F>
+   inline void stft<N, Hop>::analyze(float const* in, std::size_t n, F&& f)
+   {
+      while (n != 0)
+      {
+         auto const chunk = std::min(n, Hop - _pos);
+         std::copy(in, in + chunk, _in.begin() + (N - Hop) + _pos);
+
+         in += chunk;
+         n -= chunk;
+         _pos += chunk;
+
+         if (_pos == Hop)
+         {
+            analysis_frame(f);
+            _pos = 0;
+         }
+      }
+   }
+}
+
+#endif
@@ -7,10 +7,103 @@
 #define CYCFI_Q_BIQUAD_HPP_FEBRUARY_8_2018
 
 #include <q/support/base.hpp>
+#include <q/detail/constexpr_math.hpp>
 #include <cmath>
 
 namespace cycfi::q
 {
+   ////////////////////////////////////////////////////////////////////////////
+   // biquad_coeffs: Normalized (a0 = 1) biquad coefficients, as computed at
+   // compile time by lowpass_coeffs, highpass_coeffs, etc. (see below).
+   ////////////////////////////////////////////////////////////////////////////
+   struct biquad_coeffs
+   {
+      float b0, b1, b2, a1, a2;
+   };
+
+   namespace detail
+   {
+      /////////////////////////////////////////////////////////////////////////
+      // The transposed direct form II kernel of biquad::process (see the
+      // comments there), with the coefficients b0, k1 = b1 - a1*b0,
+      // k2 = b2 - a2*b0, c1 = a1 and c2 = a2, and the state s1 and s2,
+      // which are updated. Also used by biquad_bank.
+      /////////////////////////////////////////////////////////////////////////
+      inline void biquad_tdf2(
+         float b0, float k1, float k2, float c1, float c2
+       , float& s1_, float& s2_
+       , float const* in, float* out, std::size_t n)
+      {
+         float s1 = s1_, s2 = s2_;
+         std::size_t i = 0;
+         if (n >= 8)
+         {
+            // State transition, A = [-c1 1; -c2 0], input, B = [k1; k2]
+            // and output, C = [1 0], matrices of the state space form.
+            // Output row vectors: p[k] = C * A^k
+            float p1[4], p2[4];
+            p1[0] = 1.0f;
+            p2[0] = 0.0f;
+            for (int k = 1; k != 4; ++k)
+            {
+               p1[k] = -c1 * p1[k-1] - c2 * p2[k-1];
+               p2[k] = p1[k-1];
+            }
+
+            // Input columns: q[k] = A^k * B, and the impulse response:
+            // h[0] = b0, h[k] = C * A^(k-1) * B
+            float q1[4], q2[4], h[4];
+            q1[0] = k1;
+            q2[0] = k2;
+            h[0] = b0;
+            for (int k = 1; k != 4; ++k)
+            {
+               h[k] = q1[k-1];
+               q1[k] = -c1 * q1[k-1] + q2[k-1];
+               q2[k] = -c2 * q1[k-1];
+            }
+
+            // A^4 rows: [1 0] * A^4 = p[3] * A and [0 1] * A^4 = -c2 * p[3]
+            float const r11 = -c1 * p1[3] - c2 * p2[3];
+            float const r12 = p1[3];
+            float const r21 = -c2 * p1[3];
+            float const r22 = -c2 * p2[3];
+
+            auto const m = n - n % 4;
+            for (; i != m; i += 4)
+            {
+               float const x0 = in[i];
+               float const x1_ = in[i+1];
+               float const x2_ = in[i+2];
+               float const x3 = in[i+3];
+
+               out[i]   = s1                                            + h[0]*x0;
+               out[i+1] = p1[1]*s1 + p2[1]*s2                           + h[1]*x0 + h[0]*x1_;
+               out[i+2] = p1[2]*s1 + p2[2]*s2              + h[2]*x0 + h[1]*x1_ + h[0]*x2_;
+               out[i+3] = p1[3]*s1 + p2[3]*s2 + h[3]*x0 + h[2]*x1_ + h[1]*x2_ + h[0]*x3;
+
+               float const u1 = q1[3]*x0 + q1[2]*x1_ + q1[1]*x2_ + q1[0]*x3;
+               float const u2 = q2[3]*x0 + q2[2]*x1_ + q2[1]*x2_ + q2[0]*x3;
+               float const t = r11*s1 + r12*s2 + u1;
+               s2 = r21*s1 + r22*s2 + u2;
+               s1 = t;
+            }
+         }
+
+         for (; i < n; ++i)
+         {
+            auto x = in[i];
+            out[i] = b0 * x + s1;
+            auto t = k1 * x - c1 * s1 + s2;
+            s2 = k2 * x - c2 * s1;
+            s1 = t;
+         }
+
+         s1_ = s1;
+         s2_ = s2;
+      }
+   }
+
    ////////////////////////////////////////////////////////////////////////////
    // biquad class. Based on Audio-EQ Cookbook by Robert Bristow-Johnson.
    // https://www.w3.org/2011/audio/audio-eq-cookbook.html
@@ -19,11 +112,15 @@ namespace cycfi::q
    {
       biquad(biquad const&) = default;
 
-      biquad(float a0, float a1, float a2, float a3, float a4)
+      constexpr biquad(float a0, float a1, float a2, float a3, float a4)
        : a0(a0), a1(a1), a2(a2), a3(a3), a4(a4)
        , x1(0), x2(0), y1(0), y2(0)
       {}
 
+      constexpr biquad(biquad_coeffs const& c)
+       : biquad(c.b0, c.b1, c.b2, c.a1, c.a2)
+      {}
+
       float operator()(float s)
       {
          // compute result
@@ -40,6 +137,54 @@ namespace cycfi::q
          return r;
       }
 
+      // Block processing, in place or from in to out (in and out may be
+      // the same buffer). This uses the transposed direct form II with the
+      // filter state held in local variables (registers) for the whole
+      // block. The state is converted from and to the direct form I
+      // delays, so block processing and the function call operator above
+      // may be freely mixed.
+      //
+      // The TDF-II state update, s1 = b1*x - a1*y + s2, has y = b0*x + s1
+      // in its recursive path. We substitute y to take it out:
+      //
+      //    y  = b0*x + s1
+      //    s1 = (b1 - a1*b0)*x - a1*s1 + s2
+      //    s2 = (b2 - a2*b0)*x - a2*s1
+      //
+      // The recursion is still one sample at a time, and its latency, not
+      // the arithmetic, bounds the speed. So we look ahead 4 samples: the
+      // state 4 samples later and the 4 outputs are computed directly from
+      // the current state and the 4 inputs. The recursion then only has to
+      // go around once every 4 samples, and the 4 outputs are independent
+      // of each other.
+      void process(float const* in, float* out, std::size_t n)
+      {
+         if (n == 0)
+            return;
+
+         // Save the last two inputs now, before out overwrites in.
+         auto const last_x1 = in[n-1];
+         auto const last_x2 = (n > 1)? in[n-2] : x1;
+
+         // Direct form I delays to transposed direct form II state
+         float s1 = a1 * x1 + a2 * x2 - a3 * y1 - a4 * y2;
+         float s2 = a2 * x1 - a4 * y1;
+
+         detail::biquad_tdf2(
+            a0, a1 - a3 * a0, a2 - a4 * a0, a3, a4, s1, s2, in, out, n);
+
+         // Back to direct form I
+         y2 = (n > 1)? out[n-2] : y1;
+         y1 = out[n-1];
+         x2 = last_x2;
+         x1 = last_x1;
+      }
+
+      void process(float* inout, std::size_t n)
+      {
+         process(inout, inout, n);
+      }
+
       void config(float a0_, float a1_, float a2_, float a3_, float a4_)
       {
          a0 = a0_;
@@ -49,6 +194,11 @@ namespace cycfi::q
          a4 = a4_;
       }
 
+      void config(biquad_coeffs const& c)
+      {
+         config(c.b0, c.b1, c.b2, c.a1, c.a2);
+      }
+
       // Coefficients
       float a0, a1, a2, a3, a4;
 
@@ -66,54 +216,93 @@ namespace cycfi::q
 
    namespace detail
    {
+      /////////////////////////////////////////////////////////////////////////
+      // The filter design structs, shared by the filters below and by the
+      // compile time *_coeffs functions further below. The math is a
+      // policy: runtime_math (<cmath>, the default) for the filters, and
+      // compile_time_math (the series in constexpr_math.hpp, a few times
+      // slower) for the *_coeffs functions.
+      /////////////////////////////////////////////////////////////////////////
+      struct runtime_math
+      {
+         static double sin(double x)      { return std::sin(x); }
+         static double cos(double x)      { return std::cos(x); }
+         static double sinh(double x)     { return std::sinh(x); }
+         static double pow10(double x)    { return std::pow(10.0, x); }
+         static double sqrt(double x)     { return std::sqrt(x); }
+      };
+
+      struct compile_time_math
+      {
+         static constexpr double sin(double x)     { return constexpr_sin(x); }
+         static constexpr double cos(double x)     { return constexpr_cos(x); }
+         static constexpr double sinh(double x)    { return constexpr_sinh(x); }
+         static constexpr double pow10(double x)   { return constexpr_pow10(x); }
+         static constexpr double sqrt(double x)    { return constexpr_sqrt(x); }
+      };
+
       /////////////////////////////////////////////////////////////////////////
       struct config_biquad
       {
-         config_biquad(frequency f, std::uint32_t sps)
-          : omega(2_pi * double(f) / sps)
-          , sin(std::sin(omega))
-          , cos(std::cos(omega))
+         template <typename Math>
+         constexpr config_biquad(frequency f, std::uint32_t sps, Math)
+          : omega(2 * pi * double(f) / sps)
+          , sin(Math::sin(omega))
+          , cos(Math::cos(omega))
          {}
 
-         config_biquad(frequency f, std::uint32_t sps, bw _bw)
-          : config_biquad(f, sps)
+         template <typename Math>
+         constexpr config_biquad(frequency f, std::uint32_t sps, bw _bw, Math m)
+          : config_biquad(f, sps, m)
          {
-            alpha = sin * std::sinh(std::log(2.0) / 2.0 * _bw.val * omega / sin);
+            constexpr double ln2 = 0.693147180559945309417232121458;
+            alpha = sin * Math::sinh(ln2 / 2.0 * _bw.val * omega / sin);
          }
 
-         config_biquad(frequency f, std::uint32_t sps, double q)
-          : config_biquad(f, sps)
+         template <typename Math>
+         constexpr config_biquad(frequency f, std::uint32_t sps, double q, Math m)
+          : config_biquad(f, sps, m)
          {
             alpha = sin / (2.0 * q);
          }
 
-         biquad make()
+         constexpr biquad_coeffs coeffs() const
          {
-            return biquad(b0 / a0, b1 / a0, b2 / a0, a1 / a0, a2 / a0);
+            return {
+               float(b0 / a0), float(b1 / a0), float(b2 / a0)
+             , float(a1 / a0), float(a2 / a0)
+            };
          }
 
-         void config(biquad& bq)
+         constexpr biquad make() const
          {
-            bq.config(b0 / a0, b1 / a0, b2 / a0, a1 / a0, a2 / a0);
+            return biquad(coeffs());
          }
 
-         double omega, sin, cos, alpha;
-         double a0, a1, a2, b0, b1, b2;
+         void config(biquad& bq) const
+         {
+            bq.config(coeffs());
+         }
+
+         double omega, sin, cos, alpha = 0.0;
+         double a0 = 1.0, a1 = 0.0, a2 = 0.0, b0 = 1.0, b1 = 0.0, b2 = 0.0;
       };
 
       /////////////////////////////////////////////////////////////////////////
       struct config_biquad_a : config_biquad
       {
-         config_biquad_a(double db_gain, frequency f, std::uint32_t sps, bw _bw)
-          : config_biquad(f, sps, _bw)
-          , a(std::pow(10.0, db_gain / 40.0))
-          , beta(std::sqrt(a + a))
+         template <typename Math>
+         constexpr config_biquad_a(double db_gain, frequency f, std::uint32_t sps, bw _bw, Math m)
+          : config_biquad(f, sps, _bw, m)
+          , a(Math::pow10(db_gain / 40.0))
+          , beta(Math::sqrt(a + a))
          {}
 
-         config_biquad_a(double db_gain, frequency f, std::uint32_t sps, double q)
-          : config_biquad(f, sps, q)
-          , a(std::pow(10.0, db_gain / 40.0))
-          , beta(std::sqrt(a + a))
+         template <typename Math>
+         constexpr config_biquad_a(double db_gain, frequency f, std::uint32_t sps, double q, Math m)
+          : config_biquad(f, sps, q, m)
+          , a(Math::pow10(db_gain / 40.0))
+          , beta(Math::sqrt(a + a))
          {}
 
          double a;
@@ -123,13 +312,14 @@ namespace cycfi::q
       /////////////////////////////////////////////////////////////////////////
       struct config_lowpass : config_biquad
       {
-         config_lowpass(frequency f, std::uint32_t sps, double q)
-          : config_biquad(f, sps, q)
+         template <typename Math = runtime_math>
+         constexpr config_lowpass(frequency f, std::uint32_t sps, double q, Math m = {})
+          : config_biquad(f, sps, q, m)
          {
             init();
          }
 
-         void init()
+         constexpr void init()
          {
             b0 = (1.0 - cos) / 2.0;
             b1 = 1.0 - cos;
@@ -143,13 +333,14 @@ namespace cycfi::q
       /////////////////////////////////////////////////////////////////////////
       struct config_highpass : config_biquad
       {
-         config_highpass(frequency f, std::uint32_t sps, double q)
-          : config_biquad(f, sps, q)
+         template <typename Math = runtime_math>
+         constexpr config_highpass(frequency f, std::uint32_t sps, double q, Math m = {})
+          : config_biquad(f, sps, q, m)
          {
             init();
          }
 
-         void init()
+         constexpr void init()
          {
             b0 = (1.0 + cos) / 2.0;
             b1 = -(1.0 + cos);
@@ -163,19 +354,21 @@ namespace cycfi::q
       /////////////////////////////////////////////////////////////////////////
       struct config_bandpass_csg : config_biquad
       {
-         config_bandpass_csg(frequency f, std::uint32_t sps, bw _bw)
-          : config_biquad(f, sps, _bw)
+         template <typename Math = runtime_math>
+         constexpr config_bandpass_csg(frequency f, std::uint32_t sps, bw _bw, Math m = {})
+          : config_biquad(f, sps, _bw, m)
          {
             init();
          }
 
-         config_bandpass_csg(frequency f, std::uint32_t sps, double q)
-          : config_biquad(f, sps, q)
+         template <typename Math = runtime_math>
+         constexpr config_bandpass_csg(frequency f, std::uint32_t sps, double q, Math m = {})
+          : config_biquad(f, sps, q, m)
          {
             init();
          }
 
-         void init()
+         constexpr void init()
          {
             b0 = sin / 2.0;
             b1 = 0.0;
@@ -189,19 +382,21 @@ namespace cycfi::q
       /////////////////////////////////////////////////////////////////////////
       struct config_bandpass_cpg : config_biquad
       {
-         config_bandpass_cpg(frequency f, std::uint32_t sps, bw _bw)
-          : config_biquad(f, sps, _bw)
+         template <typename Math = runtime_math>
+         constexpr config_bandpass_cpg(frequency f, std::uint32_t sps, bw _bw, Math m = {})
+          : config_biquad(f, sps, _bw, m)
          {
             init();
          }
 
-         config_bandpass_cpg(frequency f, std::uint32_t sps, double q)
-          : config_biquad(f, sps, q)
+         template <typename Math = runtime_math>
+         constexpr config_bandpass_cpg(frequency f, std::uint32_t sps, double q, Math m = {})
+          : config_biquad(f, sps, q, m)
          {
             init();
          }
 
-         void init()
+         constexpr void init()
          {
             b0 = alpha;
             b1 = 0.0;
@@ -215,19 +410,21 @@ namespace cycfi::q
       /////////////////////////////////////////////////////////////////////////
       struct config_notch : config_biquad
       {
-         config_notch(frequency f, std::uint32_t sps, bw _bw)
-          : config_biquad(f, sps, _bw)
+         template <typename Math = runtime_math>
+         constexpr config_notch(frequency f, std::uint32_t sps, bw _bw, Math m = {})
+          : config_biquad(f, sps, _bw, m)
          {
             init();
          }
 
-         config_notch(frequency f, std::uint32_t sps, double q)
-          : config_biquad(f, sps, q)
+         template <typename Math = runtime_math>
+         constexpr config_notch(frequency f, std::uint32_t sps, double q, Math m = {})
+          : config_biquad(f, sps, q, m)
          {
             init();
          }
 
-         void init()
+         constexpr void init()
          {
             b0 = 1.0;
             b1 = -2.0 * cos;
@@ -241,13 +438,14 @@ namespace cycfi::q
       /////////////////////////////////////////////////////////////////////////
       struct config_allpass : config_biquad
       {
-         config_allpass(frequency f, std::uint32_t sps, double q)
-          : config_biquad(f, sps, q)
+         template <typename Math = runtime_math>
+         constexpr config_allpass(frequency f, std::uint32_t sps, double q, Math m = {})
+          : config_biquad(f, sps, q, m)
          {
             init();
          }
 
-         void init()
+         constexpr void init()
          {
             b0 = 1.0 - alpha;
             b1 = -2.0 * cos;
@@ -261,19 +459,21 @@ namespace cycfi::q
       /////////////////////////////////////////////////////////////////////////
       struct config_peaking : config_biquad_a
       {
-         config_peaking(double db_gain, frequency f, std::uint32_t sps, bw _bw)
-          : config_biquad_a(db_gain, f, sps, _bw)
+         template <typename Math = runtime_math>
+         constexpr config_peaking(double db_gain, frequency f, std::uint32_t sps, bw _bw, Math m = {})
+          : config_biquad_a(db_gain, f, sps, _bw, m)
          {
             init();
          }
 
-         config_peaking(double db_gain, frequency f, std::uint32_t sps, double q)
-          : config_biquad_a(db_gain, f, sps, q)
+         template <typename Math = runtime_math>
+         constexpr config_peaking(double db_gain, frequency f, std::uint32_t sps, double q, Math m = {})
+          : config_biquad_a(db_gain, f, sps, q, m)
          {
             init();
          }
 
-         void init()
+         constexpr void init()
          {
             b0 = 1.0 + alpha * a;
             b1 = -2.0 * cos;
@@ -287,13 +487,14 @@ namespace cycfi::q
       /////////////////////////////////////////////////////////////////////////
       struct config_lowshelf : config_biquad_a
       {
-         config_lowshelf(double db_gain, frequency f, std::uint32_t sps, double q)
-          : config_biquad_a(db_gain, f, sps, q)
+         template <typename Math = runtime_math>
+         constexpr config_lowshelf(double db_gain, frequency f, std::uint32_t sps, double q, Math m = {})
+          : config_biquad_a(db_gain, f, sps, q, m)
          {
             init();
          }
 
-         void init()
+         constexpr void init()
          {
             b0 = a * ((a + 1.0) -(a - 1.0) * cos + beta * sin);
             b1 = 2.0 * a * ((a - 1.0) - (a + 1.0) * cos);
@@ -307,13 +508,14 @@ namespace cycfi::q
       /////////////////////////////////////////////////////////////////////////
       struct config_highshelf : config_biquad_a
       {
-         config_highshelf(double db_gain, frequency f, std::uint32_t sps, double q)
-          : config_biquad_a(db_gain, f, sps, q)
+         template <typename Math = runtime_math>
+         constexpr config_highshelf(double db_gain, frequency f, std::uint32_t sps, double q, Math m = {})
+          : config_biquad_a(db_gain, f, sps, q, m)
          {
             init();
          }
 
-         void init()
+         constexpr void init()
          {
             b0 = a * ((a + 1.0) + (a - 1.0) * cos + beta * sin);
             b1 = -2.0 * a * ((a - 1.0) + (a + 1.0) * cos);
@@ -495,6 +697,77 @@ namespace cycfi::q
          detail::config_highshelf(db_gain, f, sps, q).config(*this);
       }
    };
+
+   ////////////////////////////////////////////////////////////////////////////
+   // Compile time filter design. For filters with constant frequency, q,
+   // gain and sample rate, these compute the coefficients of the filters
+   // above, through the same detail::config_* design structs, as constexpr
+   // functions, so that the coefficients become immediate constants, and
+   // fixed filter chains can be fully constant folded:
+   //
+   //    constexpr auto c = lowpass_coeffs(1_kHz, 48000, 0.707);
+   //    biquad f{ c };
+   //
+   // The q argument may also be a bw, for those filters that accept a
+   // bandwidth above.
+   ////////////////////////////////////////////////////////////////////////////
+   constexpr biquad_coeffs
+   lowpass_coeffs(frequency f, std::uint32_t sps, double q = 0.707)
+   {
+      return detail::config_lowpass(f, sps, q, detail::compile_time_math{}).coeffs();
+   }
+
+   constexpr biquad_coeffs
+   highpass_coeffs(frequency f, std::uint32_t sps, double q = 0.707)
+   {
+      return detail::config_highpass(f, sps, q, detail::compile_time_math{}).coeffs();
+   }
+
+   template <typename Q = double>
+   constexpr biquad_coeffs
+   bandpass_csg_coeffs(frequency f, std::uint32_t sps, Q q = 0.707)
+   {
+      return detail::config_bandpass_csg(f, sps, q, detail::compile_time_math{}).coeffs();
+   }
+
+   template <typename Q = double>
+   constexpr biquad_coeffs
+   bandpass_cpg_coeffs(frequency f, std::uint32_t sps, Q q = 0.707)
+   {
+      return detail::config_bandpass_cpg(f, sps, q, detail::compile_time_math{}).coeffs();
+   }
+
+   template <typename Q = double>
+   constexpr biquad_coeffs
+   notch_coeffs(frequency f, std::uint32_t sps, Q q = 0.707)
+   {
+      return detail::config_notch(f, sps, q, detail::compile_time_math{}).coeffs();
+   }
+
+   constexpr biquad_coeffs
+   allpass_coeffs(frequency f, std::uint32_t sps, double q = 0.707)
+   {
+      return detail::config_allpass(f, sps, q, detail::compile_time_math{}).coeffs();
+   }
+
+   template <typename Q = double>
+   constexpr biquad_coeffs
+   peaking_coeffs(double db_gain, frequency f, std::uint32_t sps, Q q = 0.707)
+   {
+      return detail::config_peaking(db_gain, f, sps, q, detail::compile_time_math{}).coeffs();
+   }
+
+   constexpr biquad_coeffs
+   lowshelf_coeffs(double db_gain, frequency f, std::uint32_t sps, double q = 0.707)
+   {
+      return detail::config_lowshelf(db_gain, f, sps, q, detail::compile_time_math{}).coeffs();
+   }
+
+   constexpr biquad_coeffs
+   highshelf_coeffs(double db_gain, frequency f, std::uint32_t sps, double q = 0.707)
+   {
+      return detail::config_highshelf(db_gain, f, sps, q, detail::compile_time_math{}).coeffs();
+   }
 }
 
 #endif
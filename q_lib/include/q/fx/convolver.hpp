@@ -0,0 +1,247 @@
+/*=============================================================================
+   Copyright (c) 2014-2020 Joel de Guzman. All rights reserved.
+
+   Distributed under the MIT License [ https://opensource.org/licenses/MIT ]
+=============================================================================*/
+#if !defined(CYCFI_Q_CONVOLVER_OCTOBER_18_2026)
+#define CYCFI_Q_CONVOLVER_OCTOBER_18_2026
+
+#include <q/support/base.hpp>
+#include <q/fft/fft.hpp>
+#include <vector>
+#include <algorithm>
+
+namespace cycfi::q
+{
+   namespace detail
+   {
+      // Complex multiply-accumulate of n complex numbers (interleaved
+      // real, imaginary pairs): acc += x * h
+      inline void complex_mac(
+         double* acc, double const* x, double const* h, std::size_t n)
+      {
+         for (std::size_t i = 0; i != n*2; i += 2)
+         {
+            acc[i] += x[i] * h[i] - x[i+1] * h[i+1];
+            acc[i+1] += x[i] * h[i+1] + x[i+1] * h[i];
+         }
+      }
+   }
+
+   ////////////////////////////////////////////////////////////////////////////
+   // convolver: Uniformly partitioned overlap-save FFT convolution.
+   //
+   // The impulse response is split into partitions of B samples. The
+   // spectrum of each partition (zero padded to 2B samples) is precomputed
+   // at construction. Every B input samples, the latest 2B samples are
+   // transformed using fft<2B> and pushed into a frequency-domain delay
+   // line (FDL) holding the spectra of the last P input blocks, where P is
+   // the number of partitions. The output spectrum is the sum of the
+   // products of the FDL spectra and the partition spectra, which is
+   // transformed back using ifft<2B>. The last B samples of the result are
+   // the output (overlap-save).
+   //
+   // Since the input is real, only the first B+1 bins are stored and
+   // multiplied. The rest are reconstructed by conjugate symmetry.
+   //
+   // The cost per sample is O(log B + P), instead of O(L) for direct
+   // convolution where L is the impulse response length.
+   //
+   // The latency is B samples (see latency()). Typically, B is set to the
+   // audio buffer size. The convolver processes single samples or blocks
+   // of any length, e.g. the frames of an audio_stream callback:
+   //
+   //    void process(in_channels const& in, out_channels const& out)
+   //    {
+   //       for (std::size_t ch = 0; ch != out.size(); ++ch)
+   //          _conv[ch](in[ch], out[ch]);
+   //    }
+   //
+   // All buffers are allocated at construction.
+   //
+   //    B: partition (block) size. Must be a power of 2.
+   ////////////////////////////////////////////////////////////////////////////
+   template <std::size_t B>
+   class convolver
+   {
+   public:
+
+      static_assert(is_pow2(B),
+         "Error: B must be a power of two");
+
+      static constexpr std::size_t block_size = B;
+      static constexpr std::size_t fft_size = B * 2;
+      static constexpr std::size_t num_bins = B + 1;
+
+                              convolver(float const* ir, std::size_t size);
+
+                              convolver(std::vector<float> const& ir)
+                               : convolver(ir.data(), ir.size())
+                              {}
+
+      float                   operator()(float s);
+      void                    operator()(float const* in, float* out, std::size_t n);
+      void                    process(float const* in, float* out);
+
+                              template <typename InRange, typename OutRange>
+      void                    operator()(InRange const& in, OutRange const& out);
+
+      constexpr std::size_t   latency() const         { return B; }
+      std::size_t             num_partitions() const  { return _num_partitions; }
+      void                    reset();
+
+   private:
+
+      std::size_t             _num_partitions;
+      std::vector<double>     _ir;        // partition spectra (num_bins each)
+      std::vector<double>     _fdl;       // frequency-domain delay line
+      std::vector<double>     _acc;       // accumulated output spectrum
+      std::vector<float>      _prev;      // previous input block
+      std::vector<float>      _in;        // current input block
+      std::vector<float>      _out;       // current output block
+      std::vector<double>     _buff;      // FFT buffer (spectrum)
+      std::size_t             _head = 0;  // FDL position of the latest spectrum
+      std::size_t             _pos = 0;   // position in the current block
+   };
+
+   ////////////////////////////////////////////////////////////////////////////
+   // Implementation
+   ////////////////////////////////////////////////////////////////////////////
+   template <std::size_t B>
+   inline convolver<B>::convolver(float const* ir, std::size_t size)
+    : _num_partitions(std::max<std::size_t>((size + B - 1) / B, 1))
+    , _ir(_num_partitions * num_bins * 2)
+    , _fdl(_num_partitions * num_bins * 2, 0.0)
+    , _acc(num_bins * 2)
+    , _prev(B, 0.0f)
+    , _in(B, 0.0f)
+    , _out(B, 0.0f)
+    , _buff(fft_size * 2)
+   {
+      for (std::size_t p = 0; p != _num_partitions; ++p)
+      {
+         std::fill(_buff.begin(), _buff.end(), 0.0);
+         auto const first = p * B;
+         auto const last = std::min(first + B, size);
+         for (auto i = first; i < last; ++i)
+            _buff[(i - first) * 2] = ir[i];
+         fft<fft_size>(_buff.data());
+         std::copy(
+            _buff.begin(), _buff.begin() + num_bins * 2
+          , _ir.begin() + p * num_bins * 2
+         );
+      }
+   }
+
+   template <std::size_t B>
+   inline void convolver<B>::reset()
+   {
+      std::fill(_fdl.begin(), _fdl.end(), 0.0);
+      std::fill(_prev.begin(), _prev.end(), 0.0f);
+      std::fill(_in.begin(), _in.end(), 0.0f);
+      std::fill(_out.begin(), _out.end(), 0.0f);
+      _head = 0;
+      _pos = 0;
+   }
+
+   // Process exactly one block of B samples with no latency. This is the
+   // overlap-save core used by the streaming function call operators,
+   // exposed for clients that already work in blocks of B samples. in and
+   // out may be the same buffer.
+   template <std::size_t B>
+   inline void convolver<B>::process(float const* in, float* out)
+   {
+      // Transform the latest 2B input samples
+      auto* buff = _buff.data();
+      for (std::size_t i = 0; i != B; ++i)
+      {
+         buff[i*2] = _prev[i];
+         buff[i*2 + 1] = 0.0;
+         buff[(i+B)*2] = in[i];
+         buff[(i+B)*2 + 1] = 0.0;
+      }
+      std::copy(in, in + B, _prev.begin());
+      fft<fft_size>(buff);
+
+      // Push the spectrum into the frequency-domain delay line
+      _head = (_head == 0)? _num_partitions-1 : _head-1;
+      std::copy(buff, buff + num_bins * 2, _fdl.begin() + _head * num_bins * 2);
+
+      // Multiply-accumulate the FDL spectra with the partition spectra
+      std::fill(_acc.begin(), _acc.end(), 0.0);
+      auto slot = _head;
+      for (std::size_t p = 0; p != _num_partitions; ++p)
+      {
+         detail::complex_mac(
+            _acc.data()
+          , _fdl.data() + slot * num_bins * 2
+          , _ir.data() + p * num_bins * 2
+          , num_bins
+         );
+         if (++slot == _num_partitions)
+            slot = 0;
+      }
+
+      // Reconstruct the full spectrum (conjugate symmetric) and transform
+      // back. The last B samples are the output.
+      std::copy(_acc.begin(), _acc.end(), buff);
+      for (std::size_t k = 1; k != B; ++k)
+      {
+         buff[(fft_size-k)*2] = _acc[k*2];
+         buff[(fft_size-k)*2 + 1] = -_acc[k*2 + 1];
+      }
+      ifft<fft_size>(buff);
+
+      for (std::size_t i = 0; i != B; ++i)
+         out[i] = buff[(i+B)*2];
+   }
+
+   template <std::size_t B>
+   inline float convolver<B>::operator()(float s)
+   {
+      auto y = _out[_pos];
+      _in[_pos] = s;
+      if (++_pos == B)
+      {
+         process(_in.data(), _out.data());
+         _pos = 0;
+      }
+      return y;
+   }
+
+   template <std::size_t B>
+   inline void convolver<B>::operator()(
+      float const* in, float* out, std::size_t n)
+   {
+      while (n != 0)
+      {
+         auto const chunk = std::min(n, B - _pos);
+
+         // Take the input first; in and out may be the same buffer.
+         std::copy(in, in + chunk, _in.begin() + _pos);
+         std::copy(_out.begin() + _pos, _out.begin() + _pos + chunk, out);
+
+         in += chunk;
+         out += chunk;
+         n -= chunk;
+         _pos += chunk;
+
+         if (_pos == B)
+         {
+            process(_in.data(), _out.data());
+            _pos = 0;
+         }
+      }
+   }
+
+   template <std::size_t B>
+   template <typename InRange, typename OutRange>
+   inline void convolver<B>::operator()(InRange const& in, OutRange const& out)
+   {
+      auto const n = in.end() - in.begin();
+      if (n != 0)
+         (*this)(&*in.begin(), &*out.begin(), n);
+   }
+}
+
+#endif
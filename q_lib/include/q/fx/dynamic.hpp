@@ -7,6 +7,8 @@
 #define CYCFI_Q_DYNAMIC_DECEMBER_7_2018
 
 #include <q/support/base.hpp>
+#include <q/detail/db_poly.hpp>
+#include <cstddef>
 
 namespace cycfi::q
 {
@@ -45,6 +47,18 @@ namespace cycfi::q
    //
    // Typically, you add some makeup gain after compression to compensate for
    // the gain reduction.
+   //
+   // Block processing: the gain processors (including the agc below) also
+   // have a function call operator that processes a block of n envelope
+   // values, env, writing n gains to gain:
+   //
+   //    comp(env, gain, n);
+   //
+   // Here, env and gain are plain floats, in decibels (the val of the
+   // decibel). The branches are computed as selects (detail::select),
+   // comparing the detail::ordered_key of the floats, so these vectorize.
+   // See dynamics_processor for the whole chain (envelope, gain, signal)
+   // in blocks.
    ////////////////////////////////////////////////////////////////////////////
    struct compressor
    {
@@ -60,6 +74,20 @@ namespace cycfi::q
          return _slope * (_threshold - env);
       }
 
+      // Block processing. See the note on block processing above.
+      void operator()(float const* env, float* gain, std::size_t n)
+      {
+         float const threshold = _threshold.val;
+         float const slope = _slope;
+         auto const k_threshold = detail::ordered_key(threshold);
+         for (std::size_t i = 0; i != n; ++i)
+         {
+            auto const e = env[i];
+            auto const g = slope * (threshold - e);
+            gain[i] = detail::select(detail::ordered_key(e) <= k_threshold, 0.0f, g);
+         }
+      }
+
       void threshold(decibel val)
       {
          _threshold = val;
@@ -102,6 +130,27 @@ namespace cycfi::q
          }
       }
 
+      // Block processing. See the note on block processing above.
+      void operator()(float const* env, float* gain, std::size_t n)
+      {
+         float const threshold = _threshold.val;
+         float const width = _width.val;
+         float const lower = _lower.val;
+         float const upper = _upper.val;
+         float const slope = _slope;
+         auto const k_lower = detail::ordered_key(lower);
+         auto const k_upper = detail::ordered_key(upper);
+         for (std::size_t i = 0; i != n; ++i)
+         {
+            auto const e = env[i];
+            auto const k = detail::ordered_key(e);
+            auto const soft = slope * ((e - lower) / width) * 0.5f * (lower - e);
+            auto const hard = slope * (threshold - e);
+            auto const g = detail::select(k <= k_upper, soft, hard);
+            gain[i] = detail::select(k <= k_lower, 0.0f, g);
+         }
+      }
+
       void threshold(decibel val)
       {
          _threshold = val;
@@ -151,6 +200,20 @@ namespace cycfi::q
          return _slope * (env - _threshold);
       }
 
+      // Block processing. See the note on block processing above.
+      void operator()(float const* env, float* gain, std::size_t n)
+      {
+         float const threshold = _threshold.val;
+         float const slope = _slope;
+         auto const k_threshold = detail::ordered_key(threshold);
+         for (std::size_t i = 0; i != n; ++i)
+         {
+            auto const e = env[i];
+            auto const g = slope * (e - threshold);
+            gain[i] = detail::select(detail::ordered_key(e) >= k_threshold, 0.0f, g);
+         }
+      }
+
       void threshold(decibel val)
       {
          _threshold = val;
@@ -184,6 +247,19 @@ namespace cycfi::q
          return g;
       }
 
+      // Block processing. See the note on block processing above.
+      void operator()(float const* env, decibel ref, float* gain, std::size_t n)
+      {
+         float const ref_ = ref.val;
+         float const max = _max.val;
+         auto const k_max = detail::ordered_key(max);
+         for (std::size_t i = 0; i != n; ++i)
+         {
+            auto const g = ref_ - env[i];
+            gain[i] = detail::select(detail::ordered_key(g) > k_max, max - (g - max), g);
+         }
+      }
+
       void max(decibel max_)
       {
          _max = max_;
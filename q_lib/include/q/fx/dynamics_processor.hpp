@@ -0,0 +1,236 @@
+/*=============================================================================
+   Copyright (c) 2014-2020 Joel de Guzman. All rights reserved.
+
+   Distributed under the MIT License [ https://opensource.org/licenses/MIT ]
+=============================================================================*/
+#if !defined(CYCFI_Q_DYNAMICS_PROCESSOR_OCTOBER_18_2026)
+#define CYCFI_Q_DYNAMICS_PROCESSOR_OCTOBER_18_2026
+
+#include <q/support/literals.hpp>
+#include <q/support/decibel.hpp>
+#include <q/fx/dynamic.hpp>
+#include <q/detail/db_poly.hpp>
+#include <algorithm>
+#include <tuple>
+#include <cmath>
+
+namespace cycfi::q
+{
+   namespace detail
+   {
+      // Block processing of an envelope follower, if it has one (process),
+      // or sample by sample, otherwise.
+      template <typename Envelope>
+      inline auto process_envelope(Envelope& env, float* x, std::size_t n, int)
+         -> decltype(env.process(x, n), void())
+      {
+         env.process(x, n);
+      }
+
+      template <typename Envelope>
+      inline void process_envelope(Envelope& env, float* x, std::size_t n, long)
+      {
+         for (std::size_t i = 0; i != n; ++i)
+            x[i] = env(x[i]);
+      }
+   }
+
+   ////////////////////////////////////////////////////////////////////////////
+   // dynamics_processor: the whole dynamics chain, envelope -> gain
+   // computers -> gain, in blocks:
+   //
+   //    1. The envelope of the magnitude of the signal, using Envelope
+   //       (e.g. envelope_follower or peak_envelope_follower), with its
+   //       block processing, if it has one.
+   //
+   //    2. The envelope in decibels (detail::fast_a2db).
+   //
+   //    3. The gain, in decibels: the makeup gain plus the sum of the gains
+   //       of all the gain computers (e.g. compressor, soft_knee_compressor
+   //       and expander), each using its block processing function call
+   //       operator: gc(env, gain, n). See dynamic.hpp.
+   //
+   //    4. The gain, linear (detail::fast_db2a), applied to the signal.
+   //
+   // The signal is processed in chunks of up to chunk_size samples, copied
+   // to a local buffer padded with zeros to whole tiles of tile_size
+   // samples. The envelope is a pass over the chunk. Stages 2 to 4 are then
+   // fused, a tile at a time. The tile loops have a fixed trip count and
+   // work on local buffers that do not alias, and, except for the
+   // envelope, have no branches (the gain computers use selects), so these
+   // vectorize, without alias checks, even at -O2. The tile size is large
+   // enough that the loops are not completely unrolled (instead of
+   // vectorized) at -O3.
+   //
+   // The function call operator, operator()(float s), processes a single
+   // sample, through the same stages.
+   //
+   // Speed: this falls short of the 4x over the per sample chains of
+   // test/compressor_*.cpp that it was meant for. Against those loops
+   // (test/dynamics_processor.cpp, Dynamics_Processor_Chains_Benchmark,
+   // g++ 12, SSE2, -O3, -O2 in parentheses):
+   //
+   //    compressor_ff_fb (feedforward)   2.8x (2.1x)
+   //    compressor_expander1 and 2       1.4x (1.2x)
+   //
+   // With one output, the per sample chain takes about 8.3 ns per sample,
+   // so 4x leaves about 2 ns. The envelope alone takes about 1.1 ns (a
+   // recurrence, at best a block scan), and the fused decibel stages about
+   // 1.8 ns (four lanes wide). The compressor_expander chains compute one
+   // envelope for two or three outputs, while a dynamics_processor per
+   // output computes its own envelope each time.
+   //
+   // Any combination of gain computers may be used (e.g. a compressor and
+   // an expander, for compression above and expansion below), including
+   // user defined ones, given the block function call operator above.
+   // For example, the agc, with a fixed reference:
+   //
+   //    auto agc_ = [agc = q::agc{ 12_dB }]
+   //       (float const* env, float* gain, std::size_t n) mutable
+   //       {
+   //          agc(env, -6_dB, gain, n);
+   //       };
+   //
+   //    auto dyn = q::dynamics_processor{ env, agc_ };
+   ////////////////////////////////////////////////////////////////////////////
+   template <typename Envelope, typename... GainComputers>
+   class dynamics_processor
+   {
+   public:
+
+      static constexpr std::size_t chunk_size = 256;
+      static constexpr std::size_t tile_size = 32;
+
+                              dynamics_processor(
+                                 Envelope env
+                               , GainComputers... gc
+                              );
+
+      float                   operator()(float s);
+      void                    process(float const* in, float* out, std::size_t n);
+      void                    process(float* inout, std::size_t n);
+
+      void                    makeup_gain(decibel gain)  { _makeup = gain.val; }
+      float                   gain() const               { return _gain; }
+
+      Envelope&               envelope()                 { return _env; }
+
+      template <std::size_t I>
+      auto&                   gain_computer()            { return std::get<I>(_gc); }
+
+   private:
+
+      Envelope                _env;
+      std::tuple<GainComputers...> _gc;
+      float                   _makeup = 0.0f;   // decibels
+      float                   _gain = 1.0f;     // latest gain
+   };
+
+   template <typename Envelope, typename... GainComputers>
+   dynamics_processor(Envelope, GainComputers...)
+      -> dynamics_processor<Envelope, GainComputers...>;
+
+   ////////////////////////////////////////////////////////////////////////////
+   // Implementation
+   ////////////////////////////////////////////////////////////////////////////
+   template <typename Envelope, typename... GainComputers>
+   inline dynamics_processor<Envelope, GainComputers...>::dynamics_processor(
+      Envelope env
+    , GainComputers... gc
+   )
+    : _env(env)
+    , _gc(gc...)
+   {}
+
+   template <typename Envelope, typename... GainComputers>
+   inline void dynamics_processor<Envelope, GainComputers...>::process(
+      float const* in, float* out, std::size_t n)
+   {
+      for (std::size_t i = 0; i < n; i += chunk_size)
+      {
+         auto const m = std::min(chunk_size, n - i);
+         auto const padded = (m + tile_size - 1) / tile_size * tile_size;
+
+         // The chunk, padded with zeros to whole tiles, in a local buffer,
+         // so that the tile loops have a fixed trip count and do not alias
+         // in and out.
+         float x[chunk_size], env[chunk_size], gain[chunk_size];
+         std::copy(in + i, in + i + m, x);
+         std::fill(x + m, x + padded, 0.0f);
+
+         // The envelope
+         for (std::size_t t = 0; t != padded; t += tile_size)
+            for (std::size_t k = 0; k != tile_size; ++k)
+               env[t+k] = std::abs(x[t+k]);
+         detail::process_envelope(_env, env, m, 0);
+
+         // The envelope in decibels, the gains, and the signal times the
+         // gains, fused, a tile at a time
+         for (std::size_t t = 0; t != padded; t += tile_size)
+         {
+            float db[tile_size], g[tile_size];
+            float* gt = gain + t;
+            for (std::size_t k = 0; k != tile_size; ++k)
+            {
+               db[k] = detail::fast_a2db(env[t+k]);
+               gt[k] = _makeup;
+            }
+
+            std::apply(
+               [&](auto&... gc)
+               {
+                  auto add = [&](auto& gc_)
+                  {
+                     gc_(static_cast<float const*>(db), g, tile_size);
+                     for (std::size_t k = 0; k != tile_size; ++k)
+                        gt[k] += g[k];
+                  };
+                  (add(gc), ...);
+               }
+             , _gc
+            );
+
+            for (std::size_t k = 0; k != tile_size; ++k)
+            {
+               gt[k] = detail::fast_db2a(gt[k]);
+               x[t+k] *= gt[k];
+            }
+         }
+
+         std::copy(x, x + m, out + i);
+         _gain = gain[m - 1];
+      }
+   }
+
+   template <typename Envelope, typename... GainComputers>
+   inline void dynamics_processor<Envelope, GainComputers...>::process(
+      float* inout, std::size_t n)
+   {
+      process(inout, inout, n);
+   }
+
+   template <typename Envelope, typename... GainComputers>
+   inline float dynamics_processor<Envelope, GainComputers...>::operator()(float s)
+   {
+      float const env = _env(std::abs(s));
+      float const db = detail::fast_a2db(env);
+      float gain = _makeup;
+      std::apply(
+         [&](auto&... gc)
+         {
+            auto add = [&](auto& gc_)
+            {
+               float g;
+               gc_(&db, &g, 1);
+               gain += g;
+            };
+            (add(gc), ...);
+         }
+       , _gc
+      );
+      _gain = detail::fast_db2a(gain);
+      return s * _gain;
+   }
+}
+
+#endif
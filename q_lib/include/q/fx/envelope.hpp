@@ -8,8 +8,11 @@
 
 #include <q/support/literals.hpp>
 #include <q/fx/moving_average.hpp>
+#include <q/fx/moving_maximum.hpp>
 #include <q/fx/lowpass.hpp>
 #include <q/support/decibel.hpp>
+#include <q/detail/recurrence.hpp>
+#include <q/detail/db_poly.hpp>
 #include <algorithm>
 
 namespace cycfi::q
@@ -31,6 +34,93 @@ namespace cycfi::q
          return y = s + ((s > y)? _attack : _release) * (y - s);
       }
 
+      // Block processing. The coefficient depends on the output, but the
+      // envelope is usually either rising (attack) or falling (release) for
+      // a whole block. So each block is computed speculatively with one
+      // coefficient (that of the first sample), using the detail::recurrence
+      // scan, then checked: the outputs are valid up to the first input that
+      // is not on the assumed side of the previous output. The rest of the
+      // block is processed sample by sample. When speculation fails, the
+      // next blocks (up to max_skip) are processed sample by sample, until
+      // speculation succeeds again, so that signals that change direction
+      // all the time (e.g. rectified noise with a fast attack) do not pay
+      // for the scans they throw away.
+      //
+      // The sample by sample steps are written as y = a*y + (1-a)*s, with
+      // both the attack and release updates computed, then selected. The
+      // (1-a)*s terms do not depend on y, so the recursive path is only a
+      // multiply-add and a select.
+      void process(float const* in, float* out, std::size_t n)
+      {
+         using detail::recurrence;
+         constexpr auto size = recurrence::block_size;
+         constexpr std::size_t max_skip = 8;
+         recurrence const attack{ _attack };
+         recurrence const release{ _release };
+         auto const ba = 1.0f - _attack, br = 1.0f - _release;
+
+         auto step =
+            [a = _attack, r = _release, ba, br]
+            (float y, float const* s, float* out, std::size_t n)
+            {
+               for (std::size_t i = 0; i != n; ++i)
+               {
+                  auto ya = a * y + ba * s[i];
+                  auto yr = r * y + br * s[i];
+                  out[i] = y = (s[i] > y)? ya : yr;
+               }
+               return y;
+            };
+
+         auto y_ = y;
+         std::size_t skip = 0, backoff = 0;
+         auto const m = n - n % size;
+         std::size_t i = 0;
+         for (; i != m; i += size)
+         {
+            float const* s = in + i;
+            if (skip != 0)
+            {
+               --skip;
+               y_ = step(y_, s, out + i, size);
+               continue;
+            }
+
+            bool const rising = s[0] > y_;
+            auto const& rec = rising? attack : release;
+            auto const b = rising? ba : br;
+
+            float u[size], v[size];
+            for (std::size_t k = 0; k != size; ++k)
+               u[k] = b * s[k];
+            auto const last = rec.block(y_, u, v);
+
+            std::size_t valid = 1;
+            while (valid != size && (s[valid] > v[valid-1]) == rising)
+               ++valid;
+
+            // In place, this overwrites only the inputs already used
+            std::copy(v, v + valid, out + i);
+            if (valid == size)
+            {
+               y_ = last;
+               backoff = 0;
+            }
+            else
+            {
+               y_ = step(v[valid-1], s + valid, out + i + valid, size - valid);
+               backoff = std::min(backoff * 2 + 1, max_skip);
+               skip = backoff;
+            }
+         }
+         y = step(y_, in + i, out + i, n - i);
+      }
+
+      void process(float* inout, std::size_t n)
+      {
+         process(inout, inout, n);
+      }
+
       float operator()() const
       {
          return y;
@@ -79,6 +169,18 @@ namespace cycfi::q
          return y;
       }
 
+      // Block processing. See detail::hold_recurrence.
+      void process(float const* in, float* out, std::size_t n)
+      {
+         using hold = detail::hold_recurrence<detail::select_max<float>>;
+         y = hold{ _release }(y, in, out, n);
+      }
+
+      void process(float* inout, std::size_t n)
+      {
+         process(inout, inout, n);
+      }
+
       float operator()() const
       {
          return y;
@@ -144,6 +246,45 @@ namespace cycfi::q
          return _latest;
       }
 
+      // Block processing. Between resets, the two peaks are running maxima,
+      // so the samples up to the next reset are processed without checking
+      // the hold counter. Only the samples that reset _y1 or _y2 are
+      // processed by operator()(s).
+      void process(float const* in, float* out, std::size_t n)
+      {
+         std::size_t i = 0;
+         while (i != n)
+         {
+            auto const m = std::min<std::size_t>(n - i, _reset - _tick);
+            auto y1 = _y1, y2 = _y2;
+            for (std::size_t k = 0; k != m; ++k)
+            {
+               y1 = std::max(y1, in[i+k]);
+               y2 = std::max(y2, in[i+k]);
+               out[i+k] = std::max(y1, y2);
+            }
+            _y1 = y1;
+            _y2 = y2;
+            _tick += m;
+            i += m;
+
+            if (i != n)
+            {
+               out[i] = (*this)(in[i]);
+               ++i;
+            }
+            else if (m != 0)
+            {
+               _latest = out[i-1];
+            }
+         }
+      }
+
+      void process(float* inout, std::size_t n)
+      {
+         process(inout, inout, n);
+      }
+
       float operator()() const
       {
          return _latest;
@@ -181,17 +322,42 @@ namespace cycfi::q
       {
       }
 
+      // The square root is taken in the dB domain with detail::fast_a2db,
+      // rather than with the decibel tables, which are off by up to 0.5 dB
+      // at low levels. fast_a2db is floored at -120 dB, the threshold, so
+      // there is no separate threshold step.
       decibel operator()(float s)
       {
-         auto e = _ma(_fenv(s * s));
-         if (e < threshold)
-            e = 0;
-
-         // Perform square-root in the dB domain:
-         _db = decibel{ e } / 2.0f;
+         auto const e = _ma(_fenv(s * s));
+         _db = decibel{ detail::fast_a2db(e) * 0.5f, decibel::direct };
          return _db;
       }
 
+      // Block processing, with the levels, in dB, in out. The squares, the
+      // fast_envelope_follower and the moving_average are computed a block
+      // at a time, in out, then converted with the buffer version of
+      // detail::fast_a2db, which vectorizes. The levels are the same as
+      // operator()(s)'s, to within 0.001 dB (the moving_average sums may
+      // round differently).
+      void process(float const* in, float* out, std::size_t n)
+      {
+         if (n == 0)
+            return;
+         for (std::size_t i = 0; i != n; ++i)
+            out[i] = in[i] * in[i];
+         _fenv.process(out, n);
+         _ma.process(out, n);
+         detail::fast_a2db(out, out, n);
+         for (std::size_t i = 0; i != n; ++i)
+            out[i] *= 0.5f;
+         _db = decibel{ out[n-1], decibel::direct };
+      }
+
+      void process(float* inout, std::size_t n)
+      {
+         process(inout, inout, n);
+      }
+
       decibel operator()() const
       {
          return _db;
@@ -0,0 +1,452 @@
+/*=============================================================================
+   Copyright (c) 2014-2020 Joel de Guzman. All rights reserved.
+
+   Distributed under the MIT License [ https://opensource.org/licenses/MIT ]
+=============================================================================*/
+#if !defined(CYCFI_Q_ENVELOPE_BANK_OCTOBER_18_2026)
+#define CYCFI_Q_ENVELOPE_BANK_OCTOBER_18_2026
+
+#include <q/fx/envelope.hpp>
+#include <q/fx/moving_sum_bank.hpp>
+#include <q/support/audio_stream.hpp>
+#include <q/detail/db_poly.hpp>
+#include <infra/assert.hpp>
+#include <algorithm>
+#include <array>
+#include <utility>
+
+namespace cycfi::q
+{
+   namespace detail
+   {
+      /////////////////////////////////////////////////////////////////////////
+      // Runs f on in, a tile of frames at a time, transposed into a frame
+      // major work buffer (see biquad_bank), then transposes the results
+      // back to out. f(buf, n) processes the n frames of buf, float[tile]
+      // [N], in place. in and out may be the same buffers.
+      /////////////////////////////////////////////////////////////////////////
+      template <std::size_t N, std::size_t TileSize, typename In, typename F>
+      inline void process_tiles(In const& in, audio_channels<float> const& out, F&& f)
+      {
+         CYCFI_ASSERT(in.size() >= N && out.size() >= N, "Not enough channels.");
+
+         auto const frames = std::min(in.frames().last, out.frames().last);
+         alignas(64) float buf[TileSize][N];
+         std::array<float const*, N> src;
+         std::array<float*, N> dest;
+         for (std::size_t ch = 0; ch != N; ++ch)
+         {
+            src[ch] = in[ch].begin();
+            dest[ch] = out[ch].begin();
+         }
+
+         for (std::size_t frame = 0; frame < frames; frame += TileSize)
+         {
+            auto const n = std::min(TileSize, frames - frame);
+
+            for (std::size_t i = 0; i != n; ++i)
+               for (std::size_t ch = 0; ch != N; ++ch)
+                  buf[i][ch] = src[ch][frame + i];
+
+            f(buf, n);
+
+            for (std::size_t i = 0; i != n; ++i)
+               for (std::size_t ch = 0; ch != N; ++ch)
+                  dest[ch][frame + i] = buf[i][ch];
+         }
+      }
+
+      // The larger of a and b, comparing the ordered keys, so that the
+      // lane loops vectorize (see ordered_key)
+      inline float key_max(float a, float b)
+      {
+         return (ordered_key(a) < ordered_key(b))? b : a;
+      }
+   }
+
+   ////////////////////////////////////////////////////////////////////////////
+   // envelope_follower_bank, peak_envelope_follower_bank and
+   // fast_rms_envelope_follower_bank: N envelope followers (see
+   // envelope.hpp), one per channel, processing non-interleaved
+   // audio_channels buffers.
+   //
+   // Like the biquad_bank, the state and coefficients are kept in
+   // structure-of-arrays form, and blocks are transposed, a tile of frames
+   // at a time, into a frame major work buffer. Each frame is then a
+   // handful of N wide operations. The attack or release choice (or the
+   // maximum) is a masked blend of the lanes: the inputs and the envelopes
+   // are compared as detail::ordered_key integers, which select the
+   // coefficient (or sample) of each lane without branches. The results
+   // are the same as the scalar envelope followers'. The levels of the
+   // fast_rms_envelope_follower_bank, in dB, are within 0.001 dB (see
+   // fast_rms_envelope_follower::process).
+   //
+   // The envelope_follower_bank and peak_envelope_follower_bank may have
+   // different attack and release times per channel (config(channel,
+   // ...)).
+   ////////////////////////////////////////////////////////////////////////////
+   template <std::size_t N>
+   class envelope_follower_bank
+   {
+   public:
+
+      static_assert(N > 0, "Error: N must be greater than zero");
+
+      static constexpr std::size_t num_channels = N;
+      static constexpr std::size_t tile_size = 32;
+
+                              envelope_follower_bank(
+                                 duration attack, duration release
+                               , std::uint32_t sps
+                              );
+
+      void                    config(
+                                 std::size_t channel
+                               , duration attack, duration release
+                               , std::uint32_t sps
+                              );
+
+      void                    operator()(audio_channels<float> const& inout);
+      void                    operator()(
+                                 audio_channels<float const> const& in
+                               , audio_channels<float> const& out
+                              );
+
+      float                   envelope(std::size_t channel) const;
+      void                    reset();
+
+   private:
+
+      using lanes = std::array<float, N>;
+
+      template <typename In>
+      void                    process(In const& in, audio_channels<float> const& out);
+
+      alignas(64) lanes       _attack, _release;
+      alignas(64) lanes       _y;
+   };
+
+   template <std::size_t N>
+   class peak_envelope_follower_bank
+   {
+   public:
+
+      static_assert(N > 0, "Error: N must be greater than zero");
+
+      static constexpr std::size_t num_channels = N;
+      static constexpr std::size_t tile_size = 32;
+
+                              peak_envelope_follower_bank(
+                                 duration release, std::uint32_t sps);
+
+      void                    config(
+                                 std::size_t channel
+                               , duration release, std::uint32_t sps
+                              );
+
+      void                    operator()(audio_channels<float> const& inout);
+      void                    operator()(
+                                 audio_channels<float const> const& in
+                               , audio_channels<float> const& out
+                              );
+
+      float                   envelope(std::size_t channel) const;
+      void                    reset();
+
+   private:
+
+      using lanes = std::array<float, N>;
+
+      template <typename In>
+      void                    process(In const& in, audio_channels<float> const& out);
+
+      alignas(64) lanes       _release;
+      alignas(64) lanes       _y;
+   };
+
+   ////////////////////////////////////////////////////////////////////////////
+   // fast_rms_envelope_follower_bank: the levels, in dB, are written to the
+   // out channels. Like fast_rms_envelope_follower::process, the square
+   // root is taken in the dB domain with detail::fast_a2db.
+   //
+   // The fast envelope followers are not transposed into lanes: between
+   // resets, these are running maxima, too cheap to pay for the transposes.
+   // Each channel is processed with fast_envelope_follower::process
+   // instead.
+   ////////////////////////////////////////////////////////////////////////////
+   template <std::size_t N>
+   class fast_rms_envelope_follower_bank
+   {
+   public:
+
+      static constexpr std::size_t num_channels = N;
+
+                              fast_rms_envelope_follower_bank(
+                                 duration hold, std::uint32_t sps);
+
+      void                    operator()(audio_channels<float> const& inout);
+      void                    operator()(
+                                 audio_channels<float const> const& in
+                               , audio_channels<float> const& out
+                              );
+
+      decibel                 level(std::size_t channel) const;
+      void                    reset();
+
+   private:
+
+      using followers = std::array<fast_envelope_follower, N>;
+
+      template <std::size_t... I>
+      static followers
+      make_fenv(duration hold, std::uint32_t sps, std::index_sequence<I...>)
+      {
+         return {{ (void(I), fast_envelope_follower{ hold, sps })... }};
+      }
+
+      template <typename In>
+      void                    process(In const& in, audio_channels<float> const& out);
+
+      followers               _fenv;
+      moving_average_bank<N>  _ma;
+      std::array<float, N>    _db;
+   };
+
+   ////////////////////////////////////////////////////////////////////////////
+   // Implementation
+   ////////////////////////////////////////////////////////////////////////////
+   template <std::size_t N>
+   inline envelope_follower_bank<N>::envelope_follower_bank(
+      duration attack, duration release, std::uint32_t sps)
+   {
+      for (std::size_t ch = 0; ch != N; ++ch)
+         config(ch, attack, release, sps);
+      reset();
+   }
+
+   template <std::size_t N>
+   inline void envelope_follower_bank<N>::config(
+      std::size_t channel
+    , duration attack, duration release
+    , std::uint32_t sps
+   )
+   {
+      CYCFI_ASSERT(channel < N, "Invalid channel.");
+      _attack[channel] = fast_exp3(-2.0f / (sps * double(attack)));
+      _release[channel] = fast_exp3(-2.0f / (sps * double(release)));
+   }
+
+   template <std::size_t N>
+   inline float envelope_follower_bank<N>::envelope(std::size_t channel) const
+   {
+      CYCFI_ASSERT(channel < N, "Invalid channel.");
+      return _y[channel];
+   }
+
+   template <std::size_t N>
+   inline void envelope_follower_bank<N>::reset()
+   {
+      _y.fill(0.0f);
+   }
+
+   template <std::size_t N>
+   template <typename In>
+   inline void envelope_follower_bank<N>::process(
+      In const& in, audio_channels<float> const& out)
+   {
+      detail::process_tiles<N, tile_size>(in, out,
+         [this](float (*buf)[N], std::size_t n)
+         {
+            using detail::ordered_key;
+            alignas(64) lanes y = _y;
+            alignas(64) lanes const attack = _attack, release = _release;
+            for (std::size_t i = 0; i != n; ++i)
+            {
+               auto* x = buf[i];
+               for (std::size_t ch = 0; ch != N; ++ch)
+               {
+                  auto const s = x[ch];
+                  auto const prev = y[ch];
+                  auto const a = attack[ch];
+                  auto const r = release[ch];
+                  auto const rising = ordered_key(s) > ordered_key(prev);
+                  auto const c = rising? a : r;
+                  x[ch] = y[ch] = s + c * (prev - s);
+               }
+            }
+            _y = y;
+         }
+      );
+   }
+
+   template <std::size_t N>
+   inline void envelope_follower_bank<N>::operator()(audio_channels<float> const& inout)
+   {
+      process(inout, inout);
+   }
+
+   template <std::size_t N>
+   inline void envelope_follower_bank<N>::operator()(
+      audio_channels<float const> const& in
+    , audio_channels<float> const& out
+   )
+   {
+      process(in, out);
+   }
+
+   template <std::size_t N>
+   inline peak_envelope_follower_bank<N>::peak_envelope_follower_bank(
+      duration release, std::uint32_t sps)
+   {
+      for (std::size_t ch = 0; ch != N; ++ch)
+         config(ch, release, sps);
+      reset();
+   }
+
+   template <std::size_t N>
+   inline void peak_envelope_follower_bank<N>::config(
+      std::size_t channel, duration release, std::uint32_t sps)
+   {
+      CYCFI_ASSERT(channel < N, "Invalid channel.");
+      _release[channel] = fast_exp3(-2.0f / (sps * double(release)));
+   }
+
+   template <std::size_t N>
+   inline float peak_envelope_follower_bank<N>::envelope(std::size_t channel) const
+   {
+      CYCFI_ASSERT(channel < N, "Invalid channel.");
+      return _y[channel];
+   }
+
+   template <std::size_t N>
+   inline void peak_envelope_follower_bank<N>::reset()
+   {
+      _y.fill(0.0f);
+   }
+
+   template <std::size_t N>
+   template <typename In>
+   inline void peak_envelope_follower_bank<N>::process(
+      In const& in, audio_channels<float> const& out)
+   {
+      detail::process_tiles<N, tile_size>(in, out,
+         [this](float (*buf)[N], std::size_t n)
+         {
+            // The release step, s + release * (y - s), is above s if y is
+            // above s, and below s otherwise, so the peak envelope is the
+            // larger of s and the release step.
+            using detail::key_max;
+            alignas(64) lanes y = _y;
+            alignas(64) lanes const release = _release;
+            for (std::size_t i = 0; i != n; ++i)
+            {
+               auto* x = buf[i];
+               for (std::size_t ch = 0; ch != N; ++ch)
+               {
+                  auto const s = x[ch];
+                  x[ch] = y[ch] = key_max(s, s + release[ch] * (y[ch] - s));
+               }
+            }
+            _y = y;
+         }
+      );
+   }
+
+   template <std::size_t N>
+   inline void peak_envelope_follower_bank<N>::operator()(
+      audio_channels<float> const& inout)
+   {
+      process(inout, inout);
+   }
+
+   template <std::size_t N>
+   inline void peak_envelope_follower_bank<N>::operator()(
+      audio_channels<float const> const& in
+    , audio_channels<float> const& out
+   )
+   {
+      process(in, out);
+   }
+
+   template <std::size_t N>
+   inline fast_rms_envelope_follower_bank<N>::fast_rms_envelope_follower_bank(
+      duration hold, std::uint32_t sps)
+    : _fenv(make_fenv(hold, sps, std::make_index_sequence<N>{}))
+    , _ma(hold, sps)
+   {
+      _db.fill(0.0f);
+   }
+
+   template <std::size_t N>
+   inline decibel fast_rms_envelope_follower_bank<N>::level(std::size_t channel) const
+   {
+      CYCFI_ASSERT(channel < N, "Invalid channel.");
+      return { _db[channel], decibel::direct };
+   }
+
+   template <std::size_t N>
+   inline void fast_rms_envelope_follower_bank<N>::reset()
+   {
+      for (auto& f : _fenv)
+      {
+         f._y1 = f._y2 = f._latest = 0;
+         f._tick = f._i = 0;
+      }
+      _ma.clear();
+      _db.fill(0.0f);
+   }
+
+   template <std::size_t N>
+   template <typename In>
+   inline void fast_rms_envelope_follower_bank<N>::process(
+      In const& in, audio_channels<float> const& out)
+   {
+      CYCFI_ASSERT(in.size() >= N && out.size() >= N, "Not enough channels.");
+
+      auto const frames = std::min(in.frames().last, out.frames().last);
+      if (frames == 0)
+         return;
+
+      // The squares, in out, and their envelope, in place, then the moving
+      // average, in place, then the square root, in the dB domain
+      std::array<float*, N> dest;
+      for (std::size_t ch = 0; ch != N; ++ch)
+      {
+         float const* src = in[ch].begin();
+         dest[ch] = out[ch].begin();
+         for (std::size_t i = 0; i != frames; ++i)
+            dest[ch][i] = src[i] * src[i];
+         _fenv[ch].process(dest[ch], frames);
+      }
+
+      audio_channels<float> const squares{ dest.data(), N, frames };
+      _ma(squares);
+
+      for (std::size_t ch = 0; ch != N; ++ch)
+      {
+         float* dest = squares[ch].begin();
+         detail::fast_a2db(dest, dest, frames);
+         for (std::size_t i = 0; i != frames; ++i)
+            dest[i] *= 0.5f;
+         _db[ch] = dest[frames - 1];
+      }
+   }
+
+   template <std::size_t N>
+   inline void fast_rms_envelope_follower_bank<N>::operator()(
+      audio_channels<float> const& inout)
+   {
+      process(inout, inout);
+   }
+
+   template <std::size_t N>
+   inline void fast_rms_envelope_follower_bank<N>::operator()(
+      audio_channels<float const> const& in
+    , audio_channels<float> const& out
+   )
+   {
+      process(in, out);
+   }
+}
+
+#endif
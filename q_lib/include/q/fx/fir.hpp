@@ -0,0 +1,359 @@
+/*=============================================================================
+   Copyright (c) 2014-2020 Joel de Guzman. All rights reserved.
+
+   Distributed under the MIT License [ https://opensource.org/licenses/MIT ]
+=============================================================================*/
+#if !defined(CYCFI_Q_FIR_OCTOBER_18_2026)
+#define CYCFI_Q_FIR_OCTOBER_18_2026
+
+#include <q/support/base.hpp>
+#include <q/support/literals.hpp>
+#include <q/utility/window.hpp>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+
+namespace cycfi::q
+{
+   ////////////////////////////////////////////////////////////////////////////
+   // fir: Direct form FIR filter, for the short to medium length (up to a
+   // few hundred taps) linear phase filters used in crossovers and
+   // anti-imaging stages. For long impulse responses, use the convolver.
+   //
+   // The delay line is a linear buffer holding the last size-1 input
+   // samples (the history), followed by room for at least size new
+   // samples (hence, at least double the filter size). New samples are
+   // appended after the history, so the taps of any output sample are
+   // always contiguous in memory. When the buffer is full, the history is
+   // moved back to the front, once every (at least) size samples.
+   //
+   // process(...) appends a whole chunk of input, then computes the
+   // outputs tap by tap, in tiles of 32 outputs accumulated in a local
+   // array. The inner loop runs over the outputs of the tile, with a single
+   // coefficient and contiguous reads, which the compiler vectorizes
+   // without reassociating any sums.
+   //
+   // If the coefficients are symmetric (h[k] == h[size-1-k], i.e. linear
+   // phase, such as the windowed-sinc designs below), the two samples
+   // sharing a coefficient are added before multiplying, halving the
+   // number of multiplies.
+   //
+   //    T: sample and coefficient type (float or double).
+   ////////////////////////////////////////////////////////////////////////////
+   template <typename T = float>
+   class fir
+   {
+   public:
+
+      static constexpr std::size_t min_chunk_size = 64;
+
+                              fir(T const* h, std::size_t size);
+
+                              fir(std::vector<T> const& h)
+                               : fir(h.data(), h.size())
+                              {}
+
+      T                       operator()(T s);
+      void                    process(T const* in, T* out, std::size_t n);
+      void                    process(T* inout, std::size_t n);
+
+      std::size_t             size() const         { return _h.size(); }
+      std::size_t             latency() const      { return (_h.size() - 1) / 2; }
+      bool                    symmetric() const    { return _symmetric; }
+      std::vector<T> const&   coefficients() const { return _h; }
+      void                    reset();
+
+   private:
+
+      void                    compute(T* out, std::size_t n) const;
+      void                    rewind();
+
+      std::vector<T>          _h;         // coefficients
+      std::vector<T>          _x;         // delay line: history + new samples
+      std::size_t             _pos;       // position of the next new sample
+      bool                    _symmetric;
+   };
+
+   ////////////////////////////////////////////////////////////////////////////
+   // Windowed-sinc FIR design. These return the coefficients of a linear
+   // phase lowpass, highpass, bandpass or bandstop filter of the given
+   // size, windowed by any of the window functions in window.hpp (the
+   // default is the blackman_window). The passband gain is normalized to 1
+   // (0 dB).
+   //
+   // The highpass and bandstop designs use spectral inversion, which needs
+   // an odd size (an even size is rounded up to the next odd number).
+   //
+   //    fir<> f{ sinc_lowpass(2_kHz, sps, 127) };
+   ////////////////////////////////////////////////////////////////////////////
+   template <typename T = float, typename Window = blackman_window>
+   std::vector<T> sinc_lowpass(
+      frequency f, std::uint32_t sps, std::size_t size, Window w = {});
+
+   template <typename T = float, typename Window = blackman_window>
+   std::vector<T> sinc_highpass(
+      frequency f, std::uint32_t sps, std::size_t size, Window w = {});
+
+   template <typename T = float, typename Window = blackman_window>
+   std::vector<T> sinc_bandpass(
+      frequency f1, frequency f2, std::uint32_t sps, std::size_t size
+    , Window w = {});
+
+   template <typename T = float, typename Window = blackman_window>
+   std::vector<T> sinc_bandstop(
+      frequency f1, frequency f2, std::uint32_t sps, std::size_t size
+    , Window w = {});
+
+   ////////////////////////////////////////////////////////////////////////////
+   // Implementation
+   ////////////////////////////////////////////////////////////////////////////
+   template <typename T>
+   inline fir<T>::fir(T const* h, std::size_t size)
+    : _h(h, h + std::max<std::size_t>(size, 1))
+    , _x((_h.size() - 1) + std::max(_h.size(), min_chunk_size), T(0))
+    , _pos(_h.size() - 1)
+    , _symmetric(true)
+   {
+      if (size == 0)
+         _h[0] = T(0);
+      auto const n = _h.size();
+      for (std::size_t k = 0; k != n / 2; ++k)
+      {
+         if (_h[k] != _h[n - 1 - k])
+         {
+            _symmetric = false;
+            break;
+         }
+      }
+   }
+
+   template <typename T>
+   inline void fir<T>::reset()
+   {
+      std::fill(_x.begin(), _x.end(), T(0));
+      _pos = _h.size() - 1;
+   }
+
+   template <typename T>
+   inline void fir<T>::rewind()
+   {
+      // Move the history (the last size-1 samples) back to the front
+      auto const history = _h.size() - 1;
+      std::copy(_x.begin() + (_pos - history), _x.begin() + _pos, _x.begin());
+      _pos = history;
+   }
+
+   template <typename T>
+   inline T fir<T>::operator()(T s)
+   {
+      if (_pos == _x.size())
+         rewind();
+      _x[_pos++] = s;
+
+      // The taps are x[0] (the oldest) to x[n-1] (the latest sample)
+      auto const n = _h.size();
+      T const* x = &_x[_pos - n];
+      T const* h = _h.data();
+      T y = 0;
+      if (_symmetric)
+      {
+         auto const half = n / 2;
+         for (std::size_t k = 0; k != half; ++k)
+            y += h[k] * (x[n - 1 - k] + x[k]);
+         if (n & 1)
+            y += h[half] * x[half];
+      }
+      else
+      {
+         for (std::size_t k = 0; k != n; ++k)
+            y += h[k] * x[n - 1 - k];
+      }
+      return y;
+   }
+
+   namespace detail
+   {
+      // Compute m outputs of the FIR h (of size n), given the input x. The
+      // taps of out[i] are x[i] (the oldest) to x[i + n - 1]. The outputs
+      // are accumulated in acc, which is a local array if M (the number of
+      // outputs) is known at compile time, so that it can be kept in
+      // registers.
+      template <typename T, std::size_t M>
+      inline void fir_compute(
+         T const* h, std::size_t n, bool symmetric
+       , T const* x, T* out, std::size_t m = M)
+      {
+         T local[M == 0? 1 : M];
+         T* acc = (M == 0)? out : local;
+         if constexpr(M != 0)
+            m = M;
+
+         if (symmetric)
+         {
+            auto const half = n / 2;
+            auto const hk = (n & 1)? h[half] : T(0);
+            for (std::size_t i = 0; i != m; ++i)
+               acc[i] = hk * x[i + half];
+            for (std::size_t k = 0; k != half; ++k)
+            {
+               auto const hk = h[k];
+               T const* a = x + (n - 1 - k);
+               T const* b = x + k;
+               for (std::size_t i = 0; i != m; ++i)
+                  acc[i] += hk * (a[i] + b[i]);
+            }
+         }
+         else
+         {
+            for (std::size_t i = 0; i != m; ++i)
+               acc[i] = 0;
+            for (std::size_t k = 0; k != n; ++k)
+            {
+               auto const hk = h[k];
+               T const* a = x + (n - 1 - k);
+               for (std::size_t i = 0; i != m; ++i)
+                  acc[i] += hk * a[i];
+            }
+         }
+
+         if constexpr(M != 0)
+         {
+            for (std::size_t i = 0; i != M; ++i)
+               out[i] = acc[i];
+         }
+      }
+   }
+
+   template <typename T>
+   inline void fir<T>::compute(T* out, std::size_t m) const
+   {
+      // Compute the outputs of the latest m samples, in tiles, then the
+      // rest.
+      constexpr std::size_t tile_size = 32;
+      auto const n = _h.size();
+      T const* x = &_x[_pos - m - (n - 1)];
+      T const* h = _h.data();
+
+      std::size_t i = 0;
+      for (; i + tile_size <= m; i += tile_size)
+         detail::fir_compute<T, tile_size>(h, n, _symmetric, x + i, out + i);
+      if (i != m)
+         detail::fir_compute<T, 0>(h, n, _symmetric, x + i, out + i, m - i);
+   }
+
+   template <typename T>
+   inline void fir<T>::process(T const* in, T* out, std::size_t n)
+   {
+      while (n != 0)
+      {
+         if (_pos == _x.size())
+            rewind();
+
+         // Append as many samples as there is room for, then compute
+         // their outputs. in is fully consumed before out is written, so
+         // in and out may be the same buffer.
+         auto const m = std::min(n, _x.size() - _pos);
+         std::copy(in, in + m, _x.begin() + _pos);
+         _pos += m;
+         compute(out, m);
+
+         in += m;
+         out += m;
+         n -= m;
+      }
+   }
+
+   template <typename T>
+   inline void fir<T>::process(T* inout, std::size_t n)
+   {
+      process(inout, inout, n);
+   }
+
+   namespace detail
+   {
+      // Windowed sinc lowpass, cutoff fc (normalized to sps), with a DC
+      // gain of 1. The coefficients are computed for the first half, then
+      // mirrored, so that the result is exactly symmetric.
+      template <typename Window>
+      std::vector<double> sinc_lowpass(double fc, std::size_t size, Window w)
+      {
+         std::vector<double> h(size);
+         double const mid = (size - 1) / 2.0;
+         for (std::size_t i = 0; i != (size + 1) / 2; ++i)
+         {
+            auto const t = i - mid;
+            auto const s = (t == 0)?
+               2 * fc : std::sin(2 * pi * fc * t) / (pi * t);
+            h[i] = h[size - 1 - i] = s * window_symmetric(w, i, size);
+         }
+         double sum = 0;
+         for (auto v : h)
+            sum += v;
+         for (auto& v : h)
+            v /= sum;
+         return h;
+      }
+
+      // Spectral inversion: delta - h. h must have an odd size.
+      inline void spectral_invert(std::vector<double>& h)
+      {
+         for (auto& v : h)
+            v = -v;
+         h[h.size() / 2] += 1.0;
+      }
+
+      template <typename T>
+      std::vector<T> fir_coefficients(std::vector<double> const& h)
+      {
+         return std::vector<T>(h.begin(), h.end());
+      }
+   }
+
+   template <typename T, typename Window>
+   inline std::vector<T> sinc_lowpass(
+      frequency f, std::uint32_t sps, std::size_t size, Window w)
+   {
+      return detail::fir_coefficients<T>(
+         detail::sinc_lowpass(double(f) / sps, std::max<std::size_t>(size, 1), w));
+   }
+
+   template <typename T, typename Window>
+   inline std::vector<T> sinc_highpass(
+      frequency f, std::uint32_t sps, std::size_t size, Window w)
+   {
+      auto h = detail::sinc_lowpass(double(f) / sps, size | 1, w);
+      detail::spectral_invert(h);
+      return detail::fir_coefficients<T>(h);
+   }
+
+   template <typename T, typename Window>
+   inline std::vector<T> sinc_bandpass(
+      frequency f1, frequency f2, std::uint32_t sps, std::size_t size
+    , Window w)
+   {
+      // The lowpass at f2 less the lowpass at f1
+      size = std::max<std::size_t>(size, 1);
+      auto h = detail::sinc_lowpass(double(f2) / sps, size, w);
+      auto const lp = detail::sinc_lowpass(double(f1) / sps, size, w);
+      for (std::size_t i = 0; i != size; ++i)
+         h[i] -= lp[i];
+      return detail::fir_coefficients<T>(h);
+   }
+
+   template <typename T, typename Window>
+   inline std::vector<T> sinc_bandstop(
+      frequency f1, frequency f2, std::uint32_t sps, std::size_t size
+    , Window w)
+   {
+      // The lowpass at f1 plus the highpass at f2
+      size |= 1;
+      auto lp = detail::sinc_lowpass(double(f1) / sps, size, w);
+      auto hp = detail::sinc_lowpass(double(f2) / sps, size, w);
+      detail::spectral_invert(hp);
+      for (std::size_t i = 0; i != size; ++i)
+         lp[i] += hp[i];
+      return detail::fir_coefficients<T>(lp);
+   }
+}
+
+#endif
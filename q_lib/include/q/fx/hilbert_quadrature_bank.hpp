@@ -0,0 +1,124 @@
+/*=============================================================================
+   Copyright (c) 2014-2020 Joel de Guzman. All rights reserved.
+
+   Distributed under the MIT License [ https://opensource.org/licenses/MIT ]
+=============================================================================*/
+#if !defined(CYCFI_Q_HILBERT_QUADRATURE_BANK_OCTOBER_18_2026)
+#define CYCFI_Q_HILBERT_QUADRATURE_BANK_OCTOBER_18_2026
+
+#include <q/fx/special.hpp>
+#include <q/support/audio_stream.hpp>
+#include <infra/assert.hpp>
+#include <algorithm>
+#include <array>
+
+namespace cycfi::q
+{
+   ////////////////////////////////////////////////////////////////////////////
+   // hilbert_quadrature_bank: N hilbert_quadrature filters, one per
+   // channel.
+   //
+   // Like hilbert_quadrature::process, the two allpass chains run two
+   // samples at a time, but here for all N channels side by side: 4 * N
+   // SIMD lanes (see detail::hilbert_lanes). The default, 4 channels, is 16
+   // lanes: four 4 wide, two 8 wide or one 16 wide instruction per
+   // operation, depending on the target's SIMD width.
+   //
+   // The bank processes non-interleaved audio_channels buffers directly,
+   // writing the I (in-phase) and Q (quadrature) outputs to separate
+   // buffers. The results are the same as those of N hilbert_quadrature
+   // filters.
+   ////////////////////////////////////////////////////////////////////////////
+   template <std::size_t N = 4>
+   class hilbert_quadrature_bank
+   {
+   public:
+
+      static_assert(N > 0, "Error: N must be greater than zero");
+
+      static constexpr std::size_t num_channels = N;
+
+                              hilbert_quadrature_bank();
+
+      template <typename In>
+      void                    process(
+                                 In const& in
+                               , audio_channels<float> const& i_out
+                               , audio_channels<float> const& q_out
+                              );
+
+      void                    reset();
+
+   private:
+
+      using lanes = detail::hilbert_lanes<N>;
+
+      lanes                   _s;
+      std::array<float, N>    _dly;
+   };
+
+   ////////////////////////////////////////////////////////////////////////////
+   // Implementation
+   ////////////////////////////////////////////////////////////////////////////
+   template <std::size_t N>
+   inline hilbert_quadrature_bank<N>::hilbert_quadrature_bank()
+   {
+      hilbert_quadrature const h;
+      float const coeffs[2][lanes::sections] =
+      {
+         { h._a.a, h._b.a, h._c.a, h._d.a }
+       , { h._w.a, h._x.a, h._y.a, h._z.a }
+      };
+      for (std::size_t k = 0; k != lanes::sections; ++k)
+         for (std::size_t l = 0; l != lanes::size; ++l)
+            _s.a[k][l] = coeffs[l / (2 * N)][k];
+      reset();
+   }
+
+   template <std::size_t N>
+   inline void hilbert_quadrature_bank<N>::reset()
+   {
+      for (std::size_t k = 0; k != lanes::sections; ++k)
+      {
+         std::fill(std::begin(_s.x[k]), std::end(_s.x[k]), 0.0f);
+         std::fill(std::begin(_s.y[k]), std::end(_s.y[k]), 0.0f);
+      }
+      _dly.fill(0.0f);
+   }
+
+   template <std::size_t N>
+   template <typename In>
+   inline void hilbert_quadrature_bank<N>::process(
+      In const& in
+    , audio_channels<float> const& i_out
+    , audio_channels<float> const& q_out
+   )
+   {
+      CYCFI_ASSERT(
+         in.size() >= N && i_out.size() >= N && q_out.size() >= N
+       , "Not enough channels."
+      );
+
+      auto const frames = std::min(
+         { in.frames().last, i_out.frames().last, q_out.frames().last });
+
+      // Keep the state in locals for the whole block.
+      auto s = _s;
+      auto d = _dly;
+      std::array<float const*, N> src;
+      std::array<float*, N> dest_i, dest_q;
+      for (std::size_t ch = 0; ch != N; ++ch)
+      {
+         src[ch] = in[ch].begin();
+         dest_i[ch] = i_out[ch].begin();
+         dest_q[ch] = q_out[ch].begin();
+      }
+
+      s.process(src.data(), dest_i.data(), dest_q.data(), d.data(), frames);
+
+      _s = s;
+      _dly = d;
+   }
+}
+
+#endif
@@ -0,0 +1,271 @@
+/*=============================================================================
+   Copyright (c) 2014-2020 Joel de Guzman. All rights reserved.
+
+   Distributed under the MIT License [ https://opensource.org/licenses/MIT ]
+=============================================================================*/
+#if !defined(CYCFI_Q_LOOKAHEAD_LIMITER_OCTOBER_18_2026)
+#define CYCFI_Q_LOOKAHEAD_LIMITER_OCTOBER_18_2026
+
+#include <q/support/base.hpp>
+#include <q/support/decibel.hpp>
+#include <q/support/audio_stream.hpp>
+#include <q/fx/moving_maximum.hpp>
+#include <q/fx/moving_average.hpp>
+#include <q/detail/recurrence.hpp>
+#include <infra/assert.hpp>
+#include <algorithm>
+#include <vector>
+#include <cmath>
+
+namespace cycfi::q
+{
+   ////////////////////////////////////////////////////////////////////////////
+   // lookahead_limiter: a brickwall limiter. The output never exceeds the
+   // ceiling. The signal is delayed by the lookahead time (see latency()),
+   // so that the gain is already down when a peak reaches the output.
+   //
+   // With L lookahead samples, the gain is computed in four stages:
+   //
+   //    1. The peak: the maximum of the magnitude of the latest L+1 samples
+   //       (moving_maximum).
+   //
+   //    2. The target gain: min(1, ceiling / peak). This is the gain
+   //       required by every sample in the window.
+   //
+   //    3. The release: the gain follows the target down immediately, and
+   //       back up exponentially (the release time). This is never above
+   //       the target.
+   //
+   //    4. The smoothing: the average of the latest L+1 gains
+   //       (moving_sum). This turns the attack into a smooth ramp, L
+   //       samples long.
+   //
+   // The sample delayed by L is in the window of all the L+1 averaged
+   // gains, so the average is not above the gain it requires, and the
+   // output (the delayed sample times the gain) is not above the ceiling.
+   // The output is also clamped to the ceiling, to take care of rounding
+   // errors.
+   //
+   // The limiter processes blocks of samples: each stage is a pass over a
+   // chunk of the block (moving_maximum and moving_sum process a block in
+   // O(1) time per sample, independent of the lookahead). The delay is a
+   // linear buffer: the lookahead history, followed by room for new
+   // samples.
+   //
+   // The limiter can process multiple channels, given the number of
+   // channels at construction. The channels are linked: a single gain,
+   // computed from the peak of all channels, is applied to all channels, so
+   // that the stereo (or multichannel) image does not shift.
+   ////////////////////////////////////////////////////////////////////////////
+   class lookahead_limiter
+   {
+   public:
+
+      static constexpr std::size_t chunk_size = 256;
+
+                              lookahead_limiter(
+                                 decibel ceiling
+                               , duration lookahead
+                               , duration release
+                               , std::uint32_t sps
+                               , std::size_t channels = 1
+                              );
+
+      float                   operator()(float s);
+      void                    process(float const* in, float* out, std::size_t n);
+      void                    process(float* inout, std::size_t n);
+
+      void                    operator()(audio_channels<float> const& inout);
+      template <typename In>
+      void                    operator()(In const& in, audio_channels<float> const& out);
+
+      std::size_t             latency() const      { return _lookahead; }
+      std::size_t             channels() const     { return _channels; }
+      float                   gain() const         { return _gain; }
+
+      void                    ceiling(decibel ceiling_);
+      void                    release(duration release_, std::uint32_t sps);
+      void                    reset();
+
+   private:
+
+      void                    process(
+                                 float const* const* src
+                               , float* const* dest
+                               , std::size_t frames
+                              );
+      void                    gains(float* g, std::size_t n);
+
+      std::size_t             _lookahead;
+      std::size_t             _channels;
+      std::size_t             _capacity;  // delay buffer size, per channel
+      std::size_t             _pos;       // position of the next new sample
+      std::vector<float>      _delay;     // per channel history + room
+      std::vector<float const*> _src;
+      std::vector<float*>     _dest;
+      moving_maximum<float>   _peak;
+      moving_sum              _smooth;
+      float                   _ceiling;   // linear
+      float                   _release;   // release coefficient
+      float                   _hold;      // release stage state
+      float                   _gain;      // latest gain
+   };
+
+   ////////////////////////////////////////////////////////////////////////////
+   // Implementation
+   ////////////////////////////////////////////////////////////////////////////
+   inline lookahead_limiter::lookahead_limiter(
+      decibel ceiling_
+    , duration lookahead
+    , duration release_
+    , std::uint32_t sps
+    , std::size_t channels
+   )
+    : _lookahead(std::size_t(std::ceil(double(lookahead) * sps)))
+    , _channels(std::max<std::size_t>(channels, 1))
+    , _capacity(_lookahead + std::max(_lookahead, 4 * chunk_size))
+    , _delay(_channels * _capacity)
+    , _src(_channels)
+    , _dest(_channels)
+    , _peak(_lookahead + 1)
+    , _smooth(_lookahead + 1)
+   {
+      ceiling(ceiling_);
+      release(release_, sps);
+      reset();
+   }
+
+   inline void lookahead_limiter::ceiling(decibel ceiling_)
+   {
+      _ceiling = float(ceiling_);
+   }
+
+   inline void lookahead_limiter::release(duration release_, std::uint32_t sps)
+   {
+      _release = fast_exp3(-2.0f / (sps * double(release_)));
+   }
+
+   inline void lookahead_limiter::reset()
+   {
+      std::fill(_delay.begin(), _delay.end(), 0.0f);
+      _pos = _lookahead;
+      _peak.reset();
+      _smooth.fill(1.0f);
+      _hold = 1.0f;
+      _gain = 1.0f;
+   }
+
+   inline void lookahead_limiter::gains(float* g, std::size_t n)
+   {
+      // g holds the magnitudes of the samples. See the stages above.
+      _peak.process(g, n);
+
+      auto const c = _ceiling;
+      for (std::size_t i = 0; i != n; ++i)
+         g[i] = c / std::max(g[i], c);
+
+      // The release: the hold follows the target down immediately, and
+      // back up exponentially.
+      using release_hold = detail::hold_recurrence<detail::select_min<float>>;
+      _hold = release_hold{ _release }(_hold, g, g, n);
+
+      _smooth.process(g, n);
+      float const window = _smooth.size();
+      for (std::size_t i = 0; i != n; ++i)
+         g[i] /= window;
+   }
+
+   inline void lookahead_limiter::process(
+      float const* const* src
+    , float* const* dest
+    , std::size_t frames
+   )
+   {
+      auto const c = _ceiling;
+      auto const lookahead = _lookahead;
+      for (std::size_t frame = 0; frame < frames;)
+      {
+         auto const n = std::min(chunk_size, frames - frame);
+
+         // The linked peak of all channels
+         float g[chunk_size];
+         for (std::size_t i = 0; i != n; ++i)
+            g[i] = std::abs(src[0][frame + i]);
+         for (std::size_t ch = 1; ch != _channels; ++ch)
+            for (std::size_t i = 0; i != n; ++i)
+               g[i] = std::max(g[i], std::abs(src[ch][frame + i]));
+
+         gains(g, n);
+
+         // Move the lookahead history back to the front when full
+         if (_pos + n > _capacity)
+         {
+            for (std::size_t ch = 0; ch != _channels; ++ch)
+            {
+               float* d = &_delay[ch * _capacity];
+               std::copy(d + _pos - lookahead, d + _pos, d);
+            }
+            _pos = lookahead;
+         }
+
+         // Append the new samples first, so that src and dest may be the
+         // same buffers, then apply the gains to the delayed samples.
+         for (std::size_t ch = 0; ch != _channels; ++ch)
+         {
+            float* d = &_delay[ch * _capacity] + _pos;
+            std::copy(src[ch] + frame, src[ch] + frame + n, d);
+            float const* delayed = d - lookahead;
+            float* out = dest[ch] + frame;
+            for (std::size_t i = 0; i != n; ++i)
+               out[i] = std::clamp(delayed[i] * g[i], -c, c);
+         }
+
+         _pos += n;
+         _gain = g[n - 1];
+         frame += n;
+      }
+   }
+
+   inline void lookahead_limiter::process(float const* in, float* out, std::size_t n)
+   {
+      CYCFI_ASSERT(_channels == 1, "Invalid number of channels.");
+      process(&in, &out, n);
+   }
+
+   inline void lookahead_limiter::process(float* inout, std::size_t n)
+   {
+      process(inout, inout, n);
+   }
+
+   inline float lookahead_limiter::operator()(float s)
+   {
+      float y;
+      process(&s, &y, 1);
+      return y;
+   }
+
+   template <typename In>
+   inline void lookahead_limiter::operator()(
+      In const& in, audio_channels<float> const& out)
+   {
+      CYCFI_ASSERT(
+         in.size() >= _channels && out.size() >= _channels
+       , "Not enough channels."
+      );
+
+      auto const frames = std::min(in.frames().last, out.frames().last);
+      for (std::size_t ch = 0; ch != _channels; ++ch)
+      {
+         _src[ch] = in[ch].begin();
+         _dest[ch] = out[ch].begin();
+      }
+      process(_src.data(), _dest.data(), frames);
+   }
+
+   inline void lookahead_limiter::operator()(audio_channels<float> const& inout)
+   {
+      (*this)(inout, inout);
+   }
+}
+
+#endif
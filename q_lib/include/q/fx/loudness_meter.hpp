@@ -0,0 +1,543 @@
+/*=============================================================================
+   Copyright (c) 2014-2020 Joel de Guzman. All rights reserved.
+
+   Distributed under the MIT License [ https://opensource.org/licenses/MIT ]
+=============================================================================*/
+#if !defined(CYCFI_Q_LOUDNESS_METER_OCTOBER_18_2026)
+#define CYCFI_Q_LOUDNESS_METER_OCTOBER_18_2026
+
+#include <q/support/base.hpp>
+#include <q/support/audio_stream.hpp>
+#include <q/fx/sos_cascade.hpp>
+#include <q/fx/moving_average.hpp>
+#include <infra/assert.hpp>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace cycfi::q
+{
+   ////////////////////////////////////////////////////////////////////////////
+   // k_weighting: the K-weighting filter of ITU-R BS.1770: a high shelf
+   // (+4 dB, the acoustic effect of the head) followed by a highpass (the
+   // revised low frequency B-weighting curve, RLB), as a cascade of two
+   // biquads. The coefficients are computed for any sample rate, from the
+   // analog prototypes of the 48kHz coefficients given in BS.1770.
+   ////////////////////////////////////////////////////////////////////////////
+   struct k_weighting : sos_cascade<2>
+   {
+      k_weighting(std::uint32_t sps)
+      {
+         config(sps);
+      }
+
+      void config(std::uint32_t sps)
+      {
+         {
+            // High shelf
+            constexpr double f0 = 1681.974450955533;
+            constexpr double g = 3.999843853973347;
+            constexpr double q = 0.7071752369554196;
+
+            auto const k = std::tan(pi * f0 / sps);
+            auto const vh = std::pow(10.0, g / 20.0);
+            auto const vb = std::pow(vh, 0.4996667741545416);
+            auto const a0 = 1.0 + k / q + k * k;
+            sos_cascade::config(
+               0
+             , (vh + vb * k / q + k * k) / a0
+             , 2.0 * (k * k - vh) / a0
+             , (vh - vb * k / q + k * k) / a0
+             , 2.0 * (k * k - 1.0) / a0
+             , (1.0 - k / q + k * k) / a0
+            );
+         }
+         {
+            // Highpass (RLB)
+            constexpr double f0 = 38.13547087602444;
+            constexpr double q = 0.5003270373238773;
+
+            auto const k = std::tan(pi * f0 / sps);
+            auto const a0 = 1.0 + k / q + k * k;
+            sos_cascade::config(
+               1
+             , 1.0, -2.0, 1.0
+             , 2.0 * (k * k - 1.0) / a0
+             , (1.0 - k / q + k * k) / a0
+            );
+         }
+      }
+   };
+
+   namespace detail
+   {
+      // Loudness, in LUFS, of the (weighted) mean square, z
+      inline double lufs(double z)
+      {
+         if (z <= 0.0)
+            return -std::numeric_limits<double>::infinity();
+         return -0.691 + 10.0 * std::log10(z);
+      }
+
+      /////////////////////////////////////////////////////////////////////////
+      // loudness_histogram: the loudness of the gating blocks, from -70
+      // LUFS (the absolute gate) to +30 LUFS, in 0.1 LU bins. Each bin keeps
+      // the number of blocks and the sum of their mean squares, so the
+      // gated loudness is the exact energy mean of the bins above the gate.
+      // This is constant memory, whatever the length of the measurement.
+      // The relative gate is resolved to the nearest bin edge.
+      /////////////////////////////////////////////////////////////////////////
+      class loudness_histogram
+      {
+      public:
+
+         static constexpr double min_lufs = -70.0;
+         static constexpr double bin_width = 0.1;
+         static constexpr std::size_t num_bins = 1000;
+
+                              loudness_histogram() { clear(); }
+
+         void                 add(double z);
+         void                 clear();
+
+         // The mean square of the blocks above the relative gate, given in
+         // LU, relative to the mean of the blocks above the absolute gate.
+         double               gated_mean(double relative_gate) const;
+
+         // The loudness of the pth percentile (0 to 1) of the blocks above
+         // the relative gate.
+         double               percentile(double relative_gate, double p) const;
+
+      private:
+
+         std::size_t          gate_bin(double relative_gate) const;
+
+         std::array<std::uint64_t, num_bins> _count;
+         std::array<double, num_bins> _sum;
+      };
+   }
+
+   class loudness_meter;
+
+   // See measure_loudness below
+   template <typename Reader>
+   loudness_meter             measure_loudness(char const* filename, std::size_t threads = 0);
+
+   ////////////////////////////////////////////////////////////////////////////
+   // loudness_meter: EBU R128 loudness (ITU-R BS.1770-4, EBU Tech 3341 and
+   // 3342), in LUFS (and LU, for the loudness range):
+   //
+   //    momentary():       mean square over 400ms
+   //    short_term():      mean square over 3s
+   //    integrated():      gated mean of the 400ms blocks (75% overlap),
+   //                       absolute gate at -70 LUFS, relative gate at -10 LU
+   //    loudness_range():  the 10th to 95th percentile spread of the 3s
+   //                       blocks (every 100ms), relative gate at -20 LU
+   //
+   // Each channel is K-weighted (k_weighting), squared and weighted by its
+   // channel weight. The weighted sum of squares is accumulated over 100ms
+   // steps. The 400ms and 3s windows are moving sums (moving_sum, with
+   // double precision) of the last 4 and 30 steps. So the meter updates
+   // every 100ms, the rate of the gating blocks, and the momentary and
+   // short-term loudness are the loudness of the latest gating block and
+   // the latest 3s block. The windows start filled with silence. Only
+   // complete windows are used for the integrated loudness and the
+   // loudness range (and the max_momentary and max_short_term loudness).
+   //
+   // The integrated loudness and loudness range keep the gating blocks in
+   // loudness histograms (detail::loudness_histogram), so the memory use is
+   // constant.
+   //
+   // The channel weights are 1 (0 dB) for the front channels, 1.41 (+1.5
+   // dB) for the surround channels and 0 for the LFE, with the 5.1 channel
+   // order (L, R, C, LFE, Ls, Rs). Otherwise, the weights are all 1. These
+   // can be changed using channel_weight(channel, weight).
+   //
+   // For files, measure_loudness (below) does the K-weighting in parallel.
+   ////////////////////////////////////////////////////////////////////////////
+   class loudness_meter
+   {
+   public:
+
+      static constexpr std::size_t momentary_steps = 4;     // 400ms
+      static constexpr std::size_t short_term_steps = 30;   // 3s
+      static constexpr std::size_t chunk_size = 256;
+
+                              loudness_meter(std::uint32_t sps, std::size_t channels = 2);
+
+      void                    process(float const* in, std::size_t n);
+      template <typename In>
+      void                    operator()(In const& in);
+
+      double                  momentary() const;
+      double                  short_term() const;
+      double                  integrated() const;
+      double                  loudness_range() const;
+      double                  max_momentary() const   { return _max_momentary; }
+      double                  max_short_term() const  { return _max_short_term; }
+
+      std::size_t             channels() const        { return _filters.size(); }
+      std::size_t             step_size() const       { return _step; }
+      void                    channel_weight(std::size_t channel, float weight);
+      void                    reset();
+
+   private:
+
+      template <typename Reader>
+      friend loudness_meter   measure_loudness(char const* filename, std::size_t threads);
+
+      void                    process(float const* const* src, std::size_t frames);
+      void                    add_step(double sum);
+
+      std::size_t             _step;      // 100ms, in samples
+      std::size_t             _pos;       // samples in the current step
+      double                  _sum;       // of the current step
+      std::size_t             _steps;     // number of steps, saturated
+      std::vector<k_weighting> _filters;
+      std::vector<float>      _weights;
+      std::vector<float const*> _src;
+      basic_moving_sum<double> _momentary;
+      basic_moving_sum<double> _short_term;
+      detail::loudness_histogram _blocks;      // 400ms blocks
+      detail::loudness_histogram _st_blocks;   // 3s blocks
+      double                  _max_momentary;
+      double                  _max_short_term;
+   };
+
+   ////////////////////////////////////////////////////////////////////////////
+   // measure_loudness: the loudness of a whole file, offline. Reader is the
+   // audio file reader (e.g. wav_reader), constructed from the filename,
+   // with the sps(), num_channels(), length(), seek(sample) and read(data,
+   // len) member functions, counting interleaved samples.
+   //
+   // The K-weighting and the sums of squares are the costly part. These are
+   // done in parallel by the given number of threads (by default, one per
+   // core), each with its own reader, on consecutive stretches of the file,
+   // split at 100ms steps. Each thread starts 500ms ahead of its stretch,
+   // for the filters to settle (the K-weighting impulse response is well
+   // below float precision by then), so the results match the streaming
+   // loudness_meter. The step sums are then passed on to the returned
+   // loudness_meter, for the gating.
+   //
+   // Throws std::runtime_error if the file cannot be opened or read (e.g.
+   // a truncated file).
+   ////////////////////////////////////////////////////////////////////////////
+   template <typename Reader>
+   loudness_meter             measure_loudness(char const* filename, std::size_t threads);
+
+   ////////////////////////////////////////////////////////////////////////////
+   // Implementation
+   ////////////////////////////////////////////////////////////////////////////
+   namespace detail
+   {
+      inline void loudness_histogram::clear()
+      {
+         _count.fill(0);
+         _sum.fill(0.0);
+      }
+
+      inline void loudness_histogram::add(double z)
+      {
+         auto const l = lufs(z);
+         if (!(l > min_lufs))
+            return;                 // absolute gate
+         auto const i = std::min(
+            std::size_t((l - min_lufs) / bin_width), num_bins - 1);
+         ++_count[i];
+         _sum[i] += z;
+      }
+
+      inline std::size_t loudness_histogram::gate_bin(double relative_gate) const
+      {
+         std::uint64_t count = 0;
+         double sum = 0.0;
+         for (std::size_t i = 0; i != num_bins; ++i)
+         {
+            count += _count[i];
+            sum += _sum[i];
+         }
+         if (count == 0)
+            return num_bins;
+
+         auto const gate = lufs(sum / count) + relative_gate;
+         auto const i = std::round((gate - min_lufs) / bin_width);
+         return std::size_t(std::clamp<double>(i, 0, num_bins));
+      }
+
+      inline double loudness_histogram::gated_mean(double relative_gate) const
+      {
+         std::uint64_t count = 0;
+         double sum = 0.0;
+         for (auto i = gate_bin(relative_gate); i < num_bins; ++i)
+         {
+            count += _count[i];
+            sum += _sum[i];
+         }
+         return (count == 0)? 0.0 : sum / count;
+      }
+
+      inline double loudness_histogram::percentile(
+         double relative_gate, double p) const
+      {
+         auto const first = gate_bin(relative_gate);
+         std::uint64_t count = 0;
+         for (auto i = first; i < num_bins; ++i)
+            count += _count[i];
+         if (count == 0)
+            return -std::numeric_limits<double>::infinity();
+
+         // The loudness (bin center) of the block at rank p * (count - 1)
+         auto const rank = std::uint64_t(std::round(p * (count - 1)));
+         std::uint64_t seen = 0;
+         for (auto i = first; i < num_bins; ++i)
+         {
+            seen += _count[i];
+            if (seen > rank)
+               return min_lufs + (i + 0.5) * bin_width;
+         }
+         return min_lufs + num_bins * bin_width;
+      }
+   }
+
+   inline loudness_meter::loudness_meter(std::uint32_t sps, std::size_t channels)
+    : _step(sps / 10)
+    , _filters(std::max<std::size_t>(channels, 1), k_weighting{ sps })
+    , _weights(_filters.size(), 1.0f)
+    , _src(_filters.size())
+    , _momentary(momentary_steps)
+    , _short_term(short_term_steps)
+   {
+      if (_weights.size() == 6)
+      {
+         _weights[3] = 0.0f;     // LFE
+         _weights[4] = 1.41f;    // Ls
+         _weights[5] = 1.41f;    // Rs
+      }
+      reset();
+   }
+
+   inline void loudness_meter::channel_weight(std::size_t channel, float weight)
+   {
+      CYCFI_ASSERT(channel < _weights.size(), "Invalid channel.");
+      _weights[channel] = weight;
+   }
+
+   inline void loudness_meter::reset()
+   {
+      for (auto& f : _filters)
+         f.reset();
+      _pos = 0;
+      _sum = 0.0;
+      _steps = 0;
+      _momentary.clear();
+      _short_term.clear();
+      _blocks.clear();
+      _st_blocks.clear();
+      _max_momentary = -std::numeric_limits<double>::infinity();
+      _max_short_term = -std::numeric_limits<double>::infinity();
+   }
+
+   inline double loudness_meter::momentary() const
+   {
+      return detail::lufs(_momentary.sum() / (momentary_steps * _step));
+   }
+
+   inline double loudness_meter::short_term() const
+   {
+      return detail::lufs(_short_term.sum() / (short_term_steps * _step));
+   }
+
+   inline double loudness_meter::integrated() const
+   {
+      return detail::lufs(_blocks.gated_mean(-10.0));
+   }
+
+   inline double loudness_meter::loudness_range() const
+   {
+      auto const low = _st_blocks.percentile(-20.0, 0.10);
+      auto const high = _st_blocks.percentile(-20.0, 0.95);
+      return std::isfinite(low)? high - low : 0.0;
+   }
+
+   inline void loudness_meter::add_step(double sum)
+   {
+      _momentary(sum);
+      _short_term(sum);
+      _steps = std::min(_steps + 1, short_term_steps);
+
+      if (_steps >= momentary_steps)
+      {
+         auto const z = _momentary.sum() / (momentary_steps * _step);
+         _blocks.add(z);
+         _max_momentary = std::max(_max_momentary, detail::lufs(z));
+      }
+      if (_steps >= short_term_steps)
+      {
+         auto const z = _short_term.sum() / (short_term_steps * _step);
+         _st_blocks.add(z);
+         _max_short_term = std::max(_max_short_term, detail::lufs(z));
+      }
+   }
+
+   namespace detail
+   {
+      // The weighted sum of squares of the K-weighted x, filtered in place
+      inline double k_weighted_sum(
+         k_weighting& filter, float* x, std::size_t n, float weight)
+      {
+         filter.process(x, n);
+
+         // Eight partial sums, so this vectorizes
+         float acc[8] = {};
+         std::size_t i = 0;
+         for (; i + 8 <= n; i += 8)
+            for (std::size_t k = 0; k != 8; ++k)
+               acc[k] += x[i+k] * x[i+k];
+         for (std::size_t k = 0; i != n; ++i, ++k)
+            acc[k] += x[i] * x[i];
+
+         double sum = 0.0;
+         for (auto a : acc)
+            sum += a;
+         return sum * weight;
+      }
+   }
+
+   inline void loudness_meter::process(float const* const* src, std::size_t frames)
+   {
+      float buf[chunk_size];
+      std::size_t i = 0;
+      while (i != frames)
+      {
+         // Up to the end of the step, a chunk at a time
+         auto const n = std::min({ frames - i, _step - _pos, chunk_size });
+         for (std::size_t ch = 0; ch != _filters.size(); ++ch)
+         {
+            std::copy(src[ch] + i, src[ch] + i + n, buf);
+            _sum += detail::k_weighted_sum(_filters[ch], buf, n, _weights[ch]);
+         }
+
+         i += n;
+         _pos += n;
+         if (_pos == _step)
+         {
+            add_step(_sum);
+            _pos = 0;
+            _sum = 0.0;
+         }
+      }
+   }
+
+   inline void loudness_meter::process(float const* in, std::size_t n)
+   {
+      CYCFI_ASSERT(_filters.size() == 1, "Not a mono loudness_meter.");
+      process(&in, n);
+   }
+
+   template <typename In>
+   inline void loudness_meter::operator()(In const& in)
+   {
+      CYCFI_ASSERT(in.size() >= _filters.size(), "Not enough channels.");
+      for (std::size_t ch = 0; ch != _filters.size(); ++ch)
+         _src[ch] = in[ch].begin();
+      process(_src.data(), in.frames().last);
+   }
+
+   template <typename Reader>
+   inline loudness_meter measure_loudness(char const* filename, std::size_t threads)
+   {
+      Reader reader{ filename };
+      if (!reader || reader.num_channels() == 0)
+         throw std::runtime_error(
+            "Error: measure_loudness cannot open the file."
+         );
+
+      auto const sps = std::uint32_t(reader.sps());
+      auto const channels = reader.num_channels();
+      loudness_meter meter{ sps, channels };
+      auto const step = meter.step_size();
+      auto const num_steps = reader.length() / channels / step;
+      auto const preroll = sps / 2;
+
+      if (threads == 0)
+         threads = std::max(std::thread::hardware_concurrency(), 1u);
+      threads = std::max<std::size_t>(std::min<std::size_t>(threads, num_steps), 1);
+
+      // The sums of each step, each thread doing a stretch of steps
+      std::vector<double> sums(num_steps);
+      std::atomic<bool> failed{ false };
+      auto stretch = [&](std::size_t first, std::size_t last)
+      {
+         Reader reader{ filename };
+         std::vector<k_weighting> filters(channels, k_weighting{ sps });
+         std::vector<float> frames(loudness_meter::chunk_size * channels);
+         std::vector<float> buf(loudness_meter::chunk_size);
+
+         // Start ahead, for the filters to settle
+         auto const start = first * step;
+         auto const ahead = std::min<std::size_t>(start, preroll);
+         if (!reader || !reader.seek((start - ahead) * channels))
+         {
+            failed = true;
+            return;
+         }
+
+         // Reads and filters n frames, and returns their weighted sum of
+         // squares. A short read fails the measurement, rather than
+         // filtering the stale frames left in the buffer.
+         auto read = [&](std::size_t n)
+         {
+            double sum = 0.0;
+            if (reader.read(frames.data(), std::uint32_t(n * channels)) != n * channels)
+            {
+               failed = true;
+               return sum;
+            }
+            for (std::size_t ch = 0; ch != channels; ++ch)
+            {
+               for (std::size_t i = 0; i != n; ++i)
+                  buf[i] = frames[i * channels + ch];
+               sum += detail::k_weighted_sum(
+                  filters[ch], buf.data(), n, meter._weights[ch]);
+            }
+            return sum;
+         };
+
+         for (std::size_t i = 0; i < ahead && !failed; i += loudness_meter::chunk_size)
+            read(std::min(ahead - i, loudness_meter::chunk_size));
+
+         for (auto s = first; s != last && !failed; ++s)
+         {
+            double sum = 0.0;
+            for (std::size_t i = 0; i < step; i += loudness_meter::chunk_size)
+               sum += read(std::min(step - i, loudness_meter::chunk_size));
+            sums[s] = sum;
+         }
+      };
+
+      std::vector<std::thread> workers;
+      for (std::size_t t = 1; t < threads; ++t)
+         workers.emplace_back(
+            stretch, (num_steps * t) / threads, (num_steps * (t + 1)) / threads);
+      stretch(0, num_steps / threads);
+      for (auto& w : workers)
+         w.join();
+
+      if (failed)
+         throw std::runtime_error(
+            "Error: measure_loudness cannot read the file."
+         );
+
+      for (auto sum : sums)
+         meter.add_step(sum);
+      return meter;
+   }
+}
+
+#endif
@@ -8,6 +8,7 @@
 
 #include <q/support/base.hpp>
 #include <q/support/literals.hpp>
+#include <q/detail/recurrence.hpp>
 
 namespace cycfi::q
 {
@@ -76,6 +77,19 @@ namespace cycfi::q
          return y = s + a * (y - s);
       }
 
+      // Block processing. See detail::recurrence.
+      void process(float const* in, float* out, std::size_t n)
+      {
+         auto const b = 1.0f - a;
+         y = detail::recurrence{ a }(y, out, n,
+            [=](std::size_t i) { return b * in[i]; });
+      }
+
+      void process(float* inout, std::size_t n)
+      {
+         process(inout, inout, n);
+      }
+
       float operator()() const
       {
          return y;
@@ -113,6 +127,19 @@ namespace cycfi::q
          return y += a * (s - y);
       }
 
+      // Block processing. See detail::recurrence.
+      void process(float const* in, float* out, std::size_t n)
+      {
+         auto const a_ = a;
+         y = detail::recurrence{ 1.0f - a }(y, out, n,
+            [=](std::size_t i) { return a_ * in[i]; });
+      }
+
+      void process(float* inout, std::size_t n)
+      {
+         process(inout, inout, n);
+      }
+
       float operator()() const
       {
          return y;
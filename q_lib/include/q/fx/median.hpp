@@ -7,6 +7,9 @@
 #define CYCFI_Q_MEDIAN_DECEMBER_7_2018
 
 #include <q/support/base.hpp>
+#include <vector>
+#include <algorithm>
+#include <limits>
 
 namespace cycfi::q
 {
@@ -54,6 +57,141 @@ namespace cycfi::q
       float b = 0.0f;
       float c = 0.0f;
    };
+
+   ////////////////////////////////////////////////////////////////////////////
+   // moving_median: Returns the median of the latest size samples (for even
+   // sizes, the mean of the two middle samples). Like median3, the window
+   // starts filled with the initial median (default 0).
+   //
+   // The window is kept twice: in order of arrival (a ring buffer), to know
+   // which sample, old, leaves the window, and sorted, to find the median.
+   // Each new sample, s, replaces old in the sorted array, and the samples
+   // in between move by one place. Rather than searching for the positions
+   // (with unpredictable branches) and moving the samples in between,
+   // every element of the new sorted array, r, is computed directly from
+   // the old one, a, with min, max and compare-select operations only. If
+   // old < s:
+   //
+   //    r[k] = (a[k] < old)? a[k] : min(a[k+1], max(a[k], s))
+   //
+   // otherwise:
+   //
+   //    r[k] = (old < a[k])? a[k] : max(a[k-1], min(a[k], s))
+   //
+   // These are O(size) per sample, but with no branches and no dependency
+   // between elements, so the loops are vectorized: a sorted ring with SIMD
+   // insertion. For the window sizes used for cleaning pitch tracks and
+   // removing impulse noise (up to a few hundred samples), this is faster
+   // than O(log(size)) skiplists or heaps, which chase pointers and branch
+   // unpredictably.
+   //
+   // The sorted array is double buffered, with sentinels at both ends (for
+   // a[-1] and a[size]). All storage is allocated by the constructor; the
+   // function call operator and process do not allocate. NaNs are not
+   // allowed in the input.
+   ////////////////////////////////////////////////////////////////////////////
+   template <typename T = float>
+   class moving_median
+   {
+   public:
+
+                              moving_median(std::size_t size, T median_ = T{});
+
+      T                       operator()(T s);
+      T                       operator()() const   { return _median; }
+      moving_median&          operator=(T median_);
+
+      void                    process(T const* in, T* out, std::size_t n);
+      void                    process(T* inout, std::size_t n);
+
+      std::size_t             size() const         { return _ring.size(); }
+
+   private:
+
+      std::vector<T>          _ring;      // samples in order of arrival
+      std::vector<T>          _sorted;    // two sorted arrays, with sentinels
+      std::size_t             _pos = 0;   // oldest sample in _ring
+      std::size_t             _current = 0;  // offset of the current sorted array
+      T                       _median;
+   };
+
+   ////////////////////////////////////////////////////////////////////////////
+   // Implementation
+   ////////////////////////////////////////////////////////////////////////////
+   template <typename T>
+   inline moving_median<T>::moving_median(std::size_t size, T median_)
+    : _ring(std::max<std::size_t>(size, 1))
+    , _sorted((_ring.size() + 2) * 2)
+   {
+      *this = median_;
+   }
+
+   template <typename T>
+   inline moving_median<T>& moving_median<T>::operator=(T median_)
+   {
+      auto const n = _ring.size();
+      std::fill(_ring.begin(), _ring.end(), median_);
+      for (auto first = _sorted.begin(); first != _sorted.end(); first += n + 2)
+      {
+         first[0] = std::numeric_limits<T>::lowest();
+         std::fill(first + 1, first + n + 1, median_);
+         first[n + 1] = std::numeric_limits<T>::max();
+      }
+      _pos = 0;
+      _current = 0;
+      _median = median_;
+      return *this;
+   }
+
+   template <typename T>
+   inline T moving_median<T>::operator()(T s)
+   {
+      auto const n = _ring.size();
+      auto const old = _ring[_pos];
+      _ring[_pos] = s;
+      if (++_pos == n)
+         _pos = 0;
+
+      auto const next = (n + 2) - _current;
+      T const* a = &_sorted[_current + 1];
+      T* r = &_sorted[next + 1];
+      if (old < s)
+      {
+         for (std::size_t k = 0; k != n; ++k)
+         {
+            auto const x = a[k];
+            auto const y = std::min(a[k + 1], std::max(x, s));
+            r[k] = (x < old)? x : y;
+         }
+      }
+      else
+      {
+         for (std::size_t k = 0; k != n; ++k)
+         {
+            auto const x = a[k];
+            auto const y = std::max(a[k - 1], std::min(x, s));
+            r[k] = (old < x)? x : y;
+         }
+      }
+      _current = next;
+
+      auto const mid = r[n / 2];
+      _median = (n % 2)? mid : (r[n / 2 - 1] + mid) / 2;
+      return _median;
+   }
+
+   template <typename T>
+   inline void moving_median<T>::process(T const* in, T* out, std::size_t n)
+   {
+      for (std::size_t i = 0; i != n; ++i)
+         out[i] = (*this)(in[i]);
+   }
+
+   template <typename T>
+   inline void moving_median<T>::process(T* inout, std::size_t n)
+   {
+      process(inout, inout, n);
+   }
 }
 
 #endif
@@ -7,23 +7,51 @@
 #define CYCFI_Q_EXP_MOVING_AVERAGE_DECEMBER_7_2018
 
 #include <q/support/base.hpp>
+#include <q/support/frequency.hpp>
 #include <q/utility/ring_buffer.hpp>
+#include <vector>
+#include <algorithm>
+#include <q/detail/recurrence.hpp>
 
 namespace cycfi::q
 {
    ////////////////////////////////////////////////////////////////////////////
    // moving_sum computes the moving sum of consecutive samples in a window
    // specified by max_size samples or duration d and std::size_t sps.
+   //
+   // The samples are kept in a linear buffer, with the latest window
+   // followed by room for new samples (like the fir). When the buffer is
+   // full, the window is moved back to the front, and the sum is
+   // recomputed from the samples in the window. The running sum is updated
+   // by adding the latest sample and subtracting the oldest, which, with
+   // floating point, accumulates rounding errors. Recomputing the sum
+   // regularly (every room samples) keeps the error from growing over long
+   // runs.
+   //
+   // The room is max_size samples (at least min_room), so the buffer is
+   // about twice the window. The move and the recomputed sum are O(max_size)
+   // work, done once every room samples. That's a constant amortized cost
+   // per sample, but the sample that triggers it (worst case) costs
+   // O(max_size).
+   //
+   // process(in, out, n) computes the sums for a block of samples. The
+   // running sum is a prefix sum of the differences between the new and
+   // the old samples. This is computed a chunk of samples at a time: the
+   // prefix sums within a chunk do not depend on the running sum, and are
+   // computed ahead, then the running sum is added to the whole chunk.
    ////////////////////////////////////////////////////////////////////////////
    template <typename T>
    struct basic_moving_sum
    {
+      static constexpr std::size_t chunk_size = 8;
+      static constexpr std::size_t min_room = 64;
+
       basic_moving_sum(std::size_t max_size)
-       : _buff(max_size)
-       , _size(max_size)
-       , _sum{ 0 }
+       : _max_size(std::max<std::size_t>(max_size, 1))
+       , _size(_max_size)
+       , _x(_max_size + std::max(_max_size, min_room))
       {
-         _buff.clear();
+         clear();
       }
 
       basic_moving_sum(duration d, std::size_t sps)
@@ -33,12 +61,61 @@ namespace cycfi::q
 
       T operator()(T s)
       {
+         if (_pos == _x.size())
+            rewind();
+         auto const old = _x[_pos - _size];
+         _x[_pos++] = s;
          _sum += s;              // Add the latest sample to the sum
-         _sum -= _buff[_size-1]; // Subtract the oldest sample from the sum
-         _buff.push(s);          // Push the latest sample, erasing the oldest
+         _sum -= old;            // Subtract the oldest sample from the sum
          return _sum;
       }
 
+      void process(T const* in, T* out, std::size_t n)
+      {
+         while (n != 0)
+         {
+            if (_pos == _x.size())
+               rewind();
+
+            // Append the new samples, so that the old samples, the ones
+            // leaving the window, are all in the buffer, _size samples back
+            auto const m = std::min(n, _x.size() - _pos);
+            T* x = &_x[_pos];
+            T const* old = x - _size;
+            std::copy(in, in + m, x);
+
+            auto sum = _sum;
+            std::size_t i = 0;
+            for (; i + chunk_size <= m; i += chunk_size)
+            {
+               accumulator v[chunk_size];
+               v[0] = accumulator(x[i]) - old[i];
+               for (std::size_t k = 1; k != chunk_size; ++k)
+                  v[k] = v[k-1] + (accumulator(x[i+k]) - old[i+k]);
+               for (std::size_t k = 0; k != chunk_size; ++k)
+                  out[i+k] = sum + v[k];
+               sum += v[chunk_size-1];
+            }
+            for (; i != m; ++i)
+            {
+               sum += x[i];
+               sum -= old[i];
+               out[i] = sum;
+            }
+
+            _sum = sum;
+            _pos += m;
+            in += m;
+            out += m;
+            n -= m;
+         }
+      }
+
+      void process(T* inout, std::size_t n)
+      {
+         process(inout, inout, n);
+      }
+
       T operator()() const
       {
          return _sum;            // Return the sum
@@ -56,29 +133,48 @@ namespace cycfi::q
 
       void clear()
       {
-         _buff.clear();
-         _sum = 0;
+         fill(T{});
       }
 
       void fill(T val)
       {
-         _buff.fill(val);
-         _sum = val * _size;
+         std::fill(_x.begin(), _x.end(), val);
+         _pos = _max_size;
+         _sum = accumulator(val) * _size;
       }
 
       void size(std::size_t size_)
       {
-         return _size = std::min(size_, _buff.size());
+         _size = std::min(std::max<std::size_t>(size_, 1), _max_size);
+         resync();
       }
 
    private:
 
-      using buffer = ring_buffer<T>;
       using accumulator = decltype(promote(T()));
 
-      buffer      _buff = buffer{};
-      std::size_t _size;
-      accumulator _sum;
+      void rewind()
+      {
+         // Move the latest window back to the front
+         std::copy(_x.end() - _max_size, _x.end(), _x.begin());
+         _pos = _max_size;
+         resync();
+      }
+
+      void resync()
+      {
+         // Recompute the sum, from scratch
+         accumulator sum{ 0 };
+         for (auto i = _pos - _size; i != _pos; ++i)
+            sum += _x[i];
+         _sum = sum;
+      }
+
+      std::size_t       _max_size;
+      std::size_t       _size;
+      std::vector<T>    _x;         // window + room for new samples
+      std::size_t       _pos;       // position of the next new sample
+      accumulator       _sum;
    };
 
    using moving_sum = basic_moving_sum<float>;
@@ -96,7 +192,7 @@ namespace cycfi::q
    // the square root of N. For example, N=16 improves SNR by 4 (12dB). The
    // filter delay is exactly (N−1)/2.
    //
-   // This filter is implemented using a ring_buffer. The data type, T, is a
+   // This filter is implemented using a moving_sum. The data type, T, is a
    // template parameter, allowing both floating point as well as integer
    // computations. Integers are typically faster than floating point and are
    // not prone to round-off errors.
@@ -114,6 +210,19 @@ namespace cycfi::q
          return (*this)();
       }
 
+      void process(T const* in, T* out, std::size_t n)
+      {
+         basic_moving_sum<T>::process(in, out, n);
+         auto const size = this->size();
+         for (std::size_t i = 0; i != n; ++i)
+            out[i] = out[i] / size;
+      }
+
+      void process(T* inout, std::size_t n)
+      {
+         process(inout, inout, n);
+      }
+
       T operator()() const
       {
           // Return the average
@@ -155,6 +264,18 @@ namespace cycfi::q
          return y = b * s + b_ * y;
       }
 
+      // Block processing. See detail::recurrence.
+      void process(float const* in, float* out, std::size_t count)
+      {
+         y = detail::recurrence{ b_ }(y, out, count,
+            [=](std::size_t i) { return b * in[i]; });
+      }
+
+      void process(float* inout, std::size_t count)
+      {
+         process(inout, inout, count);
+      }
+
       float operator()() const
       {
          return y;
@@ -191,6 +312,19 @@ namespace cycfi::q
          return y = b * s + b_ * y;
       }
 
+      // Block processing. See detail::recurrence.
+      void process(float const* in, float* out, std::size_t n)
+      {
+         auto const b_ = b;
+         y = detail::recurrence{ 1.0f - b }(y, out, n,
+            [=](std::size_t i) { return b_ * in[i]; });
+      }
+
+      void process(float* inout, std::size_t n)
+      {
+         process(inout, inout, n);
+      }
+
       float operator()() const
       {
          return y;
@@ -7,72 +7,242 @@
 #define CYCFI_Q_EXP_MOVING_MAXIMUM_NOVEMBER_6_2019
 
 #include <q/support/base.hpp>
+#include <q/support/frequency.hpp>
 #include <vector>
+#include <limits>
+#include <algorithm>
 
 namespace cycfi::q
 {
+   namespace detail
+   {
+      template <typename T>
+      struct select_max
+      {
+         static constexpr T initial() { return std::numeric_limits<T>::lowest(); }
+         T operator()(T a, T b) const { return (a < b)? b : a; }
+      };
+
+      template <typename T>
+      struct select_min
+      {
+         static constexpr T initial() { return std::numeric_limits<T>::max(); }
+         T operator()(T a, T b) const { return (b < a)? b : a; }
+      };
+   }
+
    ////////////////////////////////////////////////////////////////////////////
-   // moving_maximum: an efficient sliding maximum algorithm that has cost
-   // that is O(log2(L)).
+   // basic_moving_extremum: the maximum (or minimum, depending on Select)
+   // of the latest size samples, using the van Herk/Gil-Werman algorithm,
+   // with a constant cost of a few comparisons per sample, independent of
+   // the window size.
+   //
+   // The samples are split into consecutive blocks of size samples. The
+   // window ending at position j of the current block spans positions j+1
+   // to the end of the previous block, and 0 to j of the current block. Its
+   // maximum is the maximum of:
    //
-   // Brookes: "Algorithms for Max and Min Filters with Improved Worst-Case
-   // Performance" IEEE TRANSACTIONS ON CIRCUITS AND SYSTEMS—II: ANALOG AND
-   // DIGITAL SIGNAL PROCESSING, VOL. 47, NO. 9, SEPTEMBER 2000
+   //    1. The maximum of the previous block from j+1 to its end (the
+   //       suffix maxima, computed once, at the end of each block).
    //
-   // Many thanks to Robert Bristow-Johnson.
+   //    2. The maximum of the current block from its start to j (the
+   //       running, prefix maximum).
+   //
+   // A single buffer holds both: as each sample of the current block is
+   // stored at position j, the suffix maximum at position j+1 is still
+   // there. At the end of the block, the buffer is replaced by its suffix
+   // maxima, in place. That's one comparison per sample for each of 1, 2
+   // and the final maximum; the suffix pass is done once every size
+   // samples (worst case: size comparisons for one sample). process
+   // computes the same, a block at a time.
+   //
+   // Until size samples are seen, the window has only the samples so far.
+   //
+   // See:
+   //
+   //    M. van Herk, "A fast algorithm for local minimum and maximum filters
+   //    on rectangular and octagonal kernels", Pattern Recognition Letters
+   //    13 (1992).
+   //
+   //    J. Gil, M. Werman, "Computing 2-D min, median, and max filters",
+   //    IEEE Trans. Pattern Analysis and Machine Intelligence 15 (1993).
    ////////////////////////////////////////////////////////////////////////////
+   template <typename T, typename Select>
+   class basic_moving_extremum
+   {
+   public:
+
+                              basic_moving_extremum(duration d, std::size_t sps);
+                              basic_moving_extremum(std::size_t size);
+
+      T                       operator()(T s);
+      T                       operator()() const   { return _y; }
+
+      void                    process(T const* in, T* out, std::size_t n);
+      void                    process(T* inout, std::size_t n);
+
+      std::size_t             size() const         { return _size; }
+      void                    reset();
+
+   private:
+
+      static constexpr std::size_t chunk_size = 8;
+
+      void                    next_block();
+
+      std::size_t             _size;      // window size
+      std::size_t             _pos;       // position in the current block
+      T                       _prefix;    // maximum of the current block so far
+      T                       _y;         // latest output
+      std::vector<T>          _data;      // current block + suffix maxima
+   };
+
    template <typename T>
-   struct moving_maximum
+   struct moving_maximum : basic_moving_extremum<T, detail::select_max<T>>
    {
-      moving_maximum(duration d, std::size_t sps)
-       : moving_maximum(std::size_t(float(d) * sps))
-      {}
+      using basic_moving_extremum<T, detail::select_max<T>>::basic_moving_extremum;
+   };
 
-      moving_maximum(std::size_t size)
-       : _size(size)
-       , _input_index(0)
+   template <typename T>
+   struct moving_minimum : basic_moving_extremum<T, detail::select_min<T>>
+   {
+      using basic_moving_extremum<T, detail::select_min<T>>::basic_moving_extremum;
+   };
+
+   ////////////////////////////////////////////////////////////////////////////
+   // Implementation
+   ////////////////////////////////////////////////////////////////////////////
+   template <typename T, typename Select>
+   inline basic_moving_extremum<T, Select>::basic_moving_extremum(
+      duration d, std::size_t sps)
+    : basic_moving_extremum(std::size_t(float(d) * sps))
+   {}
+
+   template <typename T, typename Select>
+   inline basic_moving_extremum<T, Select>::basic_moving_extremum(std::size_t size)
+    : _size(std::max<std::size_t>(size, 1))
+   {
+      // One extra element past the end, always initial(), is the (empty)
+      // suffix past the last position.
+      _data.resize(_size + 1);
+      reset();
+   }
+
+   template <typename T, typename Select>
+   inline void basic_moving_extremum<T, Select>::reset()
+   {
+      std::fill(_data.begin(), _data.end(), Select::initial());
+      _pos = 0;
+      _prefix = Select::initial();
+      _y = Select::initial();
+   }
+
+   template <typename T, typename Select>
+   inline void basic_moving_extremum<T, Select>::next_block()
+   {
+      // Replace the block just completed by its suffix maxima, from the
+      // end. Each chunk of chunk_size samples first computes its own
+      // suffix maxima, independent of the rest, then folds in the suffix
+      // maximum of the chunks after it.
+      Select select;
+      T* data = _data.data();
+      auto i = _size;
+      auto suffix = Select::initial();
+      for (; i >= chunk_size; i -= chunk_size)
       {
-         constexpr T very_large_number = 3.40e38;
-         std::size_t capacity = smallest_pow2(size);
-         _data.resize(capacity * 2, T{});
-         std::fill(_data.begin(), _data.end(), -very_large_number);
+         T* p = data + i - chunk_size;
+         T local[chunk_size];
+         local[chunk_size - 1] = p[chunk_size - 1];
+         for (auto k = chunk_size - 1; k-- != 0;)
+            local[k] = select(p[k], local[k + 1]);
+         for (std::size_t k = 0; k != chunk_size; ++k)
+            p[k] = select(local[k], suffix);
+         suffix = p[0];
       }
+      while (i-- != 0)
+         data[i] = select(data[i], data[i + 1]);
+      _pos = 0;
+      _prefix = Select::initial();
+   }
 
-      T operator()(T value)
-      {
-         T* array = &_data[0];
+   template <typename T, typename Select>
+   inline T basic_moving_extremum<T, Select>::operator()(T s)
+   {
+      Select select;
+      _prefix = select(_prefix, s);
+      _y = select(_data[_pos + 1], _prefix);
+      _data[_pos] = s;
+      if (++_pos == _size)
+         next_block();
+      return _y;
+   }
 
-         // our main buffer is in the latter half of the array.
-         std::size_t index = (_data.size()/2) + _input_index;
+   template <typename T, typename Select>
+   inline void basic_moving_extremum<T, Select>::process(
+      T const* in, T* out, std::size_t n)
+   {
+      Select select;
+      while (n != 0)
+      {
+         // Up to the end of the current block
+         auto const m = std::min(n, _size - _pos);
+         T* data = &_data[_pos];
+         auto prefix = _prefix;
 
-         while (index > 1)
+         // Each running maximum waits for the previous one. So the samples
+         // are processed four at a time: the running maxima within the
+         // four do not depend on the previous ones, so the CPU can compute
+         // these ahead, and the running maximum so far is applied to all
+         // of them at once. Spelled out in scalars so that it does not
+         // depend on the optimizer unrolling a loop (it doesn't at -O2).
+         std::size_t i = 0;
+         for (; i + 4 <= m; i += 4)
          {
-            array[index] = value;
-
-            // toggle LSB, the upper bits of the sibling address are the same.
-            T sibling_value = array[index ^ 1];
-
-            if (value < sibling_value)
-            {
-               // use maximum of the two values
-               value = sibling_value;
-            }
-            // parent address is index/2 (drop remainder or "sibling bit")
-            index /= 2;
+            auto const s0 = in[i];
+            auto const s1 = in[i + 1];
+            auto const s2 = in[i + 2];
+            auto const s3 = in[i + 3];
+            auto const l1 = select(s0, s1);
+            auto const l2 = select(l1, s2);
+            auto const l3 = select(l2, s3);
+            auto const y0 = select(data[i + 1], select(prefix, s0));
+            auto const y1 = select(data[i + 2], select(prefix, l1));
+            auto const y2 = select(data[i + 3], select(prefix, l2));
+            auto const y3 = select(data[i + 4], select(prefix, l3));
+            data[i] = s0;
+            data[i + 1] = s1;
+            data[i + 2] = s2;
+            data[i + 3] = s3;
+            out[i] = y0;
+            out[i + 1] = y1;
+            out[i + 2] = y2;
+            out[i + 3] = y3;
+            prefix = select(prefix, l3);
          }
+         for (; i != m; ++i)
+         {
+            auto const s = in[i];
+            prefix = select(prefix, s);
+            out[i] = select(data[i + 1], prefix);
+            data[i] = s;
+         }
+         _prefix = prefix;
+         _y = out[m - 1];
 
-         if (++_input_index >= _size)
-            _input_index = 0;
-
-         return value;
+         _pos += m;
+         if (_pos == _size)
+            next_block();
+         in += m;
+         out += m;
+         n -= m;
       }
+   }
 
-   private:
-
-      std::size_t    _size;         // window size
-      std::size_t    _input_index;  // the actual sample placement is at (array_size + input_index);
-      std::vector<T> _data;         // the big array (twice array_size);
-   };
+   template <typename T, typename Select>
+   inline void basic_moving_extremum<T, Select>::process(T* inout, std::size_t n)
+   {
+      process(inout, inout, n);
+   }
 }
 
 #endif
@@ -0,0 +1,265 @@
+/*=============================================================================
+   Copyright (c) 2014-2020 Joel de Guzman. All rights reserved.
+
+   Distributed under the MIT License [ https://opensource.org/licenses/MIT ]
+=============================================================================*/
+#if !defined(CYCFI_Q_MOVING_SUM_BANK_OCTOBER_18_2026)
+#define CYCFI_Q_MOVING_SUM_BANK_OCTOBER_18_2026
+
+#include <q/support/base.hpp>
+#include <q/support/frequency.hpp>
+#include <q/support/audio_stream.hpp>
+#include <infra/assert.hpp>
+#include <algorithm>
+#include <array>
+#include <vector>
+
+namespace cycfi::q
+{
+   ////////////////////////////////////////////////////////////////////////////
+   // moving_sum_bank: N moving_sums, all with the same window size, one per
+   // channel (e.g. for multichannel RMS meters: feed it the squared
+   // samples).
+   //
+   // The history is kept in frame major form (N samples per frame), and
+   // the running sums in an array of N (double) accumulators, so that each
+   // frame is an N wide subtract and add. The N channels are independent,
+   // so the lane loops vectorize to 4, 8 or 16 channels per instruction,
+   // depending on the target's SIMD width.
+   //
+   // Like the moving_sum, the window is followed by room for new frames,
+   // and when the history is full, the window is moved back to the front
+   // and the sums are recomputed from the samples in the window, so the
+   // rounding errors do not accumulate over long runs. The room is size
+   // frames (at least min_room): the O(size) move and resync, once every
+   // room frames, is a constant amortized cost per frame (worst case:
+   // O(size) for one frame).
+   //
+   // The bank processes non-interleaved audio_channels buffers directly
+   // (see biquad_bank). Blocks are transposed, a tile of frames at a time,
+   // into the history, and the results are transposed back.
+   ////////////////////////////////////////////////////////////////////////////
+   template <std::size_t N>
+   class moving_sum_bank
+   {
+   public:
+
+      static_assert(N > 0, "Error: N must be greater than zero");
+
+      static constexpr std::size_t num_channels = N;
+      static constexpr std::size_t tile_size = 32;
+      static constexpr std::size_t min_room = 64;
+
+                              moving_sum_bank(std::size_t size);
+                              moving_sum_bank(duration d, std::size_t sps);
+
+      void                    operator()(audio_channels<float> const& inout);
+      template <typename In>
+      void                    operator()(
+                                 In const& in
+                               , audio_channels<float> const& out
+                              );
+
+      float                   sum(std::size_t channel) const;
+      std::size_t             size() const   { return _size; }
+      void                    clear();
+
+   protected:
+
+      template <typename In>
+      void                    process(
+                                 In const& in
+                               , audio_channels<float> const& out
+                               , double scale
+                              );
+
+   private:
+
+      using accumulators = std::array<double, N>;
+
+      void                    rewind();
+      void                    resync();
+
+      std::size_t             _size;      // window size, in frames
+      std::size_t             _frames;    // history capacity, in frames
+      std::size_t             _pos;       // position of the next new frame
+      std::vector<float>      _x;         // frame major history
+      alignas(64) accumulators _sum;
+   };
+
+   ////////////////////////////////////////////////////////////////////////////
+   // moving_average_bank: N moving_averages. See moving_sum_bank.
+   ////////////////////////////////////////////////////////////////////////////
+   template <std::size_t N>
+   class moving_average_bank : public moving_sum_bank<N>
+   {
+   public:
+
+      using moving_sum_bank<N>::moving_sum_bank;
+
+      void                    operator()(audio_channels<float> const& inout);
+      template <typename In>
+      void                    operator()(
+                                 In const& in
+                               , audio_channels<float> const& out
+                              );
+
+      float                   average(std::size_t channel) const;
+   };
+
+   ////////////////////////////////////////////////////////////////////////////
+   // Implementation
+   ////////////////////////////////////////////////////////////////////////////
+   template <std::size_t N>
+   inline moving_sum_bank<N>::moving_sum_bank(std::size_t size)
+    : _size(std::max<std::size_t>(size, 1))
+    , _frames(_size + std::max(_size, min_room))
+    , _x(_frames * N)
+   {
+      clear();
+   }
+
+   template <std::size_t N>
+   inline moving_sum_bank<N>::moving_sum_bank(duration d, std::size_t sps)
+    : moving_sum_bank(std::size_t(sps * float(d)))
+   {}
+
+   template <std::size_t N>
+   inline float moving_sum_bank<N>::sum(std::size_t channel) const
+   {
+      CYCFI_ASSERT(channel < N, "Invalid channel.");
+      return _sum[channel];
+   }
+
+   template <std::size_t N>
+   inline void moving_sum_bank<N>::clear()
+   {
+      std::fill(_x.begin(), _x.end(), 0.0f);
+      _pos = _size;
+      _sum.fill(0.0);
+   }
+
+   template <std::size_t N>
+   inline void moving_sum_bank<N>::rewind()
+   {
+      // Move the latest window back to the front
+      std::copy(_x.end() - _size * N, _x.end(), _x.begin());
+      _pos = _size;
+      resync();
+   }
+
+   template <std::size_t N>
+   inline void moving_sum_bank<N>::resync()
+   {
+      // Recompute the sums, from scratch
+      alignas(64) accumulators sum;
+      sum.fill(0.0);
+      for (auto i = _pos - _size; i != _pos; ++i)
+      {
+         float const* x = &_x[i * N];
+         for (std::size_t ch = 0; ch != N; ++ch)
+            sum[ch] += x[ch];
+      }
+      _sum = sum;
+   }
+
+   template <std::size_t N>
+   template <typename In>
+   inline void moving_sum_bank<N>::process(
+      In const& in
+    , audio_channels<float> const& out
+    , double scale
+   )
+   {
+      CYCFI_ASSERT(in.size() >= N && out.size() >= N, "Not enough channels.");
+
+      auto const frames = std::min(in.frames().last, out.frames().last);
+
+      alignas(64) float buf[tile_size][N];
+      std::array<float const*, N> src;
+      std::array<float*, N> dest;
+      for (std::size_t ch = 0; ch != N; ++ch)
+      {
+         src[ch] = in[ch].begin();
+         dest[ch] = out[ch].begin();
+      }
+
+      for (std::size_t frame = 0; frame < frames;)
+      {
+         if (_pos == _frames)
+            rewind();
+
+         // Up to a tile, or up to the end of the history
+         auto const n = std::min({ tile_size, frames - frame, _frames - _pos });
+         float* x = &_x[_pos * N];
+         float const* old = x - _size * N;
+
+         // Append the new frames first, so that in and out may be the same
+         // buffers. The old frames, the ones leaving the window, are all in
+         // the history, _size frames back.
+         for (std::size_t i = 0; i != n; ++i)
+            for (std::size_t ch = 0; ch != N; ++ch)
+               x[i * N + ch] = src[ch][frame + i];
+
+         alignas(64) accumulators sum = _sum;
+         for (std::size_t i = 0; i != n; ++i)
+         {
+            float const* xi = x + i * N;
+            float const* oi = old + i * N;
+            for (std::size_t ch = 0; ch != N; ++ch)
+            {
+               sum[ch] += double(xi[ch]) - double(oi[ch]);
+               buf[i][ch] = sum[ch] * scale;
+            }
+         }
+         _sum = sum;
+
+         for (std::size_t i = 0; i != n; ++i)
+            for (std::size_t ch = 0; ch != N; ++ch)
+               dest[ch][frame + i] = buf[i][ch];
+
+         _pos += n;
+         frame += n;
+      }
+   }
+
+   template <std::size_t N>
+   inline void moving_sum_bank<N>::operator()(audio_channels<float> const& inout)
+   {
+      process(inout, inout, 1.0);
+   }
+
+   template <std::size_t N>
+   template <typename In>
+   inline void moving_sum_bank<N>::operator()(
+      In const& in
+    , audio_channels<float> const& out
+   )
+   {
+      process(in, out, 1.0);
+   }
+
+   template <std::size_t N>
+   inline void moving_average_bank<N>::operator()(audio_channels<float> const& inout)
+   {
+      this->process(inout, inout, 1.0 / this->size());
+   }
+
+   template <std::size_t N>
+   template <typename In>
+   inline void moving_average_bank<N>::operator()(
+      In const& in
+    , audio_channels<float> const& out
+   )
+   {
+      this->process(in, out, 1.0 / this->size());
+   }
+
+   template <std::size_t N>
+   inline float moving_average_bank<N>::average(std::size_t channel) const
+   {
+      return this->sum(channel) / this->size();
+   }
+}
+
+#endif
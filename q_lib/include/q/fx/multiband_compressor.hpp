@@ -0,0 +1,350 @@
+/*=============================================================================
+   Copyright (c) 2014-2020 Joel de Guzman. All rights reserved.
+
+   Distributed under the MIT License [ https://opensource.org/licenses/MIT ]
+=============================================================================*/
+#if !defined(CYCFI_Q_MULTIBAND_COMPRESSOR_OCTOBER_18_2026)
+#define CYCFI_Q_MULTIBAND_COMPRESSOR_OCTOBER_18_2026
+
+#include <q/support/literals.hpp>
+#include <q/support/decibel.hpp>
+#include <q/fx/sos_cascade.hpp>
+#include <q/fx/dynamic.hpp>
+#include <q/detail/db_poly.hpp>
+#include <infra/assert.hpp>
+#include <array>
+#include <cmath>
+#include <limits>
+
+namespace cycfi::q
+{
+   ////////////////////////////////////////////////////////////////////////////
+   // multiband_compressor: N bands, split by N-1 Linkwitz-Riley crossovers
+   // of order 2K (K = 2 for LR4, K = 4 for LR8), each band with its own
+   // envelope follower (attack and release) and soft_knee_compressor, and
+   // its own makeup gain. The bands are summed back after compression.
+   //
+   // The bands are the usual crossover tree, with the phase compensation
+   // that makes the recombination coherent: band b is the input filtered,
+   // for each crossover j, through
+   //
+   //    j < b:   the Linkwitz-Riley highpass at crossover j
+   //    j == b:  the Linkwitz-Riley lowpass at crossover j
+   //    j > b:   the allpass at crossover j
+   //
+   // where the allpass at crossover j is the sum of its lowpass and
+   // highpass (an allpass, with the poles of the Butterworth filter of
+   // order K). Summing from the top, the last two bands differ only at the
+   // last crossover (lowpass and highpass), so their sum has the allpass
+   // there, just like the band below, and so on, down to the first band:
+   // the crossovers collapse, one at a time, into their allpasses. With no
+   // compression, the output is the input through the N-1 allpasses: a
+   // flat magnitude response, with no comb filtering at the crossover
+   // frequencies.
+   //
+   // With every band filtered from the input, rather than from the output
+   // of the previous crossover, the bands are independent, and run side by
+   // side in the SIMD lanes, as the channels of biquad_bank: each of the
+   // (N-1) * K second order sections, the envelope followers, the decibel
+   // conversions (detail::fast_a2db and fast_db2a) and the gain computers
+   // are a handful of lane wide operations, with selects instead of
+   // branches. The number of lanes is rounded up to a multiple of four
+   // (the unused lanes are silent), so, for example, three and four bands
+   // use the same number of lanes. The work per lane still grows with the
+   // number of bands: each lane runs all of the (N-1) * K sections.
+   //
+   // Typical use (4 bands, LR4):
+   //
+   //    q::multiband_compressor<4> mb{ { 120_Hz, 1_kHz, 6_kHz }, sps };
+   //    mb.compressor(0, q::soft_knee_compressor{ -24_dB, 6_dB, 1.0 / 3 });
+   //    mb.envelope(0, 30_ms, 300_ms, sps);
+   //    mb.makeup_gain(0, 3_dB);
+   //    ...
+   //    mb.process(buffer, n);
+   //
+   // Bands not configured are not compressed (the ratio is 1:1).
+   ////////////////////////////////////////////////////////////////////////////
+   template <std::size_t N, std::size_t K = 2>
+   class multiband_compressor
+   {
+   public:
+
+      static_assert(N >= 2, "Error: N must be at least 2");
+      static_assert(K > 0 && K % 2 == 0,
+         "Error: Linkwitz-Riley filters need an even number of sections");
+
+      static constexpr std::size_t num_bands = N;
+      static constexpr std::size_t num_lanes = (N + 3) / 4 * 4;
+      static constexpr std::size_t num_sections = (N - 1) * K;
+
+      using crossover_list = std::array<frequency, N-1>;
+
+                              multiband_compressor(
+                                 crossover_list const& crossovers
+                               , std::uint32_t sps
+                              );
+
+      void                    crossovers(crossover_list const& crossovers, std::uint32_t sps);
+      void                    compressor(std::size_t band, soft_knee_compressor const& comp);
+      void                    envelope(
+                                 std::size_t band
+                               , duration attack, duration release
+                               , std::uint32_t sps
+                              );
+      void                    makeup_gain(std::size_t band, decibel gain);
+
+      float                   operator()(float s);
+      void                    process(float const* in, float* out, std::size_t n);
+      void                    process(float* inout, std::size_t n);
+      void                    reset();
+
+      // The latest gain of the band's compressor, not including the
+      // makeup gain (for gain reduction meters)
+      decibel                 gain(std::size_t band) const;
+
+   private:
+
+      using lanes = std::array<float, num_lanes>;
+
+      // A second order section, for all bands. See biquad::process.
+      struct section
+      {
+         alignas(64) lanes    b0, k1, k2, a1, a2;
+         alignas(64) lanes    s1, s2;
+      };
+
+      void                    config(
+                                 std::size_t section, std::size_t band
+                               , double b0, double b1, double b2
+                               , double a1, double a2
+                              );
+
+      std::array<section, num_sections> _sections;
+
+      // Envelope followers and gain computers
+      alignas(64) lanes       _attack, _release, _env;
+      alignas(64) lanes       _lower, _upper, _width, _slope, _knee;
+      alignas(64) lanes       _makeup, _gain;
+   };
+
+   ////////////////////////////////////////////////////////////////////////////
+   // Implementation
+   ////////////////////////////////////////////////////////////////////////////
+   template <std::size_t N, std::size_t K>
+   inline multiband_compressor<N, K>::multiband_compressor(
+      crossover_list const& crossovers_
+    , std::uint32_t sps
+   )
+   {
+      // The unused lanes are silent, but they still need sane values
+      for (auto* lane : { &_attack, &_release, &_lower, &_upper
+         , &_width, &_slope, &_knee, &_makeup })
+         lane->fill(0.0f);
+
+      crossovers(crossovers_, sps);
+      for (std::size_t band = 0; band != N; ++band)
+      {
+         compressor(band, soft_knee_compressor{ 0_dB, 6_dB, 1.0f });
+         envelope(band, 10_ms, 100_ms, sps);
+      }
+      reset();
+   }
+
+   template <std::size_t N, std::size_t K>
+   inline void multiband_compressor<N, K>::config(
+      std::size_t section, std::size_t band
+    , double b0, double b1, double b2
+    , double a1, double a2
+   )
+   {
+      auto& s = _sections[section];
+      s.b0[band] = b0;
+      s.k1[band] = b1 - a1 * b0;
+      s.k2[band] = b2 - a2 * b0;
+      s.a1[band] = a1;
+      s.a2[band] = a2;
+   }
+
+   template <std::size_t N, std::size_t K>
+   inline void multiband_compressor<N, K>::crossovers(
+      crossover_list const& crossovers_, std::uint32_t sps)
+   {
+      for (std::size_t j = 0; j != N-1; ++j)
+      {
+         CYCFI_ASSERT(j == 0 || crossovers_[j-1] < crossovers_[j],
+            "Crossover frequencies must be in ascending order.");
+
+         // The K sections of crossover j, K/2 Butterworth sections, twice
+         // (see detail::config_linkwitz_riley).
+         for (std::size_t k = 0; k != K/2; ++k)
+         {
+            auto const q = detail::butterworth_q(k, K);
+            detail::config_sos_section lp{ crossovers_[j], sps, 1.0, q, false };
+            detail::config_sos_section hp{ crossovers_[j], sps, 1.0, q, true };
+
+            for (std::size_t band = 0; band != N; ++band)
+            {
+               for (auto section : { j*K + k, j*K + k + K/2 })
+               {
+                  if (band == j)
+                     config(section, band
+                      , lp.b0 / lp.a0, lp.b1 / lp.a0, lp.b2 / lp.a0
+                      , lp.a1 / lp.a0, lp.a2 / lp.a0);
+                  else if (band > j)
+                     config(section, band
+                      , hp.b0 / hp.a0, hp.b1 / hp.a0, hp.b2 / hp.a0
+                      , hp.a1 / hp.a0, hp.a2 / hp.a0);
+               }
+
+               // The allpass needs only one of the two Butterworth
+               // sections: its numerator is the denominator, reversed.
+               // The other section passes the signal through.
+               if (band < j)
+               {
+                  config(j*K + k, band
+                   , lp.a2 / lp.a0, lp.a1 / lp.a0, 1.0
+                   , lp.a1 / lp.a0, lp.a2 / lp.a0);
+                  config(j*K + k + K/2, band, 1.0, 0.0, 0.0, 0.0, 0.0);
+               }
+            }
+         }
+      }
+
+      // The unused lanes are silent
+      for (std::size_t band = N; band != num_lanes; ++band)
+         for (std::size_t s = 0; s != num_sections; ++s)
+            config(s, band, 0.0, 0.0, 0.0, 0.0, 0.0);
+   }
+
+   template <std::size_t N, std::size_t K>
+   inline void multiband_compressor<N, K>::compressor(
+      std::size_t band, soft_knee_compressor const& comp)
+   {
+      CYCFI_ASSERT(band < N, "Invalid band.");
+
+      // See soft_knee_compressor. In the knee, the gain is
+      // -knee * (env - lower)^2.
+      auto const width = comp._width.val;
+      _lower[band] = comp._lower.val;
+      _upper[band] = comp._upper.val;
+      _width[band] = width;
+      _slope[band] = comp._slope;
+      _knee[band] = (width > 0.0f)? 0.5f * comp._slope / width : 0.0f;
+   }
+
+   template <std::size_t N, std::size_t K>
+   inline void multiband_compressor<N, K>::envelope(
+      std::size_t band
+    , duration attack, duration release
+    , std::uint32_t sps
+   )
+   {
+      CYCFI_ASSERT(band < N, "Invalid band.");
+
+      // See envelope_follower
+      _attack[band] = fast_exp3(-2.0f / (sps * double(attack)));
+      _release[band] = fast_exp3(-2.0f / (sps * double(release)));
+   }
+
+   template <std::size_t N, std::size_t K>
+   inline void multiband_compressor<N, K>::makeup_gain(
+      std::size_t band, decibel gain)
+   {
+      CYCFI_ASSERT(band < N, "Invalid band.");
+      _makeup[band] = gain.val;
+   }
+
+   template <std::size_t N, std::size_t K>
+   inline decibel multiband_compressor<N, K>::gain(std::size_t band) const
+   {
+      CYCFI_ASSERT(band < N, "Invalid band.");
+      return decibel{ _gain[band], decibel::direct };
+   }
+
+   template <std::size_t N, std::size_t K>
+   inline void multiband_compressor<N, K>::reset()
+   {
+      for (auto& s : _sections)
+      {
+         s.s1.fill(0.0f);
+         s.s2.fill(0.0f);
+      }
+      _env.fill(0.0f);
+      _gain.fill(0.0f);
+   }
+
+   template <std::size_t N, std::size_t K>
+   inline void multiband_compressor<N, K>::process(
+      float const* in, float* out, std::size_t n)
+   {
+      constexpr auto L = num_lanes;
+      for (std::size_t i = 0; i != n; ++i)
+      {
+         // The bands
+         alignas(64) lanes x;
+         x.fill(in[i]);
+         for (auto& s : _sections)
+         {
+            for (std::size_t b = 0; b != L; ++b)
+            {
+               auto y = s.b0[b] * x[b] + s.s1[b];
+               auto t = s.k1[b] * x[b] - s.a1[b] * s.s1[b] + s.s2[b];
+               s.s2[b] = s.k2[b] * x[b] - s.a2[b] * s.s1[b];
+               s.s1[b] = t;
+               x[b] = y;
+            }
+         }
+
+         // The envelopes, gains and the compressed bands. The soft knee
+         // compressor is written with clamps, in place of its branches:
+         // with d, the envelope in the knee (from 0 to the knee width), and
+         // over, the envelope above the knee, the gain is
+         //
+         //    -knee * d^2 - slope * over
+         //
+         // The clamps and the envelope follower's select compare the
+         // detail::ordered_key of the floats, so these stay branch-free.
+         for (std::size_t b = 0; b != L; ++b)
+         {
+            using detail::ordered_key;
+            using detail::ordered_clamp;
+            constexpr auto max = std::numeric_limits<float>::max();
+
+            auto const a = std::abs(x[b]);
+            auto const attack = _attack[b];
+            auto const release = _release[b];
+            auto const rising = ordered_key(a) > ordered_key(_env[b]);
+            auto const c = rising? attack : release;
+            auto const env = _env[b] = a + c * (_env[b] - a);
+
+            auto const e = detail::fast_a2db(env);
+            auto const d = ordered_clamp(e - _lower[b], 0.0f, _width[b]);
+            auto const over = ordered_clamp(e - _upper[b], 0.0f, max);
+            auto const gain = _gain[b] = -_knee[b] * d * d - _slope[b] * over;
+
+            x[b] *= detail::fast_db2a(gain + _makeup[b]);
+         }
+
+         auto y = x[0];
+         for (std::size_t b = 1; b != N; ++b)
+            y += x[b];
+         out[i] = y;
+      }
+   }
+
+   template <std::size_t N, std::size_t K>
+   inline void multiband_compressor<N, K>::process(float* inout, std::size_t n)
+   {
+      process(inout, inout, n);
+   }
+
+   template <std::size_t N, std::size_t K>
+   inline float multiband_compressor<N, K>::operator()(float s)
+   {
+      float y;
+      process(&s, &y, 1);
+      return y;
+   }
+}
+
+#endif
@@ -0,0 +1,357 @@
+/*=============================================================================
+   Copyright (c) 2014-2020 Joel de Guzman. All rights reserved.
+
+   Distributed under the MIT License [ https://opensource.org/licenses/MIT ]
+=============================================================================*/
+#if !defined(CYCFI_Q_NONUNIFORM_CONVOLVER_OCTOBER_18_2026)
+#define CYCFI_Q_NONUNIFORM_CONVOLVER_OCTOBER_18_2026
+
+#include <q/fx/convolver.hpp>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+
+namespace cycfi::q
+{
+   ////////////////////////////////////////////////////////////////////////////
+   // nonuniform_convolver: Non-uniformly partitioned convolution for long
+   // impulse responses (e.g. 2-5 second reverbs), with the tail computed
+   // in a background thread.
+   //
+   // The impulse response is split into a head and a tail:
+   //
+   //    1. The head, the first H = 2T-B samples, is convolved in the
+   //       caller's thread (e.g. the audio callback) using a convolver<B>
+   //       with B sized partitions.
+   //
+   //    2. The tail, the rest of the impulse response, is convolved by a
+   //       worker thread using a convolver<T> with much larger partitions
+   //       of T = B*R samples. Larger partitions are a lot cheaper per
+   //       sample, but have a latency of T samples, which is absorbed by
+   //       the head.
+   //
+   // The caller's thread collects the input in blocks of T samples. At each
+   // block boundary, it hands the block to the worker through a ring of
+   // lock-free slots and picks up the worker's result for the previous
+   // block. The worker thus has one full block period (T samples) to
+   // deliver its result, while the caller never waits: if the result is
+   // not ready by the deadline, the tail is left out for that block and
+   // the miss is counted (see late_blocks()). If the worker falls so far
+   // behind that no slot is free, the block is not handed over at all,
+   // and the worker convolves silence in its place (see dropped_blocks()).
+   // The caller never writes a slot the worker is not done with. A dropped
+   // block is worse than a late one: it is missing from the history of
+   // the tail convolver, so its contribution is missing from the tail
+   // output for the whole length of the tail (one block per partition of
+   // T samples), not just one block.
+   //
+   // Overall latency is B samples, the same as convolver<B>.
+   //
+   // The callback side never allocates, and never takes a lock. It
+   // publishes the submitted block count, an atomic, and notifies the
+   // worker's condition variable without holding the mutex. Without the
+   // mutex, a notification sent just before the worker starts waiting is
+   // lost, so the worker waits with a timeout of 1/8 of a block period
+   // (T/sps): a lost wakeup costs at most 1/8 of the worker's deadline.
+   //
+   // The worker is a std::thread. Link with the platform's threads library
+   // (e.g. Threads::Threads in CMake) when using this header.
+   //
+   //    B: head partition size; typically the audio buffer size.
+   //    R: tail to head partition size ratio (T = B*R).
+   ////////////////////////////////////////////////////////////////////////////
+   template <std::size_t B, std::size_t R = 16>
+   class nonuniform_convolver
+   {
+   public:
+
+      static_assert(is_pow2(R) && R > 1,
+         "Error: R must be a power of two greater than one");
+
+      static constexpr std::size_t head_block_size = B;
+      static constexpr std::size_t tail_block_size = B * R;
+      static constexpr std::size_t head_size = 2 * tail_block_size - B;
+      static constexpr std::size_t num_slots = 4;
+
+                              nonuniform_convolver(
+                                 float const* ir, std::size_t size
+                               , std::uint32_t sps);
+
+                              nonuniform_convolver(
+                                 std::vector<float> const& ir, std::uint32_t sps)
+                               : nonuniform_convolver(ir.data(), ir.size(), sps)
+                              {}
+
+                              nonuniform_convolver(nonuniform_convolver const&) = delete;
+                              ~nonuniform_convolver();
+
+      nonuniform_convolver&   operator=(nonuniform_convolver const&) = delete;
+
+      float                   operator()(float s);
+      void                    operator()(float const* in, float* out, std::size_t n);
+
+                              template <typename InRange, typename OutRange>
+      void                    operator()(InRange const& in, OutRange const& out);
+
+      constexpr std::size_t   latency() const         { return B; }
+      bool                    has_tail() const        { return bool(_tail); }
+      std::size_t             late_blocks() const     { return _late; }
+      std::size_t             dropped_blocks() const  { return _dropped; }
+
+      // Block until the worker has processed all submitted blocks. Not for
+      // use in the audio callback. This is useful for offline rendering,
+      // where we want the exact result regardless of thread scheduling.
+      void                    sync();
+
+      // Hold or release the worker. While held, the worker does not start
+      // on any new block, as if it were infinitely slow. This is for
+      // testing the deadline handling deterministically, regardless of
+      // thread scheduling. Not for use in the audio callback.
+      void                    hold(bool held);
+
+   private:
+
+      using tail_convolver = convolver<tail_block_size>;
+      using block = std::array<float, tail_block_size>;
+
+      // _block is the index of the block held in _in. A slot is written
+      // by the caller only after the worker is done with it, and the
+      // worker reads it only after the block is submitted. If a block was
+      // dropped, its slot still holds an older block.
+      struct slot
+      {
+         block                _in;
+         block                _out;
+         std::size_t          _block = std::size_t(-1);
+      };
+
+      void                    next_block();
+      void                    run();
+
+      convolver<B>            _head;
+      std::unique_ptr<tail_convolver> _tail;
+
+      // Caller side
+      std::unique_ptr<block>  _fill;      // tail input being collected
+      std::unique_ptr<block>  _play;      // tail output being played
+      std::size_t             _pos = 0;   // position in the current block
+      std::size_t             _blocks = 0;
+      std::size_t             _late = 0;
+      std::size_t             _dropped = 0;
+
+      // Shared
+      using duration = std::chrono::nanoseconds;
+
+      std::unique_ptr<slot[]> _slots;
+      std::atomic<std::size_t> _submitted{ 0 };
+      std::atomic<std::size_t> _completed{ 0 };
+      std::atomic<bool>       _running{ true };
+      std::atomic<bool>       _held{ false };
+      duration                _wait_period;
+      std::mutex              _mutex;     // never locked by the caller
+      std::condition_variable _cv;        // wakes up the worker
+      std::condition_variable _synced;    // wakes up sync()
+      std::thread             _worker;
+   };
+
+   ////////////////////////////////////////////////////////////////////////////
+   // Implementation
+   ////////////////////////////////////////////////////////////////////////////
+   template <std::size_t B, std::size_t R>
+   inline nonuniform_convolver<B, R>::nonuniform_convolver(
+      float const* ir, std::size_t size, std::uint32_t sps)
+    : _head(ir, std::min(size, head_size))
+    , _wait_period(std::chrono::duration_cast<duration>(
+         std::chrono::duration<double>(double(tail_block_size) / (8.0 * sps))))
+   {
+      if (size > head_size)
+      {
+         _tail = std::make_unique<tail_convolver>(ir + head_size, size - head_size);
+         _fill = std::make_unique<block>();
+         _play = std::make_unique<block>();
+         _fill->fill(0.0f);
+         _play->fill(0.0f);
+         _slots.reset(new slot[num_slots]);
+         _worker = std::thread([this]{ run(); });
+      }
+   }
+
+   template <std::size_t B, std::size_t R>
+   inline nonuniform_convolver<B, R>::~nonuniform_convolver()
+   {
+      if (_worker.joinable())
+      {
+         {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _running = false;
+         }
+         _cv.notify_one();
+         _worker.join();
+      }
+   }
+
+   template <std::size_t B, std::size_t R>
+   inline void nonuniform_convolver<B, R>::run()
+   {
+      block silence;
+      silence.fill(0.0f);
+
+      for (std::size_t i = 0; ; ++i)
+      {
+         {
+            // next_block notifies without the mutex, so a notification
+            // may be lost. The timeout bounds the delay.
+            std::unique_lock<std::mutex> lock(_mutex);
+            while (_running &&
+               (_held || _submitted.load(std::memory_order_acquire) <= i))
+               _cv.wait_for(lock, _wait_period);
+            if (!_running)
+               return;
+         }
+
+         auto& s = _slots[i % num_slots];
+         auto const* in = (s._block == i)? s._in.data() : silence.data();
+         _tail->process(in, s._out.data());
+         _completed.store(i + 1, std::memory_order_release);
+
+         // Wake up sync(), which checks _completed with the mutex locked
+         {
+            std::lock_guard<std::mutex> lock(_mutex);
+         }
+         _synced.notify_all();
+      }
+   }
+
+   template <std::size_t B, std::size_t R>
+   inline void nonuniform_convolver<B, R>::sync()
+   {
+      if (_tail)
+      {
+         auto const submitted = _submitted.load(std::memory_order_acquire);
+         std::unique_lock<std::mutex> lock(_mutex);
+         _synced.wait(lock,
+            [&]
+            {
+               return _completed.load(std::memory_order_acquire) >= submitted;
+            }
+         );
+      }
+   }
+
+   template <std::size_t B, std::size_t R>
+   inline void nonuniform_convolver<B, R>::hold(bool held)
+   {
+      {
+         std::lock_guard<std::mutex> lock(_mutex);
+         _held = held;
+      }
+      _cv.notify_one();
+   }
+
+   template <std::size_t B, std::size_t R>
+   inline void nonuniform_convolver<B, R>::next_block()
+   {
+      auto const k = _blocks++;
+      auto const completed = _completed.load(std::memory_order_acquire);
+
+      // Pick up the worker's result for the previous block. The worker
+      // will not touch that slot again until we submit block k-1+num_slots.
+      if (k > 0)
+      {
+         if (completed >= k)
+         {
+            auto const& s = _slots[(k-1) % num_slots];
+            std::copy(s._out.begin(), s._out.end(), _play->begin());
+         }
+         else
+         {
+            _play->fill(0.0f);   // Deadline missed. Don't wait.
+            ++_late;
+         }
+      }
+
+      // Hand over the latest block. The slot is free if the worker is done
+      // with block k-num_slots. If not, leave the slot alone: the worker
+      // sees that it does not hold block k and convolves silence.
+      if (k < completed + num_slots)
+      {
+         auto& s = _slots[k % num_slots];
+         std::copy(_fill->begin(), _fill->end(), s._in.begin());
+         s._block = k;
+      }
+      else
+      {
+         ++_dropped;
+      }
+      _submitted.store(k + 1, std::memory_order_release);
+
+      // Wake up the worker. Never lock the mutex here (see run).
+      _cv.notify_one();
+   }
+
+   template <std::size_t B, std::size_t R>
+   inline float nonuniform_convolver<B, R>::operator()(float s)
+   {
+      auto y = _head(s);
+      if (_tail)
+      {
+         y += (*_play)[_pos];
+         (*_fill)[_pos] = s;
+         if (++_pos == tail_block_size)
+         {
+            next_block();
+            _pos = 0;
+         }
+      }
+      return y;
+   }
+
+   template <std::size_t B, std::size_t R>
+   inline void nonuniform_convolver<B, R>::operator()(
+      float const* in, float* out, std::size_t n)
+   {
+      if (!_tail)
+      {
+         _head(in, out, n);
+         return;
+      }
+
+      while (n != 0)
+      {
+         auto const chunk = std::min(n, tail_block_size - _pos);
+
+         // Take the input first; in and out may be the same buffer.
+         std::copy(in, in + chunk, _fill->begin() + _pos);
+         _head(in, out, chunk);
+         auto const* play = _play->data() + _pos;
+         for (std::size_t i = 0; i != chunk; ++i)
+            out[i] += play[i];
+
+         in += chunk;
+         out += chunk;
+         n -= chunk;
+         _pos += chunk;
+
+         if (_pos == tail_block_size)
+         {
+            next_block();
+            _pos = 0;
+         }
+      }
+   }
+
+   template <std::size_t B, std::size_t R>
+   template <typename InRange, typename OutRange>
+   inline void nonuniform_convolver<B, R>::operator()(
+      InRange const& in, OutRange const& out)
+   {
+      auto const n = in.end() - in.begin();
+      if (n != 0)
+         (*this)(&*in.begin(), &*out.begin(), n);
+   }
+}
+
+#endif
@@ -0,0 +1,455 @@
+/*=============================================================================
+   Copyright (c) 2014-2020 Joel de Guzman. All rights reserved.
+
+   Distributed under the MIT License [ https://opensource.org/licenses/MIT ]
+=============================================================================*/
+#if !defined(CYCFI_Q_OVERSAMPLER_OCTOBER_18_2026)
+#define CYCFI_Q_OVERSAMPLER_OCTOBER_18_2026
+
+#include <q/support/base.hpp>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <utility>
+
+namespace cycfi::q
+{
+   namespace detail
+   {
+      ////////////////////////////////////////////////////////////////////////
+      // Polyphase IIR half-band design (elliptic, after Valenzuela and
+      // Constantinides, see also http://yehar.com/blog/?p=368 and Laurent
+      // de Soras' HIIR). Computes the N allpass coefficients of a half-band
+      // filter with the given transition bandwidth (relative to the sample
+      // rate of the high rate side, centered at a quarter of that rate).
+      // Even indexed coefficients are for the first path, odd indexed
+      // coefficients for the second.
+      ////////////////////////////////////////////////////////////////////////
+      template <std::size_t N>
+      std::array<double, N> halfband_coefficients(double transition)
+      {
+         auto ipow = [](double x, int n)
+         {
+            double r = 1.0;
+            for (int i = 0; i != n; ++i)
+               r *= x;
+            return r;
+         };
+
+         // Transition parameters
+         double k = std::tan((1.0 - transition * 2.0) * pi / 4.0);
+         k *= k;
+         auto const kksqrt = std::pow(1.0 - k * k, 0.25);
+         auto const e = 0.5 * (1.0 - kksqrt) / (1.0 + kksqrt);
+         auto const e2 = e * e;
+         auto const e4 = e2 * e2;
+         auto const q = e * (1.0 + e4 * (2.0 + e4 * (15.0 + 150.0 * e4)));
+
+         std::array<double, N> coefs;
+         int const order = N * 2 + 1;
+         for (std::size_t index = 0; index != N; ++index)
+         {
+            int const c = index + 1;
+
+            double num = 0.0;
+            double term;
+            int i = 0;
+            double sign = 1.0;
+            do
+            {
+               term = ipow(q, i * (i + 1))
+                  * std::sin((i * 2 + 1) * c * pi / order) * sign;
+               num += term;
+               sign = -sign;
+               ++i;
+            }
+            while (std::abs(term) > 1e-100);
+
+            double den = 0.0;
+            i = 1;
+            sign = -1.0;
+            do
+            {
+               term = ipow(q, i * i) * std::cos(i * 2 * c * pi / order) * sign;
+               den += term;
+               sign = -sign;
+               ++i;
+            }
+            while (std::abs(term) > 1e-100);
+
+            auto const ww = (num * std::pow(q, 0.25)) / (den + 0.5);
+            auto const wwsq = ww * ww;
+            auto const x = std::sqrt((1.0 - wwsq * k) * (1.0 - wwsq / k)) / (1.0 + wwsq);
+            coefs[index] = (1.0 - x) / (1.0 + x);
+         }
+         return coefs;
+      }
+
+      ////////////////////////////////////////////////////////////////////////
+      // The two allpass paths of a polyphase half-band filter, running at
+      // the low sample rate. At the high rate, each section is the 2-pole
+      // polyphase allpass (c + z^-2) / (1 + c z^-2) (the polyphase_allpass
+      // in allpass.hpp, shifted by a quarter of the sample rate). At the
+      // low rate, z^-2 is a single sample delay, so each section is first
+      // order: y = c * (x - y1) + x1.
+      ////////////////////////////////////////////////////////////////////////
+      template <std::size_t N>
+      class halfband_paths
+      {
+      public:
+
+         static_assert(N % 2 == 0, "Error: N must be even");
+
+         halfband_paths(double transition)
+         {
+            auto const coefs = halfband_coefficients<N>(transition);
+            for (std::size_t i = 0; i != N; ++i)
+               _c[i] = float(coefs[i]);
+            reset();
+         }
+
+         // Run a through the first path and b through the second
+         void operator()(float& a, float& b)
+         {
+            step(_c, _x, _y, a, b);
+         }
+
+         // Run n pairs of samples through the paths, with the state in
+         // locals. load(i, a, b) gets the ith pair, store(i, a, b) puts
+         // the results.
+         template <typename Load, typename Store>
+         void process(std::size_t n, Load&& load, Store&& store)
+         {
+            auto const c = _c;
+            auto x = _x;
+            auto y = _y;
+            for (std::size_t i = 0; i != n; ++i)
+            {
+               float a, b;
+               load(i, a, b);
+               step(c, x, y, a, b);
+               store(i, a, b);
+            }
+            _x = x;
+            _y = y;
+         }
+
+         // Mean group delay of the two paths at DC, in high rate samples
+         double delay() const
+         {
+            double d = 0.0;
+            for (auto c : _c)
+               d += (1.0 - c) / (1.0 + c);
+            return d;
+         }
+
+         void reset()
+         {
+            _x.fill(0.0f);
+            _y.fill(0.0f);
+         }
+
+      private:
+
+         using state = std::array<float, N>;
+
+         static void step(
+            state const& c, state& x, state& y, float& a, float& b)
+         {
+            for (std::size_t i = 0; i != N; i += 2)
+            {
+               auto const ya = c[i] * (a - y[i]) + x[i];
+               auto const yb = c[i+1] * (b - y[i+1]) + x[i+1];
+               x[i] = a;
+               x[i+1] = b;
+               y[i] = a = ya;
+               y[i+1] = b = yb;
+            }
+         }
+
+         state _c;
+         state _x;
+         state _y;
+      };
+   }
+
+   ////////////////////////////////////////////////////////////////////////////
+   // halfband_upsampler and halfband_downsampler: 2x interpolation and
+   // decimation using polyphase IIR half-band filters. These are minimum
+   // phase (not linear phase), with N allpass sections (N/2 per path).
+   // Each input (upsampler) or output (downsampler) sample costs N first
+   // order allpass sections.
+   //
+   // delay() is the group delay at DC, in high rate samples. The second
+   // path is one high rate sample behind the first in the upsampler, and
+   // one sample ahead in the downsampler, so their delays differ by one
+   // sample.
+   //
+   //    N: number of allpass sections (even)
+   //    transition: transition bandwidth, relative to the high sample rate
+   ////////////////////////////////////////////////////////////////////////////
+   template <std::size_t N>
+   class halfband_upsampler
+   {
+   public:
+
+                              halfband_upsampler(double transition)
+                               : _paths(transition)
+                              {}
+
+      // Write two high rate samples to out
+      void                    operator()(float s, float* out);
+
+      // Upsample n samples from in to 2n samples in out
+      void                    process(float const* in, float* out, std::size_t n);
+
+      double                  delay() const { return _paths.delay() + 0.5; }
+      void                    reset()       { _paths.reset(); }
+
+   private:
+
+      detail::halfband_paths<N> _paths;
+   };
+
+   template <std::size_t N>
+   class halfband_downsampler
+   {
+   public:
+
+                              halfband_downsampler(double transition)
+                               : _paths(transition)
+                              {}
+
+      // Take two high rate samples from in
+      float                   operator()(float const* in);
+
+      // Downsample 2n samples from in to n samples in out
+      void                    process(float const* in, float* out, std::size_t n);
+
+      double                  delay() const { return _paths.delay() - 0.5; }
+      void                    reset()       { _paths.reset(); }
+
+   private:
+
+      detail::halfband_paths<N> _paths;
+   };
+
+   ////////////////////////////////////////////////////////////////////////////
+   // oversampled: runs a (nonlinear) processor at Factor (2, 4 or 8) times
+   // the sample rate, to reduce aliasing:
+   //
+   //    oversampled<soft_clip, 4> clipper;
+   //    auto y = clipper(s);
+   //
+   // Processor is any function object taking and returning a float, and
+   // is constructed from the oversampled constructor arguments.
+   //
+   // The signal is upsampled and downsampled in cascaded 2x stages. The
+   // first stage (next to the base rate) is steep: 8 sections, with the
+   // passband to about 92% of the base Nyquist frequency, and ~100 dB of
+   // rejection. The next stages only need to reject images of the base
+   // band, and use 4 sections each.
+   //
+   // process(...) upsamples a chunk of input through all stages, runs the
+   // processor on the whole chunk, then decimates the chunk back.
+   //
+   // The half-bands are minimum phase IIR filters. latency() is the group
+   // delay at low frequencies, in (fractional) base rate samples.
+   ////////////////////////////////////////////////////////////////////////////
+   template <typename Processor, std::size_t Factor>
+   class oversampled
+   {
+   public:
+
+      static_assert(Factor == 2 || Factor == 4 || Factor == 8,
+         "Error: Factor must be 2, 4 or 8");
+
+      static constexpr std::size_t num_stages =
+         (Factor == 2)? 1 : (Factor == 4)? 2 : 3;
+      static constexpr std::size_t chunk_size = 64;
+
+                              template <typename... Args>
+                              oversampled(Args&&... args);
+
+      float                   operator()(float s);
+      void                    process(float const* in, float* out, std::size_t n);
+      void                    process(float* inout, std::size_t n);
+
+      Processor&              processor()          { return _proc; }
+      Processor const&        processor() const    { return _proc; }
+      double                  latency() const;
+      void                    reset();
+
+   private:
+
+      using first_stage_up = halfband_upsampler<8>;
+      using first_stage_down = halfband_downsampler<8>;
+      using stage_up = halfband_upsampler<4>;
+      using stage_down = halfband_downsampler<4>;
+
+      static constexpr double first_transition = 0.04;
+      static constexpr double transition = 0.24;
+
+      template <std::size_t... I>
+      static std::array<stage_up, sizeof...(I)>
+      make_up(std::index_sequence<I...>)
+      {
+         return {{ (void(I), stage_up{ transition })... }};
+      }
+
+      template <std::size_t... I>
+      static std::array<stage_down, sizeof...(I)>
+      make_down(std::index_sequence<I...>)
+      {
+         return {{ (void(I), stage_down{ transition })... }};
+      }
+
+      void                    chunk(float const* in, float* out, std::size_t n);
+
+      using stages_index = std::make_index_sequence<num_stages - 1>;
+
+      Processor               _proc;
+      first_stage_up          _up0{ first_transition };
+      first_stage_down        _down0{ first_transition };
+      std::array<stage_up, num_stages - 1>    _up = make_up(stages_index{});
+      std::array<stage_down, num_stages - 1>  _down = make_down(stages_index{});
+      std::array<float, chunk_size * Factor>  _buff;
+      std::array<float, chunk_size * Factor>  _tmp;
+   };
+
+   ////////////////////////////////////////////////////////////////////////////
+   // Implementation
+   ////////////////////////////////////////////////////////////////////////////
+   template <std::size_t N>
+   inline void halfband_upsampler<N>::operator()(float s, float* out)
+   {
+      auto a = s, b = s;
+      _paths(a, b);
+      out[0] = a;
+      out[1] = b;
+   }
+
+   template <std::size_t N>
+   inline void halfband_upsampler<N>::process(
+      float const* in, float* out, std::size_t n)
+   {
+      _paths.process(n
+       , [in](std::size_t i, float& a, float& b) { a = b = in[i]; }
+       , [out](std::size_t i, float a, float b)
+         {
+            out[i * 2] = a;
+            out[i * 2 + 1] = b;
+         }
+      );
+   }
+
+   template <std::size_t N>
+   inline float halfband_downsampler<N>::operator()(float const* in)
+   {
+      auto a = in[1], b = in[0];
+      _paths(a, b);
+      return 0.5f * (a + b);
+   }
+
+   template <std::size_t N>
+   inline void halfband_downsampler<N>::process(
+      float const* in, float* out, std::size_t n)
+   {
+      _paths.process(n
+       , [in](std::size_t i, float& a, float& b)
+         {
+            a = in[i * 2 + 1];
+            b = in[i * 2];
+         }
+       , [out](std::size_t i, float a, float b) { out[i] = 0.5f * (a + b); }
+      );
+   }
+
+   template <typename Processor, std::size_t Factor>
+   template <typename... Args>
+   inline oversampled<Processor, Factor>::oversampled(Args&&... args)
+    : _proc(std::forward<Args>(args)...)
+   {}
+
+   template <typename Processor, std::size_t Factor>
+   inline double oversampled<Processor, Factor>::latency() const
+   {
+      // The delay of each stage is in samples of its high rate
+      double d = (_up0.delay() + _down0.delay()) / 2;
+      double rate = 2;
+      for (std::size_t i = 0; i != _up.size(); ++i)
+      {
+         rate *= 2;
+         d += (_up[i].delay() + _down[i].delay()) / rate;
+      }
+      return d;
+   }
+
+   template <typename Processor, std::size_t Factor>
+   inline void oversampled<Processor, Factor>::reset()
+   {
+      _up0.reset();
+      _down0.reset();
+      for (auto& up : _up)
+         up.reset();
+      for (auto& down : _down)
+         down.reset();
+   }
+
+   template <typename Processor, std::size_t Factor>
+   inline void oversampled<Processor, Factor>::chunk(
+      float const* in, float* out, std::size_t n)
+   {
+      // Upsample, one stage at a time. The last stage writes to _buff.
+      float* src = (num_stages % 2)? _buff.data() : _tmp.data();
+      _up0.process(in, src, n);
+
+      auto m = n * 2;
+      for (auto& up : _up)
+      {
+         float* dest = (src == _buff.data())? _tmp.data() : _buff.data();
+         up.process(src, dest, m);
+         src = dest;
+         m *= 2;
+      }
+
+      // Run the processor at the high rate
+      for (std::size_t i = 0; i != m; ++i)
+         _buff[i] = _proc(_buff[i]);
+
+      // Downsample, in reverse order
+      src = _buff.data();
+      for (auto k = _down.size(); k-- != 0;)
+      {
+         float* dest = (src == _buff.data())? _tmp.data() : _buff.data();
+         m /= 2;
+         _down[k].process(src, dest, m);
+         src = dest;
+      }
+      _down0.process(src, out, n);
+   }
+
+   template <typename Processor, std::size_t Factor>
+   inline float oversampled<Processor, Factor>::operator()(float s)
+   {
+      float out;
+      chunk(&s, &out, 1);
+      return out;
+   }
+
+   template <typename Processor, std::size_t Factor>
+   inline void oversampled<Processor, Factor>::process(
+      float const* in, float* out, std::size_t n)
+   {
+      for (std::size_t i = 0; i < n; i += chunk_size)
+         chunk(in + i, out + i, std::min(chunk_size, n - i));
+   }
+
+   template <typename Processor, std::size_t Factor>
+   inline void oversampled<Processor, Factor>::process(float* inout, std::size_t n)
+   {
+      process(inout, inout, n);
+   }
+}
+
+#endif
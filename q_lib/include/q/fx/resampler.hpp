@@ -0,0 +1,293 @@
+/*=============================================================================
+   Copyright (c) 2014-2020 Joel de Guzman. All rights reserved.
+
+   Distributed under the MIT License [ https://opensource.org/licenses/MIT ]
+=============================================================================*/
+#if !defined(CYCFI_Q_RESAMPLER_OCTOBER_18_2026)
+#define CYCFI_Q_RESAMPLER_OCTOBER_18_2026
+
+#include <q/support/base.hpp>
+#include <vector>
+#include <algorithm>
+#include <numeric>
+#include <cmath>
+#include <cstdint>
+
+namespace cycfi::q
+{
+   namespace detail
+   {
+      // Dot product of a and b. n must be a multiple of 8. The partial sums
+      // are kept in 8 independent lanes, which the compiler maps to SIMD
+      // registers without reassociating a single running sum.
+      inline float dot_product(float const* a, float const* b, std::size_t n)
+      {
+         constexpr std::size_t lanes = 8;
+         float acc[lanes] = {};
+         for (std::size_t i = 0; i != n; i += lanes)
+            for (std::size_t j = 0; j != lanes; ++j)
+               acc[j] += a[i + j] * b[i + j];
+
+         float sum = 0.0f;
+         for (std::size_t j = 0; j != lanes; ++j)
+            sum += acc[j];
+         return sum;
+      }
+
+      // Zeroth order modified Bessel function of the first kind
+      inline double bessel_i0(double x)
+      {
+         double sum = 1.0;
+         double term = 1.0;
+         double const x2 = (x * x) / 4;
+         for (int k = 1; k != 64 && term > sum * 1e-17; ++k)
+         {
+            term *= x2 / (double(k) * k);
+            sum += term;
+         }
+         return sum;
+      }
+   }
+
+   ////////////////////////////////////////////////////////////////////////////
+   // resampler: Streaming polyphase sample rate converter.
+   //
+   // Each output sample is the inner product of the latest input samples
+   // and one phase of a Kaiser windowed-sinc lowpass filter, chosen by the
+   // fractional position of the output sample relative to the input.
+   //
+   // For rational ratios (the resampler(sps_in, sps_out) constructor),
+   // the position is tracked exactly, in integer units of 1/L of an input
+   // sample, where sps_out/sps_in = L/M, reduced (e.g. L = 160 for 44.1kHz
+   // to 48kHz). If L is not more than max_phases, the filter has L phases
+   // and every output uses exactly one of them. Otherwise (and for
+   // arbitrary fractional ratios, the resampler(ratio) constructor), the
+   // filter has interpolated_phases phases, and the outputs of the two
+   // nearest phases are linearly interpolated.
+   //
+   // Like the fir, the input history is a linear buffer, with the
+   // latest samples appended after the history, so that the taps of every
+   // output are contiguous. When downsampling, the filter cutoff is lowered
+   // to the output Nyquist frequency, and the filter is made longer by the
+   // same factor, to keep the same transition band (relative to the
+   // output).
+   //
+   // Quality presets:
+   //
+   //    low:     16 taps, ~60 dB stopband, passband to 70% of Nyquist
+   //    medium:  32 taps, ~80 dB stopband, passband to 84% of Nyquist
+   //    high:    64 taps, ~100 dB stopband, passband to 90% of Nyquist
+   //
+   // where Nyquist is that of the lower of the two rates.
+   //
+   // process(in, n, out) consumes all n input samples and returns the
+   // number of output samples written. out must have room for
+   // max_output(n) samples. The output is delayed by latency() input
+   // samples.
+   ////////////////////////////////////////////////////////////////////////////
+   class resampler
+   {
+   public:
+
+      enum quality_type
+      {
+         low
+       , medium
+       , high
+      };
+
+      static constexpr std::size_t max_phases = 1024;
+      static constexpr std::size_t interpolated_phases = 256;
+
+                              resampler(
+                                 std::uint32_t sps_in, std::uint32_t sps_out
+                               , quality_type quality = medium
+                              );
+
+                              resampler(double ratio, quality_type quality = medium);
+
+      std::size_t             process(float const* in, std::size_t n, float* out);
+      std::size_t             max_output(std::size_t n) const;
+
+      double                  ratio() const;
+      std::size_t             latency() const      { return _taps / 2; }
+      std::size_t             num_taps() const     { return _taps; }
+      std::size_t             num_phases() const   { return _phases; }
+      void                    reset();
+
+   private:
+
+      void                    init(
+                                 std::uint64_t step, std::uint64_t denom
+                               , std::size_t phases, quality_type quality
+                              );
+      void                    rewind();
+      float                   compute() const;
+
+      // Time step per output, in units of 1/_denom input samples
+      std::uint64_t           _step_int;
+      std::uint64_t           _step_frac;
+      std::uint64_t           _denom;
+
+      std::size_t             _taps;      // taps per phase (multiple of 8)
+      std::size_t             _phases;
+      bool                    _interpolate;
+      std::vector<float>      _coeffs;    // (_phases + 1) * _taps
+
+      std::vector<float>      _x;         // input history + new samples
+      std::size_t             _pos;       // position of the next new sample
+      std::size_t             _base;      // first tap of the next output
+      std::uint64_t           _frac;      // position of the next output
+   };
+
+   ////////////////////////////////////////////////////////////////////////////
+   // Implementation
+   ////////////////////////////////////////////////////////////////////////////
+   inline resampler::resampler(
+      std::uint32_t sps_in, std::uint32_t sps_out, quality_type quality)
+   {
+      auto const g = std::gcd(sps_in, sps_out);
+      std::uint64_t const l = sps_out / g;
+      std::uint64_t const m = sps_in / g;
+      init(m, l, (l <= max_phases)? l : interpolated_phases, quality);
+   }
+
+   inline resampler::resampler(double ratio, quality_type quality)
+   {
+      constexpr std::uint64_t denom = 1 << 24;
+      auto const step = std::uint64_t(std::round(denom / ratio));
+      init(std::max<std::uint64_t>(step, 1), denom, interpolated_phases, quality);
+   }
+
+   inline void resampler::init(
+      std::uint64_t step, std::uint64_t denom
+    , std::size_t phases, quality_type quality)
+   {
+      struct preset { std::size_t taps; double beta; double cutoff; };
+      constexpr preset presets[] =
+      {
+         { 16, 5.0, 0.70 }
+       , { 32, 8.0, 0.84 }
+       , { 64, 10.0, 0.90 }
+      };
+      auto const& p = presets[quality];
+
+      _step_int = step / denom;
+      _step_frac = step % denom;
+      _denom = denom;
+      _phases = phases;
+      _interpolate = phases != denom;
+
+      // When downsampling, lower the cutoff and lengthen the filter by the
+      // same factor
+      auto const factor = std::max(1.0, double(step) / denom);
+      _taps = std::size_t(std::ceil(p.taps * factor / 8)) * 8;
+      auto const fc = 0.5 * p.cutoff / factor;  // cycles per input sample
+
+      // Phase k is the windowed sinc, offset by k / phases of a sample. One
+      // extra phase (equal to phase 0, shifted by one sample) is added for
+      // interpolation.
+      _coeffs.resize((_phases + 1) * _taps);
+      auto const half = _taps / 2.0;
+      auto const i0_beta = detail::bessel_i0(p.beta);
+      for (std::size_t k = 0; k != _phases + 1; ++k)
+      {
+         float* c = &_coeffs[k * _taps];
+         double sum = 0.0;
+         for (std::size_t j = 0; j != _taps; ++j)
+         {
+            auto const t = double(k) / _phases + half - 1 - j;
+            auto const r = t / half;
+            auto const w = (r * r < 1.0)?
+               detail::bessel_i0(p.beta * std::sqrt(1.0 - r * r)) / i0_beta : 0.0;
+            auto const s = (t == 0.0)?
+               2 * fc : std::sin(2 * pi * fc * t) / (pi * t);
+            c[j] = float(s * w);
+            sum += s * w;
+         }
+
+         // Normalize each phase to unity gain at DC
+         for (std::size_t j = 0; j != _taps; ++j)
+            c[j] = float(c[j] / sum);
+      }
+
+      // Room for the history and at least 256 new samples
+      _x.resize(2 * _taps + _step_int + 256);
+      reset();
+   }
+
+   inline void resampler::reset()
+   {
+      // Start with taps - 1 zeros, so that an output is computed as soon
+      // as the first input sample arrives
+      std::fill(_x.begin(), _x.end(), 0.0f);
+      _pos = _taps - 1;
+      _base = 0;
+      _frac = 0;
+   }
+
+   inline double resampler::ratio() const
+   {
+      return double(_denom) / (_step_int * _denom + _step_frac);
+   }
+
+   inline std::size_t resampler::max_output(std::size_t n) const
+   {
+      return std::size_t(std::ceil(n * ratio())) + 1;
+   }
+
+   inline void resampler::rewind()
+   {
+      // Move the samples still needed back to the front
+      std::copy(_x.begin() + _base, _x.begin() + _pos, _x.begin());
+      _pos -= _base;
+      _base = 0;
+   }
+
+   inline float resampler::compute() const
+   {
+      float const* x = &_x[_base];
+      if (!_interpolate)
+         return detail::dot_product(&_coeffs[_frac * _taps], x, _taps);
+
+      auto const pos = _frac * _phases;
+      auto const k = pos / _denom;
+      auto const mu = float(pos % _denom) / _denom;
+      float const* c = &_coeffs[k * _taps];
+      auto const y0 = detail::dot_product(c, x, _taps);
+      auto const y1 = detail::dot_product(c + _taps, x, _taps);
+      return y0 + mu * (y1 - y0);
+   }
+
+   inline std::size_t resampler::process(float const* in, std::size_t n, float* out)
+   {
+      std::size_t count = 0;
+      while (n != 0)
+      {
+         if (_pos == _x.size())
+            rewind();
+
+         auto const m = std::min(n, _x.size() - _pos);
+         std::copy(in, in + m, _x.begin() + _pos);
+         _pos += m;
+         in += m;
+         n -= m;
+
+         // Compute all the outputs we have the input samples for
+         while (_base + _taps <= _pos)
+         {
+            out[count++] = compute();
+            _base += _step_int;
+            _frac += _step_frac;
+            if (_frac >= _denom)
+            {
+               _frac -= _denom;
+               ++_base;
+            }
+         }
+      }
+      return count;
+   }
+}
+
+#endif
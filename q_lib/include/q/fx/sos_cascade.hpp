@@ -0,0 +1,468 @@
+/*=============================================================================
+   Copyright (c) 2014-2020 Joel de Guzman. All rights reserved.
+
+   Distributed under the MIT License [ https://opensource.org/licenses/MIT ]
+=============================================================================*/
+#if !defined(CYCFI_Q_SOS_CASCADE_OCTOBER_18_2026)
+#define CYCFI_Q_SOS_CASCADE_OCTOBER_18_2026
+
+#include <q/support/literals.hpp>
+#include <q/fx/biquad.hpp>
+#include <infra/assert.hpp>
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace cycfi::q
+{
+   ////////////////////////////////////////////////////////////////////////////
+   // sos_cascade: A cascade of K second-order sections (biquads), for
+   // filters of order 2K.
+   //
+   // Calling K biquads one after another serializes everything: each
+   // section waits for the previous section's output. The block processing
+   // functions instead software-pipeline the sections. The block is split
+   // into chunks of chunk_size samples, and at each stage, section k works
+   // on chunk j-k, taking the output of section k-1 from the previous
+   // stage. The K sections are then independent of each other within a
+   // stage, and run side by side in the SIMD lanes (the coefficients and
+   // state are kept in structure-of-arrays form, as in biquad_bank). The
+   // pipeline is filled at the start and drained at the end of each block,
+   // so there is no added latency, and block processing can be freely
+   // mixed with the per-sample function call operator.
+   //
+   // The pipeline only pays off for long cascades. Up to max_chained
+   // sections (e.g. the LR4 and LR8 crossovers), the block is instead run
+   // through each section in turn, with the 4 sample look-ahead kernel of
+   // biquad::process, which is as fast as a chain of biquads.
+   //
+   // Each section is the transposed direct form II of biquad::process.
+   // Sections may be configured individually from a biquad or a
+   // detail::config_* design struct, but typically, the cascade is
+   // designed by one of the filter types below (butterworth_lowpass,
+   // linkwitz_riley_lowpass, chebyshev_lowpass, etc.)
+   ////////////////////////////////////////////////////////////////////////////
+   template <std::size_t K>
+   class sos_cascade
+   {
+   public:
+
+      static_assert(K > 0, "Error: K must be greater than zero");
+
+      static constexpr std::size_t num_sections = K;
+      static constexpr std::size_t order = 2 * K;
+      static constexpr std::size_t chunk_size = 4;
+      static constexpr std::size_t max_chained = 4;
+
+                              sos_cascade();
+
+      void                    config(std::size_t section, biquad const& bq);
+      void                    config(std::size_t section, detail::config_biquad const& cfg);
+      void                    config(
+                                 std::size_t section
+                               , float b0, float b1, float b2
+                               , float a1, float a2
+                              );
+
+      float                   operator()(float s);
+      void                    process(float const* in, float* out, std::size_t n);
+      void                    process(float* inout, std::size_t n);
+      void                    reset();
+
+   private:
+
+      using lanes = std::array<float, K>;
+
+      alignas(64) lanes       _b0, _k1, _k2, _a1, _a2;
+      alignas(64) lanes       _s1, _s2;
+   };
+
+   namespace detail
+   {
+      /////////////////////////////////////////////////////////////////////////
+      // Bilinear transform of the analog second-order section:
+      //
+      //    lowpass:    w0^2 / (s^2 + (w0/q)s + w0^2)
+      //    highpass:   s^2 / (s^2 + (w0/q)s + w0^2)
+      //
+      // where s is normalized such that the cutoff frequency, f, is at 1
+      // rad/s (the whole filter is prewarped at f). The sections of
+      // Butterworth filters have w0 = 1.
+      /////////////////////////////////////////////////////////////////////////
+      struct config_sos_section
+      {
+         config_sos_section(
+            frequency f, std::uint32_t sps
+          , double w0, double q, bool highpass, double gain = 1.0)
+         {
+            auto c = 1.0 / std::tan(pi * double(f) / sps);
+            auto c2 = c * c;
+            auto w0c = w0 * c / q;
+            auto w02 = w0 * w0;
+
+            a0 = c2 + w0c + w02;
+            a1 = 2.0 * (w02 - c2);
+            a2 = c2 - w0c + w02;
+
+            auto k = gain * (highpass? c2 : w02);
+            b0 = k;
+            b1 = highpass? -2.0 * k : 2.0 * k;
+            b2 = k;
+         }
+
+         template <std::size_t K>
+         void config(sos_cascade<K>& sos, std::size_t section) const
+         {
+            sos.config(
+               section
+             , b0 / a0, b1 / a0, b2 / a0
+             , a1 / a0, a2 / a0
+            );
+         }
+
+         double a0, a1, a2, b0, b1, b2;
+      };
+
+      // Q of the kth of the n/2 sections of an nth order (n even)
+      // Butterworth filter.
+      inline double butterworth_q(std::size_t k, std::size_t n)
+      {
+         return 1.0 / (2.0 * std::cos(pi * (2*k + 1) / (2.0 * n)));
+      }
+
+      template <std::size_t K>
+      inline void config_butterworth(
+         sos_cascade<K>& sos, frequency f, std::uint32_t sps, bool highpass)
+      {
+         for (std::size_t k = 0; k != K; ++k)
+            config_sos_section(f, sps, 1.0, butterworth_q(k, 2*K), highpass)
+               .config(sos, k);
+      }
+
+      // A Linkwitz-Riley filter of order 2K is two cascaded Butterworth
+      // filters of order K.
+      template <std::size_t K>
+      inline void config_linkwitz_riley(
+         sos_cascade<K>& sos, frequency f, std::uint32_t sps, bool highpass)
+      {
+         static_assert(K % 2 == 0,
+            "Error: Linkwitz-Riley filters need an even number of sections");
+
+         for (std::size_t k = 0; k != K/2; ++k)
+         {
+            config_sos_section section{ f, sps, 1.0, butterworth_q(k, K), highpass };
+            section.config(sos, k);
+            section.config(sos, k + K/2);
+         }
+      }
+
+      // Chebyshev type I. The passband ripple is given in dB. The cutoff
+      // frequency is the edge of the passband, where the gain last dips
+      // to -ripple dB. The maximum gain in the passband is 0 dB.
+      template <std::size_t K>
+      inline void config_chebyshev(
+         sos_cascade<K>& sos, frequency f, std::uint32_t sps
+       , double ripple, bool highpass)
+      {
+         constexpr auto n = 2 * K;
+         auto eps = std::sqrt(std::pow(10.0, ripple / 10.0) - 1.0);
+         auto v = std::asinh(1.0 / eps) / n;
+         auto sinh_v = std::sinh(v);
+         auto cosh_v = std::cosh(v);
+
+         for (std::size_t k = 0; k != K; ++k)
+         {
+            // Analog pole pair: -sinh(v)sin(theta) +/- j cosh(v)cos(theta)
+            auto theta = pi * (2*k + 1) / (2.0 * n);
+            auto re = sinh_v * std::sin(theta);
+            auto im = cosh_v * std::cos(theta);
+            auto w0 = std::sqrt(re*re + im*im);
+            auto q = w0 / (2.0 * re);
+
+            // The sections have unity gain at DC (or Nyquist for
+            // highpass). Even order Chebyshev filters start at the bottom
+            // of the ripple, so we scale the first section down.
+            auto gain = (k == 0)? std::pow(10.0, -ripple / 20.0) : 1.0;
+
+            // Highpass: the lowpass to highpass transform, s -> 1/s, maps
+            // the pole pair's w0 to 1/w0 with the same q.
+            config_sos_section section{
+               f, sps, highpass? 1.0 / w0 : w0, q, highpass, gain };
+            section.config(sos, k);
+         }
+      }
+   }
+
+   ////////////////////////////////////////////////////////////////////////////
+   // Butterworth filters of order 2K
+   ////////////////////////////////////////////////////////////////////////////
+   template <std::size_t K>
+   struct butterworth_lowpass : sos_cascade<K>
+   {
+      butterworth_lowpass(frequency f, std::uint32_t sps)
+      {
+         config(f, sps);
+      }
+
+      void config(frequency f, std::uint32_t sps)
+      {
+         detail::config_butterworth(*this, f, sps, false);
+      }
+   };
+
+   template <std::size_t K>
+   struct butterworth_highpass : sos_cascade<K>
+   {
+      butterworth_highpass(frequency f, std::uint32_t sps)
+      {
+         config(f, sps);
+      }
+
+      void config(frequency f, std::uint32_t sps)
+      {
+         detail::config_butterworth(*this, f, sps, true);
+      }
+   };
+
+   ////////////////////////////////////////////////////////////////////////////
+   // Linkwitz-Riley crossover filters of order 2K (e.g. K = 2 for LR4,
+   // K = 4 for LR8). K must be even. The lowpass and highpass outputs sum
+   // to an allpass response, and are -6 dB at the crossover frequency.
+   ////////////////////////////////////////////////////////////////////////////
+   template <std::size_t K>
+   struct linkwitz_riley_lowpass : sos_cascade<K>
+   {
+      linkwitz_riley_lowpass(frequency f, std::uint32_t sps)
+      {
+         config(f, sps);
+      }
+
+      void config(frequency f, std::uint32_t sps)
+      {
+         detail::config_linkwitz_riley(*this, f, sps, false);
+      }
+   };
+
+   template <std::size_t K>
+   struct linkwitz_riley_highpass : sos_cascade<K>
+   {
+      linkwitz_riley_highpass(frequency f, std::uint32_t sps)
+      {
+         config(f, sps);
+      }
+
+      void config(frequency f, std::uint32_t sps)
+      {
+         detail::config_linkwitz_riley(*this, f, sps, true);
+      }
+   };
+
+   ////////////////////////////////////////////////////////////////////////////
+   // Chebyshev type I filters of order 2K, with the passband ripple given
+   // in dB.
+   ////////////////////////////////////////////////////////////////////////////
+   template <std::size_t K>
+   struct chebyshev_lowpass : sos_cascade<K>
+   {
+      chebyshev_lowpass(frequency f, std::uint32_t sps, double ripple = 1.0)
+      {
+         config(f, sps, ripple);
+      }
+
+      void config(frequency f, std::uint32_t sps, double ripple = 1.0)
+      {
+         detail::config_chebyshev(*this, f, sps, ripple, false);
+      }
+   };
+
+   template <std::size_t K>
+   struct chebyshev_highpass : sos_cascade<K>
+   {
+      chebyshev_highpass(frequency f, std::uint32_t sps, double ripple = 1.0)
+      {
+         config(f, sps, ripple);
+      }
+
+      void config(frequency f, std::uint32_t sps, double ripple = 1.0)
+      {
+         detail::config_chebyshev(*this, f, sps, ripple, true);
+      }
+   };
+
+   ////////////////////////////////////////////////////////////////////////////
+   // Implementation
+   ////////////////////////////////////////////////////////////////////////////
+   template <std::size_t K>
+   inline sos_cascade<K>::sos_cascade()
+   {
+      for (std::size_t k = 0; k != K; ++k)
+         config(k, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f);
+      reset();
+   }
+
+   template <std::size_t K>
+   inline void sos_cascade<K>::config(
+      std::size_t section
+    , float b0, float b1, float b2
+    , float a1, float a2
+   )
+   {
+      CYCFI_ASSERT(section < K, "Invalid section.");
+
+      // See biquad::process for the k1 and k2 terms.
+      _b0[section] = b0;
+      _k1[section] = b1 - a1 * b0;
+      _k2[section] = b2 - a2 * b0;
+      _a1[section] = a1;
+      _a2[section] = a2;
+   }
+
+   template <std::size_t K>
+   inline void sos_cascade<K>::config(std::size_t section, biquad const& bq)
+   {
+      config(section, bq.a0, bq.a1, bq.a2, bq.a3, bq.a4);
+   }
+
+   template <std::size_t K>
+   inline void sos_cascade<K>::config(
+      std::size_t section, detail::config_biquad const& cfg)
+   {
+      config(
+         section
+       , cfg.b0 / cfg.a0, cfg.b1 / cfg.a0, cfg.b2 / cfg.a0
+       , cfg.a1 / cfg.a0, cfg.a2 / cfg.a0
+      );
+   }
+
+   template <std::size_t K>
+   inline void sos_cascade<K>::reset()
+   {
+      _s1.fill(0.0f);
+      _s2.fill(0.0f);
+   }
+
+   template <std::size_t K>
+   inline float sos_cascade<K>::operator()(float s)
+   {
+      for (std::size_t k = 0; k != K; ++k)
+      {
+         auto y = _b0[k] * s + _s1[k];
+         auto t = _k1[k] * s - _a1[k] * _s1[k] + _s2[k];
+         _s2[k] = _k2[k] * s - _a2[k] * _s1[k];
+         _s1[k] = t;
+         s = y;
+      }
+      return s;
+   }
+
+   template <std::size_t K>
+   inline void sos_cascade<K>::process(float const* in, float* out, std::size_t n)
+   {
+      if constexpr (K <= max_chained)
+      {
+         for (std::size_t k = 0; k != K; ++k)
+         {
+            detail::biquad_tdf2(
+               _b0[k], _k1[k], _k2[k], _a1[k], _a2[k]
+             , _s1[k], _s2[k], (k == 0)? in : out, out, n
+            );
+         }
+         return;
+      }
+
+      constexpr auto T = chunk_size;
+      if (n < 2 * T)
+      {
+         for (std::size_t i = 0; i != n; ++i)
+            out[i] = (*this)(in[i]);
+         return;
+      }
+
+      // The block is split into chunks of T samples. At stage j, section k
+      // works on chunk j-k. w[t][k] is the input to section k, at sample t
+      // of its chunk: the output of section k-1 from the previous stage
+      // (or the block input, for section 0).
+      auto const chunks = (n + T - 1) / T;
+      auto const last_size = n - (chunks - 1) * T;
+      auto size_of = [&](std::size_t j, std::size_t k) -> std::size_t
+      {
+         if (j < k || j - k >= chunks)
+            return 0;
+         return (j - k == chunks - 1)? last_size : T;
+      };
+
+      alignas(64) float w[T][K] = {};
+      for (std::size_t t = 0; t != T; ++t)
+         w[t][0] = in[t];
+
+      // Keep the state and coefficients in locals for the whole block.
+      alignas(64) lanes s1 = _s1, s2 = _s2;
+      alignas(64) lanes const b0 = _b0, k1 = _k1, k2 = _k2, a1 = _a1, a2 = _a2;
+
+      for (std::size_t j = 0; j != chunks + K - 1; ++j)
+      {
+         if (j >= K-1 && size_of(j, K-1) == T && size_of(j, 0) == T)
+         {
+            // All sections are busy for the whole chunk
+            for (std::size_t t = 0; t != T; ++t)
+            {
+               auto* x = w[t];
+               for (std::size_t k = 0; k != K; ++k)
+               {
+                  auto y = b0[k] * x[k] + s1[k];
+                  auto u = k1[k] * x[k] - a1[k] * s1[k] + s2[k];
+                  s2[k] = k2[k] * x[k] - a2[k] * s1[k];
+                  s1[k] = u;
+                  x[k] = y;
+               }
+            }
+         }
+         else
+         {
+            // Filling or draining the pipeline, or at the last, possibly
+            // short, chunk. Section k is busy for the first size_of(j, k)
+            // samples. Idle sections pass their input through. The result
+            // is never used: it feeds the next section at the next stage,
+            // which is idle there too.
+            for (std::size_t k = 0; k != K; ++k)
+            {
+               auto const size = size_of(j, k);
+               for (std::size_t t = 0; t != size; ++t)
+               {
+                  auto* x = w[t];
+                  auto y = b0[k] * x[k] + s1[k];
+                  auto u = k1[k] * x[k] - a1[k] * s1[k] + s2[k];
+                  s2[k] = k2[k] * x[k] - a2[k] * s1[k];
+                  s1[k] = u;
+                  x[k] = y;
+               }
+            }
+         }
+
+         // Pass the outputs on to the next section, and take in the next
+         // chunk. The output of the last section is done.
+         auto const out_size = size_of(j, K-1);
+         auto const next_size = size_of(j + 1, 0);
+         for (std::size_t t = 0; t != T; ++t)
+         {
+            auto* x = w[t];
+            if (t < out_size)
+               out[(j - (K-1)) * T + t] = x[K-1];
+            for (std::size_t k = K-1; k != 0; --k)
+               x[k] = x[k-1];
+            x[0] = (t < next_size)? in[(j + 1) * T + t] : 0.0f;
+         }
+      }
+
+      _s1 = s1;
+      _s2 = s2;
+   }
+
+   template <std::size_t K>
+   inline void sos_cascade<K>::process(float* inout, std::size_t n)
+   {
+      process(inout, inout, n);
+   }
+}
+
+#endif
@@ -12,6 +12,8 @@
 #include <q/fx/delay.hpp>
 #include <q/fx/moving_average.hpp>
 #include <q/fx/envelope.hpp>
+#include <q/detail/recurrence.hpp>
+#include <algorithm>
 
 namespace cycfi::q
 {
@@ -86,6 +88,27 @@ namespace cycfi::q
          return y;
       }
 
+      // Block processing. See detail::recurrence.
+      void process(float const* in, float* out, std::size_t n)
+      {
+         auto x_ = x;
+         y = detail::recurrence{ _pole }(y, out, n,
+            [&](std::size_t i)
+            {
+               auto const s = in[i];
+               auto const d = s - x_;
+               x_ = s;
+               return d;
+            }
+         );
+         x = x_;
+      }
+
+      void process(float* inout, std::size_t n)
+      {
+         process(inout, inout, n);
+      }
+
       dc_block& operator=(bool y_)
       {
          y = y_;
@@ -249,6 +272,142 @@ namespace cycfi::q
       float low2 = 0.0f;
    };
 
+   namespace detail
+   {
+      ////////////////////////////////////////////////////////////////////////
+      // The two allpass chains of hilbert_quadrature, for N channels, in
+      // SIMD lanes.
+      //
+      // Each polyphase_allpass section is a function of the input and
+      // output two samples back:
+      //
+      //    y[n] = a * (x[n] + y[n-2]) - x[n-2]
+      //
+      // so even and odd samples are independent chains too. A step
+      // processes two samples (even and odd) of both chains (I and Q) of N
+      // channels: 4 * N lanes, lane (chain * 2 + parity) * N + channel.
+      //
+      // Each lane keeps the input, x, and output, y, of each section, two
+      // samples back.
+      ////////////////////////////////////////////////////////////////////////
+      template <std::size_t N>
+      struct hilbert_lanes
+      {
+         static constexpr std::size_t size = 4 * N;
+         static constexpr std::size_t sections = 4;
+         static constexpr std::size_t tile_size = 32;
+
+         // Two samples in v (all lanes), processed in place
+         void step(float* v)
+         {
+            for (std::size_t k = 0; k != sections; ++k)
+            {
+               for (std::size_t l = 0; l != size; ++l)
+               {
+                  auto const r = a[k][l] * (v[l] + y[k][l]) - x[k][l];
+                  x[k][l] = v[l];
+                  y[k][l] = r;
+                  v[l] = r;
+               }
+            }
+         }
+
+         // One sample in the even lanes of v, processed in place. The
+         // roles of the even and odd lanes are then swapped: the odd lanes
+         // hold the state of the latest sample, and the even lanes, the
+         // sample before that.
+         void single(float* v)
+         {
+            auto const save = *this;
+            step(v);
+            for (std::size_t k = 0; k != sections; ++k)
+            {
+               for (std::size_t c = 0; c != 2; ++c)
+               {
+                  for (std::size_t ch = 0; ch != N; ++ch)
+                  {
+                     auto const even = (c * 2) * N + ch;
+                     auto const odd = even + N;
+                     x[k][odd] = x[k][even];
+                     x[k][even] = save.x[k][odd];
+                     y[k][odd] = y[k][even];
+                     y[k][even] = save.y[k][odd];
+                  }
+               }
+            }
+         }
+
+         // Process n frames of N channels. The I output is delayed by one
+         // sample (see hilbert_quadrature), and dly holds the last one.
+         void process(
+            float const* const* in, float* const* i_out, float* const* q_out
+          , float* dly, std::size_t frames)
+         {
+            // Blocks are transposed, a tile of frames at a time, into lanes (two
+            // frames per row), filtered, then transposed back.
+            alignas(64) float buf[tile_size / 2][size];
+            auto const pairs = frames / 2;
+            for (std::size_t pair = 0; pair < pairs; pair += tile_size / 2)
+            {
+               auto const n = std::min(tile_size / 2, pairs - pair);
+               auto const frame = pair * 2;
+
+               for (std::size_t j = 0; j != n; ++j)
+               {
+                  auto* v = buf[j];
+                  for (std::size_t ch = 0; ch != N; ++ch)
+                  {
+                     v[ch] = v[2 * N + ch] = in[ch][frame + j * 2];
+                     v[N + ch] = v[3 * N + ch] = in[ch][frame + j * 2 + 1];
+                  }
+               }
+
+               for (std::size_t j = 0; j != n; ++j)
+                  step(buf[j]);
+
+               for (std::size_t j = 0; j != n; ++j)
+               {
+                  auto const* v = buf[j];
+                  auto const i = frame + j * 2;
+                  for (std::size_t ch = 0; ch != N; ++ch)
+                  {
+                     i_out[ch][i] = dly[ch];
+                     i_out[ch][i + 1] = v[ch];
+                     dly[ch] = v[N + ch];
+                     q_out[ch][i] = v[2 * N + ch];
+                     q_out[ch][i + 1] = v[3 * N + ch];
+                  }
+               }
+            }
+
+            // The last frame, if the number of frames is odd
+            if (frames % 2)
+            {
+               auto const i = frames - 1;
+               auto* v = buf[0];
+               for (std::size_t ch = 0; ch != N; ++ch)
+               {
+                  v[ch] = v[2 * N + ch] = in[ch][i];
+                  v[N + ch] = v[3 * N + ch] = 0.0f;
+               }
+
+               single(v);
+
+               for (std::size_t ch = 0; ch != N; ++ch)
+               {
+                  i_out[ch][i] = dly[ch];
+                  dly[ch] = v[ch];
+                  q_out[ch][i] = v[2 * N + ch];
+               }
+            }
+         }
+
+         alignas(64) float a[sections][size];
+         alignas(64) float x[sections][size];
+         alignas(64) float y[sections][size];
+      };
+   }
+
    ////////////////////////////////////////////////////////////////////////////
    // hilbert_quadrature uses two all-pass IIR filters with a phase
    // difference of approximately 90 degrees over a range of frequencies
@@ -256,6 +415,13 @@ namespace cycfi::q
    //
    // This is probably the most efficient structure for implementing a
    // Hilbert transform (See http://yehar.com/blog/?p=368) by Olli Niemitalo.
+   //
+   // process(in, i_out, q_out, n) processes a block, writing the I
+   // (in-phase) and Q (quadrature) outputs to separate buffers. The two
+   // allpass chains, for two samples at a time, run side by side in SIMD
+   // lanes (see detail::hilbert_lanes). The results are the same as the
+   // function call operator, and the two may be freely mixed. See
+   // hilbert_quadrature_bank for processing multiple channels.
    ////////////////////////////////////////////////////////////////////////////
    struct hilbert_quadrature
    {
@@ -267,6 +433,8 @@ namespace cycfi::q
          };
       }
 
+      void process(float const* in, float* i_out, float* q_out, std::size_t n);
+
       polyphase_allpass _a{ 0.47940086558884 };
       polyphase_allpass _b{ 0.87621849353931 };
       polyphase_allpass _c{ 0.976597589508199 };
@@ -278,6 +446,13 @@ namespace cycfi::q
       polyphase_allpass _z{ 0.990599156684529 };
 
       delay1            _dly;
+
+   private:
+
+      using lanes = detail::hilbert_lanes<1>;
+
+      void              load(lanes& s) const;
+      void              store(lanes const& s);
    };
 
    ////////////////////////////////////////////////////////////////////////////
@@ -398,6 +573,66 @@ namespace cycfi::q
       float                   _onset_threshold;
       float                   _release_threshold;
    };
+
+   ////////////////////////////////////////////////////////////////////////////
+   // Implementation
+   ////////////////////////////////////////////////////////////////////////////
+   inline void hilbert_quadrature::load(lanes& s) const
+   {
+      // Lanes: I even, I odd, Q even, Q odd. The even lanes (the next
+      // sample) need the state two samples back, the odd lanes, one
+      // sample back.
+      polyphase_allpass const* chains[2][4] =
+      {
+         { &_a, &_b, &_c, &_d }
+       , { &_w, &_x, &_y, &_z }
+      };
+      for (std::size_t c = 0; c != 2; ++c)
+      {
+         auto const even = c * 2;
+         auto const odd = even + 1;
+         for (std::size_t k = 0; k != lanes::sections; ++k)
+         {
+            auto const& ap = *chains[c][k];
+            s.a[k][even] = s.a[k][odd] = ap.a;
+            s.x[k][even] = ap.x2;
+            s.x[k][odd] = ap.x1;
+            s.y[k][even] = ap.y2;
+            s.y[k][odd] = ap.y1;
+         }
+      }
+   }
+
+   inline void hilbert_quadrature::store(lanes const& s)
+   {
+      polyphase_allpass* chains[2][4] =
+      {
+         { &_a, &_b, &_c, &_d }
+       , { &_w, &_x, &_y, &_z }
+      };
+      for (std::size_t c = 0; c != 2; ++c)
+      {
+         auto const even = c * 2;
+         auto const odd = even + 1;
+         for (std::size_t k = 0; k != lanes::sections; ++k)
+         {
+            auto& ap = *chains[c][k];
+            ap.x2 = s.x[k][even];
+            ap.x1 = s.x[k][odd];
+            ap.y2 = s.y[k][even];
+            ap.y1 = s.y[k][odd];
+         }
+      }
+   }
+
+   inline void hilbert_quadrature::process(
+      float const* in, float* i_out, float* q_out, std::size_t n)
+   {
+      lanes s;
+      load(s);
+      s.process(&in, &i_out, &q_out, &_dly.y, n);
+      store(s);
+   }
 }
 
 #endif
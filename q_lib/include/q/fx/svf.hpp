@@ -0,0 +1,234 @@
+/*=============================================================================
+   Copyright (c) 2014-2020 Joel de Guzman. All rights reserved.
+
+   Distributed under the MIT License [ https://opensource.org/licenses/MIT ]
+=============================================================================*/
+#if !defined(CYCFI_Q_SVF_OCTOBER_18_2026)
+#define CYCFI_Q_SVF_OCTOBER_18_2026
+
+#include <q/support/base.hpp>
+#include <q/support/literals.hpp>
+#include <cmath>
+
+namespace cycfi::q
+{
+   ////////////////////////////////////////////////////////////////////////////
+   // svf: Topology preserving transform (TPT), trapezoidal integrated state
+   // variable filter, for modulated filters (auto-wah, envelope filters,
+   // sweeps).
+   //
+   // Modulating a biquad means redesigning it, which, with the
+   // detail::config_* structs, costs a handful of double precision
+   // transcendental functions per call. On top of that, the direct form
+   // biquad is not well behaved when its coefficients change quickly.
+   //
+   // The svf is designed from just two parameters: g = tan(pi * f / sps)
+   // and k = 1 / q. Its state (the integrators) is independent of the
+   // coefficients, so the filter is stable for any positive g and k, even
+   // when these change every sample. This makes it possible to design at
+   // control rate, then linearly ramp g and k to the new values over the
+   // next n samples:
+   //
+   //    f.config(freq, sps, q, 32);  // every 32 samples, glide to freq
+   //
+   // fast_config does the same, using the fast_math.hpp tan approximation.
+   // The static responses are the same as the corresponding RBJ biquads
+   // (both are bilinear transforms of the same analog prototypes), with
+   // bandpass matching bandpass_cpg (0 dB peak gain) and peak being
+   // lowpass - highpass.
+   ////////////////////////////////////////////////////////////////////////////
+   class svf
+   {
+   public:
+
+      enum mode_type
+      {
+         lowpass
+       , highpass
+       , bandpass
+       , notch
+       , peak
+       , allpass
+      };
+
+                              svf(
+                                 mode_type mode_
+                               , frequency f, std::uint32_t sps
+                               , double q = 0.707
+                              );
+
+      float                   operator()(float s);
+      void                    process(float const* in, float* out, std::size_t n);
+      void                    process(float* inout, std::size_t n);
+
+      void                    config(frequency f, std::uint32_t sps, double q);
+      void                    config(
+                                 frequency f, std::uint32_t sps, double q
+                               , std::size_t ramp
+                              );
+      void                    fast_config(frequency f, std::uint32_t sps, double q);
+      void                    fast_config(
+                                 frequency f, std::uint32_t sps, double q
+                               , std::size_t ramp
+                              );
+
+      void                    mode(mode_type mode_);
+      mode_type               mode() const { return _mode; }
+      bool                    ramping() const { return _ramp != 0; }
+      void                    reset();
+
+   private:
+
+      float                   tick(float s, float a1, float a2, float a3, float k);
+      void                    target(float g, float k, std::size_t ramp);
+
+      // Current and target coefficients, and the per sample ramp
+      // increments
+      float                   _g, _k;
+      float                   _target_g, _target_k;
+      float                   _dg = 0, _dk = 0;
+      std::size_t             _ramp = 0;
+
+      // Output mix: m0 * v0 + m1 * k * v1 + m2 * v2
+      mode_type               _mode;
+      float                   _m0, _m1, _m2;
+
+      // Integrator states
+      float                   _ic1 = 0, _ic2 = 0;
+   };
+
+   ////////////////////////////////////////////////////////////////////////////
+   // Implementation
+   ////////////////////////////////////////////////////////////////////////////
+   inline svf::svf(mode_type mode_, frequency f, std::uint32_t sps, double q)
+   {
+      mode(mode_);
+      config(f, sps, q);
+   }
+
+   inline void svf::mode(mode_type mode_)
+   {
+      _mode = mode_;
+      switch (_mode)
+      {
+         case lowpass:  _m0 = 0.0f;  _m1 = 0.0f;  _m2 = 1.0f;  break;
+         case highpass: _m0 = 1.0f;  _m1 = -1.0f; _m2 = -1.0f; break;
+         case bandpass: _m0 = 0.0f;  _m1 = 1.0f;  _m2 = 0.0f;  break;
+         case notch:    _m0 = 1.0f;  _m1 = -1.0f; _m2 = 0.0f;  break;
+         case peak:     _m0 = -1.0f; _m1 = 1.0f;  _m2 = 2.0f;  break;
+         case allpass:  _m0 = 1.0f;  _m1 = -2.0f; _m2 = 0.0f;  break;
+      }
+   }
+
+   inline void svf::reset()
+   {
+      _ic1 = _ic2 = 0.0f;
+   }
+
+   inline void svf::target(float g, float k, std::size_t ramp)
+   {
+      _target_g = g;
+      _target_k = k;
+      _ramp = ramp;
+      if (ramp == 0)
+      {
+         _g = g;
+         _k = k;
+      }
+      else
+      {
+         _dg = (g - _g) / ramp;
+         _dk = (k - _k) / ramp;
+      }
+   }
+
+   inline void svf::config(frequency f, std::uint32_t sps, double q)
+   {
+      target(std::tan(pi * double(f) / sps), 1.0 / q, 0);
+   }
+
+   inline void svf::config(
+      frequency f, std::uint32_t sps, double q, std::size_t ramp)
+   {
+      target(std::tan(pi * double(f) / sps), 1.0 / q, ramp);
+   }
+
+   inline void svf::fast_config(frequency f, std::uint32_t sps, double q)
+   {
+      target(fasttan(float(pi) * float(f) / sps), 1.0f / float(q), 0);
+   }
+
+   inline void svf::fast_config(
+      frequency f, std::uint32_t sps, double q, std::size_t ramp)
+   {
+      target(fasttan(float(pi) * float(f) / sps), 1.0f / float(q), ramp);
+   }
+
+   inline float svf::tick(float s, float a1, float a2, float a3, float k)
+   {
+      auto v3 = s - _ic2;
+      auto v1 = a1 * _ic1 + a2 * v3;
+      auto v2 = _ic2 + a2 * _ic1 + a3 * v3;
+      _ic1 = 2.0f * v1 - _ic1;
+      _ic2 = 2.0f * v2 - _ic2;
+      return _m0 * s + _m1 * k * v1 + _m2 * v2;
+   }
+
+   inline float svf::operator()(float s)
+   {
+      if (_ramp)
+      {
+         if (--_ramp == 0)
+         {
+            // Land exactly on the target
+            _g = _target_g;
+            _k = _target_k;
+         }
+         else
+         {
+            _g += _dg;
+            _k += _dk;
+         }
+      }
+      auto a1 = 1.0f / (1.0f + _g * (_g + _k));
+      auto a2 = _g * a1;
+      auto a3 = _g * a2;
+      return tick(s, a1, a2, a3, _k);
+   }
+
+   inline void svf::process(float const* in, float* out, std::size_t n)
+   {
+      std::size_t i = 0;
+
+      // While ramping, the coefficients are updated every sample
+      for (; i != n && _ramp; ++i)
+         out[i] = (*this)(in[i]);
+
+      // Then, they are constant for the rest of the block. Keep the state
+      // in locals for the whole loop.
+      auto const a1 = 1.0f / (1.0f + _g * (_g + _k));
+      auto const a2 = _g * a1;
+      auto const a3 = _g * a2;
+      auto const m0 = _m0, m1 = _m1 * _k, m2 = _m2;
+      auto ic1 = _ic1, ic2 = _ic2;
+      for (; i != n; ++i)
+      {
+         auto s = in[i];
+         auto v3 = s - ic2;
+         auto v1 = a1 * ic1 + a2 * v3;
+         auto v2 = ic2 + a2 * ic1 + a3 * v3;
+         ic1 = 2.0f * v1 - ic1;
+         ic2 = 2.0f * v2 - ic2;
+         out[i] = m0 * s + m1 * v1 + m2 * v2;
+      }
+      _ic1 = ic1;
+      _ic2 = ic2;
+   }
+
+   inline void svf::process(float* inout, std::size_t n)
+   {
+      process(inout, inout, n);
+   }
+}
+
+#endif
@@ -0,0 +1,241 @@
+/*=============================================================================
+   Copyright (c) 2014-2020 Joel de Guzman. All rights reserved.
+
+   Distributed under the MIT License [ https://opensource.org/licenses/MIT ]
+=============================================================================*/
+#if !defined(CYCFI_Q_TRUE_PEAK_METER_OCTOBER_18_2026)
+#define CYCFI_Q_TRUE_PEAK_METER_OCTOBER_18_2026
+
+#include <q/support/base.hpp>
+#include <q/support/audio_stream.hpp>
+#include <infra/assert.hpp>
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace cycfi::q
+{
+   namespace detail
+   {
+      /////////////////////////////////////////////////////////////////////////
+      // The 4x interpolation filter of ITU-R BS.1770-4 (Annex 2): a 48 tap
+      // FIR lowpass, split into its 4 phases of 12 taps each. Phase p of the
+      // output at input sample i is the sum of h[p][k] * x[i - k].
+      /////////////////////////////////////////////////////////////////////////
+      constexpr float true_peak_coefficients[4][12] = {
+         {
+            0.0017089843750f, 0.0109863281250f, -0.0196533203125f
+          , 0.0332031250000f, -0.0594482421875f, 0.1373291015625f
+          , 0.9721679687500f, -0.1022949218750f, 0.0476074218750f
+          , -0.0266113281250f, 0.0148925781250f, -0.0083007812500f
+         }
+       , {
+            -0.0291748046875f, 0.0292968750000f, -0.0517578125000f
+          , 0.0891113281250f, -0.1665039062500f, 0.4650878906250f
+          , 0.7797851562500f, -0.2003173828125f, 0.1015625000000f
+          , -0.0582275390625f, 0.0330810546875f, -0.0189208984375f
+         }
+       , {
+            -0.0189208984375f, 0.0330810546875f, -0.0582275390625f
+          , 0.1015625000000f, -0.2003173828125f, 0.7797851562500f
+          , 0.4650878906250f, -0.1665039062500f, 0.0891113281250f
+          , -0.0517578125000f, 0.0292968750000f, -0.0291748046875f
+         }
+       , {
+            -0.0083007812500f, 0.0148925781250f, -0.0266113281250f
+          , 0.0476074218750f, -0.1022949218750f, 0.9721679687500f
+          , 0.1373291015625f, -0.0594482421875f, 0.0332031250000f
+          , -0.0196533203125f, 0.0109863281250f, 0.0017089843750f
+         }
+      };
+
+      /////////////////////////////////////////////////////////////////////////
+      // true_peak_tile: interpolates a tile of M input samples (4M output
+      // samples) and folds their magnitudes into peak, M lanes of ordered
+      // keys (the bits of the magnitudes, which, being positive, are
+      // ordered like the floats). Only the first m lanes are folded. x
+      // holds the 11 samples of history, followed by the M samples of the
+      // tile (all readable, even if m < M).
+      //
+      // The outputs are accumulated tap by tap, for all the phases, in a
+      // local array. The inner loops run over the samples of the tile with
+      // a single coefficient and contiguous reads, and the maximum is taken
+      // on the integer keys, so the whole tile vectorizes.
+      /////////////////////////////////////////////////////////////////////////
+      template <std::size_t M>
+      inline void true_peak_tile(
+         float const* x, std::int32_t (&peak)[M], std::size_t m = M)
+      {
+         constexpr std::size_t taps = 12;
+         float acc[4][M] = {};
+         for (std::size_t k = 0; k != taps; ++k)
+         {
+            float const* xk = x + (taps - 1 - k);
+            for (std::size_t p = 0; p != 4; ++p)
+            {
+               auto const hk = true_peak_coefficients[p][k];
+               for (std::size_t i = 0; i != M; ++i)
+                  acc[p][i] += hk * xk[i];
+            }
+         }
+
+         for (std::size_t p = 0; p != 4; ++p)
+         {
+            for (std::size_t i = 0; i != M; ++i)
+            {
+               std::int32_t key;
+               std::memcpy(&key, &acc[p][i], sizeof(float));
+               key &= 0x7fffffff;
+               key = (i < m)? key : 0;
+               peak[i] = (key > peak[i])? key : peak[i];
+            }
+         }
+      }
+   }
+
+   ////////////////////////////////////////////////////////////////////////////
+   // true_peak_meter: the true peak level (ITU-R BS.1770-4, Annex 2) of one
+   // or more channels. The signal is interpolated 4x (the polyphase FIR in
+   // detail::true_peak_coefficients), and the true peak is the largest
+   // magnitude of the interpolated samples. Unlike the sample peak (see
+   // peak_envelope_follower), this catches the inter-sample peaks that
+   // appear after D/A conversion or sample rate conversion. The peaks are
+   // linear. Use decibel(peak) for dBTP.
+   //
+   // The meter is updated a block at a time: process(in, n) for a single
+   // channel, or operator()(in) for multichannel audio_channels. Both
+   // return the true peak of the block (of all its channels). block_peak(ch)
+   // is the true peak of the latest block of channel ch, and peak(ch) the
+   // true peak since the last reset.
+   //
+   // The blocks are processed in chunks (chunk_size), one channel at a
+   // time, in tiles of tile_size samples (see detail::true_peak_tile). The
+   // 4x oversampling is meant for 48kHz. It is enough, but more than needed,
+   // at higher sample rates.
+   ////////////////////////////////////////////////////////////////////////////
+   class true_peak_meter
+   {
+   public:
+
+      static constexpr std::size_t oversampling = 4;
+      static constexpr std::size_t taps = 12;      // per phase
+      static constexpr std::size_t tile_size = 32;
+      static constexpr std::size_t chunk_size = 256;
+
+                              true_peak_meter(std::size_t channels = 1);
+
+      float                   process(float const* in, std::size_t n);
+      template <typename In>
+      float                   operator()(In const& in);
+
+      float                   peak() const;
+      float                   peak(std::size_t channel) const;
+      float                   block_peak(std::size_t channel) const;
+
+      std::size_t             channels() const  { return _peak.size(); }
+      void                    reset();
+
+   private:
+
+      using history = std::array<float, taps - 1>;
+
+      float                   process(std::size_t channel, float const* in, std::size_t n);
+
+      std::vector<history>    _history;
+      std::vector<float>      _peak;
+      std::vector<float>      _block_peak;
+   };
+
+   ////////////////////////////////////////////////////////////////////////////
+   // Implementation
+   ////////////////////////////////////////////////////////////////////////////
+   inline true_peak_meter::true_peak_meter(std::size_t channels)
+    : _history(std::max<std::size_t>(channels, 1))
+    , _peak(_history.size())
+    , _block_peak(_history.size())
+   {
+      reset();
+   }
+
+   inline void true_peak_meter::reset()
+   {
+      for (auto& h : _history)
+         h.fill(0.0f);
+      std::fill(_peak.begin(), _peak.end(), 0.0f);
+      std::fill(_block_peak.begin(), _block_peak.end(), 0.0f);
+   }
+
+   inline float true_peak_meter::peak() const
+   {
+      return *std::max_element(_peak.begin(), _peak.end());
+   }
+
+   inline float true_peak_meter::peak(std::size_t channel) const
+   {
+      CYCFI_ASSERT(channel < _peak.size(), "Invalid channel.");
+      return _peak[channel];
+   }
+
+   inline float true_peak_meter::block_peak(std::size_t channel) const
+   {
+      CYCFI_ASSERT(channel < _block_peak.size(), "Invalid channel.");
+      return _block_peak[channel];
+   }
+
+   inline float true_peak_meter::process(
+      std::size_t channel, float const* in, std::size_t n)
+   {
+      constexpr auto h = taps - 1;
+      float buf[h + chunk_size];
+      std::int32_t lanes[tile_size] = {};
+      auto& hist = _history[channel];
+
+      while (n != 0)
+      {
+         // The history, then the chunk, padded to whole tiles
+         auto const m = std::min(n, chunk_size);
+         auto const padded = (m + tile_size - 1) / tile_size * tile_size;
+         std::copy(hist.begin(), hist.end(), buf);
+         std::copy(in, in + m, buf + h);
+         std::fill(buf + h + m, buf + h + padded, 0.0f);
+
+         std::size_t i = 0;
+         for (; i + tile_size <= m; i += tile_size)
+            detail::true_peak_tile(buf + i, lanes);
+         if (i != m)
+            detail::true_peak_tile(buf + i, lanes, m - i);
+
+         std::copy(buf + m, buf + m + h, hist.begin());
+         in += m;
+         n -= m;
+      }
+
+      auto key = *std::max_element(std::begin(lanes), std::end(lanes));
+      float peak;
+      std::memcpy(&peak, &key, sizeof(float));
+      _block_peak[channel] = peak;
+      _peak[channel] = std::max(_peak[channel], peak);
+      return peak;
+   }
+
+   inline float true_peak_meter::process(float const* in, std::size_t n)
+   {
+      CYCFI_ASSERT(_peak.size() == 1, "Not a mono true_peak_meter.");
+      return process(0, in, n);
+   }
+
+   template <typename In>
+   inline float true_peak_meter::operator()(In const& in)
+   {
+      CYCFI_ASSERT(in.size() >= _peak.size(), "Not enough channels.");
+      auto const n = in.frames().last;
+      float peak = 0.0f;
+      for (std::size_t ch = 0; ch != _peak.size(); ++ch)
+         peak = std::max(peak, process(ch, in[ch].begin(), n));
+      return peak;
+   }
+}
+
+#endif
@@ -9,13 +9,23 @@
 #include <q/utility/bitset.hpp>
 #include <q/utility/zero_crossing.hpp>
 #include <q/utility/bitstream_acf.hpp>
+#include <q/utility/fft_acf.hpp>
+#include <q/utility/ring_buffer.hpp>
 #include <q/fx/feature_detection.hpp>
 #include <q/fx/envelope.hpp>
 #include <cmath>
 #include <stdexcept>
+#include <optional>
 
 namespace cycfi::q
 {
+   ////////////////////////////////////////////////////////////////////////////
+   // The period_detector correlates the zero-crossing pulses using bitstream
+   // autocorrelation by default. Alternatively, a float correlation method
+   // (see correlation in fft_acf.hpp) may be selected at construction. The
+   // float methods are more robust with polyphonic or noisy material, at a
+   // higher CPU cost. Both feed the same sub-harmonic arbitration (see
+   // detail::sub_collector).
    ////////////////////////////////////////////////////////////////////////////
    class period_detector
    {
@@ -36,6 +46,7 @@ namespace cycfi::q
                                , frequency highest_freq
                                , std::uint32_t sps
                                , decibel hysteresis
+                               , correlation method = correlation::bitstream
                               );
 
       bool                    operator()(float s);
@@ -50,12 +61,16 @@ namespace cycfi::q
 
       info const&             fundamental() const     { return _fundamental; }
       float                   harmonic(std::size_t index) const;
+      correlation             method() const;
 
    private:
 
       void                    set_bitstream();
       void                    autocorrelate();
       int                     autocorrelate(bitstream_acf<> const& ac, std::size_t& period, bool first) const;
+      float                   autocorrelate(fft_acf const& ac, std::size_t& period) const;
+      float                   refine_period(fft_acf const& ac, float period) const;
+      void                    correlate_samples();
 
       zero_crossing           _zc;
       info                    _fundamental;
@@ -70,6 +85,8 @@ namespace cycfi::q
       mutable std::size_t     _predict_edge = 0;
       std::size_t             _num_pulses = 0;
       bool                    _half_empty = false;
+      std::optional<fft_acf>  _acf;
+      ring_buffer<float>      _samples;
    };
 
    ////////////////////////////////////////////////////////////////////////////
@@ -80,6 +97,7 @@ namespace cycfi::q
     , frequency highest_freq
     , std::uint32_t sps
     , decibel hysteresis
+    , correlation method
    )
     : _zc(hysteresis, float(lowest_freq.period() * 2) * sps)
     , _min_period(float(highest_freq.period()) * sps)
@@ -88,11 +106,20 @@ namespace cycfi::q
     , _weight(2.0 / _zc.window_size())
     , _mid_point(_zc.window_size() / 2)
     , _period_diff_threshold(_mid_point * periodicity_diff_factor)
+    , _samples(method == correlation::bitstream? 1 : _zc.window_size() * 2 + 2)
    {
       if (highest_freq <= lowest_freq)
          throw std::runtime_error(
             "Error: highest_freq <= lowest_freq."
          );
+
+      if (method != correlation::bitstream)
+         _acf.emplace(_zc.window_size(), method);
+   }
+
+   inline correlation period_detector::method() const
+   {
+      return _acf? _acf->method() : correlation::bitstream;
    }
 
    inline void period_detector::set_bitstream()
@@ -279,6 +306,65 @@ namespace cycfi::q
       return count;
    }
 
+   inline float period_detector::autocorrelate(fft_acf const& ac, std::size_t& period) const
+   {
+      // The zero-crossing edges give us the period to within a sample or
+      // so. Search for the peak periodicity around it.
+      auto periodicity = ac(period);
+      auto const start = period;
+
+      // Search upwards for the maximum periodicity
+      for (auto p = start + 1; p <= _mid_point; ++p)
+      {
+         auto c = ac(p);
+         if (c < periodicity)
+            break;
+         periodicity = c;
+         period = p;
+      }
+      // Search downwards for the maximum periodicity
+      for (auto p = start - 1; p > _min_period; --p)
+      {
+         auto c = ac(p);
+         if (c < periodicity)
+            break;
+         periodicity = c;
+         period = p;
+      }
+      return periodicity;
+   }
+
+   inline float period_detector::refine_period(fft_acf const& ac, float period) const
+   {
+      // Find the correlation peak nearest the given period and refine it
+      // to a fraction of a sample using parabolic interpolation. This is
+      // more accurate than the zero-crossing edges of noisy signals.
+      std::size_t p = std::round(period);
+      if (p <= _min_period || p >= _mid_point)
+         return period;
+      autocorrelate(ac, p);
+      if (p <= _min_period || p >= _mid_point)
+         return p;
+
+      auto y0 = ac(p - 1);
+      auto y1 = ac(p);
+      auto y2 = ac(p + 1);
+      auto den = y0 - 2 * y1 + y2;
+      if (den >= 0.0f)
+         return p;
+      return p + 0.5f * (y0 - y2) / den;
+   }
+
+   inline void period_detector::correlate_samples()
+   {
+      // The zero_crossing window is frames [0, window_size). The latest
+      // sample is at frame() + window_size/2 - 1 (see zero_crossing).
+      auto const latest = _zc.frame() + (_zc.window_size() / 2) - 1;
+      _acf->correlate(
+         [&](std::size_t i) { return _samples[latest - i]; }
+      );
+   }
+
    inline void period_detector::autocorrelate()
    {
       auto threshold = _zc.peak_pulse() * pulse_threshold;
@@ -293,6 +379,32 @@ namespace cycfi::q
          _fundamental._periodicity = -1; // force reset
          return;
       }
+      else if (_acf)
+      {
+         correlate_samples();
+         for (std::size_t i = 0; i != _zc.num_edges()-1; ++i)
+         {
+            auto const& first = _zc[i];
+            if (first._peak >= threshold)
+            {
+               for (std::size_t j = i+1; j != _zc.num_edges(); ++j)
+               {
+                  auto const& next = _zc[j];
+                  if (next._peak >= threshold)
+                  {
+                     auto period = first.period(next);
+                     if (period > _mid_point)
+                        break;
+                     if (period >= _min_period)
+                     {
+                        float periodicity = autocorrelate(*_acf, period);
+                        collect({ int(i), int(j), int(period), periodicity });
+                     }
+                  }
+               }
+            }
+         }
+      }
       else
       {
          [&]()
@@ -329,6 +441,13 @@ namespace cycfi::q
 
       // Get the final resuts
       collect.get(collect._fundamental, _fundamental);
+
+      if (_acf && !collect.empty())
+      {
+         auto const& info = collect._fundamental;
+         _fundamental._period =
+            refine_period(*_acf, collect.period_of(info)) / info._harmonic;
+      }
    }
 
    inline bool period_detector::operator()(float s)
@@ -336,6 +455,8 @@ namespace cycfi::q
       // Zero crossing
       bool prev = _zc();
       bool zc = _zc(s);
+      if (_acf)
+         _samples.push(s);
 
       if (!zc && prev != zc)
       {
@@ -365,6 +486,9 @@ namespace cycfi::q
          auto target_period = _fundamental._period / index;
          if (target_period >= _min_period && target_period < _mid_point)
          {
+            if (_acf)
+               return (*_acf)(std::round(target_period));
+
             bitstream_acf<> ac{ _bits };
             auto count = ac(std::round(target_period));
             float periodicity = 1.0f - (count * _weight);
@@ -31,6 +31,7 @@ namespace cycfi::q
                                , frequency highest_freq
                                , std::uint32_t sps
                                , decibel hysteresis = default_hysteresis
+                               , correlation method = correlation::bitstream
                               );
 
       bool                    operator()(float s);
@@ -66,8 +67,9 @@ namespace cycfi::q
      , q::frequency highest_freq
      , std::uint32_t sps
      , decibel hysteresis
+     , correlation method
    )
-     : _pd{ lowest_freq, highest_freq, sps, hysteresis }
+     : _pd{ lowest_freq, highest_freq, sps, hysteresis, method }
      , _sps{ sps }
    {}
 
@@ -0,0 +1,322 @@
+/*=============================================================================
+   Copyright (c) 2014-2020 Joel de Guzman. All rights reserved.
+
+   Distributed under the MIT License [ https://opensource.org/licenses/MIT ]
+=============================================================================*/
+#if !defined(CYCFI_Q_FFT_ACF_OCTOBER_18_2026)
+#define CYCFI_Q_FFT_ACF_OCTOBER_18_2026
+
+#include <q/support/base.hpp>
+#include <q/support/literals.hpp>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace cycfi::q
+{
+   ////////////////////////////////////////////////////////////////////////////
+   // Correlation methods available to the period_detector:
+   //
+   //    bitstream:  Bitstream autocorrelation of the zero-crossing pulses
+   //                (see bitstream_acf). The fastest, but the binary pulse
+   //                stream loses information with polyphonic or noisy
+   //                material.
+   //
+   //    acf:        Normalized float autocorrelation, r(t) / sqrt(e0 * et),
+   //                where e0 and et are the energies of the two correlated
+   //                segments.
+   //
+   //    nsdf:       McLeod's normalized square difference function (MPM),
+   //                2 * r(t) / (e0 + et).
+   //
+   //    yin:        1 - d'(t), where d'(t) is YIN's cumulative mean
+   //                normalized difference function.
+   //
+   // The float methods are computed by fft_acf in O(N log N).
+   ////////////////////////////////////////////////////////////////////////////
+   enum class correlation
+   {
+      bitstream
+    , acf
+    , nsdf
+    , yin
+   };
+
+   namespace detail
+   {
+      // In-place radix-2 FFT of run-time size n (a power of two), with the
+      // same layout and sign convention as fft<N> and ifft<N> (the inverse
+      // is scaled by 1/n). w holds e^(+i2pi*k/w_size) for k in [0, w_size/2)
+      // as interleaved (real, imaginary) pairs, where w_size is a multiple
+      // of n. Unlike fft<N>, this does not instantiate code per size.
+      inline void runtime_fft(
+         double* data, std::size_t n, double const* w, std::size_t w_size
+       , bool inverse)
+      {
+         // Bit reversal permutation
+         for (std::size_t i = 1, j = 0; i < n; ++i)
+         {
+            auto bit = n >> 1;
+            for (; j & bit; bit >>= 1)
+               j ^= bit;
+            j ^= bit;
+            if (i < j)
+            {
+               std::swap(data[i*2], data[j*2]);
+               std::swap(data[i*2 + 1], data[j*2 + 1]);
+            }
+         }
+
+         // Butterflies. The forward transform uses e^(-i2pi*k/len).
+         double const sign = inverse? 1.0 : -1.0;
+         for (std::size_t len = 2; len <= n; len *= 2)
+         {
+            auto const half = len / 2;
+            auto const step = (w_size / len) * 2;
+            for (std::size_t i = 0; i != n; i += len)
+            {
+               auto* a = data + i*2;
+               auto* b = a + half*2;
+               for (std::size_t k = 0; k != half; ++k)
+               {
+                  double wr = w[k*step], wi = sign * w[k*step + 1];
+                  double tr = b[k*2]*wr - b[k*2 + 1]*wi;
+                  double ti = b[k*2]*wi + b[k*2 + 1]*wr;
+                  b[k*2] = a[k*2] - tr;
+                  b[k*2 + 1] = a[k*2 + 1] - ti;
+                  a[k*2] += tr;
+                  a[k*2 + 1] += ti;
+               }
+            }
+         }
+
+         if (inverse)
+         {
+            double const scale = 1.0 / n;
+            for (std::size_t i = 0; i != n*2; ++i)
+               data[i] *= scale;
+         }
+      }
+   }
+
+   ////////////////////////////////////////////////////////////////////////////
+   // The fft_acf computes the float autocorrelation of a window of samples
+   // through the FFT, in O(N log N) instead of the O(N^2) of the direct
+   // method. Just like bitstream_acf, the first half of the window is
+   // correlated with the window shifted by pos, for all positions from 0
+   // to window_size/2:
+   //
+   //    r(pos) = sum(x[i] * x[i + pos]), for i in [0, window_size/2)
+   //
+   // Computing the correlation of a half window against the full window
+   // does not suffer from circular wrap-around, so an FFT of window_size
+   // (rounded up to a power of two) is sufficient. The two real signals
+   // (the half window and the full window) are packed into a single
+   // complex FFT, and the (real) correlation is recovered with a half-size
+   // inverse FFT.
+   //
+   // r(pos) is then normalized by the selected correlation method (see
+   // correlation above), giving a periodicity value for each position,
+   // where 1.0 is perfect correlation.
+   //
+   // Call correlate(x) once per window, where x(i) returns the ith sample
+   // of the window, then use the function call operator to get the
+   // periodicity at each position. The fft_acf allocates its buffers at
+   // construction.
+   ////////////////////////////////////////////////////////////////////////////
+   class fft_acf
+   {
+   public:
+
+      static constexpr std::size_t max_window_size = 65536;
+
+                              fft_acf(std::size_t window_size, correlation method);
+
+                              template <typename F>
+      void                    correlate(F&& x);
+
+      float                   operator()(std::size_t pos) const;
+      std::size_t             window_size() const     { return _window_size; }
+      std::size_t             fft_size() const        { return _fft_size; }
+      correlation             method() const          { return _method; }
+
+   private:
+
+      void                    transform();
+      void                    normalize();
+
+      std::size_t const       _window_size;
+      std::size_t const       _mid_point;
+      std::size_t const       _fft_size;
+      correlation const       _method;
+      std::vector<double>     _data;         // fft_size complex
+      std::vector<double>     _twiddle;      // fft_size/2 complex
+      std::vector<double>     _energy;       // prefix sums of x[i]^2
+      std::vector<float>      _result;       // periodicity, mid_point+1
+   };
+
+   ////////////////////////////////////////////////////////////////////////////
+   // Implementation
+   ////////////////////////////////////////////////////////////////////////////
+   inline fft_acf::fft_acf(std::size_t window_size, correlation method)
+    : _window_size(window_size)
+    , _mid_point(window_size / 2)
+    , _fft_size(smallest_pow2(std::max<std::size_t>(window_size, 8)))
+    , _method(method)
+    , _data(_fft_size * 2)
+    , _twiddle(_fft_size)
+    , _energy(window_size + 1)
+    , _result(_mid_point + 1)
+   {
+      if (_fft_size > max_window_size)
+         throw std::runtime_error(
+            "Error: fft_acf window_size is too large."
+         );
+
+      if (method == correlation::bitstream)
+         throw std::runtime_error(
+            "Error: fft_acf does not support bitstream correlation."
+         );
+
+      // e^(+i2pi*k/fft_size), for k in [0, fft_size/2)
+      for (std::size_t k = 0; k != _fft_size / 2; ++k)
+      {
+         auto angle = 2_pi * double(k) / _fft_size;
+         _twiddle[k*2] = std::cos(angle);
+         _twiddle[k*2 + 1] = std::sin(angle);
+      }
+   }
+
+   template <typename F>
+   inline void fft_acf::correlate(F&& x)
+   {
+      // Pack the half window (real part) and the full window (imaginary
+      // part) in one complex signal, zero padded to fft_size.
+      _energy[0] = 0.0;
+      for (std::size_t i = 0; i != _window_size; ++i)
+      {
+         double s = x(i);
+         _data[i*2] = (i < _mid_point)? s : 0.0;
+         _data[i*2 + 1] = s;
+         _energy[i + 1] = _energy[i] + s*s;
+      }
+      std::fill(_data.begin() + _window_size*2, _data.end(), 0.0);
+
+      transform();
+      normalize();
+   }
+
+   inline void fft_acf::transform()
+   {
+      auto const n = _fft_size;
+      auto const m = n / 2;
+      auto* z = _data.data();
+
+      detail::runtime_fft(z, n, _twiddle.data(), n, false);
+
+      // Unpack the spectra of the half window, A, and the full window, B,
+      // and compute the cross spectrum, C = conj(A) * B, for k in [0, n/2].
+      // C is Hermitian (r is real) so that is all we need. C[k] needs Z[k]
+      // and Z[n-k] only, so we can write C[k] over Z[k] as we go.
+      for (std::size_t k = 0; k <= m; ++k)
+      {
+         auto nk = (n - k) & (n - 1);
+         double zr = z[k*2], zi = z[k*2 + 1];
+         double wr = z[nk*2], wi = -z[nk*2 + 1];    // conj(Z[n-k])
+         double ar = 0.5 * (zr + wr), ai = 0.5 * (zi + wi);
+         double br = 0.5 * (zi - wi), bi = -0.5 * (zr - wr);
+         z[k*2] = ar*br + ai*bi;
+         z[k*2 + 1] = ar*bi - ai*br;
+      }
+
+      // Half size inverse real FFT: fold C into the m point complex
+      // spectrum Y[k] = E[k] + iO[k], where E and O are the spectra of the
+      // even and odd samples of r. The inverse then gives r[2j] in the real
+      // and r[2j+1] in the imaginary parts. Y[k] and Y[m-k] both need C[k]
+      // and C[m-k], so we compute them in pairs.
+      auto fold = [this, z, m](std::size_t k, double& yr, double& yi)
+      {
+         double cr = z[k*2], ci = z[k*2 + 1];
+         double dr = z[(m-k)*2], di = -z[(m-k)*2 + 1];  // conj(C[m-k])
+         double er = 0.5 * (cr + dr), ei = 0.5 * (ci + di);
+         double fr = 0.5 * (cr - dr), fi = 0.5 * (ci - di);
+         double tr = _twiddle[k*2], ti = _twiddle[k*2 + 1];
+         double or_ = fr*tr - fi*ti, oi = fr*ti + fi*tr;
+         yr = er - oi;
+         yi = ei + or_;
+      };
+
+      {
+         double yr, yi;
+         fold(0, yr, yi);
+         z[0] = yr;
+         z[1] = yi;
+      }
+      for (std::size_t k = 1; k <= m/2; ++k)
+      {
+         double ar, ai, br, bi;
+         fold(k, ar, ai);
+         fold(m - k, br, bi);
+         z[k*2] = ar;
+         z[k*2 + 1] = ai;
+         z[(m-k)*2] = br;
+         z[(m-k)*2 + 1] = bi;
+      }
+
+      detail::runtime_fft(z, m, _twiddle.data(), n, true);
+   }
+
+   inline void fft_acf::normalize()
+   {
+      // After correlate(), r[pos] is in _data[pos]
+      auto const* r = _data.data();
+      auto const* e = _energy.data();
+      auto const mid = _mid_point;
+      auto const e0 = e[mid];
+
+      switch (_method)
+      {
+         case correlation::acf:
+            for (std::size_t pos = 0; pos <= mid; ++pos)
+            {
+               auto et = e[pos + mid] - e[pos];
+               auto den = std::sqrt(e0 * et);
+               _result[pos] = (den > 0.0)? r[pos] / den : 0.0f;
+            }
+            break;
+
+         case correlation::nsdf:
+            for (std::size_t pos = 0; pos <= mid; ++pos)
+            {
+               auto den = e0 + (e[pos + mid] - e[pos]);
+               _result[pos] = (den > 0.0)? 2.0 * r[pos] / den : 0.0f;
+            }
+            break;
+
+         case correlation::yin:
+         {
+            _result[0] = 1.0f;
+            double sum = 0.0;
+            for (std::size_t pos = 1; pos <= mid; ++pos)
+            {
+               auto d = std::max(e0 + (e[pos + mid] - e[pos]) - 2.0 * r[pos], 0.0);
+               sum += d;
+               _result[pos] = (sum > 0.0)? 1.0 - (d * pos / sum) : 1.0f;
+            }
+            break;
+         }
+
+         default:
+            break;
+      }
+   }
+
+   inline float fft_acf::operator()(std::size_t pos) const
+   {
+      return (pos <= _mid_point)? _result[pos] : 0.0f;
+   }
+}
+
+#endif
@@ -0,0 +1,90 @@
+/*=============================================================================
+   Copyright (c) 2014-2020 Joel de Guzman. All rights reserved.
+
+   Distributed under the MIT License [ https://opensource.org/licenses/MIT ]
+=============================================================================*/
+#if !defined(CYCFI_Q_WINDOW_OCTOBER_18_2026)
+#define CYCFI_Q_WINDOW_OCTOBER_18_2026
+
+#include <q/support/base.hpp>
+#include <q/detail/window_table.hpp>
+#include <cstddef>
+
+namespace cycfi::q
+{
+   namespace detail
+   {
+      // Look up a window table at position pos (0.0 to 1.0), interpolating
+      // linearly between table points.
+      template <std::size_t N>
+      constexpr float window_lookup(float pos, float const (&table)[N])
+      {
+         constexpr auto size = N - 1;
+         auto const x = pos * size;
+         auto const index = std::size_t(x);
+         if (index >= size)
+            return table[size];
+         return linear_interpolate(table[index], table[index + 1], x - index);
+      }
+   }
+
+   ////////////////////////////////////////////////////////////////////////////
+   // Window functions. These are computed from the precomputed tables in
+   // q/detail/window_table.hpp. The function call operator takes a position
+   // pos, from 0.0 to 1.0, spanning one full period of the window.
+   //
+   // Use window_periodic for spectral analysis (e.g. stft). Use
+   // window_symmetric for FIR filter design.
+   ////////////////////////////////////////////////////////////////////////////
+   struct hann_window
+   {
+      constexpr float operator()(float pos) const
+      {
+         return detail::window_lookup(pos, detail::hann_table);
+      }
+   };
+
+   struct hamming_window
+   {
+      constexpr float operator()(float pos) const
+      {
+         return detail::window_lookup(pos, detail::hamming_table);
+      }
+   };
+
+   struct blackman_window
+   {
+      constexpr float operator()(float pos) const
+      {
+         return detail::window_lookup(pos, detail::blackman_table);
+      }
+   };
+
+   struct rectangular_window
+   {
+      constexpr float operator()(float /*pos*/) const
+      {
+         return 1.0f;
+      }
+   };
+
+   ////////////////////////////////////////////////////////////////////////////
+   // Get the ith point of a periodic (DFT-even) window of the given size.
+   ////////////////////////////////////////////////////////////////////////////
+   template <typename Window>
+   constexpr float window_periodic(Window const& w, std::size_t i, std::size_t size)
+   {
+      return w(float(i) / size);
+   }
+
+   ////////////////////////////////////////////////////////////////////////////
+   // Get the ith point of a symmetric window of the given size.
+   ////////////////////////////////////////////////////////////////////////////
+   template <typename Window>
+   constexpr float window_symmetric(Window const& w, std::size_t i, std::size_t size)
+   {
+      return (size < 2)? 1.0f : w(float(i) / (size - 1));
+   }
+}
+
+#endif
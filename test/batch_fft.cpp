@@ -0,0 +1,160 @@
+/*=============================================================================
+   Copyright (c) 2014-2020 Joel de Guzman. All rights reserved.
+
+   Distributed under the MIT License [ https://opensource.org/licenses/MIT ]
+=============================================================================*/
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <infra/doctest.hpp>
+
+#include <q/support/literals.hpp>
+#include <q/fft/batch_fft.hpp>
+#include <vector>
+#include <array>
+#include <iostream>
+#include <iomanip>
+#include <cmath>
+#include "benchmark.hpp"
+
+namespace q = cycfi::q;
+using namespace q::literals;
+
+namespace
+{
+   template <std::size_t N, std::size_t K>
+   struct test_data
+   {
+      test_data()
+      {
+         for (std::size_t k = 0; k != K; ++k)
+         {
+            real[k].resize(N);
+            complex[k].resize(N * 2);
+            for (std::size_t i = 0; i != N; ++i)
+            {
+               real[k][i] =
+                  0.5 * std::sin(2_pi * i * (k + 1) / N) +
+                  0.3 * std::cos(2_pi * i * (3 * k + 7) / N) +
+                  0.1 * ((q::fast_rand() / 16384.0f) - 1.0f)
+               ;
+               complex[k][i*2] = real[k][i];
+               complex[k][i*2 + 1] = 0.2 * std::sin(2_pi * i * (k + 2) / N);
+            }
+            real_ptrs[k] = real[k].data();
+            complex_ptrs[k] = complex[k].data();
+         }
+      }
+
+      std::array<std::vector<float>, K>   real;
+      std::array<std::vector<double>, K>  complex;
+      std::array<float const*, K>         real_ptrs;
+      std::array<double*, K>              complex_ptrs;
+   };
+
+   template <std::size_t N, std::size_t K>
+   void check_batch_fft()
+   {
+      test_data<N, K> data;
+      auto const input = data.complex;
+      auto expected = data.complex;
+      for (auto& ch : expected)
+         q::fft<N>(ch.data());
+
+      q::batch_fft<N, K> fft;
+      fft(data.complex_ptrs.data());
+
+      for (std::size_t k = 0; k != K; ++k)
+         for (std::size_t i = 0; i != N * 2; ++i)
+            CHECK(data.complex[k][i] == doctest::Approx(expected[k][i]).epsilon(1e-9));
+
+      // Round trip
+      fft.inverse(data.complex_ptrs.data());
+      for (std::size_t k = 0; k != K; ++k)
+         for (std::size_t i = 0; i != N * 2; ++i)
+            CHECK(data.complex[k][i] == doctest::Approx(input[k][i]).epsilon(1e-9));
+   }
+}
+
+TEST_CASE("Batch_FFT")
+{
+   check_batch_fft<2, 1>();
+   check_batch_fft<4, 3>();
+   check_batch_fft<64, 4>();
+   check_batch_fft<256, 6>();
+   check_batch_fft<1024, 8>();
+}
+
+TEST_CASE("Batch_FFT_Real")
+{
+   constexpr std::size_t n = 512;
+   constexpr std::size_t k = 6;
+
+   test_data<n, k> data;
+   std::array<std::vector<double>, k> expected;
+   for (std::size_t ch = 0; ch != k; ++ch)
+   {
+      expected[ch].resize(n * 2);
+      for (std::size_t i = 0; i != n; ++i)
+      {
+         expected[ch][i*2] = data.real[ch][i];
+         expected[ch][i*2 + 1] = 0.0;
+      }
+      q::fft<n>(expected[ch].data());
+   }
+
+   q::batch_fft<n, k> fft;
+   fft(data.real_ptrs.data(), data.complex_ptrs.data());
+
+   for (std::size_t ch = 0; ch != k; ++ch)
+      for (std::size_t i = 0; i != n * 2; ++i)
+         CHECK(data.complex[ch][i] == doctest::Approx(expected[ch][i]).epsilon(1e-9));
+}
+
+namespace
+{
+   template <std::size_t N, std::size_t K>
+   void benchmark_batch_fft()
+   {
+      test_data<N, K> data;
+      q::batch_fft<N, K> fft;
+
+      auto t1 = benchmark::run(
+         [&]
+         {
+            for (int r = 0; r != 100; ++r)
+               for (auto p : data.complex_ptrs)
+                  q::fft<N>(p);
+            benchmark::keep(data.complex[0][1]);
+         }
+      ) / 100;
+
+      auto t2 = benchmark::run(
+         [&]
+         {
+            for (int r = 0; r != 100; ++r)
+               fft(data.complex_ptrs.data());
+            benchmark::keep(data.complex[0][1]);
+         }
+      ) / 100;
+
+      std::cout
+         << std::setw(6) << N << std::setw(4) << K
+         << std::setw(18) << std::fixed << std::setprecision(2) << t1 / 1000
+         << std::setw(18) << t2 / 1000
+         << std::setw(10) << t1 / t2 << 'x'
+         << std::endl;
+   }
+}
+
+TEST_CASE("Batch_FFT_Benchmark" * doctest::skip())
+{
+   std::cout
+      << std::endl
+      << "     N   K   fft<N> x K (us)   batch_fft (us)   speedup"
+      << std::endl;
+
+   benchmark_batch_fft<256, 6>();
+   benchmark_batch_fft<256, 8>();
+   benchmark_batch_fft<1024, 6>();
+   benchmark_batch_fft<1024, 8>();
+   benchmark_batch_fft<4096, 8>();
+}
@@ -0,0 +1,55 @@
+/*=============================================================================
+   Copyright (c) 2014-2020 Joel de Guzman. All rights reserved.
+
+   Distributed under the MIT License [ https://opensource.org/licenses/MIT ]
+=============================================================================*/
+#if !defined(CYCFI_Q_TEST_BENCHMARK_HPP_OCTOBER_18_2026)
+#define CYCFI_Q_TEST_BENCHMARK_HPP_OCTOBER_18_2026
+
+#include <chrono>
+#include <algorithm>
+#include <limits>
+
+////////////////////////////////////////////////////////////////////////////////
+// Benchmarks are test cases decorated with doctest::skip(), for example:
+//
+//    TEST_CASE("Convolver_Benchmark" * doctest::skip())
+//
+// so that a plain run of a test executable runs only the unit tests, which
+// are fast and deterministic. Run the executable with --no-skip to also
+// run (and print) the benchmarks.
+////////////////////////////////////////////////////////////////////////////////
+namespace benchmark
+{
+   ////////////////////////////////////////////////////////////////////////////
+   // Call f() repeat times and return the fastest run in nanoseconds. The
+   // fastest run is the least disturbed by the rest of the system.
+   ////////////////////////////////////////////////////////////////////////////
+   template <typename F>
+   inline double run(F&& f, int repeat = 5)
+   {
+      using clock = std::chrono::high_resolution_clock;
+      auto best = std::numeric_limits<double>::max();
+      for (int i = 0; i != repeat; ++i)
+      {
+         auto start = clock::now();
+         f();
+         auto stop = clock::now();
+         best = std::min(
+            best, std::chrono::duration<double, std::nano>(stop - start).count());
+      }
+      return best;
+   }
+
+   ////////////////////////////////////////////////////////////////////////////
+   // Keep the compiler from optimizing away the computation of val.
+   ////////////////////////////////////////////////////////////////////////////
+   template <typename T>
+   inline void keep(T const& val)
+   {
+      [[maybe_unused]] static T volatile sink;
+      sink = val;
+   }
+}
+
+#endif
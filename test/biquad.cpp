@@ -0,0 +1,229 @@
+/*=============================================================================
+   Copyright (c) 2014-2020 Joel de Guzman. All rights reserved.
+
+   Distributed under the MIT License [ https://opensource.org/licenses/MIT ]
+=============================================================================*/
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <infra/doctest.hpp>
+
+#include <q/support/literals.hpp>
+#include <q/fx/biquad.hpp>
+#include <vector>
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include "benchmark.hpp"
+#include "test_signal.hpp"
+
+namespace q = cycfi::q;
+using namespace q::literals;
+
+constexpr auto sps = 48000;
+
+namespace
+{
+   // Double precision direct form I reference, with the same coefficients
+   template <typename Filter>
+   std::vector<double> reference(Filter const& f, std::vector<float> const& in)
+   {
+      std::vector<double> out(in.size());
+      double x1 = 0, x2 = 0, y1 = 0, y2 = 0;
+      for (std::size_t i = 0; i != in.size(); ++i)
+      {
+         double x = in[i];
+         double y = f.a0 * x + f.a1 * x1 + f.a2 * x2 - f.a3 * y1 - f.a4 * y2;
+         x2 = x1;
+         x1 = x;
+         y2 = y1;
+         y1 = y;
+         out[i] = y;
+      }
+      return out;
+   }
+
+   double max_error(std::vector<float> const& out, std::vector<double> const& ref)
+   {
+      double error = 0.0;
+      for (std::size_t i = 0; i != out.size(); ++i)
+         error = std::max(error, std::abs(out[i] - ref[i]));
+      return error;
+   }
+
+   template <typename Filter>
+   void check_process(Filter const& filter)
+   {
+      auto const in = test::noise(4096);
+      auto const ref = reference(filter, in);
+
+      // Per-sample, single precision
+      auto f1 = filter;
+      std::vector<float> out1(in.size());
+      for (std::size_t i = 0; i != in.size(); ++i)
+         out1[i] = f1(in[i]);
+
+      // In place, with odd block sizes, mixed with per-sample calls
+      auto f2 = filter;
+      auto out2 = in;
+      std::size_t sizes[] = { 1, 2, 3, 64, 1, 100, 17, 256, 8, 9 };
+      std::size_t i = 0;
+      for (std::size_t k = 0; i < out2.size(); ++k)
+      {
+         auto n = std::min(sizes[k % std::size(sizes)], out2.size() - i);
+         if (k % 7 == 6)
+         {
+            for (auto j = i; j != i + n; ++j)
+               out2[j] = f2(out2[j]);
+         }
+         else
+         {
+            f2.process(&out2[i], n);
+         }
+         i += n;
+      }
+
+      // Out of place
+      auto f3 = filter;
+      std::vector<float> out3(in.size());
+      f3.process(in.data(), out3.data(), in.size());
+
+      // Block processing should be as accurate as per-sample processing
+      auto error = max_error(out1, ref);
+      auto limit = std::max(error * 2, 1e-5);
+      CHECK(max_error(out2, ref) <= limit);
+      CHECK(max_error(out3, ref) <= limit);
+   }
+}
+
+TEST_CASE("Biquad_Process")
+{
+   check_process(q::lowpass{ 1_kHz, sps });
+   check_process(q::highpass{ 200_Hz, sps, 0.5 });
+   check_process(q::bandpass_csg{ 800_Hz, sps, q::bw{ 1.0 } });
+   check_process(q::bandpass_cpg{ 800_Hz, sps, 2.0 });
+   check_process(q::allpass{ 3_kHz, sps });
+   check_process(q::notch{ 60_Hz, sps, 10.0 });
+   check_process(q::peaking{ 6.0, 2_kHz, sps, 1.4 });
+   check_process(q::lowshelf{ -4.0, 100_Hz, sps });
+   check_process(q::highshelf{ 3.0, 8_kHz, sps });
+}
+
+namespace
+{
+   // The compile time design shares the formulas of the run time design,
+   // but not the math (series instead of <cmath>), so the coefficients may
+   // differ in the last bits
+   void check_coeffs(q::biquad_coeffs const& c, q::biquad const& f)
+   {
+      CHECK(c.b0 == doctest::Approx(f.a0).epsilon(1e-6));
+      CHECK(c.b1 == doctest::Approx(f.a1).epsilon(1e-6));
+      CHECK(c.b2 == doctest::Approx(f.a2).epsilon(1e-6));
+      CHECK(c.a1 == doctest::Approx(f.a3).epsilon(1e-6));
+      CHECK(c.a2 == doctest::Approx(f.a4).epsilon(1e-6));
+   }
+}
+
+TEST_CASE("Constexpr_Math")
+{
+   namespace d = q::detail;
+   for (double x : { -20.0, -3.0, -0.5, 0.0, 1e-3, 0.7, 1.5, 3.1, 7.0, 20.0 })
+   {
+      CHECK(d::constexpr_sin(x) == doctest::Approx(std::sin(x)).epsilon(1e-14));
+      CHECK(d::constexpr_cos(x) == doctest::Approx(std::cos(x)).epsilon(1e-14));
+      CHECK(d::constexpr_exp(x) == doctest::Approx(std::exp(x)).epsilon(1e-14));
+   }
+
+   // sinh at small arguments, where exp(x) - exp(-x) cancels
+   for (double x : { 1e-12, -1e-8, 1e-5, 1e-3, 0.01, 0.5, 0.999, 1.0, 4.0 })
+   {
+      INFO("x = " << x);
+      auto expected = std::sinh(x);
+      CHECK(std::abs(d::constexpr_sinh(x) - expected) <= 1e-15 * std::abs(expected));
+   }
+
+   for (double x : { 1e-6, 0.5, 2.0, 1e6 })
+      CHECK(d::constexpr_sqrt(x) == doctest::Approx(std::sqrt(x)).epsilon(1e-15));
+   for (double x : { -2.0, -0.15, 0.0, 0.3, 3.0 })
+      CHECK(d::constexpr_pow10(x) == doctest::Approx(std::pow(10.0, x)).epsilon(1e-14));
+}
+
+TEST_CASE("Biquad_Constexpr")
+{
+   // These are all computed at compile time
+   constexpr auto lp = q::lowpass_coeffs(1_kHz, sps, 0.707);
+   constexpr auto hp = q::highpass_coeffs(200_Hz, sps, 0.5);
+   constexpr auto bp1 = q::bandpass_csg_coeffs(800_Hz, sps, q::bw{ 1.0 });
+   constexpr auto bp2 = q::bandpass_cpg_coeffs(800_Hz, sps, 2.0);
+   constexpr auto ap = q::allpass_coeffs(3_kHz, sps);
+   constexpr auto nt = q::notch_coeffs(60_Hz, sps, 10.0);
+   constexpr auto pk = q::peaking_coeffs(6.0, 2_kHz, sps, 1.4);
+   constexpr auto pk_bw = q::peaking_coeffs(-3.0, 500_Hz, sps, q::bw{ 2.0 });
+   constexpr auto ls = q::lowshelf_coeffs(-4.0, 100_Hz, sps);
+   constexpr auto hs = q::highshelf_coeffs(3.0, 8_kHz, sps);
+
+   static_assert(lp.b0 > 0 && lp.b1 == 2 * lp.b0);
+   static_assert(nt.b0 == nt.b2);
+
+   check_coeffs(lp, q::lowpass{ 1_kHz, sps, 0.707 });
+   check_coeffs(hp, q::highpass{ 200_Hz, sps, 0.5 });
+   check_coeffs(bp1, q::bandpass_csg{ 800_Hz, sps, q::bw{ 1.0 } });
+   check_coeffs(bp2, q::bandpass_cpg{ 800_Hz, sps, 2.0 });
+   check_coeffs(ap, q::allpass{ 3_kHz, sps });
+   check_coeffs(nt, q::notch{ 60_Hz, sps, 10.0 });
+   check_coeffs(pk, q::peaking{ 6.0, 2_kHz, sps, 1.4 });
+   check_coeffs(pk_bw, q::peaking{ -3.0, 500_Hz, sps, q::bw{ 2.0 } });
+   check_coeffs(ls, q::lowshelf{ -4.0, 100_Hz, sps });
+   check_coeffs(hs, q::highshelf{ 3.0, 8_kHz, sps });
+
+   // High and low frequencies, where the range reduction matters
+   check_coeffs(q::lowpass_coeffs(20_Hz, sps), q::lowpass{ 20_Hz, sps });
+   check_coeffs(q::lowpass_coeffs(20_kHz, sps), q::lowpass{ 20_kHz, sps });
+   check_coeffs(q::highpass_coeffs(15_kHz, 44100), q::highpass{ 15_kHz, 44100 });
+
+   // A filter constructed from the coefficients
+   q::biquad f{ lp };
+   q::lowpass g{ 1_kHz, sps, 0.707 };
+   for (auto s : test::noise(1024))
+      CHECK(f(s) == doctest::Approx(g(s)).epsilon(1e-4).scale(1));
+}
+
+TEST_CASE("Biquad_Benchmark" * doctest::skip())
+{
+   constexpr std::size_t buffer_size = 128;
+   auto const in = test::noise(48000);
+   std::vector<float> out(in.size());
+
+   auto per_sample = [&](auto& filter)
+   {
+      return benchmark::run(
+         [&]
+         {
+            for (std::size_t i = 0; i != in.size(); ++i)
+               out[i] = filter(in[i]);
+            benchmark::keep(out.back());
+         }
+      ) / in.size();
+   };
+
+   auto block = [&](auto& filter)
+   {
+      return benchmark::run(
+         [&]
+         {
+            for (std::size_t i = 0; i < in.size(); i += buffer_size)
+               filter.process(&in[i], &out[i], std::min(buffer_size, in.size() - i));
+            benchmark::keep(out.back());
+         }
+      ) / in.size();
+   };
+
+   q::peaking f1{ 4.0, 3_kHz, sps, 2.0 };
+   q::peaking f2 = f1;
+   auto t1 = per_sample(f1);
+   auto t2 = block(f2);
+
+   std::cout
+      << std::endl
+      << "Peaking EQ, " << buffer_size << " sample buffers (ns/sample)" << std::endl
+      << "   per-sample:    " << std::fixed << std::setprecision(2) << t1 << std::endl
+      << "   process():     " << t2 << std::endl;
+}
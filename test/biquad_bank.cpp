@@ -0,0 +1,198 @@
+/*=============================================================================
+   Copyright (c) 2014-2020 Joel de Guzman. All rights reserved.
+
+   Distributed under the MIT License [ https://opensource.org/licenses/MIT ]
+=============================================================================*/
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <infra/doctest.hpp>
+
+#include <q/support/literals.hpp>
+#include <q/fx/biquad_bank.hpp>
+#include <vector>
+#include <iostream>
+#include <iomanip>
+#include "benchmark.hpp"
+
+namespace q = cycfi::q;
+using namespace q::literals;
+
+constexpr auto sps = 48000;
+
+namespace
+{
+   struct multichannel
+   {
+      multichannel(std::size_t channels, std::size_t frames)
+       : _data(channels, std::vector<float>(frames))
+       , _ptrs(channels)
+       , _cptrs(channels)
+      {
+         for (std::size_t ch = 0; ch != channels; ++ch)
+         {
+            for (auto& s : _data[ch])
+               s = (q::fast_rand() / 16384.0f) - 1.0f;
+            _ptrs[ch] = _data[ch].data();
+            _cptrs[ch] = _data[ch].data();
+         }
+      }
+
+      q::audio_channels<float> channels()
+      {
+         return { _ptrs.data(), _ptrs.size(), _data[0].size() };
+      }
+
+      q::audio_channels<float const> const_channels()
+      {
+         return { _cptrs.data(), _cptrs.size(), _data[0].size() };
+      }
+
+      std::vector<std::vector<float>>  _data;
+      std::vector<float*>              _ptrs;
+      std::vector<float const*>        _cptrs;
+   };
+
+   // A different filter on each channel
+   q::biquad make_filter(std::size_t ch)
+   {
+      switch (ch % 6)
+      {
+         case 0: return q::lowpass{ 1_kHz * (ch + 1), sps };
+         case 1: return q::highpass{ 100_Hz * (ch + 1), sps, 0.5 };
+         case 2: return q::peaking{ 6.0, 500_Hz * (ch + 1), sps, 2.0 };
+         case 3: return q::lowshelf{ -3.0, 200_Hz, sps };
+         case 4: return q::highshelf{ 4.0, 6_kHz, sps };
+         default: return q::notch{ 60_Hz * (ch + 1), sps, 5.0 };
+      }
+   }
+
+   template <std::size_t N>
+   void check_bank(std::size_t frames, std::size_t block_size)
+   {
+      multichannel in{ N, frames };
+      multichannel out{ N, frames };
+
+      q::biquad_bank<N> bank;
+      std::vector<q::biquad> ref;
+      for (std::size_t ch = 0; ch != N; ++ch)
+      {
+         ref.push_back(make_filter(ch));
+         if (ch == 1)
+            bank.config(ch, q::detail::config_highpass(200_Hz, sps, 0.5));
+         else
+            bank.config(ch, ref.back());
+      }
+      if (N > 1)
+         ref[1] = q::highpass{ 200_Hz, sps, 0.5 };
+
+      for (std::size_t i = 0; i < frames; i += block_size)
+      {
+         auto n = std::min(block_size, frames - i);
+         std::vector<float const*> ip(N);
+         std::vector<float*> op(N);
+         for (std::size_t ch = 0; ch != N; ++ch)
+         {
+            ip[ch] = in._data[ch].data() + i;
+            op[ch] = out._data[ch].data() + i;
+         }
+         bank(
+            q::audio_channels<float const>{ ip.data(), N, n }
+          , q::audio_channels<float>{ op.data(), N, n }
+         );
+      }
+
+      for (std::size_t ch = 0; ch != N; ++ch)
+      {
+         auto& f = ref[ch];
+         for (std::size_t i = 0; i != frames; ++i)
+         {
+            INFO("channel = " << ch << ", index = " << i);
+            auto expected = f(in._data[ch][i]);
+            CHECK(out._data[ch][i] == doctest::Approx(expected).epsilon(0.001).scale(1));
+         }
+      }
+
+      // In place
+      bank.reset();
+      bank(in.channels());
+      CHECK(in._data[0][frames-1] == doctest::Approx(out._data[0][frames-1]).epsilon(0.001));
+   }
+}
+
+TEST_CASE("Biquad_Bank")
+{
+   check_bank<1>(1000, 128);
+   check_bank<4>(1000, 100);
+   check_bank<8>(4096, 128);
+   check_bank<16>(4096, 37);
+}
+
+TEST_CASE("Biquad_Bank_Unconfigured")
+{
+   multichannel in{ 4, 256 };
+   auto original = in._data;
+   q::biquad_bank<4> bank;
+   bank(in.channels());
+   CHECK(in._data == original);
+}
+
+namespace
+{
+   template <std::size_t N>
+   void benchmark_bank()
+   {
+      // One second at 48kHz, in 128 sample buffers. The same buffers are
+      // used over and over, as they would be in an audio callback, where
+      // they are hot in the cache.
+      constexpr std::size_t buffer_size = 128;
+      constexpr std::size_t iterations = 48000 / buffer_size;
+      multichannel in{ N, buffer_size };
+      multichannel out{ N, buffer_size };
+
+      std::vector<q::biquad> filters;
+      q::biquad_bank<N> bank;
+      for (std::size_t ch = 0; ch != N; ++ch)
+      {
+         filters.push_back(make_filter(ch));
+         bank.config(ch, filters.back());
+      }
+
+      auto t1 = benchmark::run(
+         [&]
+         {
+            for (std::size_t i = 0; i != iterations; ++i)
+               for (std::size_t ch = 0; ch != N; ++ch)
+                  filters[ch].process(
+                     in._data[ch].data(), out._data[ch].data(), buffer_size);
+            benchmark::keep(out._data[0].back());
+         }
+      ) / (iterations * buffer_size * N);
+
+      auto t2 = benchmark::run(
+         [&]
+         {
+            for (std::size_t i = 0; i != iterations; ++i)
+               bank(in.const_channels(), out.channels());
+            benchmark::keep(out._data[0].back());
+         }
+      ) / (iterations * buffer_size * N);
+
+      std::cout
+         << std::setw(4) << N
+         << std::setw(16) << std::fixed << std::setprecision(2) << t1
+         << std::setw(16) << t2
+         << std::setw(10) << t1 / t2 << 'x'
+         << std::endl;
+   }
+}
+
+TEST_CASE("Biquad_Bank_Benchmark" * doctest::skip())
+{
+   std::cout
+      << std::endl
+      << "ns per channel per sample, 128 sample buffers" << std::endl
+      << "   N   biquad::process     biquad_bank   speedup" << std::endl;
+
+   benchmark_bank<4>();
+   benchmark_bank<8>();
+   benchmark_bank<16>();
+}
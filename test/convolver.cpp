@@ -0,0 +1,187 @@
+/*=============================================================================
+   Copyright (c) 2014-2020 Joel de Guzman. All rights reserved.
+
+   Distributed under the MIT License [ https://opensource.org/licenses/MIT ]
+=============================================================================*/
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <infra/doctest.hpp>
+
+#include <q/support/literals.hpp>
+#include <q/fx/convolver.hpp>
+#include <infra/iterator_range.hpp>
+#include <vector>
+#include <iostream>
+#include <iomanip>
+#include <cmath>
+#include "benchmark.hpp"
+#include "test_signal.hpp"
+
+namespace q = cycfi::q;
+using namespace q::literals;
+
+namespace
+{
+   // Exponentially decaying noise (a crude cabinet/room impulse response)
+   std::vector<float> impulse_response(std::size_t size)
+   {
+      auto ir = test::noise(size);
+      for (std::size_t i = 0; i != size; ++i)
+         ir[i] *= std::exp(-5.0f * i / size);
+      return ir;
+   }
+
+   // Direct (time domain) convolution, for reference.
+   struct direct_convolver
+   {
+      direct_convolver(std::vector<float> const& ir)
+       : _ir(ir)
+       , _x(ir.size() * 2, 0.0f)
+       , _pos(ir.size())
+      {}
+
+      float operator()(float s)
+      {
+         // Doubled delay line for contiguous reads
+         auto const n = _ir.size();
+         if (_pos == 0)
+            _pos = n;
+         --_pos;
+         _x[_pos] = _x[_pos + n] = s;
+
+         float y = 0.0f;
+         auto const* x = _x.data() + _pos;
+         for (std::size_t i = 0; i != n; ++i)
+            y += _ir[i] * x[i];
+         return y;
+      }
+
+      std::vector<float> _ir;
+      std::vector<float> _x;
+      std::size_t _pos;
+   };
+
+   template <std::size_t B>
+   void check_convolver(std::size_t ir_size, std::size_t block_size)
+   {
+      auto const ir = impulse_response(ir_size);
+      auto const in = test::noise(std::max<std::size_t>(ir_size * 3, 1024));
+
+      direct_convolver direct{ ir };
+      std::vector<float> expected(in.size());
+      for (std::size_t i = 0; i != in.size(); ++i)
+         expected[i] = direct(in[i]);
+
+      q::convolver<B> conv{ ir };
+      std::vector<float> out(in.size());
+      for (std::size_t i = 0; i < in.size(); i += block_size)
+      {
+         auto n = std::min(block_size, in.size() - i);
+         conv(&in[i], &out[i], n);
+      }
+
+      auto latency = conv.latency();
+      for (std::size_t i = latency; i != in.size(); ++i)
+      {
+         INFO("index = " << i);
+         CHECK(out[i] == doctest::Approx(expected[i - latency]).epsilon(0.0001));
+      }
+   }
+
+   template <typename F>
+   double time_per_sample(F& f, std::vector<float> const& in)
+   {
+      auto ns = benchmark::run(
+         [&]
+         {
+            float sum = 0.0f;
+            for (auto s : in)
+               sum += f(s);
+            benchmark::keep(sum);
+         }
+      );
+      return ns / in.size();
+   }
+}
+
+TEST_CASE("Convolver")
+{
+   check_convolver<64>(1, 64);
+   check_convolver<64>(64, 64);
+   check_convolver<64>(1000, 17);
+   check_convolver<128>(2048, 128);
+   check_convolver<256>(3000, 100);
+}
+
+TEST_CASE("Convolver_Per_Sample")
+{
+   auto const ir = impulse_response(500);
+   auto const in = test::noise(2000);
+
+   direct_convolver direct{ ir };
+   q::convolver<32> conv{ ir };
+
+   std::vector<float> expected(in.size());
+   for (std::size_t i = 0; i != in.size(); ++i)
+      expected[i] = direct(in[i]);
+
+   for (std::size_t i = 0; i != in.size(); ++i)
+   {
+      auto y = conv(in[i]);
+      if (i >= conv.latency())
+         CHECK(y == doctest::Approx(expected[i - conv.latency()]).epsilon(0.0001));
+   }
+}
+
+TEST_CASE("Convolver_Range")
+{
+   auto const ir = impulse_response(300);
+   auto const in = test::noise(1000);
+
+   q::convolver<64> ref{ ir };
+   std::vector<float> expected(in.size());
+   ref(in.data(), expected.data(), in.size());
+
+   using in_range = cycfi::iterator_range<float const*>;
+   using out_range = cycfi::iterator_range<float*>;
+
+   // Empty ranges are allowed (and do nothing)
+   q::convolver<64> conv{ ir };
+   conv(in_range{}, out_range{});
+
+   std::vector<float> out(in.size());
+   conv(
+      in_range{ in.data(), in.data() + in.size() }
+    , out_range{ out.data(), out.data() + out.size() }
+   );
+   for (std::size_t i = 0; i != in.size(); ++i)
+      CHECK(out[i] == expected[i]);
+}
+
+TEST_CASE("Convolver_Benchmark" * doctest::skip())
+{
+   // Compare direct convolution with uniformly partitioned convolution
+   // (block size 128) over a range of impulse response lengths.
+   auto const in = test::noise(48000);
+
+   std::cout
+      << std::endl
+      << "IR length   direct (ns/sample)   partitioned<128> (ns/sample)"
+      << std::endl;
+
+   for (std::size_t ir_size = 16; ir_size <= 8192; ir_size *= 2)
+   {
+      auto const ir = impulse_response(ir_size);
+      direct_convolver direct{ ir };
+      q::convolver<128> conv{ ir };
+
+      auto t1 = time_per_sample(direct, in);
+      auto t2 = time_per_sample(conv, in);
+
+      std::cout
+         << std::setw(9) << ir_size
+         << std::setw(21) << std::fixed << std::setprecision(1) << t1
+         << std::setw(31) << t2
+         << ((t2 < t1)? "  <- partitioned is faster" : "")
+         << std::endl;
+   }
+}
@@ -0,0 +1,165 @@
+/*=============================================================================
+   Copyright (c) 2014-2020 Joel de Guzman. All rights reserved.
+
+   Distributed under the MIT License [ https://opensource.org/licenses/MIT ]
+=============================================================================*/
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <infra/doctest.hpp>
+
+#include <q/support/base.hpp>
+#include <q/support/decibel.hpp>
+#include <q/detail/db_poly.hpp>
+#include <vector>
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include "benchmark.hpp"
+
+namespace q = cycfi::q;
+
+namespace
+{
+   // Linear values, log spaced, from 1e-6 to 1e6 (-120 dB to 120 dB)
+   std::vector<float> linear_values(std::size_t size)
+   {
+      std::vector<float> sig(size);
+      for (std::size_t i = 0; i != size; ++i)
+         sig[i] = std::pow(10.0, -6.0 + (12.0 * i) / (size - 1));
+      return sig;
+   }
+
+   // Decibels, from -120 dB to 120 dB
+   std::vector<float> db_values(std::size_t size)
+   {
+      std::vector<float> sig(size);
+      for (std::size_t i = 0; i != size; ++i)
+         sig[i] = -120.0 + (240.0 * i) / (size - 1);
+      return sig;
+   }
+}
+
+TEST_CASE("Fast_a2db")
+{
+   auto const in = linear_values(1000000);
+   std::vector<float> out(in.size());
+   q::detail::fast_a2db(in.data(), out.data(), in.size());
+
+   double max_error = 0.0, max_table_error = 0.0;
+   for (std::size_t i = 0; i != in.size(); ++i)
+   {
+      auto expected = 20.0 * std::log10(double(in[i]));
+      max_error = std::max(max_error, std::abs(out[i] - expected));
+      max_table_error = std::max(
+         max_table_error, std::abs(q::detail::a2db(in[i]) - expected));
+      CHECK(out[i] == q::detail::fast_a2db(in[i]));
+   }
+
+   std::cout
+      << "fast_a2db max error: " << max_error << " dB"
+      << " (table: " << max_table_error << " dB)" << std::endl;
+   CHECK(max_error < 2e-5);
+
+   // Clamped to +-120 dB
+   CHECK(q::detail::fast_a2db(0.0f) == doctest::Approx(-120.0f));
+   CHECK(q::detail::fast_a2db(1e9f) == doctest::Approx(120.0f));
+   CHECK(q::detail::fast_a2db(1.0f) == 0.0f);
+}
+
+TEST_CASE("Fast_db2a")
+{
+   auto const in = db_values(1000000);
+   std::vector<float> out(in.size());
+   q::detail::fast_db2a(in.data(), out.data(), in.size());
+
+   double max_error = 0.0, max_table_error = 0.0;
+   for (std::size_t i = 0; i != in.size(); ++i)
+   {
+      auto expected = std::pow(10.0, in[i] / 20.0);
+      max_error = std::max(max_error, std::abs(out[i] / expected - 1.0));
+      max_table_error = std::max(
+         max_table_error, std::abs(q::detail::db2a(in[i]) / expected - 1.0));
+      CHECK(out[i] == q::detail::fast_db2a(in[i]));
+   }
+
+   std::cout
+      << "fast_db2a max relative error: " << max_error
+      << " (table: " << max_table_error << ")" << std::endl;
+   CHECK(max_error < 1.2e-6);
+
+   // Clamped to +-120 dB
+   CHECK(q::detail::fast_db2a(-200.0f) == doctest::Approx(1e-6f));
+   CHECK(q::detail::fast_db2a(200.0f) == doctest::Approx(1e6f));
+   CHECK(q::detail::fast_db2a(0.0f) == 1.0f);
+
+   // Round trip
+   for (auto a : { 1e-5f, 0.001f, 0.5f, 1.0f, 2.0f, 100.0f, 12345.0f })
+      CHECK(q::detail::fast_db2a(q::detail::fast_a2db(a)) == doctest::Approx(a).epsilon(1e-5));
+}
+
+TEST_CASE("Fast_Decibel_Benchmark" * doctest::skip())
+{
+   // Audio levels, in 256 sample buffers
+   constexpr std::size_t buffer_size = 256;
+   constexpr std::size_t iterations = 1000;
+
+   std::vector<float> lin(buffer_size), db(buffer_size), out(buffer_size);
+   for (std::size_t i = 0; i != buffer_size; ++i)
+   {
+      lin[i] = (q::fast_rand() / 32768.0f) + 1e-3f;
+      db[i] = (q::fast_rand() / 32768.0f) * -60.0f;
+   }
+
+   auto run = [&](auto f, std::vector<float> const& in)
+   {
+      return benchmark::run(
+         [&]
+         {
+            for (std::size_t i = 0; i != iterations; ++i)
+            {
+               f(in.data(), out.data());
+               benchmark::keep(out[0]);
+            }
+         }
+      ) / (iterations * buffer_size);
+   };
+
+   auto t1 = run(
+      [](float const* in, float* out)
+      {
+         for (std::size_t i = 0; i != buffer_size; ++i)
+            out[i] = q::detail::a2db(in[i]);
+      }, lin);
+
+   auto t2 = run(
+      [](float const* in, float* out)
+      {
+         q::detail::fast_a2db(in, out, buffer_size);
+      }, lin);
+
+   auto t3 = run(
+      [](float const* in, float* out)
+      {
+         for (std::size_t i = 0; i != buffer_size; ++i)
+            out[i] = q::detail::db2a(in[i]);
+      }, db);
+
+   auto t4 = run(
+      [](float const* in, float* out)
+      {
+         q::detail::fast_db2a(in, out, buffer_size);
+      }, db);
+
+   auto const a2db_tables =
+      sizeof(q::detail::db_table0) + sizeof(q::detail::db_table1)
+      + sizeof(q::detail::db_table2);
+   auto const db2a_tables = sizeof(q::detail::inv_db_table);
+
+   std::cout
+      << std::endl
+      << "Decibel conversion, ns per sample (table size)" << std::endl
+      << std::fixed << std::setprecision(2)
+      << "   a2db table:       " << t1 << " (" << a2db_tables << " bytes)" << std::endl
+      << "   fast_a2db:        " << t2 << " (" << t1 / t2 << "x)" << std::endl
+      << "   db2a table:       " << t3 << " (" << db2a_tables << " bytes)" << std::endl
+      << "   fast_db2a:        " << t4 << " (" << t3 / t4 << "x)" << std::endl;
+}
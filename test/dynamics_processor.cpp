@@ -0,0 +1,322 @@
+/*=============================================================================
+   Copyright (c) 2014-2020 Joel de Guzman. All rights reserved.
+
+   Distributed under the MIT License [ https://opensource.org/licenses/MIT ]
+=============================================================================*/
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <infra/doctest.hpp>
+
+#include <q/support/literals.hpp>
+#include <q/fx/envelope.hpp>
+#include <q/fx/dynamics_processor.hpp>
+#include <vector>
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include "benchmark.hpp"
+#include "test_signal.hpp"
+
+namespace q = cycfi::q;
+using namespace q::literals;
+
+constexpr auto sps = 44100;
+
+namespace
+{
+   // Noise at varying levels: -40 dB to 0 dB, in steps
+   std::vector<float> program(std::size_t size)
+   {
+      auto sig = test::noise(size);
+      for (std::size_t i = 0; i != size; ++i)
+         sig[i] *= float(q::decibel{ -40.0 + ((i / 2000) % 5) * 10.0, q::decibel::direct });
+      return sig;
+   }
+
+   // The gain processors, block vs per sample
+   template <typename GC>
+   void check_gain_computer(GC gc)
+   {
+      std::vector<float> env(1000), gain(env.size());
+      for (std::size_t i = 0; i != env.size(); ++i)
+         env[i] = -60.0f + i * 0.06f;
+      gc(env.data(), gain.data(), env.size());
+      for (std::size_t i = 0; i != env.size(); ++i)
+      {
+         INFO("env = " << env[i]);
+         auto ref = gc(q::decibel{ env[i], q::decibel::direct });
+         CHECK(gain[i] == doctest::Approx(ref.val).epsilon(1e-5).scale(1));
+      }
+   }
+}
+
+TEST_CASE("Gain_Computer_Blocks")
+{
+   check_gain_computer(q::compressor{ -18_dB, 1.0 / 4 });
+   check_gain_computer(q::soft_knee_compressor{ -18_dB, 6_dB, 1.0 / 4 });
+   check_gain_computer(q::expander{ -30_dB, 2.0 });
+
+   q::agc agc{ 12_dB };
+   std::vector<float> env(1000), gain(env.size());
+   for (std::size_t i = 0; i != env.size(); ++i)
+      env[i] = -60.0f + i * 0.06f;
+   agc(env.data(), -6_dB, gain.data(), env.size());
+   for (std::size_t i = 0; i != env.size(); ++i)
+   {
+      auto ref = agc(q::decibel{ env[i], q::decibel::direct }, -6_dB);
+      CHECK(gain[i] == doctest::Approx(ref.val).epsilon(1e-5).scale(1));
+   }
+}
+
+TEST_CASE("Dynamics_Processor")
+{
+   // Against the per sample chain (see test/compressor_expander1.cpp):
+   // envelope -> decibel -> compressor and expander -> gain
+   auto const in = program(50000);
+   auto env = q::peak_envelope_follower{ 50_ms, sps };
+   auto comp = q::compressor{ -18_dB, 1.0 / 4 };
+   auto exp = q::expander{ -30_dB, 2.0 };
+   auto makeup = 4_dB;
+
+   auto dyn = q::dynamics_processor{ env, comp, exp };
+   dyn.makeup_gain(makeup);
+
+   // In odd sized blocks, in place
+   auto out = in;
+   std::size_t i = 0;
+   for (std::size_t k = 0; i < in.size(); ++k)
+   {
+      auto n = std::min(test::block_sizes[k % std::size(test::block_sizes)], in.size() - i);
+      dyn.process(&out[i], n);
+      i += n;
+   }
+
+   double max_error = 0.0;
+   for (std::size_t i = 0; i != in.size(); ++i)
+   {
+      auto s = in[i];
+      auto e = q::decibel(env(std::abs(s)));
+      auto gain = float(comp(e) + exp(e) + makeup);
+      max_error = std::max(max_error, std::abs(double(out[i]) - s * gain));
+   }
+
+   // Within the errors of the decibel tables
+   CHECK(max_error < 1e-4);
+
+   // Sample by sample, through the same stages
+   auto dyn1 = q::dynamics_processor{ q::peak_envelope_follower{ 50_ms, sps }, comp, exp };
+   dyn1.makeup_gain(makeup);
+   max_error = 0.0;
+   for (std::size_t i = 0; i != in.size(); ++i)
+      max_error = std::max(max_error, std::abs(double(out[i]) - dyn1(in[i])));
+   CHECK(max_error < 1e-5);
+   CHECK(dyn1.gain() == doctest::Approx(dyn.gain()).epsilon(1e-5));
+}
+
+TEST_CASE("Dynamics_Processor_Benchmark" * doctest::skip())
+{
+   // The chains of test/compressor_expander1.cpp and
+   // test/compressor_ff_fb.cpp (feedforward), one second, in 256 sample
+   // buffers
+   constexpr std::size_t buffer_size = 256;
+   constexpr std::size_t iterations = sps / buffer_size;
+   auto const in = program(buffer_size * iterations);
+   std::vector<float> out(buffer_size);
+   auto const makeup = 4.0f;
+
+   auto per_sample = [&](auto env, auto gc)
+   {
+      return benchmark::run(
+         [&]
+         {
+            for (std::size_t i = 0; i != iterations; ++i)
+            {
+               auto const* s = &in[i * buffer_size];
+               for (std::size_t j = 0; j != buffer_size; ++j)
+               {
+                  auto e = q::decibel(env(std::abs(s[j])));
+                  out[j] = s[j] * float(gc(e)) * makeup;
+               }
+               benchmark::keep(out[0]);
+            }
+         }
+      ) / (iterations * buffer_size);
+   };
+
+   auto block = [&](auto env, auto gc)
+   {
+      auto dyn = q::dynamics_processor{ env, gc };
+      dyn.makeup_gain(q::decibel(makeup));
+      return benchmark::run(
+         [&]
+         {
+            for (std::size_t i = 0; i != iterations; ++i)
+            {
+               dyn.process(&in[i * buffer_size], out.data(), buffer_size);
+               benchmark::keep(out[0]);
+            }
+         }
+      ) / (iterations * buffer_size);
+   };
+
+   auto report = [&](char const* name, auto env, auto gc)
+   {
+      auto t1 = per_sample(env, gc);
+      auto t2 = block(env, gc);
+      std::cout
+         << "   " << std::left << std::setw(24) << name << std::right
+         << std::fixed << std::setprecision(2)
+         << std::setw(8) << t1
+         << std::setw(8) << t2
+         << std::setw(8) << t1 / t2 << 'x' << std::endl;
+   };
+
+   std::cout
+      << std::endl
+      << "Dynamics (ns/sample)        per sample   block" << std::endl;
+
+   auto peak_env = q::peak_envelope_follower{ 10_s, sps };
+   auto ff_env = q::envelope_follower{ 10_ms, 1_s, sps };
+   report("compressor", peak_env, q::compressor{ -18_dB, 1.0 / 4 });
+   report("soft_knee_compressor", peak_env, q::soft_knee_compressor{ -18_dB, 3_dB, 1.0 / 4 });
+   report("expander", peak_env, q::expander{ -18_dB, 2.0 / 1.0 });
+   report("compressor (ff)", ff_env, q::compressor{ -18_dB, 1.0 / 4 });
+}
+
+TEST_CASE("Dynamics_Processor_Chains_Benchmark" * doctest::skip())
+{
+   // The whole per sample loops of test/compressor_expander1.cpp,
+   // test/compressor_expander2.cpp and test/compressor_ff_fb.cpp (the
+   // feedforward compressor; the feedback compressor needs its own output,
+   // one sample at a time), against the dynamics_processor, one per
+   // output, each with its own envelope. One second, in 256 sample
+   // buffers. The outputs go to separate buffers (not interleaved).
+   constexpr std::size_t buffer_size = 256;
+   constexpr std::size_t iterations = sps / buffer_size;
+   auto const in = program(buffer_size * iterations);
+   std::vector<float> out1(buffer_size), out2(buffer_size), out3(buffer_size);
+
+   auto time = [&](auto&& f)
+   {
+      return benchmark::run(
+         [&]
+         {
+            for (std::size_t i = 0; i != iterations; ++i)
+            {
+               f(&in[i * buffer_size]);
+               benchmark::keep(out1[0]);
+            }
+         }
+      ) / (iterations * buffer_size);
+   };
+
+   auto report = [&](char const* name, double t1, double t2)
+   {
+      std::cout
+         << "   " << std::left << std::setw(24) << name << std::right
+         << std::fixed << std::setprecision(2)
+         << std::setw(8) << t1
+         << std::setw(8) << t2
+         << std::setw(8) << t1 / t2 << 'x' << std::endl;
+   };
+
+   std::cout
+      << std::endl
+      << "Dynamics chains (ns/sample)  per sample   block" << std::endl;
+
+   {
+      // compressor_expander1: compressor, soft knee compressor and expander
+      auto env = q::peak_envelope_follower{ 10_s, sps };
+      auto comp = q::compressor{ -18_dB, 1.0 / 4 };
+      auto comp2 = q::soft_knee_compressor{ -18_dB, 3_dB, 1.0 / 4 };
+      auto exp = q::expander{ -18_dB, 2.0 / 1.0 };
+      auto makeup_gain = 4.0f;
+
+      auto t1 = time(
+         [&](float const* s)
+         {
+            for (std::size_t j = 0; j != buffer_size; ++j)
+            {
+               auto env_out = q::decibel(env(std::abs(s[j])));
+               out1[j] = s[j] * float(comp(env_out)) * makeup_gain;
+               out2[j] = s[j] * float(comp2(env_out)) * makeup_gain;
+               out3[j] = s[j] * float(exp(env_out));
+            }
+         }
+      );
+
+      auto dyn1 = q::dynamics_processor{ env, comp };
+      auto dyn2 = q::dynamics_processor{ env, comp2 };
+      auto dyn3 = q::dynamics_processor{ env, exp };
+      dyn1.makeup_gain(q::decibel(makeup_gain));
+      dyn2.makeup_gain(q::decibel(makeup_gain));
+      auto t2 = time(
+         [&](float const* s)
+         {
+            dyn1.process(s, out1.data(), buffer_size);
+            dyn2.process(s, out2.data(), buffer_size);
+            dyn3.process(s, out3.data(), buffer_size);
+         }
+      );
+      report("compressor_expander1", t1, t2);
+   }
+
+   {
+      // compressor_expander2: compressor and expander
+      auto env = q::envelope_follower{ 10_ms, 1_s, sps };
+      auto comp = q::compressor{ -18_dB, 1.0 / 4 };
+      auto exp = q::expander{ -18_dB, 2.0 / 1.0 };
+      auto makeup_gain = 3.0f;
+
+      auto t1 = time(
+         [&](float const* s)
+         {
+            for (std::size_t j = 0; j != buffer_size; ++j)
+            {
+               auto env_out = q::decibel(env(std::abs(s[j])));
+               out1[j] = s[j] * float(comp(env_out)) * makeup_gain;
+               out2[j] = s[j] * float(exp(env_out));
+            }
+         }
+      );
+
+      auto dyn1 = q::dynamics_processor{ env, comp };
+      auto dyn2 = q::dynamics_processor{ env, exp };
+      dyn1.makeup_gain(q::decibel(makeup_gain));
+      auto t2 = time(
+         [&](float const* s)
+         {
+            dyn1.process(s, out1.data(), buffer_size);
+            dyn2.process(s, out2.data(), buffer_size);
+         }
+      );
+      report("compressor_expander2", t1, t2);
+   }
+
+   {
+      // compressor_ff_fb: the feedforward compressor
+      auto ff_env = q::envelope_follower{ 10_ms, 1_s, sps };
+      auto ff_comp = q::compressor{ -18_dB, 1.0 / 4 };
+      auto makeup_gain = 3.0f;
+
+      auto t1 = time(
+         [&](float const* s)
+         {
+            for (std::size_t j = 0; j != buffer_size; ++j)
+            {
+               auto ff_env_out = q::decibel(ff_env(std::abs(s[j])));
+               out1[j] = s[j] * float(ff_comp(ff_env_out)) * makeup_gain;
+            }
+         }
+      );
+
+      auto dyn = q::dynamics_processor{ ff_env, ff_comp };
+      dyn.makeup_gain(q::decibel(makeup_gain));
+      auto t2 = time(
+         [&](float const* s)
+         {
+            dyn.process(s, out1.data(), buffer_size);
+         }
+      );
+      report("compressor_ff_fb (ff)", t1, t2);
+   }
+}
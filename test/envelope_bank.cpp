@@ -0,0 +1,282 @@
+/*=============================================================================
+   Copyright (c) 2014-2020 Joel de Guzman. All rights reserved.
+
+   Distributed under the MIT License [ https://opensource.org/licenses/MIT ]
+=============================================================================*/
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <infra/doctest.hpp>
+
+#include <q/support/literals.hpp>
+#include <q/fx/envelope_bank.hpp>
+#include <vector>
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include "benchmark.hpp"
+#include "test_signal.hpp"
+
+namespace q = cycfi::q;
+using namespace q::literals;
+
+constexpr auto sps = 48000;
+
+namespace
+{
+   // Rectified noise bursts, at varying levels, with silence in between:
+   // attack and release phases, and blocks with both.
+   std::vector<float> bursts(std::size_t size, std::size_t period)
+   {
+      auto sig = test::noise(size);
+      for (std::size_t i = 0; i != size; ++i)
+      {
+         auto const level = float(q::decibel{ -40.0 + ((i / period) % 5) * 10.0, q::decibel::direct });
+         sig[i] = ((i / period) % 3 == 2)? 0.0f : std::abs(sig[i]) * level;
+      }
+      return sig;
+   }
+
+   // The levels of the fast_rms_envelope_follower, in dB, as floats
+   float value(float y) { return y; }
+   float value(q::decibel y) { return y.val; }
+
+   // N channels of bursts, each with its own period
+   struct multichannel
+   {
+      multichannel(std::size_t channels, std::size_t frames)
+       : _ptrs(channels)
+       , _cptrs(channels)
+      {
+         for (std::size_t ch = 0; ch != channels; ++ch)
+            _data.push_back(bursts(frames, 700 + ch * 130));
+      }
+
+      // The frames from i to i + n
+      q::audio_channels<float> channels(std::size_t i, std::size_t n)
+      {
+         for (std::size_t ch = 0; ch != _data.size(); ++ch)
+            _ptrs[ch] = _data[ch].data() + i;
+         return { _ptrs.data(), _ptrs.size(), n };
+      }
+
+      q::audio_channels<float const> const_channels(std::size_t i, std::size_t n)
+      {
+         for (std::size_t ch = 0; ch != _data.size(); ++ch)
+            _cptrs[ch] = _data[ch].data() + i;
+         return { _cptrs.data(), _cptrs.size(), n };
+      }
+
+      std::size_t frames() const { return _data[0].size(); }
+
+      std::vector<std::vector<float>>  _data;
+      std::vector<float*>              _ptrs;
+      std::vector<float const*>        _cptrs;
+   };
+
+   // Runs the bank on the channels of in (into out), in odd sized blocks,
+   // and returns the largest difference from the scalar followers
+   template <typename Bank, typename Scalar>
+   double check_bank(Bank& bank, std::vector<Scalar> scalar, multichannel& in, multichannel& out)
+   {
+      std::size_t i = 0;
+      for (std::size_t k = 0; i < in.frames(); ++k)
+      {
+         auto n = std::min(test::block_sizes[k % std::size(test::block_sizes)], in.frames() - i);
+         if (k % 2)
+         {
+            bank(in.const_channels(i, n), out.channels(i, n));
+         }
+         else
+         {
+            // In place
+            for (std::size_t ch = 0; ch != in._data.size(); ++ch)
+               std::copy_n(&in._data[ch][i], n, &out._data[ch][i]);
+            bank(out.channels(i, n));
+         }
+         i += n;
+      }
+
+      double error = 0.0;
+      for (std::size_t ch = 0; ch != in._data.size(); ++ch)
+      {
+         for (std::size_t i = 0; i != in.frames(); ++i)
+         {
+            auto y = scalar[ch](in._data[ch][i]);
+            error = std::max(error, double(std::abs(y - out._data[ch][i])));
+         }
+      }
+      return error;
+   }
+}
+
+TEST_CASE("Envelope_Follower_Bank")
+{
+   constexpr std::size_t N = 8;
+   multichannel in{ N, 20000 };
+   multichannel out{ N, 20000 };
+
+   // Different attack and release times per channel
+   q::envelope_follower_bank<N> bank{ 2_ms, 50_ms, sps };
+   std::vector<q::envelope_follower> scalar;
+   for (std::size_t ch = 0; ch != N; ++ch)
+   {
+      auto const attack = q::duration(0.001 * (ch + 1));
+      auto const release = q::duration(0.02 * (ch + 1));
+      bank.config(ch, attack, release, sps);
+      scalar.emplace_back(attack, release, sps);
+   }
+   CHECK(check_bank(bank, scalar, in, out) < 1e-6);
+   CHECK(bank.envelope(3) == out._data[3].back());
+
+   bank.reset();
+   CHECK(bank.envelope(3) == 0.0f);
+}
+
+TEST_CASE("Peak_Envelope_Follower_Bank")
+{
+   // An odd number of channels
+   constexpr std::size_t N = 5;
+   multichannel in{ N, 20000 };
+   multichannel out{ N, 20000 };
+
+   q::peak_envelope_follower_bank<N> bank{ 50_ms, sps };
+   std::vector<q::peak_envelope_follower> scalar;
+   for (std::size_t ch = 0; ch != N; ++ch)
+   {
+      auto const release = q::duration(0.01 * (ch + 1));
+      bank.config(ch, release, sps);
+      scalar.emplace_back(release, sps);
+   }
+   CHECK(check_bank(bank, scalar, in, out) < 1e-6);
+   CHECK(bank.envelope(4) == out._data[4].back());
+}
+
+TEST_CASE("Fast_RMS_Envelope_Follower_Bank")
+{
+   constexpr std::size_t N = 4;
+   multichannel in{ N, 20000 };
+   multichannel out{ N, 20000 };
+
+   q::fast_rms_envelope_follower_bank<N> bank{ 5_ms, sps };
+   std::vector<q::fast_rms_envelope_follower> scalar(N, { 5_ms, sps });
+
+   std::size_t i = 0;
+   for (std::size_t k = 0; i < in.frames(); ++k)
+   {
+      auto n = std::min(test::block_sizes[k % std::size(test::block_sizes)], in.frames() - i);
+      bank(in.const_channels(i, n), out.channels(i, n));
+      i += n;
+   }
+
+   double error = 0.0;
+   for (std::size_t ch = 0; ch != N; ++ch)
+   {
+      for (std::size_t i = 0; i != in.frames(); ++i)
+      {
+         auto const db = scalar[ch](in._data[ch][i]);
+         error = std::max(error, double(std::abs(db.val - out._data[ch][i])));
+      }
+      CHECK(bank.level(ch).val == out._data[ch].back());
+   }
+   CHECK(error <= 0.001);
+}
+
+TEST_CASE("Envelope_Follower_Block")
+{
+   // The single channel block processing of the fast followers
+   auto const in = bursts(20000, 900);
+   auto check = [&](auto scalar, auto block, double tolerance)
+   {
+      auto out = in;
+      std::size_t i = 0;
+      for (std::size_t k = 0; i < in.size(); ++k)
+      {
+         auto n = std::min(test::block_sizes[k % std::size(test::block_sizes)], in.size() - i);
+         block.process(&out[i], n);
+         i += n;
+      }
+
+      double error = 0.0;
+      for (std::size_t i = 0; i != in.size(); ++i)
+      {
+         auto const y = value(scalar(in[i]));
+         error = std::max(error, double(std::abs(y - out[i])));
+      }
+      CHECK(error <= tolerance);
+   };
+
+   check(q::fast_envelope_follower{ 5_ms, sps }, q::fast_envelope_follower{ 5_ms, sps }, 0.0);
+   check(q::fast_envelope_follower{ 3 }, q::fast_envelope_follower{ 3 }, 0.0);
+   check(q::fast_envelope_follower{ 0 }, q::fast_envelope_follower{ 0 }, 0.0);
+   check(q::fast_rms_envelope_follower{ 5_ms, sps }, q::fast_rms_envelope_follower{ 5_ms, sps }, 0.001);
+}
+
+TEST_CASE("Envelope_Follower_Bank_Benchmark" * doctest::skip())
+{
+   // One second, 8 channels, in 256 frame buffers: the scalar followers,
+   // sample by sample, against the banks
+   constexpr std::size_t N = 8;
+   constexpr std::size_t buffer_size = 256;
+   constexpr std::size_t iterations = sps / buffer_size;
+   multichannel in{ N, buffer_size * iterations };
+   multichannel out{ N, buffer_size * iterations };
+
+   auto scalar = [&](auto f)
+   {
+      std::vector<decltype(f)> fs(N, f);
+      return benchmark::run(
+         [&]
+         {
+            for (std::size_t i = 0; i != iterations; ++i)
+            {
+               for (std::size_t ch = 0; ch != N; ++ch)
+               {
+                  float const* s = &in._data[ch][i * buffer_size];
+                  float* y = &out._data[ch][i * buffer_size];
+                  for (std::size_t j = 0; j != buffer_size; ++j)
+                     y[j] = float(fs[ch](s[j]));
+               }
+               benchmark::keep(out._data[0][i * buffer_size]);
+            }
+         }
+      ) / (iterations * buffer_size * N);
+   };
+
+   auto bank = [&](auto b)
+   {
+      return benchmark::run(
+         [&]
+         {
+            for (std::size_t i = 0; i != iterations; ++i)
+            {
+               auto const n = buffer_size;
+               b(in.const_channels(i * n, n), out.channels(i * n, n));
+               benchmark::keep(out._data[0][i * n]);
+            }
+         }
+      ) / (iterations * buffer_size * N);
+   };
+
+   auto report = [](char const* name, double scalar, double bank)
+   {
+      std::cout
+         << "   " << std::left << std::setw(28) << name << std::right
+         << std::fixed << std::setprecision(2)
+         << std::setw(8) << scalar
+         << std::setw(8) << bank
+         << std::setw(8) << scalar / bank << 'x' << std::endl;
+   };
+
+   std::cout
+      << std::endl
+      << "Envelope followers, 8 channels (ns/sample)   scalar    bank" << std::endl;
+
+   report("envelope_follower"
+    , scalar(q::envelope_follower{ 2_ms, 50_ms, sps })
+    , bank(q::envelope_follower_bank<N>{ 2_ms, 50_ms, sps }));
+   report("peak_envelope_follower"
+    , scalar(q::peak_envelope_follower{ 50_ms, sps })
+    , bank(q::peak_envelope_follower_bank<N>{ 50_ms, sps }));
+   report("fast_rms_envelope_follower"
+    , scalar(q::fast_rms_envelope_follower{ 5_ms, sps })
+    , bank(q::fast_rms_envelope_follower_bank<N>{ 5_ms, sps }));
+}
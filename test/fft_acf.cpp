@@ -0,0 +1,212 @@
+/*=============================================================================
+   Copyright (c) 2014-2020 Joel de Guzman. All rights reserved.
+
+   Distributed under the MIT License [ https://opensource.org/licenses/MIT ]
+=============================================================================*/
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <infra/doctest.hpp>
+
+#include <q/support/literals.hpp>
+#include <q/utility/fft_acf.hpp>
+#include <q/pitch/period_detector.hpp>
+#include <vector>
+#include <iostream>
+#include <iomanip>
+#include <cmath>
+#include "benchmark.hpp"
+#include "test_signal.hpp"
+
+namespace q = cycfi::q;
+using namespace q::literals;
+
+namespace
+{
+   // Direct O(N^2) reference
+   std::vector<double> direct_acf(std::vector<float> const& x, q::correlation method)
+   {
+      auto const mid = x.size() / 2;
+      std::vector<double> result(mid + 1);
+      double sum = 0.0;
+      for (std::size_t pos = 0; pos <= mid; ++pos)
+      {
+         double r = 0.0, e0 = 0.0, et = 0.0, d = 0.0;
+         for (std::size_t i = 0; i != mid; ++i)
+         {
+            r += double(x[i]) * x[i + pos];
+            e0 += double(x[i]) * x[i];
+            et += double(x[i + pos]) * x[i + pos];
+            d += (double(x[i]) - x[i + pos]) * (double(x[i]) - x[i + pos]);
+         }
+         switch (method)
+         {
+            case q::correlation::acf:
+               result[pos] = r / std::sqrt(e0 * et);
+               break;
+            case q::correlation::nsdf:
+               result[pos] = 2.0 * r / (e0 + et);
+               break;
+            case q::correlation::yin:
+               sum += d;
+               result[pos] = (pos == 0)? 1.0 : 1.0 - (d * pos / sum);
+               break;
+            default:
+               break;
+         }
+      }
+      return result;
+   }
+
+   void check_acf(std::size_t window_size, q::correlation method)
+   {
+      auto x = test::noise(window_size);
+      for (std::size_t i = 0; i != window_size; ++i)
+         x[i] = 0.3f * x[i] + 0.7f * std::sin(2_pi * i / 37.3);
+
+      q::fft_acf ac{ window_size, method };
+      ac.correlate([&](std::size_t i) { return x[i]; });
+      auto expected = direct_acf(x, method);
+
+      for (std::size_t pos = 0; pos != expected.size(); ++pos)
+      {
+         INFO("window_size = " << window_size << ", pos = " << pos);
+         CHECK(ac(pos) == doctest::Approx(expected[pos]).epsilon(0.0001));
+      }
+   }
+}
+
+TEST_CASE("FFT_ACF")
+{
+   for (auto method : { q::correlation::acf, q::correlation::nsdf, q::correlation::yin })
+   {
+      check_acf(128, method);
+      check_acf(192, method);       // not a power of two
+      check_acf(1000, method);
+      check_acf(2048, method);
+   }
+}
+
+namespace
+{
+   // A harmonic rich tone (a crude plucked string) with added noise
+   std::vector<float> tone(q::frequency freq, std::uint32_t sps, float noise_level)
+   {
+      auto sig = test::noise(sps / 2);
+      auto period = float(freq.period()) * sps;
+      for (std::size_t i = 0; i != sig.size(); ++i)
+      {
+         float s = 0.0f;
+         for (int h = 1; h != 8; ++h)
+            s += std::sin(2_pi * h * i / period) / h;
+         sig[i] = 0.5f * s + noise_level * sig[i];
+      }
+      return sig;
+   }
+
+   // Returns the mean relative period error
+   double check_period_detector(q::correlation method, float noise_level)
+   {
+      constexpr auto sps = 44100;
+      constexpr auto freq = 220_Hz;
+      auto const sig = tone(freq, sps, noise_level);
+      auto const expected = float(freq.period()) * sps;
+
+      q::period_detector pd{ 100_Hz, 800_Hz, sps, -30_dB, method };
+      CHECK(pd.method() == method);
+
+      int ready = 0;
+      double error = 0.0;
+      for (auto s : sig)
+      {
+         if (pd(s))
+         {
+            ++ready;
+            error += std::abs(pd.fundamental()._period - expected) / expected;
+         }
+      }
+      CHECK(ready > 10);
+      return error / ready;
+   }
+}
+
+TEST_CASE("Period_Detector_Correlation_Methods")
+{
+   for (auto method : {
+         q::correlation::bitstream
+       , q::correlation::acf
+       , q::correlation::nsdf
+       , q::correlation::yin
+      }
+   )
+   {
+      auto clean = check_period_detector(method, 0.0f);
+      auto noisy = check_period_detector(method, 0.2f);
+      std::cout
+         << "method " << int(method) << ", mean period error: "
+         << clean * 100 << "% (clean), "
+         << noisy * 100 << "% (noisy)" << std::endl;
+
+      CHECK(clean < 0.0001);
+
+      // The bitstream loses too much information in the presence of noise
+      if (method != q::correlation::bitstream)
+         CHECK(noisy < 0.005);
+   }
+}
+
+TEST_CASE("FFT_ACF_Benchmark" * doctest::skip())
+{
+   std::cout
+      << std::endl
+      << "Correlation per window (us)" << std::endl
+      << "window    direct    fft_acf" << std::endl;
+
+   for (std::size_t window_size : { 256, 1024, 4096 })
+   {
+      auto const x = test::noise(window_size);
+      q::fft_acf ac{ window_size, q::correlation::nsdf };
+
+      auto t1 = benchmark::run(
+         [&]
+         {
+            auto r = direct_acf(x, q::correlation::nsdf);
+            benchmark::keep(r[1]);
+         }
+      );
+
+      auto t2 = benchmark::run(
+         [&]
+         {
+            for (int i = 0; i != 100; ++i)
+               ac.correlate([&](std::size_t i) { return x[i]; });
+            benchmark::keep(ac(1));
+         }
+      ) / 100;
+
+      std::cout
+         << std::setw(6) << window_size
+         << std::setw(10) << std::fixed << std::setprecision(2) << t1 / 1000
+         << std::setw(11) << t2 / 1000
+         << std::endl;
+   }
+
+   // Period detector cost per sample
+   constexpr auto sps = 44100;
+   auto const sig = tone(220_Hz, sps, 0.1f);
+   std::cout << std::endl << "period_detector (ns/sample)" << std::endl;
+   for (auto method : { q::correlation::bitstream, q::correlation::nsdf })
+   {
+      q::period_detector pd{ 50_Hz, 800_Hz, sps, -30_dB, method };
+      auto t = benchmark::run(
+         [&]
+         {
+            for (auto s : sig)
+               pd(s);
+            benchmark::keep(pd.fundamental()._period);
+         }
+      ) / sig.size();
+
+      std::cout
+         << (method == q::correlation::bitstream? "   bitstream: " : "   nsdf:      ")
+         << std::setprecision(1) << t << std::endl;
+   }
+}
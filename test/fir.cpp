@@ -0,0 +1,255 @@
+/*=============================================================================
+   Copyright (c) 2014-2020 Joel de Guzman. All rights reserved.
+
+   Distributed under the MIT License [ https://opensource.org/licenses/MIT ]
+=============================================================================*/
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <infra/doctest.hpp>
+
+#include <q/support/literals.hpp>
+#include <q/fx/fir.hpp>
+#include <vector>
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include "benchmark.hpp"
+#include "test_signal.hpp"
+
+namespace q = cycfi::q;
+using namespace q::literals;
+
+constexpr auto sps = 48000;
+
+namespace
+{
+   // Double precision direct convolution reference
+   std::vector<double> reference(
+      std::vector<float> const& h, std::vector<float> const& in)
+   {
+      std::vector<double> out(in.size());
+      for (std::size_t i = 0; i != in.size(); ++i)
+      {
+         double y = 0;
+         for (std::size_t k = 0; k != h.size() && k <= i; ++k)
+            y += double(h[k]) * in[i - k];
+         out[i] = y;
+      }
+      return out;
+   }
+
+   void check_process(std::vector<float> const& h)
+   {
+      auto const in = test::noise(4096);
+      auto const ref = reference(h, in);
+
+      // Per-sample
+      q::fir<> f1{ h };
+      for (std::size_t i = 0; i != in.size(); ++i)
+      {
+         INFO("index = " << i);
+         CHECK(f1(in[i]) == doctest::Approx(ref[i]).epsilon(0.0001).scale(1));
+      }
+
+      // In place, with odd block sizes, mixed with per-sample calls
+      q::fir<> f2{ h };
+      auto out = in;
+      std::size_t sizes[] = { 1, 2, 3, 64, 1, 100, 17, 256, 8, 9, 700 };
+      std::size_t i = 0;
+      for (std::size_t k = 0; i < out.size(); ++k)
+      {
+         auto n = std::min(sizes[k % std::size(sizes)], out.size() - i);
+         if (k % 7 == 6)
+         {
+            for (auto j = i; j != i + n; ++j)
+               out[j] = f2(out[j]);
+         }
+         else
+         {
+            f2.process(&out[i], n);
+         }
+         i += n;
+      }
+
+      for (std::size_t i = 0; i != in.size(); ++i)
+      {
+         INFO("index = " << i);
+         CHECK(out[i] == doctest::Approx(ref[i]).epsilon(0.0001).scale(1));
+      }
+   }
+
+   // Steady state gain of the filter at frequency f
+   double gain_at(std::vector<float> const& h, double freq)
+   {
+      constexpr std::size_t size = 8192;
+      std::vector<float> buf(size);
+      for (std::size_t i = 0; i != size; ++i)
+         buf[i] = std::sin(2 * q::pi * freq * i / sps);
+      q::fir<> f{ h };
+      f.process(buf.data(), size);
+
+      double peak = 0.0;
+      for (std::size_t i = h.size(); i != size; ++i)
+         peak = std::max(peak, double(std::abs(buf[i])));
+      return peak;
+   }
+}
+
+TEST_CASE("FIR_Process")
+{
+   // Symmetric, odd and even sizes
+   check_process(q::sinc_lowpass(2_kHz, sps, 127));
+   check_process(q::sinc_lowpass(5_kHz, sps, 64, q::hann_window{}));
+   check_process(q::sinc_highpass(500_Hz, sps, 31));
+
+   // Not symmetric
+   auto h = test::noise(100);
+   for (auto& v : h)
+      v *= 0.05f;
+   check_process(h);
+
+   // Small filters
+   check_process({ 0.5f });
+   check_process({ 0.25f, 0.5f, 0.25f });
+   check_process({ 1.0f, -0.5f });
+
+   CHECK(q::fir<>{ q::sinc_lowpass(2_kHz, sps, 127) }.symmetric());
+   CHECK(q::fir<>{ q::sinc_bandpass(1_kHz, 2_kHz, sps, 64) }.symmetric());
+   CHECK(!q::fir<>{ h }.symmetric());
+}
+
+TEST_CASE("FIR_Double")
+{
+   auto const h = q::sinc_lowpass<double>(1_kHz, sps, 65);
+   q::fir<double> f1{ h };
+   q::fir<double> f2{ h };
+   auto const in = test::noise(1000);
+   std::vector<double> out(in.begin(), in.end());
+   f2.process(out.data(), out.size());
+   for (std::size_t i = 0; i != in.size(); ++i)
+      CHECK(f1(in[i]) == doctest::Approx(out[i]).epsilon(1e-12).scale(1));
+}
+
+TEST_CASE("FIR_Latency")
+{
+   // A linear phase filter delays the input by (size-1)/2 samples
+   q::fir<> f{ q::sinc_lowpass(4_kHz, sps, 101) };
+   CHECK(f.latency() == 50);
+
+   std::vector<float> buf(200, 0.0f);
+   buf[0] = 1.0f;
+   f.process(buf.data(), buf.size());
+   auto peak = std::max_element(buf.begin(), buf.end()) - buf.begin();
+   CHECK(peak == 50);
+}
+
+TEST_CASE("FIR_Design")
+{
+   auto const stop = std::pow(10.0, -60.0 / 20);
+
+   // Lowpass
+   auto const lp = q::sinc_lowpass(2_kHz, sps, 255);
+   CHECK(gain_at(lp, 500) == doctest::Approx(1.0).epsilon(0.001));
+   CHECK(gain_at(lp, 2000) == doctest::Approx(0.5).epsilon(0.02));
+   CHECK(gain_at(lp, 4000) < stop);
+   CHECK(gain_at(lp, 10000) < stop);
+
+   // Highpass (an even size is rounded up)
+   auto const hp = q::sinc_highpass(2_kHz, sps, 254);
+   CHECK(hp.size() == 255);
+   CHECK(gain_at(hp, 500) < stop);
+   CHECK(gain_at(hp, 2000) == doctest::Approx(0.5).epsilon(0.02));
+   CHECK(gain_at(hp, 7000) == doctest::Approx(1.0).epsilon(0.001));
+
+   // Bandpass
+   auto const bp = q::sinc_bandpass(2_kHz, 6_kHz, sps, 255);
+   CHECK(gain_at(bp, 200) < stop);
+   CHECK(gain_at(bp, 4000) == doctest::Approx(1.0).epsilon(0.001));
+   CHECK(gain_at(bp, 12000) < stop);
+
+   // Bandstop
+   auto const bs = q::sinc_bandstop(2_kHz, 6_kHz, sps, 255);
+   CHECK(gain_at(bs, 200) == doctest::Approx(1.0).epsilon(0.001));
+   CHECK(gain_at(bs, 4000) < stop);
+   CHECK(gain_at(bs, 12000) == doctest::Approx(1.0).epsilon(0.001));
+}
+
+namespace
+{
+   void benchmark_fir(std::size_t taps)
+   {
+      // One second at 48kHz, in 128 sample buffers
+      constexpr std::size_t buffer_size = 128;
+      constexpr std::size_t iterations = 48000 / buffer_size;
+      auto const in = test::noise(buffer_size);
+      std::vector<float> out(buffer_size);
+      auto const h = q::sinc_lowpass(4_kHz, sps, taps);
+
+      // Plain direct form, with a circular delay line
+      std::vector<float> delay(taps, 0.0f);
+      std::size_t pos = 0;
+      auto t1 = benchmark::run(
+         [&]
+         {
+            for (std::size_t i = 0; i != iterations; ++i)
+            {
+               for (std::size_t j = 0; j != buffer_size; ++j)
+               {
+                  delay[pos] = in[j];
+                  float y = 0;
+                  auto p = pos;
+                  for (std::size_t k = 0; k != taps; ++k)
+                  {
+                     y += h[k] * delay[p];
+                     p = (p == 0)? taps - 1 : p - 1;
+                  }
+                  out[j] = y;
+                  pos = (pos + 1 == taps)? 0 : pos + 1;
+               }
+            }
+            benchmark::keep(out.back());
+         }
+      ) / (iterations * buffer_size);
+
+      q::fir<> f1{ h };
+      auto t2 = benchmark::run(
+         [&]
+         {
+            for (std::size_t i = 0; i != iterations; ++i)
+               for (std::size_t j = 0; j != buffer_size; ++j)
+                  out[j] = f1(in[j]);
+            benchmark::keep(out.back());
+         }
+      ) / (iterations * buffer_size);
+
+      q::fir<> f2{ h };
+      auto t3 = benchmark::run(
+         [&]
+         {
+            for (std::size_t i = 0; i != iterations; ++i)
+               f2.process(in.data(), out.data(), buffer_size);
+            benchmark::keep(out.back());
+         }
+      ) / (iterations * buffer_size);
+
+      std::cout
+         << std::setw(6) << taps
+         << std::setw(12) << std::fixed << std::setprecision(2) << t1
+         << std::setw(14) << t2
+         << std::setw(12) << t3
+         << std::setw(10) << t1 / t3 << 'x'
+         << std::endl;
+   }
+}
+
+TEST_CASE("FIR_Benchmark" * doctest::skip())
+{
+   std::cout
+      << std::endl
+      << "Symmetric FIR, ns per sample, 128 sample buffers" << std::endl
+      << "  taps    circular    per-sample     process   speedup" << std::endl;
+
+   benchmark_fir(63);
+   benchmark_fir(127);
+   benchmark_fir(255);
+   benchmark_fir(511);
+}
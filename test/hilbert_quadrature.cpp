@@ -0,0 +1,199 @@
+/*=============================================================================
+   Copyright (c) 2014-2020 Joel de Guzman. All rights reserved.
+
+   Distributed under the MIT License [ https://opensource.org/licenses/MIT ]
+=============================================================================*/
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <infra/doctest.hpp>
+
+#include <q/support/literals.hpp>
+#include <q/fx/hilbert_quadrature_bank.hpp>
+#include <vector>
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include "benchmark.hpp"
+#include "test_signal.hpp"
+
+namespace q = cycfi::q;
+using namespace q::literals;
+
+constexpr auto sps = 48000;
+
+namespace
+{
+   struct multichannel
+   {
+      multichannel(std::size_t channels, std::size_t frames)
+       : _data(channels, std::vector<float>(frames))
+       , _ptrs(channels)
+      {
+         for (std::size_t ch = 0; ch != channels; ++ch)
+            _ptrs[ch] = _data[ch].data();
+      }
+
+      q::audio_channels<float> channels(std::size_t offset, std::size_t frames)
+      {
+         for (std::size_t ch = 0; ch != _data.size(); ++ch)
+            _ptrs[ch] = _data[ch].data() + offset;
+         return { _ptrs.data(), _ptrs.size(), frames };
+      }
+
+      std::vector<std::vector<float>>  _data;
+      std::vector<float*>              _ptrs;
+   };
+
+   constexpr std::size_t block_sizes[] = { 1, 2, 3, 64, 1, 100, 17, 256, 7 };
+}
+
+TEST_CASE("Hilbert_Quadrature_Process")
+{
+   // Block processing, in odd sized blocks, gives the same results as the
+   // per sample function call operator
+   auto const in = test::noise(10000);
+   q::hilbert_quadrature ref, h;
+   std::vector<float> i_out(in.size()), q_out(in.size());
+
+   std::size_t i = 0;
+   for (std::size_t k = 0; i < in.size(); ++k)
+   {
+      auto n = std::min(block_sizes[k % std::size(block_sizes)], in.size() - i);
+      h.process(&in[i], &i_out[i], &q_out[i], n);
+      i += n;
+   }
+
+   for (std::size_t i = 0; i != in.size(); ++i)
+   {
+      INFO("index = " << i);
+      auto [i_ref, q_ref] = ref(in[i]);
+      CHECK(i_out[i] == doctest::Approx(i_ref).epsilon(1e-6).scale(1));
+      CHECK(q_out[i] == doctest::Approx(q_ref).epsilon(1e-6).scale(1));
+   }
+
+   // Mixed with the function call operator
+   auto [i_ref, q_ref] = ref(0.5f);
+   auto [i_h, q_h] = h(0.5f);
+   CHECK(i_h == doctest::Approx(i_ref).epsilon(1e-6).scale(1));
+   CHECK(q_h == doctest::Approx(q_ref).epsilon(1e-6).scale(1));
+}
+
+TEST_CASE("Hilbert_Quadrature_Phase")
+{
+   // The I and Q outputs of a 1 kHz sine are 90 degrees apart: the
+   // magnitude of (I, Q) is constant.
+   constexpr std::size_t size = 4800;
+   std::vector<float> in(size), i_out(size), q_out(size);
+   for (std::size_t i = 0; i != size; ++i)
+      in[i] = std::sin(2 * q::pi * 1000 * i / sps);
+
+   q::hilbert_quadrature h;
+   h.process(in.data(), i_out.data(), q_out.data(), size);
+   for (std::size_t i = size / 2; i != size; ++i)
+      CHECK(std::hypot(i_out[i], q_out[i]) == doctest::Approx(1.0).epsilon(0.01));
+}
+
+TEST_CASE("Hilbert_Quadrature_Bank")
+{
+   constexpr std::size_t channels = 4;
+   constexpr std::size_t frames = 5000;
+   multichannel in{ channels, frames };
+   multichannel i_out{ channels, frames };
+   multichannel q_out{ channels, frames };
+   for (auto& ch : in._data)
+      ch = test::noise(frames);
+
+   q::hilbert_quadrature_bank<channels> bank;
+   std::size_t i = 0;
+   for (std::size_t k = 0; i < frames; ++k)
+   {
+      auto n = std::min(block_sizes[k % std::size(block_sizes)], frames - i);
+      bank.process(
+         in.channels(i, n), i_out.channels(i, n), q_out.channels(i, n));
+      i += n;
+   }
+
+   for (std::size_t ch = 0; ch != channels; ++ch)
+   {
+      q::hilbert_quadrature ref;
+      for (std::size_t i = 0; i != frames; ++i)
+      {
+         INFO("channel = " << ch << ", index = " << i);
+         auto [i_ref, q_ref] = ref(in._data[ch][i]);
+         CHECK(i_out._data[ch][i] == doctest::Approx(i_ref).epsilon(1e-6).scale(1));
+         CHECK(q_out._data[ch][i] == doctest::Approx(q_ref).epsilon(1e-6).scale(1));
+      }
+   }
+}
+
+TEST_CASE("Hilbert_Quadrature_Benchmark" * doctest::skip())
+{
+   // One second at 48kHz, in 128 sample buffers
+   constexpr std::size_t buffer_size = 128;
+   constexpr std::size_t iterations = sps / buffer_size;
+   constexpr std::size_t channels = 4;
+
+   multichannel in{ channels, buffer_size };
+   multichannel i_out{ channels, buffer_size };
+   multichannel q_out{ channels, buffer_size };
+   for (auto& ch : in._data)
+      ch = test::noise(buffer_size);
+
+   q::hilbert_quadrature h[channels];
+   auto t1 = benchmark::run(
+      [&]
+      {
+         for (std::size_t i = 0; i != iterations; ++i)
+         {
+            for (std::size_t ch = 0; ch != channels; ++ch)
+            {
+               for (std::size_t j = 0; j != buffer_size; ++j)
+               {
+                  auto [i_, q_] = h[ch](in._data[ch][j]);
+                  i_out._data[ch][j] = i_;
+                  q_out._data[ch][j] = q_;
+               }
+            }
+            benchmark::keep(q_out._data[0][0]);
+         }
+      }
+   ) / (iterations * buffer_size * channels);
+
+   auto t2 = benchmark::run(
+      [&]
+      {
+         for (std::size_t i = 0; i != iterations; ++i)
+         {
+            for (std::size_t ch = 0; ch != channels; ++ch)
+            {
+               h[ch].process(
+                  in._data[ch].data(), i_out._data[ch].data()
+                , q_out._data[ch].data(), buffer_size);
+            }
+            benchmark::keep(q_out._data[0][0]);
+         }
+      }
+   ) / (iterations * buffer_size * channels);
+
+   q::hilbert_quadrature_bank<channels> bank;
+   auto t3 = benchmark::run(
+      [&]
+      {
+         for (std::size_t i = 0; i != iterations; ++i)
+         {
+            bank.process(
+               in.channels(0, buffer_size)
+             , i_out.channels(0, buffer_size)
+             , q_out.channels(0, buffer_size));
+            benchmark::keep(q_out._data[0][0]);
+         }
+      }
+   ) / (iterations * buffer_size * channels);
+
+   std::cout
+      << std::endl
+      << "hilbert_quadrature, ns per channel per sample" << std::endl
+      << std::fixed << std::setprecision(2)
+      << "   operator():     " << t1 << std::endl
+      << "   process:        " << t2 << " (" << t1 / t2 << "x)" << std::endl
+      << "   bank<4>:        " << t3 << " (" << t1 / t3 << "x)" << std::endl;
+}
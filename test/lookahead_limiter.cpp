@@ -0,0 +1,212 @@
+/*=============================================================================
+   Copyright (c) 2014-2020 Joel de Guzman. All rights reserved.
+
+   Distributed under the MIT License [ https://opensource.org/licenses/MIT ]
+=============================================================================*/
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <infra/doctest.hpp>
+
+#include <q/support/literals.hpp>
+#include <q/fx/lookahead_limiter.hpp>
+#include <q/fx/envelope.hpp>
+#include <q/fx/dynamic.hpp>
+#include <q/fx/delay.hpp>
+#include <vector>
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include "benchmark.hpp"
+#include "test_signal.hpp"
+
+namespace q = cycfi::q;
+using namespace q::literals;
+
+constexpr auto sps = 48000;
+
+namespace
+{
+   // Noise with loud bursts (+12dB), quiet passages, and single spikes
+   std::vector<float> program(std::size_t size)
+   {
+      auto sig = test::noise(size);
+      for (std::size_t i = 0; i != size; ++i)
+      {
+         auto const section = (i / 3000) % 3;
+         sig[i] *= (section == 0)? 4.0f : (section == 1)? 0.1f : 0.5f;
+         if (i % 1777 == 0)
+            sig[i] = (i % 2)? 8.0f : -8.0f;
+      }
+      return sig;
+   }
+}
+
+TEST_CASE("Lookahead_Limiter_Ceiling")
+{
+   auto const in = program(100000);
+   q::lookahead_limiter lim{ -1_dB, 1_ms, 50_ms, sps };
+   auto const ceiling = float(-1_dB);
+
+   std::vector<float> out(in.size());
+   lim.process(in.data(), out.data(), in.size());
+
+   float peak = 0.0f;
+   for (auto s : out)
+      peak = std::max(peak, std::abs(s));
+   CHECK(peak <= ceiling);
+   CHECK(peak > ceiling * 0.99f);
+
+   // The gain is never applied after the peak: the limited samples are
+   // the delayed input times a gain no more than 1
+   auto const latency = lim.latency();
+   CHECK(latency == 48);
+   for (std::size_t i = latency; i != in.size(); ++i)
+   {
+      auto x = in[i - latency];
+      CHECK(std::abs(out[i]) <= std::abs(x) * (1.0f + 1e-6f));
+   }
+}
+
+TEST_CASE("Lookahead_Limiter_Transparent")
+{
+   // Below the ceiling, the limiter is a pure delay
+   auto in = test::noise(10000);
+   for (auto& s : in)
+      s *= 0.5f;
+
+   q::lookahead_limiter lim{ 0_dB, 2_ms, 50_ms, sps };
+   auto const latency = lim.latency();
+   for (std::size_t i = 0; i != in.size(); ++i)
+   {
+      auto y = lim(in[i]);
+      CHECK(y == ((i < latency)? 0.0f : in[i - latency]));
+   }
+   CHECK(lim.gain() == 1.0f);
+}
+
+TEST_CASE("Lookahead_Limiter_Blocks")
+{
+   // Blocks, in odd sizes, in place, give the same results as sample by
+   // sample processing
+   auto const in = program(20000);
+   q::lookahead_limiter ref{ -3_dB, 1.5_ms, 20_ms, sps };
+   q::lookahead_limiter lim{ -3_dB, 1.5_ms, 20_ms, sps };
+
+   auto out = in;
+   std::size_t i = 0;
+   for (std::size_t k = 0; i < in.size(); ++k)
+   {
+      auto n = std::min(test::block_sizes[k % std::size(test::block_sizes)], in.size() - i);
+      lim.process(&out[i], n);
+      i += n;
+   }
+
+   for (std::size_t i = 0; i != in.size(); ++i)
+      CHECK(ref(in[i]) == doctest::Approx(out[i]).epsilon(1e-5).scale(1));
+}
+
+TEST_CASE("Lookahead_Limiter_Linked")
+{
+   // Stereo, linked: a peak in one channel turns down both
+   constexpr std::size_t frames = 20000;
+   std::vector<float> left = program(frames);
+   std::vector<float> right = test::noise(frames);
+   for (auto& s : right)
+      s *= 0.25f;
+
+   std::vector<float> out_left(frames), out_right(frames);
+   float const* in_ptrs[] = { left.data(), right.data() };
+   float* out_ptrs[] = { out_left.data(), out_right.data() };
+
+   q::lookahead_limiter lim{ -1_dB, 1_ms, 50_ms, sps, 2 };
+   lim(
+      q::audio_channels<float const>{ in_ptrs, 2, frames }
+    , q::audio_channels<float>{ out_ptrs, 2, frames }
+   );
+
+   auto const ceiling = float(-1_dB);
+   auto const latency = lim.latency();
+   for (std::size_t i = latency; i != frames; ++i)
+   {
+      CHECK(std::abs(out_left[i]) <= ceiling);
+
+      // Same gain on both channels
+      auto x_left = left[i - latency];
+      auto x_right = right[i - latency];
+      if (std::abs(x_left) > 1e-3f && std::abs(x_right) > 1e-3f
+         && std::abs(out_left[i]) < ceiling)
+      {
+         CHECK(out_left[i] / x_left
+            == doctest::Approx(out_right[i] / x_right).epsilon(1e-4));
+      }
+   }
+
+   // The right channel, alone, is below the ceiling, but it is turned
+   // down with the left.
+   float min_ratio = 1.0f;
+   for (std::size_t i = latency; i != frames; ++i)
+   {
+      auto x = right[i - latency];
+      if (std::abs(x) > 1e-3f)
+         min_ratio = std::min(min_ratio, out_right[i] / x);
+   }
+   CHECK(min_ratio < 0.25f);
+}
+
+TEST_CASE("Lookahead_Limiter_Benchmark" * doctest::skip())
+{
+   // One second at 48kHz, in 128 sample buffers, stereo
+   constexpr std::size_t buffer_size = 128;
+   constexpr std::size_t iterations = sps / buffer_size;
+
+   auto const left = program(buffer_size * iterations);
+   auto const right = program(buffer_size * iterations);
+   std::vector<float> out_left(buffer_size), out_right(buffer_size);
+
+   // By hand: peak envelope follower, compressor (infinite ratio) and a
+   // delay to align the signal with the gain
+   q::peak_envelope_follower env{ 50_ms, sps };
+   q::compressor comp{ -1_dB, 0.0f };
+   q::nf_delay dly_left{ 48 }, dly_right{ 48 };
+   auto t1 = benchmark::run(
+      [&]
+      {
+         for (std::size_t i = 0; i != iterations; ++i)
+         {
+            auto const* l = &left[i * buffer_size];
+            auto const* r = &right[i * buffer_size];
+            for (std::size_t j = 0; j != buffer_size; ++j)
+            {
+               auto e = env(std::max(std::abs(l[j]), std::abs(r[j])));
+               auto g = float(comp(q::decibel(e)));
+               out_left[j] = dly_left(l[j], 48) * g;
+               out_right[j] = dly_right(r[j], 48) * g;
+            }
+            benchmark::keep(out_left[0]);
+         }
+      }
+   ) / (iterations * buffer_size);
+
+   q::lookahead_limiter lim{ -1_dB, 1_ms, 50_ms, sps, 2 };
+   auto t2 = benchmark::run(
+      [&]
+      {
+         for (std::size_t i = 0; i != iterations; ++i)
+         {
+            float const* in_ptrs[] = { &left[i * buffer_size], &right[i * buffer_size] };
+            float* out_ptrs[] = { out_left.data(), out_right.data() };
+            lim(
+               q::audio_channels<float const>{ in_ptrs, 2, buffer_size }
+             , q::audio_channels<float>{ out_ptrs, 2, buffer_size }
+            );
+            benchmark::keep(out_left[0]);
+         }
+      }
+   ) / (iterations * buffer_size);
+
+   std::cout
+      << std::endl
+      << "Stereo limiter, ns per frame" << std::endl
+      << std::fixed << std::setprecision(2)
+      << "   by hand:           " << t1 << std::endl
+      << "   lookahead_limiter: " << t2 << " (" << t1 / t2 << "x)" << std::endl;
+}
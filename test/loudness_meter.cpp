@@ -0,0 +1,276 @@
+/*=============================================================================
+   Copyright (c) 2014-2020 Joel de Guzman. All rights reserved.
+
+   Distributed under the MIT License [ https://opensource.org/licenses/MIT ]
+=============================================================================*/
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <infra/doctest.hpp>
+
+#include <q/support/literals.hpp>
+#include <q/fx/loudness_meter.hpp>
+#include <q_io/audio_file.hpp>
+#include <vector>
+#include <utility>
+#include <cmath>
+#include <filesystem>
+#include <stdexcept>
+#include <iostream>
+#include <iomanip>
+#include "benchmark.hpp"
+#include "test_signal.hpp"
+
+namespace q = cycfi::q;
+using namespace q::literals;
+
+constexpr auto sps = 48000;
+
+namespace
+{
+   // The EBU Tech 3341 and 3342 test signals: 1kHz sine waves, in the
+   // same channels, given a list of (level in dBFS, seconds)
+   std::vector<float> sines(std::initializer_list<std::pair<double, double>> parts)
+   {
+      std::vector<float> sig;
+      std::size_t i = 0;
+      for (auto [level, seconds] : parts)
+      {
+         auto const a = std::pow(10.0, level / 20.0);
+         auto const n = std::size_t(seconds * sps);
+         for (std::size_t k = 0; k != n; ++k, ++i)
+            sig.push_back(a * std::sin(2_pi * 1000.0 * i / sps));
+      }
+      return sig;
+   }
+
+   // The same signal in all the channels, in odd sized blocks
+   void measure(q::loudness_meter& meter, std::vector<float> const& sig)
+   {
+      std::vector<float const*> ptrs(meter.channels());
+      std::size_t i = 0;
+      for (std::size_t k = 0; i < sig.size(); ++k)
+      {
+         auto n = std::min(test::block_sizes[k % std::size(test::block_sizes)] * 37, sig.size() - i);
+         for (auto& p : ptrs)
+            p = &sig[i];
+         meter(q::audio_channels<float const>{ ptrs.data(), ptrs.size(), n });
+         i += n;
+      }
+   }
+}
+
+TEST_CASE("Loudness_Meter_K_Weighting")
+{
+   // The 48kHz coefficients of BS.1770
+   constexpr double b[2][3] = {
+      { 1.53512485958697, -2.69169618940638, 1.19839281085285 }
+    , { 1.0, -2.0, 1.0 }
+   };
+   constexpr double a[2][2] = {
+      { -1.69065929318241, 0.73248077421585 }
+    , { -1.99004745483398, 0.99007225036621 }
+   };
+
+   // The impulse response, against the cascade in double precision
+   q::k_weighting k{ sps };
+   double x1[2] = {}, x2[2] = {}, y1[2] = {}, y2[2] = {};
+   double max_error = 0.0;
+   for (std::size_t i = 0; i != 1000; ++i)
+   {
+      double s = (i == 0)? 1.0 : 0.0;
+      for (std::size_t j = 0; j != 2; ++j)
+      {
+         auto y = b[j][0] * s + b[j][1] * x1[j] + b[j][2] * x2[j]
+            - a[j][0] * y1[j] - a[j][1] * y2[j];
+         x2[j] = x1[j]; x1[j] = s;
+         y2[j] = y1[j]; y1[j] = y;
+         s = y;
+      }
+      max_error = std::max(max_error, std::abs(k(i == 0? 1.0f : 0.0f) - s));
+   }
+   CHECK(max_error < 1e-5);
+}
+
+TEST_CASE("Loudness_Meter_EBU_Tech_3341")
+{
+   auto check = [](std::initializer_list<std::pair<double, double>> parts, double expected)
+   {
+      q::loudness_meter meter{ sps, 2 };
+      measure(meter, sines(parts));
+      CHECK(std::abs(meter.integrated() - expected) <= 0.1);
+      return meter;
+   };
+
+   // Test cases 1 to 5 (stereo)
+   auto m1 = check({ { -23, 20 } }, -23.0);
+   CHECK(std::abs(m1.momentary() - (-23.0)) <= 0.1);
+   CHECK(std::abs(m1.short_term() - (-23.0)) <= 0.1);
+   CHECK(std::abs(m1.max_momentary() - (-23.0)) <= 0.1);
+
+   check({ { -33, 20 } }, -33.0);
+   check({ { -36, 10 }, { -23, 60 }, { -36, 10 } }, -23.0);
+   check({ { -72, 10 }, { -36, 10 }, { -23, 60 }, { -36, 10 }, { -72, 10 } }, -23.0);
+   check({ { -26, 20 }, { -20, 20.1 }, { -26, 20 } }, -23.0);
+
+   // BS.1770: a 0dBFS 1kHz sine, in one channel, is -3.01 LKFS
+   q::loudness_meter mono{ sps, 1 };
+   auto const sig = sines({ { 0, 5 } });
+   mono.process(sig.data(), sig.size());
+   CHECK(std::abs(mono.integrated() - (-3.01)) <= 0.01);
+
+   // Silence
+   q::loudness_meter silent{ sps, 2 };
+   measure(silent, std::vector<float>(sps * 2));
+   CHECK(std::isinf(silent.integrated()));
+   CHECK(silent.loudness_range() == 0.0);
+}
+
+TEST_CASE("Loudness_Meter_EBU_Tech_3342")
+{
+   auto check = [](std::initializer_list<std::pair<double, double>> parts, double expected)
+   {
+      q::loudness_meter meter{ sps, 2 };
+      measure(meter, sines(parts));
+      CHECK(std::abs(meter.loudness_range() - expected) <= 1.0);
+   };
+
+   // Test cases 1 to 4 (stereo)
+   check({ { -20, 20 }, { -30, 20 } }, 10.0);
+   check({ { -20, 20 }, { -15, 20 } }, 5.0);
+   check({ { -40, 20 }, { -20, 20 } }, 20.0);
+   check({ { -50, 20 }, { -35, 20 }, { -20, 20 }, { -35, 20 }, { -50, 20 } }, 15.0);
+}
+
+TEST_CASE("Loudness_Meter_5_1")
+{
+   // The surround channels are weighted +1.5 dB, the LFE is ignored
+   auto const sig = sines({ { -23, 10 } });
+   q::loudness_meter meter{ sps, 6 };
+   std::vector<float> silence(sig.size());
+   float const* ptrs[] = {
+      silence.data(), silence.data(), silence.data()
+    , sig.data(), sig.data(), silence.data()
+   };
+   meter(q::audio_channels<float const>{ ptrs, 6, sig.size() });
+
+   // LFE: nothing, Ls: -23 + 1.5 - 3 (one channel)
+   CHECK(std::abs(meter.integrated() - (-23.0 + 1.5 - 3.01)) <= 0.1);
+}
+
+TEST_CASE("Loudness_Meter_Offline")
+{
+   // A minute of stereo noise at varying levels, in a file
+   constexpr std::size_t frames = sps * 60;
+   auto const left = test::noise(frames);
+   auto const right = test::noise(frames);
+   std::vector<float> interleaved(frames * 2);
+   for (std::size_t i = 0; i != frames; ++i)
+   {
+      auto const gain = std::pow(10.0f, -float((i / sps) % 7) * 5.0f / 20.0f);
+      interleaved[i * 2] = left[i] * gain;
+      interleaved[i * 2 + 1] = right[i] * gain * 0.5f;
+   }
+   {
+      q::wav_writer wav{ "results/loudness_meter.wav", 2, sps };
+      wav.write(interleaved);
+   }
+
+   // Streaming
+   q::loudness_meter meter{ sps, 2 };
+   std::vector<float> l(frames), r(frames);
+   for (std::size_t i = 0; i != frames; ++i)
+   {
+      l[i] = interleaved[i * 2];
+      r[i] = interleaved[i * 2 + 1];
+   }
+   float const* ptrs[] = { l.data(), r.data() };
+   meter(q::audio_channels<float const>{ ptrs, 2, frames });
+
+   for (std::size_t threads : { 1, 3, 8 })
+   {
+      auto offline = q::measure_loudness<q::wav_reader>(
+         "results/loudness_meter.wav", threads);
+      INFO("threads: " << threads);
+      CHECK(offline.integrated() == doctest::Approx(meter.integrated()).epsilon(1e-6));
+      CHECK(offline.loudness_range() == doctest::Approx(meter.loudness_range()).epsilon(1e-6));
+      CHECK(offline.max_momentary() == doctest::Approx(meter.max_momentary()).epsilon(1e-6));
+      CHECK(offline.max_short_term() == doctest::Approx(meter.max_short_term()).epsilon(1e-6));
+   }
+   CHECK(meter.loudness_range() > 10.0);
+}
+
+TEST_CASE("Loudness_Meter_Offline_Errors")
+{
+   CHECK_THROWS_AS(
+      q::measure_loudness<q::wav_reader>("results/no_such_file.wav")
+    , std::runtime_error
+   );
+
+   // A file cut short of the length in its header
+   auto const sig = test::noise(sps * 4);
+   {
+      q::wav_writer wav{ "results/loudness_meter_truncated.wav", 2, sps };
+      wav.write(sig);
+   }
+   std::filesystem::resize_file(
+      "results/loudness_meter_truncated.wav", sps * 2 * sizeof(float));
+   for (std::size_t threads : { 1, 3 })
+   {
+      INFO("threads: " << threads);
+      CHECK_THROWS_AS(
+         q::measure_loudness<q::wav_reader>(
+            "results/loudness_meter_truncated.wav", threads)
+       , std::runtime_error
+      );
+   }
+}
+
+TEST_CASE("Loudness_Meter_Benchmark" * doctest::skip())
+{
+   // Ten seconds, in 256 frame buffers, stereo and 5.1
+   constexpr std::size_t buffer_size = 256;
+   constexpr std::size_t iterations = (sps * 10) / buffer_size;
+   auto const sig = test::noise(buffer_size * iterations);
+
+   auto run = [&](std::size_t channels)
+   {
+      q::loudness_meter meter{ sps, channels };
+      std::vector<float const*> ptrs(channels);
+      auto t = benchmark::run(
+         [&]
+         {
+            for (std::size_t i = 0; i != iterations; ++i)
+            {
+               for (auto& p : ptrs)
+                  p = &sig[i * buffer_size];
+               meter(q::audio_channels<float const>{ ptrs.data(), channels, buffer_size });
+            }
+            benchmark::keep(meter.momentary());
+         }
+      );
+      return t / (iterations * buffer_size * channels);
+   };
+
+   auto offline = [](std::size_t threads)
+   {
+      return benchmark::run(
+         [&]
+         {
+            auto m = q::measure_loudness<q::wav_reader>(
+               "results/loudness_meter.wav", threads);
+            benchmark::keep(m.integrated());
+         }
+      ) / (sps * 60 * 2);
+   };
+
+   auto const t1 = offline(1);
+   auto const t4 = offline(4);
+
+   std::cout
+      << std::endl
+      << "Loudness meter, ns per sample" << std::endl
+      << std::fixed << std::setprecision(2)
+      << "   stereo:              " << run(2) << std::endl
+      << "   5.1:                 " << run(6) << std::endl
+      << "   offline, 1 thread:   " << t1 << std::endl
+      << "   offline, 4 threads:  " << t4 << " (" << t1 / t4 << "x)" << std::endl;
+}
@@ -8,10 +8,61 @@
 
 #include <q/support/literals.hpp>
 #include <q/fx/moving_maximum.hpp>
+#include <vector>
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+#include "benchmark.hpp"
+#include "test_signal.hpp"
 
 namespace q = cycfi::q;
 using namespace q::literals;
 
+namespace
+{
+   // Brute force reference: the maximum and minimum of the latest size
+   // samples (or all the samples so far)
+   float window_max(std::vector<float> const& in, std::size_t i, std::size_t size)
+   {
+      auto first = (i + 1 > size)? i + 1 - size : 0;
+      return *std::max_element(in.begin() + first, in.begin() + i + 1);
+   }
+
+   float window_min(std::vector<float> const& in, std::size_t i, std::size_t size)
+   {
+      auto first = (i + 1 > size)? i + 1 - size : 0;
+      return *std::min_element(in.begin() + first, in.begin() + i + 1);
+   }
+
+   // The previous O(log2(size)) segment tree implementation (Brookes), for
+   // the benchmark
+   struct segment_tree_maximum
+   {
+      segment_tree_maximum(std::size_t size)
+       : _size(size)
+       , _data(cycfi::smallest_pow2(size) * 2, -3.40e38f)
+      {}
+
+      float operator()(float value)
+      {
+         std::size_t index = (_data.size()/2) + _input_index;
+         while (index > 1)
+         {
+            _data[index] = value;
+            value = std::max(value, _data[index ^ 1]);
+            index /= 2;
+         }
+         if (++_input_index >= _size)
+            _input_index = 0;
+         return value;
+      }
+
+      std::size_t          _size;
+      std::size_t          _input_index = 0;
+      std::vector<float>   _data;
+   };
+}
+
 TEST_CASE("MovingMaximum")
 {
    float input[] = {
@@ -40,10 +91,116 @@ TEST_CASE("MovingMaximum")
    }
 }
 
+TEST_CASE("MovingMaximum_Window")
+{
+   auto const in = test::noise(5000);
+   for (std::size_t size : { 1, 2, 3, 7, 64, 100, 1000 })
+   {
+      INFO("size = " << size);
+      q::moving_maximum<float> mmax{ size };
+      q::moving_minimum<float> mmin{ size };
+      for (std::size_t i = 0; i != in.size(); ++i)
+      {
+         INFO("index = " << i);
+         CHECK(mmax(in[i]) == window_max(in, i, size));
+         CHECK(mmin(in[i]) == window_min(in, i, size));
+      }
+   }
+}
 
+TEST_CASE("MovingMaximum_Process")
+{
+   // Block processing, in odd sized blocks, in place, gives the same
+   // results as per sample processing
+   auto const in = test::noise(5000);
+   std::size_t block_sizes[] = { 1, 2, 3, 64, 1, 100, 17, 256, 7 };
+   for (std::size_t size : { 1, 5, 64, 441 })
+   {
+      INFO("size = " << size);
+      q::moving_maximum<float> mmax1{ size }, mmax2{ size };
+      q::moving_minimum<float> mmin1{ size }, mmin2{ size };
+      auto max_out = in;
+      auto min_out = in;
 
+      std::size_t i = 0;
+      for (std::size_t k = 0; i < in.size(); ++k)
+      {
+         auto n = std::min(block_sizes[k % std::size(block_sizes)], in.size() - i);
+         mmax2.process(max_out.data() + i, n);
+         mmin2.process(min_out.data() + i, n);
+         i += n;
+      }
 
+      for (std::size_t i = 0; i != in.size(); ++i)
+      {
+         INFO("index = " << i);
+         CHECK(max_out[i] == mmax1(in[i]));
+         CHECK(min_out[i] == mmin1(in[i]));
+      }
+      CHECK(mmax1() == mmax2());
+      CHECK(mmin1() == mmin2());
+   }
+}
 
+TEST_CASE("MovingMaximum_Benchmark" * doctest::skip())
+{
+   // One second at 48kHz, in 128 sample buffers
+   constexpr std::size_t buffer_size = 128;
+   constexpr std::size_t iterations = 48000 / buffer_size;
+   auto const in = test::noise(48000);
+   std::vector<float> out(buffer_size);
 
+   auto time = [&](auto&& f)
+   {
+      return benchmark::run(
+         [&]
+         {
+            for (std::size_t i = 0; i != iterations; ++i)
+               f(&in[i * buffer_size]);
+            benchmark::keep(out[0]);
+         }
+      ) / (iterations * buffer_size);
+   };
 
+   std::cout
+      << std::endl
+      << "Moving maximum (ns/sample)" << std::endl
+      << "      size   segment tree    operator()     process" << std::endl;
 
+   for (std::size_t size : { 8, 64, 480, 2400, 9600 })
+   {
+      segment_tree_maximum tree{ size };
+      q::moving_maximum<float> mmax{ size };
+
+      auto t1 = time(
+         [&](float const* s)
+         {
+            for (std::size_t j = 0; j != buffer_size; ++j)
+               out[j] = tree(s[j]);
+         }
+      );
+
+      auto t2 = time(
+         [&](float const* s)
+         {
+            for (std::size_t j = 0; j != buffer_size; ++j)
+               out[j] = mmax(s[j]);
+         }
+      );
+
+      auto t3 = time(
+         [&](float const* s)
+         {
+            mmax.process(s, out.data(), buffer_size);
+         }
+      );
+
+      std::cout
+         << std::setw(10) << size
+         << std::fixed << std::setprecision(2)
+         << std::setw(15) << t1
+         << std::setw(14) << t2
+         << std::setw(12) << t3
+         << std::endl;
+   }
+}
@@ -0,0 +1,142 @@
+/*=============================================================================
+   Copyright (c) 2014-2020 Joel de Guzman. All rights reserved.
+
+   Distributed under the MIT License [ https://opensource.org/licenses/MIT ]
+=============================================================================*/
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <infra/doctest.hpp>
+
+#include <q/support/literals.hpp>
+#include <q/fx/median.hpp>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include "benchmark.hpp"
+#include "test_signal.hpp"
+
+namespace q = cycfi::q;
+using namespace q::literals;
+
+namespace
+{
+   // Brute force reference: the median of the latest size samples, with
+   // the window initially filled with zeros
+   float window_median(std::vector<float> const& in, std::size_t i, std::size_t size)
+   {
+      std::vector<float> w(size, 0.0f);
+      for (std::size_t k = 0; k != size && k <= i; ++k)
+         w[k] = in[i - k];
+      std::sort(w.begin(), w.end());
+      return (size % 2)? w[size / 2] : (w[size / 2 - 1] + w[size / 2]) / 2;
+   }
+}
+
+TEST_CASE("Moving_Median")
+{
+   auto in = test::noise(3000);
+
+   // With repeated values too
+   for (std::size_t i = 0; i < in.size(); i += 5)
+      in[i] = std::round(in[i] * 4) / 4;
+
+   for (std::size_t size : { 1, 2, 3, 4, 5, 8, 25, 101 })
+   {
+      INFO("size = " << size);
+      q::moving_median<float> med{ size };
+      for (std::size_t i = 0; i != in.size(); ++i)
+      {
+         INFO("index = " << i);
+         CHECK(med(in[i]) == window_median(in, i, size));
+      }
+   }
+}
+
+TEST_CASE("Moving_Median_Median3")
+{
+   // Same as median3
+   auto const in = test::noise(1000);
+   q::median3 m3{ 0.5f };
+   q::moving_median<float> med{ 3, 0.5f };
+   for (auto s : in)
+      CHECK(med(s) == m3(s));
+}
+
+TEST_CASE("Moving_Median_Impulse_Noise")
+{
+   // A slow sine with impulses: the median removes the impulses
+   constexpr std::size_t size = 2000;
+   std::vector<float> in(size);
+   for (std::size_t i = 0; i != size; ++i)
+      in[i] = std::sin(2 * q::pi * i / 500);
+   auto clean = in;
+   for (std::size_t i = 7; i < size; i += 13)
+      in[i] += (i % 2)? 5.0f : -5.0f;
+
+   q::moving_median<float> med{ 9 };
+   std::vector<float> out(size);
+   med.process(in.data(), out.data(), size);
+
+   // The output is delayed by 4 samples (half the window)
+   for (std::size_t i = 16; i != size; ++i)
+      CHECK(std::abs(out[i] - clean[i - 4]) < 0.05);
+}
+
+TEST_CASE("Moving_Median_Benchmark" * doctest::skip())
+{
+   // One second at 48kHz, in 128 sample buffers
+   constexpr std::size_t buffer_size = 128;
+   constexpr std::size_t iterations = 48000 / buffer_size;
+   auto const in = test::noise(48000);
+   std::vector<float> out(buffer_size);
+
+   std::cout
+      << std::endl
+      << "Moving median (ns/sample)" << std::endl
+      << "      size  nth_element  moving_median" << std::endl;
+
+   for (std::size_t size : { 5, 11, 25, 51, 101, 255 })
+   {
+      // Reference: a ring buffer, copied and partially sorted per sample
+      std::vector<float> ring(size), work(size);
+      std::size_t pos = 0;
+      auto t1 = benchmark::run(
+         [&]
+         {
+            for (std::size_t i = 0; i != iterations; ++i)
+            {
+               for (std::size_t j = 0; j != buffer_size; ++j)
+               {
+                  ring[pos] = in[i * buffer_size + j];
+                  if (++pos == size)
+                     pos = 0;
+                  work = ring;
+                  std::nth_element(work.begin(), work.begin() + size / 2, work.end());
+                  out[j] = work[size / 2];
+               }
+               benchmark::keep(out[0]);
+            }
+         }
+      ) / (iterations * buffer_size);
+
+      q::moving_median<float> med{ size };
+      auto t2 = benchmark::run(
+         [&]
+         {
+            for (std::size_t i = 0; i != iterations; ++i)
+            {
+               med.process(&in[i * buffer_size], out.data(), buffer_size);
+               benchmark::keep(out[0]);
+            }
+         }
+      ) / (iterations * buffer_size);
+
+      std::cout
+         << std::setw(10) << size
+         << std::fixed << std::setprecision(2)
+         << std::setw(13) << t1
+         << std::setw(15) << t2
+         << std::endl;
+   }
+}
@@ -0,0 +1,234 @@
+/*=============================================================================
+   Copyright (c) 2014-2020 Joel de Guzman. All rights reserved.
+
+   Distributed under the MIT License [ https://opensource.org/licenses/MIT ]
+=============================================================================*/
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <infra/doctest.hpp>
+
+#include <q/support/literals.hpp>
+#include <q/fx/moving_average.hpp>
+#include <q/fx/moving_sum_bank.hpp>
+#include <vector>
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include "benchmark.hpp"
+#include "test_signal.hpp"
+
+namespace q = cycfi::q;
+using namespace q::literals;
+
+constexpr auto sps = 48000;
+
+namespace
+{
+   struct multichannel
+   {
+      multichannel(std::size_t channels, std::size_t frames)
+       : _data(channels, std::vector<float>(frames))
+       , _ptrs(channels)
+      {
+         for (std::size_t ch = 0; ch != channels; ++ch)
+            _ptrs[ch] = _data[ch].data();
+      }
+
+      q::audio_channels<float> channels(std::size_t offset, std::size_t frames)
+      {
+         for (std::size_t ch = 0; ch != _data.size(); ++ch)
+            _ptrs[ch] = _data[ch].data() + offset;
+         return { _ptrs.data(), _ptrs.size(), frames };
+      }
+
+      std::vector<std::vector<float>>  _data;
+      std::vector<float*>              _ptrs;
+   };
+
+   // The exact sum of the window ending at i (the samples before the start
+   // are zeros)
+   double exact_sum(std::vector<float> const& in, std::size_t i, std::size_t size)
+   {
+      double sum = 0.0;
+      for (auto j = (i + 1 > size)? i + 1 - size : 0; j <= i; ++j)
+         sum += in[j];
+      return sum;
+   }
+}
+
+TEST_CASE("Moving_Sum_Process")
+{
+   auto const in = test::noise(20000);
+   for (std::size_t size : { 1, 5, 16, 300, 2000 })
+   {
+      INFO("size = " << size);
+      q::moving_sum ref{ size }, ms{ size };
+      q::moving_average ref_avg{ size }, avg{ size };
+
+      // In odd sized blocks, in place
+      auto out = in;
+      auto avg_out = in;
+      std::size_t i = 0;
+      for (std::size_t k = 0; i < in.size(); ++k)
+      {
+         auto n = std::min(test::block_sizes[k % std::size(test::block_sizes)], in.size() - i);
+         ms.process(&out[i], n);
+         avg.process(&avg_out[i], n);
+         i += n;
+      }
+
+      double error = 0.0, avg_error = 0.0;
+      for (std::size_t i = 0; i != in.size(); ++i)
+      {
+         error = std::max(error, double(std::abs(ref(in[i]) - out[i])));
+         avg_error = std::max(avg_error, double(std::abs(ref_avg(in[i]) - avg_out[i])));
+      }
+      CHECK(error < 1e-5);
+      CHECK(avg_error < 1e-6);
+      CHECK(ms() == doctest::Approx(ref()).epsilon(1e-5).scale(1));
+
+      // Against the exact sum
+      for (std::size_t i = 0; i < in.size(); i += 997)
+         CHECK(out[i] == doctest::Approx(exact_sum(in, i, size)).epsilon(1e-5).scale(1));
+   }
+}
+
+TEST_CASE("Moving_Sum_Integer")
+{
+   q::basic_moving_sum<int> ref{ 10 }, ms{ 10 };
+   std::vector<int> in(5000), out(5000);
+   for (std::size_t i = 0; i != in.size(); ++i)
+      in[i] = int(q::fast_rand() % 200) - 100;
+
+   ms.process(in.data(), out.data(), in.size());
+   for (std::size_t i = 0; i != in.size(); ++i)
+      CHECK(ref(in[i]) == out[i]);
+}
+
+TEST_CASE("Moving_Sum_Resync")
+{
+   // A long run (10 minutes at 48kHz) of a signal with a large offset and
+   // small details, the worst case for the rounding errors of the running
+   // sum. With the regular resync, the error does not grow: the sum is
+   // still that of the latest window, to float precision.
+   constexpr std::size_t size = 480;
+   constexpr std::size_t buffer_size = 4800;
+   constexpr std::size_t iterations = 600 * sps / buffer_size;
+
+   q::moving_sum ms{ size };
+   std::vector<float> in(buffer_size), out(buffer_size);
+   for (std::size_t i = 0; i != iterations; ++i)
+   {
+      for (auto& s : in)
+         s = 1000.0f + (q::fast_rand() / 32768.0f);
+      if (i % 2)
+         ms.process(in.data(), out.data(), buffer_size);
+      else
+         for (std::size_t j = 0; j != buffer_size; ++j)
+            out[j] = ms(in[j]);
+   }
+
+   CHECK(ms() == doctest::Approx(exact_sum(in, buffer_size - 1, size)).epsilon(1e-7));
+   CHECK(out.back() == ms());
+}
+
+TEST_CASE("Moving_Sum_Bank")
+{
+   constexpr std::size_t channels = 16;
+   constexpr std::size_t frames = 5000;
+   constexpr std::size_t size = 300;
+   multichannel in{ channels, frames };
+   multichannel sum_out{ channels, frames };
+   multichannel avg_out{ channels, frames };
+   for (auto& ch : in._data)
+      ch = test::noise(frames);
+
+   q::moving_sum_bank<channels> sum_bank{ size };
+   q::moving_average_bank<channels> avg_bank{ size };
+   std::size_t i = 0;
+   for (std::size_t k = 0; i < frames; ++k)
+   {
+      auto n = std::min(test::block_sizes[k % std::size(test::block_sizes)], frames - i);
+      sum_bank(in.channels(i, n), sum_out.channels(i, n));
+
+      // In place
+      auto avg = avg_out.channels(i, n);
+      for (std::size_t ch = 0; ch != channels; ++ch)
+         std::copy_n(&in._data[ch][i], n, &avg_out._data[ch][i]);
+      avg_bank(avg);
+      i += n;
+   }
+
+   for (std::size_t ch = 0; ch != channels; ++ch)
+   {
+      q::moving_sum ref{ size };
+      q::moving_average ref_avg{ size };
+      for (std::size_t i = 0; i != frames; ++i)
+      {
+         INFO("channel = " << ch << ", index = " << i);
+         CHECK(sum_out._data[ch][i] == doctest::Approx(ref(in._data[ch][i])).epsilon(1e-5).scale(1));
+         CHECK(avg_out._data[ch][i] == doctest::Approx(ref_avg(in._data[ch][i])).epsilon(1e-6).scale(1));
+      }
+      CHECK(sum_bank.sum(ch) == doctest::Approx(ref()).epsilon(1e-5).scale(1));
+      CHECK(avg_bank.average(ch) == doctest::Approx(ref_avg()).epsilon(1e-6).scale(1));
+   }
+}
+
+TEST_CASE("Moving_Sum_Benchmark" * doctest::skip())
+{
+   // One second at 48kHz, in 128 sample buffers
+   constexpr std::size_t buffer_size = 128;
+   constexpr std::size_t iterations = sps / buffer_size;
+   constexpr std::size_t channels = 16;
+   auto const size = std::size_t(sps * 0.3);    // 300ms (e.g. VU)
+
+   multichannel in{ channels, buffer_size };
+   multichannel out{ channels, buffer_size };
+   for (auto& ch : in._data)
+      ch = test::noise(buffer_size);
+
+   std::vector<q::moving_sum> ms(channels, q::moving_sum{ size });
+   auto t1 = benchmark::run(
+      [&]
+      {
+         for (std::size_t i = 0; i != iterations; ++i)
+         {
+            for (std::size_t ch = 0; ch != channels; ++ch)
+               for (std::size_t j = 0; j != buffer_size; ++j)
+                  out._data[ch][j] = ms[ch](in._data[ch][j]);
+            benchmark::keep(out._data[0][0]);
+         }
+      }
+   ) / (iterations * buffer_size * channels);
+
+   auto t2 = benchmark::run(
+      [&]
+      {
+         for (std::size_t i = 0; i != iterations; ++i)
+         {
+            for (std::size_t ch = 0; ch != channels; ++ch)
+               ms[ch].process(in._data[ch].data(), out._data[ch].data(), buffer_size);
+            benchmark::keep(out._data[0][0]);
+         }
+      }
+   ) / (iterations * buffer_size * channels);
+
+   q::moving_sum_bank<channels> bank{ size };
+   auto t3 = benchmark::run(
+      [&]
+      {
+         for (std::size_t i = 0; i != iterations; ++i)
+         {
+            bank(in.channels(0, buffer_size), out.channels(0, buffer_size));
+            benchmark::keep(out._data[0][0]);
+         }
+      }
+   ) / (iterations * buffer_size * channels);
+
+   std::cout
+      << std::endl
+      << "moving_sum, ns per channel per sample" << std::endl
+      << std::fixed << std::setprecision(2)
+      << "   operator():     " << t1 << std::endl
+      << "   process:        " << t2 << " (" << t1 / t2 << "x)" << std::endl
+      << "   bank<16>:       " << t3 << " (" << t1 / t3 << "x)" << std::endl;
+}
@@ -0,0 +1,266 @@
+/*=============================================================================
+   Copyright (c) 2014-2020 Joel de Guzman. All rights reserved.
+
+   Distributed under the MIT License [ https://opensource.org/licenses/MIT ]
+=============================================================================*/
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <infra/doctest.hpp>
+
+#include <q/support/literals.hpp>
+#include <q/fx/multiband_compressor.hpp>
+#include <q/fx/envelope.hpp>
+#include <q/synth/sin.hpp>
+#include <vector>
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include "benchmark.hpp"
+#include "test_signal.hpp"
+
+namespace q = cycfi::q;
+using namespace q::literals;
+
+constexpr auto sps = 48000;
+
+namespace
+{
+   // Noise at varying levels: -40 dB to 0 dB, in steps
+   std::vector<float> program(std::size_t size)
+   {
+      auto sig = test::noise(size);
+      for (std::size_t i = 0; i != size; ++i)
+         sig[i] *= float(q::decibel{ -40.0 + ((i / 2000) % 5) * 10.0, q::decibel::direct });
+      return sig;
+   }
+
+   // The allpass of a Linkwitz-Riley crossover: the sum of its lowpass and
+   // highpass
+   struct lr4_allpass
+   {
+      lr4_allpass(q::frequency f, std::uint32_t sps)
+       : lp(f, sps), hp(f, sps)
+      {}
+
+      float operator()(float s)
+      {
+         return lp(s) + hp(s);
+      }
+
+      q::linkwitz_riley_lowpass<2> lp;
+      q::linkwitz_riley_highpass<2> hp;
+   };
+
+   // The multiband compressor, by hand: the usual crossover tree (LR4),
+   // with allpasses to align the lower bands, then an envelope follower
+   // and a soft knee compressor per band.
+   struct reference_4band
+   {
+      reference_4band(std::array<q::frequency, 3> const& f, std::uint32_t sps)
+       : lp0(f[0], sps), hp0(f[0], sps)
+       , lp1(f[1], sps), hp1(f[1], sps)
+       , lp2(f[2], sps), hp2(f[2], sps)
+       , ap01(f[1], sps), ap02(f[2], sps), ap12(f[2], sps)
+      {}
+
+      float operator()(float s)
+      {
+         float band[4];
+         auto const low = lp0(s);
+         auto rest = hp0(s);
+         auto const mid = lp1(rest);
+         rest = hp1(rest);
+         band[0] = ap02(ap01(low));
+         band[1] = ap12(mid);
+         band[2] = lp2(rest);
+         band[3] = hp2(rest);
+
+         float y = 0.0f;
+         for (std::size_t b = 0; b != 4; ++b)
+         {
+            auto e = q::decibel(env[b](std::abs(band[b])));
+            auto g = comp[b](e) + makeup[b];
+            y += band[b] * float(g);
+         }
+         return y;
+      }
+
+      q::linkwitz_riley_lowpass<2> lp0; q::linkwitz_riley_highpass<2> hp0;
+      q::linkwitz_riley_lowpass<2> lp1; q::linkwitz_riley_highpass<2> hp1;
+      q::linkwitz_riley_lowpass<2> lp2; q::linkwitz_riley_highpass<2> hp2;
+      lr4_allpass ap01, ap02, ap12;
+
+      std::vector<q::envelope_follower> env{ 4, q::envelope_follower{ 10_ms, 100_ms, sps } };
+      std::vector<q::soft_knee_compressor> comp{ 4, q::soft_knee_compressor{ 0_dB, 6_dB, 1.0f } };
+      std::vector<q::decibel> makeup{ 4, 0_dB };
+   };
+
+   // Steady state gain (RMS) of a sine wave at frequency f
+   template <typename Filter>
+   double sine_gain(Filter& f, q::frequency freq, std::uint32_t sps)
+   {
+      q::phase_iterator phase{ freq, sps };
+      double sum_in = 0, sum_out = 0;
+      for (std::size_t i = 0; i != sps; ++i)
+      {
+         auto s = q::sin(phase++);
+         auto y = f(s);
+         if (i >= sps / 2)
+         {
+            sum_in += s * s;
+            sum_out += y * y;
+         }
+      }
+      return std::sqrt(sum_out / sum_in);
+   }
+}
+
+TEST_CASE("Multiband_Compressor_Flat")
+{
+   // Uncompressed, the bands sum to an allpass: the magnitude response is
+   // flat, including at (and around) the crossover frequencies.
+   auto check = [](auto mb, std::uint32_t sps)
+   {
+      for (auto f : { 40.0, 100.0, 120.0, 150.0, 500.0, 1000.0
+         , 2000.0, 6000.0, 8000.0, 15000.0 })
+      {
+         mb.reset();
+         INFO("frequency: " << f);
+         CHECK(sine_gain(mb, q::frequency(f), sps) == doctest::Approx(1.0).epsilon(1e-3));
+      }
+   };
+
+   check(q::multiband_compressor<2>{ { 1_kHz }, sps }, sps);
+   check(q::multiband_compressor<3>{ { 120_Hz, 2_kHz }, sps }, sps);
+   check(q::multiband_compressor<4>{ { 120_Hz, 1_kHz, 6_kHz }, sps }, sps);
+   check(q::multiband_compressor<5>{ { 120_Hz, 500_Hz, 2_kHz, 8_kHz }, sps }, sps);
+   check(q::multiband_compressor<4, 4>{ { 120_Hz, 1_kHz, 6_kHz }, sps }, sps);
+   check(q::multiband_compressor<4>{ { 120_Hz, 1_kHz, 6_kHz }, 96000 }, 96000);
+}
+
+TEST_CASE("Multiband_Compressor_Reference")
+{
+   // Against the crossover tree, by hand
+   std::array<q::frequency, 3> const f = { 120_Hz, 1_kHz, 6_kHz };
+   q::multiband_compressor<4> mb{ f, sps };
+   reference_4band ref{ f, sps };
+
+   q::soft_knee_compressor const comp[] = {
+      { -30_dB, 6_dB, 1.0f / 4 }
+    , { -24_dB, 3_dB, 1.0f / 2 }
+    , { -20_dB, 12_dB, 1.0f / 8 }
+    , { -36_dB, 6_dB, 1.0f / 3 }
+   };
+   for (std::size_t b = 0; b != 4; ++b)
+   {
+      mb.compressor(b, comp[b]);
+      ref.comp[b] = comp[b];
+      mb.envelope(b, q::duration(0.005 * (b + 1)), 50_ms, sps);
+      ref.env[b].config(q::duration(0.005 * (b + 1)), 50_ms, sps);
+      mb.makeup_gain(b, q::decibel{ double(b), q::decibel::direct });
+      ref.makeup[b] = q::decibel{ double(b), q::decibel::direct };
+   }
+
+   auto const in = program(50000);
+
+   // In odd sized blocks, in place
+   auto out = in;
+   std::size_t i = 0;
+   for (std::size_t k = 0; i < in.size(); ++k)
+   {
+      auto n = std::min(test::block_sizes[k % std::size(test::block_sizes)], in.size() - i);
+      mb.process(&out[i], n);
+      i += n;
+   }
+
+   double max_error = 0.0;
+   for (std::size_t i = 0; i != in.size(); ++i)
+      max_error = std::max(max_error, std::abs(double(out[i]) - ref(in[i])));
+
+   // Within the errors of the decibel tables (used by hand)
+   CHECK(max_error < 1e-3);
+
+   // Some compression, in every band
+   for (std::size_t b = 0; b != 4; ++b)
+      CHECK(mb.gain(b) < -1_dB);
+}
+
+TEST_CASE("Multiband_Compressor_Bands")
+{
+   // A loud sine in the top band is compressed. The bottom band is not.
+   q::multiband_compressor<4> mb{ { 120_Hz, 1_kHz, 6_kHz }, sps };
+   for (std::size_t b = 0; b != 4; ++b)
+      mb.compressor(b, q::soft_knee_compressor{ -20_dB, 6_dB, 1.0f / 4 });
+
+   q::phase_iterator hi{ 10_kHz, sps };
+   q::phase_iterator lo{ 60_Hz, sps };
+   for (std::size_t i = 0; i != sps; ++i)
+      mb(q::sin(hi++) * 0.5f + q::sin(lo++) * 0.01f);
+
+   INFO("gain(3): " << mb.gain(3).val << " gain(0): " << mb.gain(0).val);
+   CHECK(mb.gain(3) < -6_dB);
+   CHECK(mb.gain(0) == 0_dB);
+}
+
+TEST_CASE("Multiband_Compressor_Benchmark" * doctest::skip())
+{
+   // One second at 48kHz, in 256 sample buffers. With the bands in SIMD lanes, the
+   // cost grows with the number of crossovers, not with the number of
+   // bands squared.
+   constexpr std::size_t buffer_size = 256;
+   constexpr std::size_t iterations = sps / buffer_size;
+   auto const in = program(buffer_size * iterations);
+   std::vector<float> out(buffer_size);
+
+   auto run = [&](auto&& f)
+   {
+      return benchmark::run(
+         [&]
+         {
+            for (std::size_t i = 0; i != iterations; ++i)
+            {
+               f(&in[i * buffer_size], out.data(), buffer_size);
+               benchmark::keep(out[0]);
+            }
+         }
+      ) / (iterations * buffer_size);
+   };
+
+   auto by_hand = [ref = reference_4band{ { 120_Hz, 1_kHz, 6_kHz }, sps }]
+      (float const* in, float* out, std::size_t n) mutable
+      {
+         for (std::size_t i = 0; i != n; ++i)
+            out[i] = ref(in[i]);
+      };
+
+   auto report = [&](char const* name, double t)
+   {
+      // Percent of one core, in real time
+      std::cout
+         << "   " << std::left << std::setw(28) << name << std::right
+         << std::fixed << std::setprecision(2)
+         << std::setw(8) << t
+         << std::setw(10) << t * 48000 * 1e-7 << '%'
+         << std::setw(9) << t * 96000 * 1e-7 << '%' << std::endl;
+   };
+
+   auto mb = [&](auto mb_)
+   {
+      return run(
+         [&](float const* in, float* out, std::size_t n)
+         {
+            mb_.process(in, out, n);
+         }
+      );
+   };
+
+   std::cout
+      << std::endl
+      << "Multiband compressor     ns/sample   48kHz CPU  96kHz CPU" << std::endl;
+
+   report("by hand, 4 bands LR4", run(by_hand));
+   report("2 bands LR4", mb(q::multiband_compressor<2>{ { 1_kHz }, sps }));
+   report("3 bands LR4", mb(q::multiband_compressor<3>{ { 120_Hz, 2_kHz }, sps }));
+   report("4 bands LR4", mb(q::multiband_compressor<4>{ { 120_Hz, 1_kHz, 6_kHz }, sps }));
+   report("5 bands LR4", mb(q::multiband_compressor<5>{ { 120_Hz, 500_Hz, 2_kHz, 8_kHz }, sps }));
+   report("4 bands LR8", mb(q::multiband_compressor<4, 4>{ { 120_Hz, 1_kHz, 6_kHz }, sps }));
+}
@@ -0,0 +1,174 @@
+/*=============================================================================
+   Copyright (c) 2014-2020 Joel de Guzman. All rights reserved.
+
+   Distributed under the MIT License [ https://opensource.org/licenses/MIT ]
+=============================================================================*/
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <infra/doctest.hpp>
+
+#include <q/support/literals.hpp>
+#include <q/fx/nonuniform_convolver.hpp>
+#include <vector>
+#include <iostream>
+#include <iomanip>
+#include <cmath>
+#include "benchmark.hpp"
+#include "test_signal.hpp"
+
+namespace q = cycfi::q;
+using namespace q::literals;
+
+namespace
+{
+   // Exponentially decaying noise (a crude reverb impulse response)
+   std::vector<float> impulse_response(std::size_t size)
+   {
+      auto ir = test::noise(size);
+      for (std::size_t i = 0; i != size; ++i)
+         ir[i] *= std::exp(-5.0f * i / size);
+      return ir;
+   }
+
+   template <std::size_t B, std::size_t R>
+   void check_convolver(std::size_t ir_size, std::size_t block_size)
+   {
+      auto const ir = impulse_response(ir_size);
+      auto const in = test::noise(ir_size * 2);
+
+      // Reference: uniformly partitioned convolver with the same latency
+      q::convolver<B> ref{ ir };
+      std::vector<float> expected(in.size());
+      ref(in.data(), expected.data(), in.size());
+
+      q::nonuniform_convolver<B, R> conv{ ir, 48000 };
+      CHECK(conv.latency() == ref.latency());
+      CHECK(conv.has_tail() == (ir_size > conv.head_size));
+
+      std::vector<float> out(in.size());
+      for (std::size_t i = 0; i < in.size(); i += block_size)
+      {
+         auto n = std::min(block_size, in.size() - i);
+         conv(&in[i], &out[i], n);
+         conv.sync();   // offline: wait for the worker
+      }
+
+      CHECK(conv.late_blocks() == 0);
+      CHECK(conv.dropped_blocks() == 0);
+      for (std::size_t i = 0; i != in.size(); ++i)
+      {
+         INFO("index = " << i);
+         CHECK(out[i] == doctest::Approx(expected[i]).epsilon(0.0001));
+      }
+   }
+}
+
+TEST_CASE("Nonuniform_Convolver")
+{
+   check_convolver<64, 8>(500, 64);       // head only
+   check_convolver<64, 8>(960, 64);       // head only (exactly)
+   check_convolver<64, 8>(961, 64);       // single tail sample
+   check_convolver<64, 8>(20000, 64);
+   check_convolver<32, 4>(10000, 50);
+   check_convolver<128, 16>(48000, 128);
+}
+
+TEST_CASE("Nonuniform_Convolver_Per_Sample")
+{
+   auto const ir = impulse_response(5000);
+   auto const in = test::noise(10000);
+
+   q::convolver<32> ref{ ir };
+   q::nonuniform_convolver<32, 8> conv{ ir, 48000 };
+
+   for (std::size_t i = 0; i != in.size(); ++i)
+   {
+      auto expected = ref(in[i]);
+      auto y = conv(in[i]);
+      conv.sync();
+      CHECK(y == doctest::Approx(expected).epsilon(0.0001));
+   }
+}
+
+TEST_CASE("Nonuniform_Convolver_Deadline")
+{
+   // Hold the worker so that it never delivers: every block after the
+   // first misses its deadline, and once all slots are taken, every new
+   // block is dropped. Holding the worker makes this independent of
+   // thread scheduling.
+   auto const ir = impulse_response(4096);
+   auto const in = test::noise(64 * 64);
+
+   q::nonuniform_convolver<32, 2> conv{ ir, 48000 };
+   conv.hold(true);
+
+   std::vector<float> out(in.size());
+   conv(in.data(), out.data(), in.size());
+
+   auto const blocks = in.size() / conv.tail_block_size;
+   auto const late = conv.late_blocks();
+   auto const dropped = conv.dropped_blocks();
+   CHECK(late == blocks - 1);
+   CHECK(dropped == blocks - conv.num_slots);
+
+   // Missing the deadline never blocks nor corrupts the head: the
+   // output is the head alone, without the tail.
+   q::convolver<32> head{ ir.data(), conv.head_size };
+   std::vector<float> expected(in.size());
+   head(in.data(), expected.data(), in.size());
+   for (std::size_t i = 0; i != in.size(); ++i)
+      CHECK(out[i] == doctest::Approx(expected[i]).epsilon(0.0001));
+
+   // Release the worker. Once the caller waits for the worker, nothing
+   // is late or dropped.
+   conv.hold(false);
+   conv.sync();
+   for (std::size_t i = 0; i != in.size(); i += 32)
+   {
+      conv(&in[i], &out[i], 32);
+      conv.sync();
+   }
+   CHECK(conv.late_blocks() == late);
+   CHECK(conv.dropped_blocks() == dropped);
+}
+
+TEST_CASE("Nonuniform_Convolver_Benchmark" * doctest::skip())
+{
+   // Callback cost of a 2 second reverb at 48kHz, 128 sample buffers.
+   // For the nonuniform_convolver, this is the cost in the audio thread.
+   // The tail runs in the background and is allowed one tail block
+   // period to complete. Take note that this benchmark is not paced in
+   // real time, so the worker is expected to miss some deadlines here.
+   constexpr std::size_t buffer_size = 128;
+   auto const ir = impulse_response(96000);
+   auto const in = test::noise(48000 * 2);
+   std::vector<float> out(in.size());
+
+   q::convolver<buffer_size> uniform{ ir };
+   q::nonuniform_convolver<buffer_size, 16> nonuniform{ ir, 48000 };
+
+   auto process = [&](auto& conv)
+   {
+      return benchmark::run(
+         [&]
+         {
+            for (std::size_t i = 0; i < in.size(); i += buffer_size)
+               conv(&in[i], &out[i], buffer_size);
+            benchmark::keep(out.back());
+         }, 3
+      ) / in.size();
+   };
+
+   auto t1 = process(uniform);
+   auto t2 = process(nonuniform);
+
+   std::cout
+      << std::endl
+      << "2s IR @ 48kHz, " << buffer_size << " sample buffers (ns/sample)"
+      << std::endl
+      << "   uniform<128>:          " << std::fixed << std::setprecision(1) << t1
+      << std::endl
+      << "   nonuniform<128, 16>:   " << t2
+      << " (late blocks: " << nonuniform.late_blocks()
+      << ", dropped blocks: " << nonuniform.dropped_blocks() << ")"
+      << std::endl;
+}
@@ -0,0 +1,138 @@
+/*=============================================================================
+   Copyright (c) 2014-2020 Joel de Guzman. All rights reserved.
+
+   Distributed under the MIT License [ https://opensource.org/licenses/MIT ]
+=============================================================================*/
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <infra/doctest.hpp>
+
+#include <q/support/literals.hpp>
+#include <q/fx/lowpass.hpp>
+#include <q/fx/special.hpp>
+#include <q/fx/envelope.hpp>
+#include <q/fx/moving_average.hpp>
+#include <vector>
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include "benchmark.hpp"
+#include "test_signal.hpp"
+
+namespace q = cycfi::q;
+using namespace q::literals;
+
+constexpr auto sps = 44100;
+
+namespace
+{
+   // Rectified noise bursts with silence in between, for the envelope
+   // follower: attack and release phases, and blocks with both.
+   std::vector<float> bursts(std::size_t size)
+   {
+      auto sig = test::noise(size);
+      for (std::size_t i = 0; i != size; ++i)
+         sig[i] = ((i / 1000) % 2)? 0.0f : std::abs(sig[i]);
+      return sig;
+   }
+
+   // Block processing, in odd sized blocks, in place, is within a small
+   // tolerance of the sample by sample processing.
+   template <typename Filter>
+   void check_process(Filter f1, Filter f2, std::vector<float> const& in)
+   {
+      auto out = in;
+      std::size_t sizes[] = { 1, 7, 8, 64, 3, 100, 17, 256 };
+      std::size_t i = 0;
+      for (std::size_t k = 0; i < in.size(); ++k)
+      {
+         auto n = std::min(sizes[k % std::size(sizes)], in.size() - i);
+         f2.process(out.data() + i, n);
+         i += n;
+      }
+
+      double error = 0.0;
+      for (std::size_t i = 0; i != in.size(); ++i)
+         error = std::max(error, double(std::abs(f1(in[i]) - out[i])));
+      CHECK(error < 1e-5);
+      CHECK(f1.y == doctest::Approx(f2.y).epsilon(1e-5).scale(1));
+   }
+
+   // ns/sample of f(s) and f.process
+   template <typename Filter>
+   void run(char const* name, Filter f, std::vector<float> const& in)
+   {
+      constexpr std::size_t buffer_size = 256;
+      auto const iterations = in.size() / buffer_size;
+      std::vector<float> out(buffer_size);
+
+      auto scalar = benchmark::run(
+         [&]
+         {
+            for (std::size_t i = 0; i != iterations; ++i)
+            {
+               float const* s = &in[i * buffer_size];
+               for (std::size_t j = 0; j != buffer_size; ++j)
+                  out[j] = f(s[j]);
+               benchmark::keep(out[0]);
+            }
+         }
+      ) / (iterations * buffer_size);
+
+      auto block = benchmark::run(
+         [&]
+         {
+            for (std::size_t i = 0; i != iterations; ++i)
+            {
+               f.process(&in[i * buffer_size], out.data(), buffer_size);
+               benchmark::keep(out[0]);
+            }
+         }
+      ) / (iterations * buffer_size);
+
+      std::cout
+         << "   " << std::left << std::setw(22) << name << std::right
+         << std::fixed << std::setprecision(2)
+         << std::setw(8) << scalar
+         << std::setw(8) << block
+         << std::setw(8) << scalar / block << 'x' << std::endl;
+   }
+}
+
+TEST_CASE("One_Pole_Process")
+{
+   auto const in = test::noise(10000);
+   auto const env = bursts(10000);
+
+   check_process(q::one_pole_lowpass{ 1_kHz, sps }, q::one_pole_lowpass{ 1_kHz, sps }, in);
+   check_process(q::one_pole_lowpass{ 20_Hz, sps }, q::one_pole_lowpass{ 20_Hz, sps }, in);
+   check_process(q::leaky_integrator{ 0.9f }, q::leaky_integrator{ 0.9f }, in);
+   check_process(q::leaky_integrator{}, q::leaky_integrator{}, in);
+   check_process(q::dc_block{ 20_Hz, sps }, q::dc_block{ 20_Hz, sps }, in);
+   check_process(q::exp_moving_average<16>{}, q::exp_moving_average<16>{}, in);
+   check_process(q::rt_exp_moving_average{ 100 }, q::rt_exp_moving_average{ 100 }, in);
+
+   q::envelope_follower ef{ 2_ms, 50_ms, sps };
+   check_process(ef, ef, env);
+   check_process(ef, ef, in);
+
+   q::peak_envelope_follower pef{ 50_ms, sps };
+   check_process(pef, pef, env);
+   check_process(pef, pef, in);
+}
+
+TEST_CASE("One_Pole_Benchmark" * doctest::skip())
+{
+   auto const in = test::noise(sps);
+   auto const env = bursts(sps);
+
+   std::cout
+      << std::endl
+      << "One pole filters (ns/sample)   scalar   block" << std::endl;
+
+   run("one_pole_lowpass", q::one_pole_lowpass{ 1_kHz, sps }, in);
+   run("leaky_integrator", q::leaky_integrator{}, in);
+   run("dc_block", q::dc_block{ 20_Hz, sps }, in);
+   run("exp_moving_average", q::exp_moving_average<16>{}, in);
+   run("envelope_follower", q::envelope_follower{ 2_ms, 50_ms, sps }, env);
+   run("peak_envelope_follower", q::peak_envelope_follower{ 50_ms, sps }, env);
+}
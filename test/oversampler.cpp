@@ -0,0 +1,228 @@
+/*=============================================================================
+   Copyright (c) 2014-2020 Joel de Guzman. All rights reserved.
+
+   Distributed under the MIT License [ https://opensource.org/licenses/MIT ]
+=============================================================================*/
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <infra/doctest.hpp>
+
+#include <q/support/literals.hpp>
+#include <q/fx/oversampler.hpp>
+#include <q/fx/waveshaper.hpp>
+#include <vector>
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include "benchmark.hpp"
+#include "test_signal.hpp"
+
+namespace q = cycfi::q;
+using namespace q::literals;
+
+constexpr auto sps = 44100;
+
+namespace
+{
+   std::vector<float> sine(double freq, std::size_t size, double gain = 1.0)
+   {
+      std::vector<float> sig(size);
+      for (std::size_t i = 0; i != size; ++i)
+         sig[i] = gain * std::sin(2 * q::pi * freq * i / sps);
+      return sig;
+   }
+
+   // Level (in dB) of the component at freq (an integer number of Hz),
+   // for a signal one second long.
+   double level_at(std::vector<float> const& sig, double freq)
+   {
+      double re = 0.0, im = 0.0;
+      for (std::size_t i = 0; i != sig.size(); ++i)
+      {
+         auto const w = 2 * q::pi * freq * i / sps;
+         re += sig[i] * std::cos(w);
+         im += sig[i] * std::sin(w);
+      }
+      auto const amplitude = 2 * std::sqrt(re * re + im * im) / sig.size();
+      return 20 * std::log10(amplitude + 1e-12);
+   }
+
+   struct identity
+   {
+      float operator()(float s) const { return s; }
+   };
+
+   // Hard clipper, with gain
+   struct drive
+   {
+      drive(float gain) : _gain(gain) {}
+      float operator()(float s) const { return q::clip{}(s * _gain); }
+      float _gain;
+   };
+
+   // Passband sines are delayed by latency(), but otherwise unchanged
+   template <std::size_t Factor>
+   void check_passthrough()
+   {
+      q::oversampled<identity, Factor> os;
+      for (auto freq : { 100.0, 1000.0, 5000.0 })
+      {
+         INFO("Factor = " << Factor << ", frequency = " << freq);
+         os.reset();
+         auto const in = sine(freq, 4096);
+         std::vector<float> out(in.size());
+         os.process(in.data(), out.data(), in.size());
+
+         double error = 0.0;
+         for (std::size_t i = 1024; i != out.size(); ++i)
+         {
+            auto const t = (i - os.latency()) / sps;
+            auto const expected = std::sin(2 * q::pi * freq * t);
+            error = std::max(error, std::abs(out[i] - expected));
+         }
+
+         // The half-bands are not linear phase, so higher frequencies
+         // deviate a bit from the low frequency delay
+         CHECK(error < ((freq < 2000)? 0.005 : 0.1));
+      }
+   }
+
+   template <std::size_t Factor>
+   void check_process()
+   {
+      // Block processing is the same as per-sample processing
+      q::oversampled<drive, Factor> os1{ 3.0f };
+      q::oversampled<drive, Factor> os2{ 3.0f };
+      auto const in = test::noise(1000);
+      auto out = in;
+      os2.process(out.data(), 300);
+      os2.process(out.data() + 300, 700);
+      for (std::size_t i = 0; i != in.size(); ++i)
+         CHECK(os1(in[i]) == doctest::Approx(out[i]).epsilon(1e-5).scale(1));
+   }
+}
+
+TEST_CASE("Oversampler_Halfband")
+{
+   // The decimator passes the lower half of the high rate band, and
+   // rejects the upper half
+   auto response = [](double freq)
+   {
+      q::halfband_downsampler<8> down{ 0.04 };
+      constexpr std::size_t size = 8192;
+      std::vector<float> in(size * 2);
+      for (std::size_t i = 0; i != in.size(); ++i)
+         in[i] = std::sin(2 * q::pi * freq * i);
+
+      std::vector<float> out(size);
+      for (std::size_t i = 0; i != size; ++i)
+         out[i] = down(&in[i * 2]);
+
+      double re = 0.0, im = 0.0;
+      for (std::size_t i = size / 2; i != size; ++i)
+      {
+         auto const w = 2 * q::pi * (1.0 - 2 * freq) * i;
+         re += out[i] * std::cos(w);
+         im += out[i] * std::sin(w);
+      }
+      return 2 * std::sqrt(re * re + im * im) / (size / 2);
+   };
+
+   CHECK(response(0.01) == doctest::Approx(1.0).epsilon(0.001));
+   CHECK(response(0.2) == doctest::Approx(1.0).epsilon(0.001));
+   CHECK(response(0.28) < 1e-5);
+   CHECK(response(0.4) < 1e-5);
+}
+
+TEST_CASE("Oversampler_Passthrough")
+{
+   check_passthrough<2>();
+   check_passthrough<4>();
+   check_passthrough<8>();
+}
+
+TEST_CASE("Oversampler_Process")
+{
+   check_process<2>();
+   check_process<4>();
+   check_process<8>();
+}
+
+TEST_CASE("Oversampler_Aliasing")
+{
+   // A 5 kHz sine, hard clipped, has odd harmonics at 15, 25, 35 kHz, etc.
+   // At 44.1 kHz, 35 kHz aliases to 9.1 kHz, and 45 kHz to 900 Hz.
+   auto const in = sine(5000, sps, 0.9);
+   drive clipper{ 4.0f };
+
+   std::vector<float> naive(in.size());
+   for (std::size_t i = 0; i != in.size(); ++i)
+      naive[i] = clipper(in[i]);
+
+   q::oversampled<drive, 2> os2{ 4.0f };
+   q::oversampled<drive, 4> os4{ 4.0f };
+   q::oversampled<drive, 8> os8{ 4.0f };
+   std::vector<float> out2(in.size()), out4(in.size()), out8(in.size());
+   os2.process(in.data(), out2.data(), in.size());
+   os4.process(in.data(), out4.data(), in.size());
+   os8.process(in.data(), out8.data(), in.size());
+
+   // The fundamental is unchanged
+   CHECK(level_at(out4, 5000) == doctest::Approx(level_at(naive, 5000)).epsilon(0.01));
+
+   std::cout
+      << std::endl
+      << "Hard clipped 5 kHz sine at 44.1 kHz, aliases (dB)" << std::endl
+      << "                    9.1 kHz     900 Hz" << std::endl
+      << std::fixed << std::setprecision(1);
+
+   auto report = [](char const* name, std::vector<float> const& out)
+   {
+      std::cout
+         << "   " << std::left << std::setw(12) << name << std::right
+         << std::setw(10) << level_at(out, 9100)
+         << std::setw(11) << level_at(out, 900)
+         << std::endl;
+   };
+   report("none", naive);
+   report("2x", out2);
+   report("4x", out4);
+   report("8x", out8);
+
+   // The aliases are much lower with oversampling
+   CHECK(level_at(out2, 9100) < level_at(naive, 9100) - 20);
+   CHECK(level_at(out4, 9100) < level_at(naive, 9100) - 30);
+   CHECK(level_at(out8, 900) < level_at(naive, 900) - 30);
+}
+
+TEST_CASE("Oversampler_Benchmark" * doctest::skip())
+{
+   // One second at 44.1 kHz, in 128 sample buffers
+   constexpr std::size_t buffer_size = 128;
+   constexpr std::size_t iterations = sps / buffer_size;
+   auto const in = test::noise(buffer_size);
+   std::vector<float> out(buffer_size);
+
+   auto time = [&](auto& os)
+   {
+      return benchmark::run(
+         [&]
+         {
+            for (std::size_t i = 0; i != iterations; ++i)
+               os.process(in.data(), out.data(), buffer_size);
+            benchmark::keep(out.back());
+         }
+      ) / (iterations * buffer_size);
+   };
+
+   q::oversampled<q::soft_clip, 2> os2;
+   q::oversampled<q::soft_clip, 4> os4;
+   q::oversampled<q::soft_clip, 8> os8;
+
+   std::cout
+      << std::endl
+      << "Oversampled soft_clip (ns/sample)" << std::endl
+      << std::fixed << std::setprecision(2)
+      << "   2x: " << time(os2) << ", latency: " << os2.latency() << std::endl
+      << "   4x: " << time(os4) << ", latency: " << os4.latency() << std::endl
+      << "   8x: " << time(os8) << ", latency: " << os8.latency() << std::endl;
+}
@@ -0,0 +1,203 @@
+/*=============================================================================
+   Copyright (c) 2014-2020 Joel de Guzman. All rights reserved.
+
+   Distributed under the MIT License [ https://opensource.org/licenses/MIT ]
+=============================================================================*/
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <infra/doctest.hpp>
+
+#include <q/support/literals.hpp>
+#include <q/fx/resampler.hpp>
+#include <vector>
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include "benchmark.hpp"
+#include "test_signal.hpp"
+
+namespace q = cycfi::q;
+using namespace q::literals;
+
+namespace
+{
+   std::vector<float> sine(double freq, double sps, std::size_t size)
+   {
+      std::vector<float> sig(size);
+      for (std::size_t i = 0; i != size; ++i)
+         sig[i] = std::sin(2 * q::pi * freq * i / sps);
+      return sig;
+   }
+
+   std::vector<float> resample(q::resampler& r, std::vector<float> const& in)
+   {
+      std::vector<float> out(r.max_output(in.size()));
+      out.resize(r.process(in.data(), in.size(), out.data()));
+      return out;
+   }
+
+   // Max error of a resampled sine, against the ideal sine, delayed by the
+   // resampler latency. The first and last few samples are skipped.
+   double sine_error(
+      std::uint32_t sps_in, std::uint32_t sps_out, double freq
+    , q::resampler::quality_type quality)
+   {
+      q::resampler r{ sps_in, sps_out, quality };
+      auto const out = resample(r, sine(freq, sps_in, sps_in));
+      auto const delay = double(r.latency()) / sps_in;
+
+      double error = 0.0;
+      for (std::size_t i = out.size() / 4; i != out.size() * 3 / 4; ++i)
+      {
+         auto const t = double(i) / sps_out - delay;
+         auto const expected = std::sin(2 * q::pi * freq * t);
+         error = std::max(error, std::abs(out[i] - expected));
+      }
+      return error;
+   }
+
+   // Level of the output, in dB, given a full scale sine input at freq
+   double level(
+      std::uint32_t sps_in, std::uint32_t sps_out, double freq
+    , q::resampler::quality_type quality)
+   {
+      q::resampler r{ sps_in, sps_out, quality };
+      auto const out = resample(r, sine(freq, sps_in, sps_in));
+      double peak = 0.0;
+      for (std::size_t i = out.size() / 4; i != out.size(); ++i)
+         peak = std::max(peak, double(std::abs(out[i])));
+      return 20 * std::log10(std::max(peak, 1e-10));
+   }
+}
+
+TEST_CASE("Resampler_Ratio")
+{
+   q::resampler up{ 44100, 48000 };
+   CHECK(up.ratio() == doctest::Approx(48000.0 / 44100));
+   CHECK(up.num_phases() == 160);
+
+   q::resampler down{ 96000, 48000 };
+   CHECK(down.ratio() == doctest::Approx(0.5));
+   CHECK(down.num_phases() == 1);
+   CHECK(down.num_taps() == 64);
+
+   q::resampler odd{ 44100, 44101 };
+   CHECK(odd.num_phases() == q::resampler::interpolated_phases);
+
+   q::resampler frac{ 1.0001 };
+   CHECK(frac.ratio() == doctest::Approx(1.0001).epsilon(1e-6));
+
+   // One second in, one second out, give or take a sample
+   auto const in = test::noise(44100);
+   CHECK(std::abs(long(resample(up, in).size()) - 48000) <= 1);
+   CHECK(std::abs(long(resample(frac, in).size()) - 44104) <= 1);
+}
+
+TEST_CASE("Resampler_Streaming")
+{
+   // Processing in odd sized blocks gives the same result as a single block
+   auto const in = test::noise(20000);
+   for (auto sps : { 32000u, 44100u, 48000u, 96000u })
+   {
+      INFO("sps_out = " << sps);
+      q::resampler r1{ 48000, sps };
+      q::resampler r2{ 48000, sps };
+      auto const ref = resample(r1, in);
+
+      std::vector<float> out;
+      std::vector<float> buf(r2.max_output(1000));
+      std::size_t sizes[] = { 1, 2, 3, 64, 1, 100, 17, 1000, 8, 9, 700 };
+      std::size_t i = 0;
+      for (std::size_t k = 0; i < in.size(); ++k)
+      {
+         auto n = std::min(sizes[k % std::size(sizes)], in.size() - i);
+         auto m = r2.process(&in[i], n, buf.data());
+         CHECK(m <= r2.max_output(n));
+         out.insert(out.end(), buf.begin(), buf.begin() + m);
+         i += n;
+      }
+
+      REQUIRE(out.size() == ref.size());
+      for (std::size_t i = 0; i != out.size(); ++i)
+         CHECK(out[i] == ref[i]);
+   }
+}
+
+TEST_CASE("Resampler_Sine")
+{
+   using q::resampler;
+
+   // Passband sines come out as the same sine, at the new rate
+   CHECK(sine_error(44100, 48000, 1000, resampler::low) < 0.005);
+   CHECK(sine_error(44100, 48000, 1000, resampler::medium) < 0.0005);
+   CHECK(sine_error(44100, 48000, 1000, resampler::high) < 0.00005);
+   CHECK(sine_error(48000, 44100, 5000, resampler::high) < 0.00005);
+   CHECK(sine_error(96000, 48000, 10000, resampler::high) < 0.00005);
+   CHECK(sine_error(48000, 96000, 15000, resampler::medium) < 0.0005);
+   CHECK(sine_error(44100, 44101, 2000, resampler::medium) < 0.0005);
+}
+
+TEST_CASE("Resampler_Aliasing")
+{
+   using q::resampler;
+
+   // Sines above the output Nyquist frequency are rejected
+   CHECK(level(48000, 44100, 24000 * 0.99, resampler::low) < -50);
+   CHECK(level(48000, 44100, 24000 * 0.99, resampler::medium) < -75);
+   CHECK(level(48000, 44100, 24000 * 0.99, resampler::high) < -95);
+   CHECK(level(96000, 48000, 30000, resampler::high) < -95);
+
+   // Images above the input Nyquist frequency are rejected: they would
+   // show up as an error against the ideal sine
+   CHECK(sine_error(44100, 96000, 15000, resampler::high) < 0.0001);
+}
+
+TEST_CASE("Resampler_Benchmark" * doctest::skip())
+{
+   using q::resampler;
+
+   std::cout
+      << std::endl
+      << "Resampler, one second of input in 512 sample buffers" << std::endl
+      << "                       ns/sample (in)   alias (dB)" << std::endl;
+
+   auto run = [](char const* name, std::uint32_t sps_in, std::uint32_t sps_out
+    , resampler::quality_type quality)
+   {
+      constexpr std::size_t buffer_size = 512;
+      auto const iterations = sps_in / buffer_size;
+      auto const in = test::noise(buffer_size);
+      resampler r{ sps_in, sps_out, quality };
+      std::vector<float> out(r.max_output(buffer_size));
+
+      auto t = benchmark::run(
+         [&]
+         {
+            for (std::size_t i = 0; i != iterations; ++i)
+               r.process(in.data(), buffer_size, out.data());
+            benchmark::keep(out[0]);
+         }
+      ) / (iterations * buffer_size);
+
+      std::cout
+         << "   " << std::left << std::setw(20) << name << std::right
+         << std::fixed << std::setprecision(2) << std::setw(14) << t;
+
+      // When downsampling, the aliasing is the level of the output, given
+      // a sine 5% above the output Nyquist frequency
+      if (sps_out < sps_in)
+      {
+         auto const alias = level(sps_in, sps_out, sps_out / 2 * 1.05, quality);
+         std::cout << std::setw(13) << std::setprecision(1) << alias;
+      }
+      std::cout << std::endl;
+   };
+
+   run("44.1k->48k low", 44100, 48000, resampler::low);
+   run("44.1k->48k medium", 44100, 48000, resampler::medium);
+   run("44.1k->48k high", 44100, 48000, resampler::high);
+   run("48k->44.1k low", 48000, 44100, resampler::low);
+   run("48k->44.1k medium", 48000, 44100, resampler::medium);
+   run("48k->44.1k high", 48000, 44100, resampler::high);
+   run("96k->48k high", 96000, 48000, resampler::high);
+   run("48k->96k high", 48000, 96000, resampler::high);
+}
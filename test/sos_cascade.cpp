@@ -0,0 +1,252 @@
+/*=============================================================================
+   Copyright (c) 2014-2020 Joel de Guzman. All rights reserved.
+
+   Distributed under the MIT License [ https://opensource.org/licenses/MIT ]
+=============================================================================*/
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <infra/doctest.hpp>
+
+#include <q/support/literals.hpp>
+#include <q/fx/sos_cascade.hpp>
+#include <vector>
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include "benchmark.hpp"
+#include "test_signal.hpp"
+
+namespace q = cycfi::q;
+using namespace q::literals;
+
+constexpr auto sps = 48000;
+
+namespace
+{
+   // Steady state gain of the filter at frequency f
+   template <typename Filter>
+   double gain_at(Filter f, double freq)
+   {
+      constexpr std::size_t size = 48000;
+      std::vector<float> buf(size);
+      for (std::size_t i = 0; i != size; ++i)
+         buf[i] = std::sin(2 * q::pi * freq * i / sps);
+      f.process(buf.data(), size);
+
+      // Skip the first half, while the filter settles
+      double peak = 0.0;
+      for (std::size_t i = size/2; i != size; ++i)
+         peak = std::max(peak, double(std::abs(buf[i])));
+      return peak;
+   }
+
+   // The pipelined block processing should match the per-sample cascade
+   template <std::size_t K>
+   void check_process(q::sos_cascade<K> const& filter)
+   {
+      auto const in = test::noise(4096);
+
+      auto f1 = filter;
+      std::vector<float> ref(in.size());
+      for (std::size_t i = 0; i != in.size(); ++i)
+         ref[i] = f1(in[i]);
+
+      // In place, with odd block sizes, mixed with per-sample calls
+      auto f2 = filter;
+      auto out = in;
+      std::size_t sizes[] = { 1, 2, 3, 64, 1, 100, 17, 256, 8, 9 };
+      std::size_t i = 0;
+      for (std::size_t k = 0; i < out.size(); ++k)
+      {
+         auto n = std::min(sizes[k % std::size(sizes)], out.size() - i);
+         if (k % 7 == 6)
+         {
+            for (auto j = i; j != i + n; ++j)
+               out[j] = f2(out[j]);
+         }
+         else
+         {
+            f2.process(&out[i], n);
+         }
+         i += n;
+      }
+
+      for (std::size_t i = 0; i != in.size(); ++i)
+      {
+         INFO("index = " << i);
+         CHECK(out[i] == doctest::Approx(ref[i]).epsilon(0.001).scale(1));
+      }
+   }
+}
+
+TEST_CASE("SOS_Cascade_Process")
+{
+   check_process(q::butterworth_lowpass<1>{ 1_kHz, sps });
+   check_process(q::butterworth_lowpass<2>{ 1_kHz, sps });
+   check_process(q::butterworth_highpass<3>{ 300_Hz, sps });
+   check_process(q::linkwitz_riley_lowpass<4>{ 2_kHz, sps });
+   check_process(q::chebyshev_lowpass<4>{ 5_kHz, sps, 0.5 });
+   check_process(q::chebyshev_highpass<8>{ 100_Hz, sps, 1.0 });
+}
+
+TEST_CASE("SOS_Cascade_Biquads")
+{
+   // A cascade configured from biquads is the same as the biquads in series
+   q::lowpass lp{ 2_kHz, sps, 0.9 };
+   q::peaking pk{ 6.0, 500_Hz, sps, 2.0 };
+   q::highpass hp{ 80_Hz, sps };
+
+   q::sos_cascade<3> sos;
+   sos.config(0, lp);
+   sos.config(1, pk);
+   sos.config(2, q::detail::config_highpass(80_Hz, sps, 0.707));
+
+   auto in = test::noise(2048);
+   std::vector<float> out(in.size());
+   sos.process(in.data(), out.data(), in.size());
+
+   for (std::size_t i = 0; i != in.size(); ++i)
+   {
+      INFO("index = " << i);
+      auto expected = hp(pk(lp(in[i])));
+      CHECK(out[i] == doctest::Approx(expected).epsilon(0.001).scale(1));
+   }
+}
+
+TEST_CASE("SOS_Cascade_Response")
+{
+   auto const fc = 1_kHz;
+   auto const f = double(fc);
+   auto const minus_3dB = 1.0 / std::sqrt(2.0);
+
+   // Butterworth: -3 dB at the cutoff, maximally flat
+   CHECK(gain_at(q::butterworth_lowpass<2>{ fc, sps }, f) ==
+      doctest::Approx(minus_3dB).epsilon(0.01));
+   CHECK(gain_at(q::butterworth_lowpass<4>{ fc, sps }, f) ==
+      doctest::Approx(minus_3dB).epsilon(0.01));
+   CHECK(gain_at(q::butterworth_highpass<3>{ fc, sps }, f) ==
+      doctest::Approx(minus_3dB).epsilon(0.01));
+   CHECK(gain_at(q::butterworth_lowpass<4>{ fc, sps }, f / 4) ==
+      doctest::Approx(1.0).epsilon(0.01));
+
+   // Order 8: 48 dB/octave, one octave and more above the cutoff
+   CHECK(gain_at(q::butterworth_lowpass<4>{ fc, sps }, f * 2) < 0.005);
+
+   // Linkwitz-Riley: -6 dB at the crossover
+   CHECK(gain_at(q::linkwitz_riley_lowpass<2>{ fc, sps }, f) ==
+      doctest::Approx(0.5).epsilon(0.01));
+   CHECK(gain_at(q::linkwitz_riley_highpass<4>{ fc, sps }, f) ==
+      doctest::Approx(0.5).epsilon(0.01));
+
+   // Chebyshev: the passband ripples between 0 and -ripple dB, and is
+   // -ripple dB at the cutoff
+   auto const ripple = 1.0;
+   auto const bottom = std::pow(10.0, -ripple / 20);
+   CHECK(gain_at(q::chebyshev_lowpass<3>{ fc, sps, ripple }, f) ==
+      doctest::Approx(bottom).epsilon(0.01));
+   CHECK(gain_at(q::chebyshev_highpass<3>{ fc, sps, ripple }, f) ==
+      doctest::Approx(bottom).epsilon(0.01));
+   for (auto fr : { 50.0, 200.0, 400.0, 700.0, 900.0 })
+   {
+      INFO("frequency = " << fr);
+      auto g = gain_at(q::chebyshev_lowpass<3>{ fc, sps, ripple }, fr);
+      CHECK(g <= 1.01);
+      CHECK(g >= bottom * 0.99);
+   }
+}
+
+TEST_CASE("SOS_Cascade_Linkwitz_Riley_Sum")
+{
+   // The lowpass and highpass outputs of a Linkwitz-Riley crossover sum to
+   // an allpass response: flat magnitude at all frequencies.
+   for (auto fr : { 100.0, 500.0, 1000.0, 2000.0, 8000.0 })
+   {
+      INFO("frequency = " << fr);
+      q::linkwitz_riley_lowpass<4> lp{ 1_kHz, sps };
+      q::linkwitz_riley_highpass<4> hp{ 1_kHz, sps };
+
+      constexpr std::size_t size = 48000;
+      std::vector<float> a(size), b(size);
+      for (std::size_t i = 0; i != size; ++i)
+         a[i] = b[i] = std::sin(2 * q::pi * fr * i / sps);
+      lp.process(a.data(), size);
+      hp.process(b.data(), size);
+
+      double peak = 0.0;
+      for (std::size_t i = size/2; i != size; ++i)
+         peak = std::max(peak, double(std::abs(a[i] + b[i])));
+      CHECK(peak == doctest::Approx(1.0).epsilon(0.01));
+   }
+}
+
+namespace
+{
+   template <std::size_t K>
+   void benchmark_cascade()
+   {
+      // One second at 48kHz, in 128 sample buffers
+      constexpr std::size_t buffer_size = 128;
+      constexpr std::size_t iterations = 48000 / buffer_size;
+      auto const in = test::noise(buffer_size);
+      std::vector<float> out(buffer_size);
+
+      q::butterworth_lowpass<K> sos{ 1_kHz, sps };
+      auto per_sample = sos;
+
+      // The same filter, as K biquads in series
+      std::vector<q::biquad> chain;
+      for (std::size_t k = 0; k != K; ++k)
+         chain.push_back(q::lowpass{ 1_kHz, sps, q::detail::butterworth_q(k, 2*K) });
+
+      auto t1 = benchmark::run(
+         [&]
+         {
+            for (std::size_t i = 0; i != iterations; ++i)
+               for (std::size_t j = 0; j != buffer_size; ++j)
+                  out[j] = per_sample(in[j]);
+            benchmark::keep(out.back());
+         }
+      ) / (iterations * buffer_size);
+
+      auto t2 = benchmark::run(
+         [&]
+         {
+            for (std::size_t i = 0; i != iterations; ++i)
+            {
+               chain[0].process(in.data(), out.data(), buffer_size);
+               for (std::size_t k = 1; k != K; ++k)
+                  chain[k].process(out.data(), buffer_size);
+            }
+            benchmark::keep(out.back());
+         }
+      ) / (iterations * buffer_size);
+
+      auto t3 = benchmark::run(
+         [&]
+         {
+            for (std::size_t i = 0; i != iterations; ++i)
+               sos.process(in.data(), out.data(), buffer_size);
+            benchmark::keep(out.back());
+         }
+      ) / (iterations * buffer_size);
+
+      std::cout
+         << std::setw(4) << K
+         << std::setw(14) << std::fixed << std::setprecision(2) << t1
+         << std::setw(16) << t2
+         << std::setw(16) << t3
+         << std::setw(10) << t2 / t3 << 'x'
+         << std::endl;
+   }
+}
+
+TEST_CASE("SOS_Cascade_Benchmark" * doctest::skip())
+{
+   std::cout
+      << std::endl
+      << "Butterworth lowpass, ns per sample, 128 sample buffers" << std::endl
+      << "   K    per-sample   biquad chain     sos_cascade  vs chain" << std::endl;
+
+   benchmark_cascade<2>();
+   benchmark_cascade<4>();
+   benchmark_cascade<8>();
+}
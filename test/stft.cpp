@@ -0,0 +1,172 @@
+/*=============================================================================
+   Copyright (c) 2014-2020 Joel de Guzman. All rights reserved.
+
+   Distributed under the MIT License [ https://opensource.org/licenses/MIT ]
+=============================================================================*/
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <infra/doctest.hpp>
+
+#include <q/support/literals.hpp>
+#include <q/fft/stft.hpp>
+#include <vector>
+#include <cmath>
+
+namespace q = cycfi::q;
+using namespace q::literals;
+
+namespace
+{
+   std::vector<float> test_signal(std::size_t size)
+   {
+      std::vector<float> sig(size);
+      for (std::size_t i = 0; i != size; ++i)
+      {
+         sig[i] =
+            0.5 * std::sin(2_pi * i * 0.013) +
+            0.3 * std::sin(2_pi * i * 0.171) +
+            0.2 * std::sin(2_pi * i * 0.377)
+         ;
+      }
+      return sig;
+   }
+
+   template <typename STFT>
+   void check_reconstruction(STFT& stft, std::size_t block_size)
+   {
+      auto const in = test_signal(8192);
+      std::vector<float> out(in.size());
+
+      // Process in blocks of arbitrary size
+      for (std::size_t i = 0; i < in.size(); i += block_size)
+      {
+         auto n = std::min(block_size, in.size() - i);
+         stft(&in[i], &out[i], n, [](auto& /*spectrum*/) {});
+      }
+
+      auto latency = stft.latency();
+      for (std::size_t i = latency; i != in.size(); ++i)
+      {
+         INFO("index = " << i);
+         CHECK(out[i] == doctest::Approx(in[i - latency]).epsilon(0.0001));
+      }
+   }
+}
+
+TEST_CASE("STFT_Reconstruction")
+{
+   {
+      q::stft<256, 64> stft;
+      check_reconstruction(stft, 37);
+   }
+   {
+      q::stft<512, 256> stft{ q::hamming_window{} };
+      check_reconstruction(stft, 128);
+   }
+   {
+      q::stft<1024, 128> stft{ q::blackman_window{} };
+      check_reconstruction(stft, 1000);
+   }
+}
+
+TEST_CASE("STFT_Zero_Window_Sum")
+{
+   // With Hop == N, the periodic hann window is zero at the start of each
+   // frame, so the input there cannot be recovered, and the output is zero.
+   // Everywhere else, the input is reconstructed.
+   constexpr std::size_t n = 256;
+   q::stft<n, n> stft;
+   auto const in = test_signal(4096);
+   std::vector<float> out(in.size());
+   stft(in.data(), out.data(), in.size(), [](auto& /*spectrum*/) {});
+
+   auto latency = stft.latency();
+   for (std::size_t i = latency; i != in.size(); ++i)
+   {
+      INFO("index = " << i);
+      if ((i - latency) % n == 0)
+         CHECK(out[i] == 0.0f);
+      else
+         CHECK(out[i] == doctest::Approx(in[i - latency]).epsilon(0.0001));
+   }
+}
+
+TEST_CASE("STFT_In_Place")
+{
+   q::stft<256, 64> stft;
+   auto const in = test_signal(4096);
+   auto buff = in;
+
+   for (std::size_t i = 0; i < buff.size(); i += 100)
+   {
+      auto n = std::min<std::size_t>(100, buff.size() - i);
+      stft(&buff[i], &buff[i], n, [](auto& /*spectrum*/) {});
+   }
+
+   auto latency = stft.latency();
+   for (std::size_t i = latency; i != in.size(); ++i)
+      CHECK(buff[i] == doctest::Approx(in[i - latency]).epsilon(0.0001));
+}
+
+TEST_CASE("STFT_Analysis")
+{
+   constexpr std::size_t n = 1024;
+   constexpr std::size_t bin = 32;
+   q::stft<n, 256> stft;
+
+   std::vector<float> in(n * 4);
+   for (std::size_t i = 0; i != in.size(); ++i)
+      in[i] = std::sin(2_pi * i * bin / n);
+
+   std::size_t frames = 0;
+   stft.analyze(in.data(), in.size(),
+      [&](auto const& spectrum)
+      {
+         if (++frames < 4) // skip the initial (partially filled) frames
+            return;
+
+         // The peak should be at our bin
+         std::size_t peak = 0;
+         double peak_mag = 0.0;
+         for (std::size_t k = 1; k != n/2; ++k)
+         {
+            auto mag = std::hypot(spectrum[k*2], spectrum[k*2 + 1]);
+            if (mag > peak_mag)
+            {
+               peak_mag = mag;
+               peak = k;
+            }
+         }
+         CHECK(peak == bin);
+      }
+   );
+   CHECK(frames == in.size() / 256);
+}
+
+TEST_CASE("STFT_Spectral_Processing")
+{
+   // Zero out everything above bin 64 (a brickwall lowpass). The low
+   // frequency component should pass and the high frequency component
+   // should be removed.
+   constexpr std::size_t n = 512;
+   q::stft<n, 128> stft;
+
+   std::vector<float> in(n * 16);
+   for (std::size_t i = 0; i != in.size(); ++i)
+      in[i] = std::sin(2_pi * i * 8 / n) + std::sin(2_pi * i * 200 / n);
+
+   std::vector<float> out(in.size());
+   stft(in.data(), out.data(), in.size(),
+      [](auto& spectrum)
+      {
+         for (std::size_t k = 65; k != n-64; ++k)
+            spectrum[k*2] = spectrum[k*2 + 1] = 0.0;
+      }
+   );
+
+   auto latency = stft.latency();
+   for (std::size_t i = latency * 2; i != in.size(); ++i)
+   {
+      auto expected = std::sin(2_pi * (i - latency) * 8 / n);
+      CHECK(out[i] == doctest::Approx(expected).epsilon(0.001).scale(1.0));
+   }
+}
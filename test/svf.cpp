@@ -0,0 +1,211 @@
+/*=============================================================================
+   Copyright (c) 2014-2020 Joel de Guzman. All rights reserved.
+
+   Distributed under the MIT License [ https://opensource.org/licenses/MIT ]
+=============================================================================*/
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <infra/doctest.hpp>
+
+#include <q/support/literals.hpp>
+#include <q/fx/biquad.hpp>
+#include <q/fx/svf.hpp>
+#include <vector>
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include "benchmark.hpp"
+#include "test_signal.hpp"
+
+namespace q = cycfi::q;
+using namespace q::literals;
+
+constexpr auto sps = 48000;
+
+namespace
+{
+   // The svf should have the same response as the RBJ biquad
+   template <typename Biquad>
+   void check_same(q::svf f, Biquad bq)
+   {
+      auto const in = test::noise(4096);
+      for (std::size_t i = 0; i != in.size(); ++i)
+      {
+         INFO("index = " << i);
+         auto expected = bq(in[i]);
+         CHECK(f(in[i]) == doctest::Approx(expected).epsilon(0.001).scale(1));
+      }
+   }
+}
+
+TEST_CASE("SVF_Response")
+{
+   check_same(q::svf{ q::svf::lowpass, 1_kHz, sps }, q::lowpass{ 1_kHz, sps });
+   check_same(q::svf{ q::svf::lowpass, 300_Hz, sps, 4.0 }, q::lowpass{ 300_Hz, sps, 4.0 });
+   check_same(q::svf{ q::svf::highpass, 2_kHz, sps, 0.5 }, q::highpass{ 2_kHz, sps, 0.5 });
+   check_same(q::svf{ q::svf::bandpass, 800_Hz, sps, 2.0 }, q::bandpass_cpg{ 800_Hz, sps, 2.0 });
+   check_same(q::svf{ q::svf::notch, 5_kHz, sps, 3.0 }, q::notch{ 5_kHz, sps, 3.0 });
+   check_same(q::svf{ q::svf::allpass, 3_kHz, sps }, q::allpass{ 3_kHz, sps });
+
+   // Peak is lowpass - highpass
+   q::svf pk{ q::svf::peak, 1_kHz, sps, 2.0 };
+   q::svf lp{ q::svf::lowpass, 1_kHz, sps, 2.0 };
+   q::svf hp{ q::svf::highpass, 1_kHz, sps, 2.0 };
+   for (auto s : test::noise(1024))
+   {
+      auto expected = lp(s) - hp(s);
+      CHECK(pk(s) == doctest::Approx(expected).epsilon(0.0001).scale(1));
+   }
+}
+
+TEST_CASE("SVF_Fast_Config")
+{
+   // The fast design should be very close to the exact design
+   for (auto f : { 50.0, 200.0, 1000.0, 5000.0, 15000.0 })
+   {
+      INFO("frequency = " << f);
+      q::svf exact{ q::svf::bandpass, q::frequency(f), sps, 3.0 };
+      q::svf fast = exact;
+      fast.fast_config(q::frequency(f), sps, 3.0);
+
+      double error = 0.0;
+      for (auto s : test::noise(4096))
+         error = std::max<double>(error, std::abs(exact(s) - fast(s)));
+      CHECK(error < 0.002);
+   }
+}
+
+TEST_CASE("SVF_Ramp")
+{
+   q::svf a{ q::svf::lowpass, 200_Hz, sps, 2.0 };
+   a.config(2_kHz, sps, 2.0, 64);
+
+   auto const in = test::noise(4800);
+   std::vector<float> out(in.size());
+
+   // Ramping, in odd blocks
+   a.process(in.data(), out.data(), 13);
+   CHECK(a.ramping());
+   a.process(in.data() + 13, out.data() + 13, 50);
+   CHECK(a.ramping());
+   a.process(in.data() + 63, out.data() + 63, 1);
+   CHECK(!a.ramping());
+
+   // After the ramp, the filter is the same as one designed for the
+   // target. With the same input, the difference (the initial state)
+   // decays.
+   q::svf b{ q::svf::lowpass, 2_kHz, sps, 2.0 };
+   double error = 0.0;
+   for (std::size_t i = 64; i != in.size(); ++i)
+   {
+      auto diff = std::abs(a(in[i]) - b(in[i]));
+      if (i > in.size() - 1000)
+         error = std::max<double>(error, diff);
+   }
+   CHECK(error < 1e-5);
+}
+
+TEST_CASE("SVF_Modulation")
+{
+   // Jump the frequency around every sample, with high resonance. The
+   // filter should stay stable.
+   q::svf f{ q::svf::bandpass, 1_kHz, sps, 20.0 };
+   double peak = 0.0;
+   for (auto s : test::noise(48000))
+   {
+      auto freq = 50.0 + (q::fast_rand() / 32768.0) * 15000.0;
+      f.fast_config(q::frequency(freq), sps, 20.0);
+      peak = std::max<double>(peak, std::abs(f(s)));
+   }
+   CHECK(std::isfinite(peak));
+   CHECK(peak < 10.0);
+}
+
+TEST_CASE("SVF_Benchmark" * doctest::skip())
+{
+   // Auto-wah: a 2 Hz sweep from 200 Hz to 2 kHz, q = 5. The sweep is
+   // computed up front, so that only the filter design and processing are
+   // timed.
+   constexpr std::size_t size = 48000;
+   constexpr std::size_t control_rate = 32;
+   auto const in = test::noise(size);
+   std::vector<float> out(size);
+   std::vector<q::frequency> sweep;
+   for (std::size_t i = 0; i != size; ++i)
+   {
+      auto lfo = 0.5 + 0.5 * std::sin(2 * q::pi * 2.0 * i / sps);
+      sweep.push_back(q::frequency(200.0 * std::pow(10.0, lfo)));
+   }
+
+   auto time = [&](auto&& f)
+   {
+      return benchmark::run(
+         [&]
+         {
+            f();
+            benchmark::keep(out.back());
+         }
+      ) / size;
+   };
+
+   q::lowpass bq{ 200_Hz, sps, 5.0 };
+   auto t1 = time(
+      [&]
+      {
+         for (std::size_t i = 0; i != size; ++i)
+         {
+            bq.config(sweep[i], sps, 5.0);
+            out[i] = bq(in[i]);
+         }
+      });
+
+   q::svf f{ q::svf::lowpass, 200_Hz, sps, 5.0 };
+   auto t2 = time(
+      [&]
+      {
+         for (std::size_t i = 0; i != size; ++i)
+         {
+            f.config(sweep[i], sps, 5.0);
+            out[i] = f(in[i]);
+         }
+      });
+
+   auto t3 = time(
+      [&]
+      {
+         for (std::size_t i = 0; i != size; ++i)
+         {
+            f.fast_config(sweep[i], sps, 5.0);
+            out[i] = f(in[i]);
+         }
+      });
+
+   auto t4 = time(
+      [&]
+      {
+         for (std::size_t i = 0; i < size; i += control_rate)
+         {
+            f.config(sweep[i], sps, 5.0, control_rate);
+            f.process(&in[i], &out[i], control_rate);
+         }
+      });
+
+   auto t5 = time(
+      [&]
+      {
+         for (std::size_t i = 0; i < size; i += control_rate)
+         {
+            f.fast_config(sweep[i], sps, 5.0, control_rate);
+            f.process(&in[i], &out[i], control_rate);
+         }
+      });
+
+   std::cout
+      << std::endl
+      << "Auto-wah sweep (ns/sample)" << std::endl
+      << std::fixed << std::setprecision(2)
+      << "   biquad, config per sample:              " << t1 << std::endl
+      << "   svf, config per sample:                 " << t2 << std::endl
+      << "   svf, fast_config per sample:            " << t3 << std::endl
+      << "   svf, config every 32, ramped:           " << t4 << std::endl
+      << "   svf, fast_config every 32, ramped:      " << t5 << std::endl;
+}
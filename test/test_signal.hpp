@@ -0,0 +1,37 @@
+/*=============================================================================
+   Copyright (c) 2014-2020 Joel de Guzman. All rights reserved.
+
+   Distributed under the MIT License [ https://opensource.org/licenses/MIT ]
+=============================================================================*/
+#if !defined(CYCFI_Q_TEST_SIGNAL_HPP_OCTOBER_18_2026)
+#define CYCFI_Q_TEST_SIGNAL_HPP_OCTOBER_18_2026
+
+#include <q/support/base.hpp>
+#include <cstddef>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+// Test signals and block sizes shared by the block processing tests.
+////////////////////////////////////////////////////////////////////////////////
+namespace test
+{
+   ////////////////////////////////////////////////////////////////////////////
+   // White noise, from q::fast_rand, in [-1, 1).
+   ////////////////////////////////////////////////////////////////////////////
+   inline std::vector<float> noise(std::size_t size)
+   {
+      std::vector<float> sig(size);
+      for (auto& s : sig)
+         s = (cycfi::q::fast_rand() / 16384.0f) - 1.0f;
+      return sig;
+   }
+
+   ////////////////////////////////////////////////////////////////////////////
+   // Odd block sizes, for checking block processing against processing a
+   // sample at a time: single samples, sizes that are not multiples of the
+   // vector widths, and blocks longer than the internal chunks.
+   ////////////////////////////////////////////////////////////////////////////
+   constexpr std::size_t block_sizes[] = { 1, 7, 8, 64, 3, 100, 17, 256, 1500 };
+}
+
+#endif
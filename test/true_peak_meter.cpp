@@ -0,0 +1,242 @@
+/*=============================================================================
+   Copyright (c) 2014-2020 Joel de Guzman. All rights reserved.
+
+   Distributed under the MIT License [ https://opensource.org/licenses/MIT ]
+=============================================================================*/
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <infra/doctest.hpp>
+
+#include <q/support/literals.hpp>
+#include <q/fx/true_peak_meter.hpp>
+#include <vector>
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include "benchmark.hpp"
+#include "test_signal.hpp"
+
+namespace q = cycfi::q;
+using namespace q::literals;
+
+constexpr auto sps = 48000;
+
+namespace
+{
+   std::vector<float> sine(double freq, double phase, double level, std::size_t size)
+   {
+      std::vector<float> sig(size);
+      auto const a = std::pow(10.0, level / 20.0);
+      for (std::size_t i = 0; i != size; ++i)
+         sig[i] = a * std::sin(2_pi * freq * i / sps + phase);
+      return sig;
+   }
+
+   // The true peak, by hand: the 4 phases of the interpolation filter, one
+   // output at a time, in double precision
+   struct reference_true_peak
+   {
+      double operator()(float s)
+      {
+         for (std::size_t k = 11; k != 0; --k)
+            x[k] = x[k-1];
+         x[0] = s;
+
+         double peak = 0.0;
+         for (std::size_t p = 0; p != 4; ++p)
+         {
+            double y = 0.0;
+            for (std::size_t k = 0; k != 12; ++k)
+               y += double(q::detail::true_peak_coefficients[p][k]) * x[k];
+            peak = std::max(peak, std::abs(y));
+         }
+         return peak;
+      }
+
+      double x[12] = {};
+   };
+
+   float true_peak(std::vector<float> const& sig)
+   {
+      q::true_peak_meter meter;
+      return meter.process(sig.data(), sig.size());
+   }
+
+   // The true peak, after the first 1000 samples (past the onset)
+   float steady_true_peak(std::vector<float> const& sig)
+   {
+      q::true_peak_meter meter;
+      meter.process(sig.data(), 1000);
+      return meter.process(sig.data() + 1000, sig.size() - 1000);
+   }
+
+   float sample_peak(std::vector<float> const& sig)
+   {
+      float peak = 0.0f;
+      for (auto s : sig)
+         peak = std::max(peak, std::abs(s));
+      return peak;
+   }
+}
+
+TEST_CASE("True_Peak_Meter_Filter")
+{
+   // The 48 tap filter is symmetric (linear phase), with a gain of 4 (the
+   // interpolation factor) at DC, within 0.15 dB.
+   auto const& h = q::detail::true_peak_coefficients;
+   double sum = 0.0;
+   for (std::size_t p = 0; p != 4; ++p)
+   {
+      for (std::size_t k = 0; k != 12; ++k)
+      {
+         CHECK(h[p][k] == h[3 - p][11 - k]);
+         sum += h[p][k];
+      }
+   }
+   CHECK(std::abs(20 * std::log10(sum / 4)) < 0.15);
+}
+
+TEST_CASE("True_Peak_Meter_Reference")
+{
+   // Against the filter by hand, in odd sized blocks, with the block peaks
+   auto const sig = test::noise(20000);
+   q::true_peak_meter meter;
+   reference_true_peak ref;
+
+   double max_error = 0.0;
+   double overall = 0.0;
+   std::size_t i = 0;
+   for (std::size_t k = 0; i < sig.size(); ++k)
+   {
+      auto n = std::min(test::block_sizes[k % std::size(test::block_sizes)], sig.size() - i);
+      double expected = 0.0;
+      for (std::size_t j = 0; j != n; ++j)
+         expected = std::max(expected, ref(sig[i + j]));
+      auto const peak = meter.process(&sig[i], n);
+      CHECK(meter.block_peak(0) == peak);
+      max_error = std::max(max_error, std::abs(peak - expected));
+      overall = std::max(overall, expected);
+      i += n;
+   }
+   CHECK(max_error < 1e-6);
+   CHECK(meter.peak() == doctest::Approx(overall).epsilon(1e-6));
+
+   meter.reset();
+   CHECK(meter.peak() == 0.0f);
+}
+
+TEST_CASE("True_Peak_Meter_Sines")
+{
+   // A sine at a quarter of the sample rate, 45 degrees off the samples:
+   // the sample peak is 3 dB below the true peak.
+   {
+      auto const sig = sine(sps / 4, q::pi / 4, -6, sps);
+      CHECK(std::abs(q::decibel(sample_peak(sig)).val - (-9.01)) <= 0.01);
+      CHECK(std::abs(q::decibel(steady_true_peak(sig)).val - (-6.0)) <= 0.1);
+   }
+
+   // Sines at any phase, up to 12kHz (at 48kHz), read within -0.4 dB (the
+   // EBU Tech 3341 tolerance) and +0.25 dB (the ripple of the BS.1770
+   // filter reaches 0.2 dB) of their peak.
+   for (auto freq : { 100.0, 997.0, 4000.0, 6000.0, 9000.0, 11025.0, 12000.0 })
+   {
+      for (auto phase : { 0.0, 0.3, q::pi / 4, 1.0, 2.0 })
+      {
+         auto const sig = sine(freq, phase, -6, sps / 10);
+         auto const tp = q::decibel(steady_true_peak(sig)).val;
+         INFO("frequency: " << freq << " phase: " << phase);
+         CHECK(tp <= -6.0 + 0.25);
+         CHECK(tp >= -6.0 - 0.4);
+      }
+   }
+
+   // Full scale square-ish signals overshoot 0 dBFS
+   {
+      std::vector<float> sig(sps / 10);
+      for (std::size_t i = 0; i != sig.size(); ++i)
+         sig[i] = ((i / 8) % 2)? 1.0f : -1.0f;
+      CHECK(true_peak(sig) > 1.0f);
+      CHECK(sample_peak(sig) == 1.0f);
+   }
+}
+
+TEST_CASE("True_Peak_Meter_Channels")
+{
+   // Each channel is metered on its own, as a mono meter would
+   constexpr std::size_t frames = 10000;
+   std::vector<std::vector<float>> sig = {
+      test::noise(frames)
+    , sine(1000, 0.5, -20, frames)
+    , sine(sps / 4, q::pi / 4, -3, frames)
+   };
+   sig[0][5000] = 2.0f;
+
+   q::true_peak_meter meter{ 3 };
+   float const* ptrs[3];
+   std::size_t i = 0;
+   float overall = 0.0f;
+   for (std::size_t k = 0; i < frames; ++k)
+   {
+      auto n = std::min(test::block_sizes[k % std::size(test::block_sizes)] * 3, frames - i);
+      for (std::size_t ch = 0; ch != 3; ++ch)
+         ptrs[ch] = &sig[ch][i];
+      auto peak = meter(q::audio_channels<float const>{ ptrs, 3, n });
+      CHECK(peak == std::max({ meter.block_peak(0), meter.block_peak(1), meter.block_peak(2) }));
+      overall = std::max(overall, peak);
+      i += n;
+   }
+
+   for (std::size_t ch = 0; ch != 3; ++ch)
+   {
+      INFO("channel: " << ch);
+      CHECK(meter.peak(ch) == true_peak(sig[ch]));
+   }
+   CHECK(meter.peak() == overall);
+   CHECK(meter.peak(0) > 2.0f);
+}
+
+TEST_CASE("True_Peak_Meter_Benchmark" * doctest::skip())
+{
+   // Ten seconds, in 256 frame buffers
+   constexpr std::size_t buffer_size = 256;
+   constexpr std::size_t iterations = (sps * 10) / buffer_size;
+   auto const sig = test::noise(buffer_size * iterations);
+
+   auto by_hand = benchmark::run(
+      [&]
+      {
+         reference_true_peak ref;
+         double peak = 0.0;
+         for (auto s : sig)
+            peak = std::max(peak, ref(s));
+         benchmark::keep(peak);
+      }
+   ) / sig.size();
+
+   auto run = [&](std::size_t channels)
+   {
+      q::true_peak_meter meter{ channels };
+      std::vector<float const*> ptrs(channels);
+      auto t = benchmark::run(
+         [&]
+         {
+            for (std::size_t i = 0; i != iterations; ++i)
+            {
+               for (auto& p : ptrs)
+                  p = &sig[i * buffer_size];
+               benchmark::keep(
+                  meter(q::audio_channels<float const>{ ptrs.data(), channels, buffer_size }));
+            }
+         }
+      );
+      return t / (iterations * buffer_size * channels);
+   };
+
+   std::cout
+      << std::endl
+      << "True peak meter, ns per sample" << std::endl
+      << std::fixed << std::setprecision(2)
+      << "   by hand:       " << by_hand << std::endl
+      << "   mono:          " << run(1) << std::endl
+      << "   stereo:        " << run(2) << std::endl
+      << "   5.1:           " << run(6) << std::endl;
+}